@@ -188,11 +188,80 @@ void test_case_realloc_size()
     TEST_ASSERT_EQUAL_UINT32(stats_start.current_size, stats_current.current_size);
 }
 
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+static mbed_stats_heap_site_t sites_start[MBED_CONF_PLATFORM_HEAP_STATS_SITES + 1];
+static mbed_stats_heap_site_t sites_current[MBED_CONF_PLATFORM_HEAP_STATS_SITES + 1];
+
+static const mbed_stats_heap_site_t *find_site(const mbed_stats_heap_site_t *sites, size_t count, void *caller)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (sites[i].caller == caller) {
+            return &sites[i];
+        }
+    }
+    return NULL;
+}
+
+void test_case_site_size()
+{
+    const size_t max_count = MBED_CONF_PLATFORM_HEAP_STATS_SITES + 1;
+    const mbed_stats_heap_site_t empty = {NULL, 0, 0, 0, 0};
+    mbed_stats_heap_t stats_current;
+    void *data[4];
+
+    size_t count_start = mbed_stats_heap_site_get_each(sites_start, max_count);
+    for (uint32_t i = 0; i < 4; i++) {
+        data[i] = thunk_malloc(ALLOCATION_SIZE_SMALL);
+        TEST_ASSERT(data[i] != NULL);
+    }
+    size_t count_current = mbed_stats_heap_site_get_each(sites_current, max_count);
+
+    // Find the call site in thunk_malloc
+    const mbed_stats_heap_site_t *site = NULL;
+    const mbed_stats_heap_site_t *start = NULL;
+    for (size_t i = 0; i < count_current && site == NULL; i++) {
+        start = find_site(sites_start, count_start, sites_current[i].caller);
+        if (start == NULL) {
+            start = &empty;
+        }
+        if (sites_current[i].current_size - start->current_size == 4 * ALLOCATION_SIZE_SMALL) {
+            site = &sites_current[i];
+        }
+    }
+    TEST_ASSERT(site != NULL);
+    TEST_ASSERT_EQUAL_UINT32(start->alloc_cnt + 4, site->alloc_cnt);
+    TEST_ASSERT_EQUAL_UINT32(start->total_cnt + 4, site->total_cnt);
+    TEST_ASSERT(site->max_size >= site->current_size);
+    void *caller = site->caller;
+
+    // Every allocation is accounted to a call site
+    mbed_stats_heap_get(&stats_current);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < count_current; i++) {
+        sum += sites_current[i].current_size;
+    }
+    TEST_ASSERT_EQUAL_UINT32(stats_current.current_size, sum);
+
+    // Free memory and assert back to starting size
+    for (uint32_t i = 0; i < 4; i++) {
+        free(data[i]);
+    }
+    count_current = mbed_stats_heap_site_get_each(sites_current, max_count);
+    site = find_site(sites_current, count_current, caller);
+    TEST_ASSERT(site != NULL);
+    TEST_ASSERT_EQUAL_UINT32(start->current_size, site->current_size);
+    TEST_ASSERT_EQUAL_UINT32(start->alloc_cnt, site->alloc_cnt);
+}
+#endif
+
 Case cases[] = {
     Case("malloc and free size", test_case_malloc_free_size),
     Case("allocate size zero", test_case_allocate_zero),
     Case("allocation failure", test_case_allocate_fail),
     Case("realloc size", test_case_realloc_size),
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+    Case("call site size", test_case_site_size),
+#endif
 };
 
 utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
@@ -80,6 +80,7 @@ void TLSSOCKET_SEND_REPEAT();
 void TLSSOCKET_NO_CERT();
 void TLSSOCKET_SIMULTANEOUS();
 void TLSSOCKET_SEND_TIMEOUT();
+void TLSSOCKET_RAM_BENCHMARK();
 
 #endif // defined(MBEDTLS_SSL_CLI_C) || defined(DOXYGEN_ONLY)
 
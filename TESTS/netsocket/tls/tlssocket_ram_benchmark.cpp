@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "TLSSocket.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest.h"
+#include "tls_tests.h"
+
+using namespace utest::v1;
+
+#if defined(MBEDTLS_SSL_CLI_C)
+
+namespace {
+static const int TOTAL_BYTES = 16 * 1024;
+static const int CHUNK_SIZE = 1000;
+static const size_t frag_lens[] = {0, 512, 1024, 2048, 4096};
+}
+
+static size_t heap_used()
+{
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    return stats.current_size;
+}
+
+// Heap used by one connected TLS socket, and echo throughput, for each max_fragment_length
+void TLSSOCKET_RAM_BENCHMARK()
+{
+    SKIP_IF_TCP_UNSUPPORTED();
+#if !MBED_HEAP_STATS_ENABLED
+    TEST_SKIP_MESSAGE("Heap statistics not enabled");
+#endif
+
+    for (unsigned i = 0; i < sizeof(frag_lens) / sizeof(frag_lens[0]); i++) {
+        size_t heap_before = heap_used();
+        TLSSocket *sock = new TLSSocket;
+        // Always a full handshake, so that the numbers can be compared
+        sock->set_session_cache(NULL);
+
+        nsapi_error_t err = sock->set_max_frag_len(frag_lens[i]);
+        if (err == NSAPI_ERROR_UNSUPPORTED) {
+            delete sock;
+            TEST_SKIP_MESSAGE("MBEDTLS_SSL_MAX_FRAGMENT_LENGTH not enabled");
+        }
+        TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, err);
+
+        Timer handshake;
+        handshake.start();
+        if (tlssocket_connect_to_echo_srv(*sock) != NSAPI_ERROR_OK) {
+            printf("Error from tlssocket_connect_to_echo_srv\n");
+            TEST_FAIL();
+            delete sock;
+            return;
+        }
+        handshake.stop();
+        size_t heap_connected = heap_used() - heap_before;
+
+        fill_tx_buffer_ascii(tls_global::tx_buffer, CHUNK_SIZE);
+        Timer transfer;
+        transfer.start();
+        for (int sent_total = 0; sent_total < TOTAL_BYTES; sent_total += CHUNK_SIZE) {
+            int sent = sock->send(tls_global::tx_buffer, CHUNK_SIZE);
+            TEST_ASSERT_EQUAL(CHUNK_SIZE, sent);
+            int recvd_total = 0;
+            while (recvd_total < sent) {
+                int recvd = sock->recv(tls_global::rx_buffer + recvd_total, sent - recvd_total);
+                if (recvd <= 0) {
+                    printf("sock.recv returned %d\n", recvd);
+                    TEST_FAIL();
+                    sock->close();
+                    delete sock;
+                    return;
+                }
+                recvd_total += recvd;
+            }
+            TEST_ASSERT_EQUAL(0, memcmp(tls_global::tx_buffer, tls_global::rx_buffer, sent));
+        }
+        transfer.stop();
+
+        TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, sock->close());
+        size_t heap_closed = heap_used() - heap_before;
+        delete sock;
+
+        int ms = transfer.read_ms() ? transfer.read_ms() : 1;
+        printf("MBED: max_frag_len %4u: %6u bytes connected, %5u bytes after close, handshake %5d ms, echo %6d bytes/s\n",
+               frag_lens[i], heap_connected, heap_closed, handshake.read_ms(), TOTAL_BYTES * 1000 / ms);
+    }
+}
+
+#endif // defined(MBEDTLS_SSL_CLI_C)
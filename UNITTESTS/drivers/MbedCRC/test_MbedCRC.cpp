@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "drivers/MbedCRC.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace mbed;
+
+// Bit by bit reference model, for any width up to 32
+static uint32_t reference_crc(uint32_t poly, uint8_t width, uint32_t init, uint32_t final_xor,
+                              bool reflect_in, bool reflect_out, const uint8_t *data, size_t size)
+{
+    uint32_t top = 1UL << (width - 1);
+    uint32_t mask = (width == 32) ? 0xFFFFFFFF : ((1UL << width) - 1);
+    uint32_t crc = init & mask;
+
+    for (size_t i = 0; i < size; i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            int in_bit = reflect_in ? (data[i] >> bit) & 1 : (data[i] >> (7 - bit)) & 1;
+            bool feedback = ((crc & top) != 0) ^ in_bit;
+            crc = (crc << 1) & mask;
+            if (feedback) {
+                crc ^= poly;
+            }
+        }
+    }
+
+    if (reflect_out) {
+        uint32_t reflected = 0;
+        for (int bit = 0; bit < width; bit++) {
+            if (crc & (1UL << bit)) {
+                reflected |= 1UL << (width - 1 - bit);
+            }
+        }
+        crc = reflected;
+    }
+    crc = (crc ^ final_xor) & mask;
+
+    // MbedCRC returns CRCs narrower than 8 bits left aligned in a byte
+    return (width < 8) ? crc << (8 - width) : crc;
+}
+
+class TestMbedCRC : public testing::Test {
+protected:
+    uint8_t data[1024];
+
+    virtual void SetUp()
+    {
+        srand(1);
+        for (size_t i = 0; i < sizeof(data); i++) {
+            data[i] = rand();
+        }
+    }
+
+    // Compute CRC of data at all alignments and sizes, both at once and in two parts
+    template <uint32_t polynomial, uint8_t width>
+    void check(MbedCRC<polynomial, width> &ct, uint32_t poly, uint32_t init, uint32_t final_xor,
+               bool reflect_in, bool reflect_out)
+    {
+        for (size_t offset = 0; offset < 8; offset++) {
+            for (size_t size = 0; size < 300; size += 1 + size / 16) {
+                uint32_t crc, expected;
+                expected = reference_crc(poly, width, init, final_xor, reflect_in, reflect_out,
+                                         data + offset, size);
+                EXPECT_EQ(0, ct.compute(data + offset, size, &crc));
+                EXPECT_EQ(expected, crc) << "offset " << offset << " size " << size;
+
+                size_t split = size ? rand() % size : 0;
+                EXPECT_EQ(0, ct.compute_partial_start(&crc));
+                EXPECT_EQ(0, ct.compute_partial(data + offset, split, &crc));
+                EXPECT_EQ(0, ct.compute_partial(data + offset + split, size - split, &crc));
+                EXPECT_EQ(0, ct.compute_partial_stop(&crc));
+                EXPECT_EQ(expected, crc) << "offset " << offset << " size " << size << " split " << split;
+            }
+        }
+    }
+};
+
+TEST_F(TestMbedCRC, check_value)
+{
+    char test[] = "123456789";
+    uint32_t crc;
+
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    EXPECT_EQ(0, ct.compute(test, strlen(test), &crc));
+    EXPECT_EQ(0xCBF43926, crc);
+
+    MbedCRC<POLY_32BIT_REV_ANSI, 32> ct_rev(0xFFFFFFFF, 0xFFFFFFFF, true, false);
+    EXPECT_EQ(0, ct_rev.compute(test, strlen(test), &crc));
+    EXPECT_EQ(0xCBF43926, crc);
+}
+
+TEST_F(TestMbedCRC, poly_7bit_sd)
+{
+    MbedCRC<POLY_7BIT_SD, 7> ct;
+    check(ct, POLY_7BIT_SD, 0, 0, false, false);
+}
+
+TEST_F(TestMbedCRC, poly_8bit_ccitt)
+{
+    MbedCRC<POLY_8BIT_CCITT, 8> ct;
+    check(ct, POLY_8BIT_CCITT, 0, 0, false, false);
+}
+
+TEST_F(TestMbedCRC, poly_16bit_ccitt)
+{
+    MbedCRC<POLY_16BIT_CCITT, 16> ct;
+    check(ct, POLY_16BIT_CCITT, 0xFFFF, 0, false, false);
+}
+
+TEST_F(TestMbedCRC, poly_16bit_ibm)
+{
+    MbedCRC<POLY_16BIT_IBM, 16> ct;
+    check(ct, POLY_16BIT_IBM, 0, 0, true, true);
+}
+
+TEST_F(TestMbedCRC, poly_32bit_ansi)
+{
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    check(ct, POLY_32BIT_ANSI, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+
+    // As used by TDBStore: chained initial value and no remainder reflection
+    MbedCRC<POLY_32BIT_ANSI, 32> ct_chained(0x12345678, 0, true, false);
+    check(ct_chained, POLY_32BIT_ANSI, 0x12345678, 0, true, false);
+
+    // Non reflected data takes the byte table path
+    MbedCRC<POLY_32BIT_ANSI, 32> ct_msb(0xFFFFFFFF, 0, false, false);
+    check(ct_msb, POLY_32BIT_ANSI, 0xFFFFFFFF, 0, false, false);
+}
+
+TEST_F(TestMbedCRC, poly_32bit_rev_ansi)
+{
+    // The reversed polynomial is computed LSB first, regardless of reflection settings
+    MbedCRC<POLY_32BIT_REV_ANSI, 32> ct(0xFFFFFFFF, 0xFFFFFFFF, true, false);
+    check(ct, POLY_32BIT_ANSI, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+}
+
+static double now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+TEST_F(TestMbedCRC, benchmark)
+{
+    const int iterations = 2000;
+    uint32_t crc, sum = 0;
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    MbedCRC<POLY_32BIT_ANSI, 32> ct_msb(0xFFFFFFFF, 0, false, false);
+    MbedCRC<POLY_16BIT_CCITT, 16> ct16;
+
+    double start = now_us();
+    for (int i = 0; i < iterations; i++) {
+        ct.compute(data, sizeof(data), &crc);
+        sum += crc;
+    }
+    double mid = now_us();
+    for (int i = 0; i < iterations; i++) {
+        ct_msb.compute(data, sizeof(data), &crc);
+        sum += crc;
+    }
+    double mid2 = now_us();
+    for (int i = 0; i < iterations; i++) {
+        ct16.compute(data, sizeof(data), &crc);
+        sum += crc;
+    }
+    double end = now_us();
+
+    // Keep the results alive
+    EXPECT_NE(0U, sum);
+
+    double bytes = (double) iterations * sizeof(data);
+    printf("CRC32 reflected (%d slices): %.1f MB/s\n", MBED_CRC_TABLE_SLICES,
+           bytes / (mid - start));
+    printf("CRC32 byte table: %.1f MB/s\n",
+           bytes / (mid2 - mid));
+    printf("CRC16 byte table: %.1f MB/s\n",
+           bytes / (end - mid2));
+}
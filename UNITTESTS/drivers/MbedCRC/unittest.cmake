@@ -0,0 +1,18 @@
+
+####################
+# UNIT TESTS
+####################
+
+set(unittest-sources
+  ../drivers/MbedCRC.cpp
+  ../drivers/TableCRC.cpp
+  stubs/mbed_assert_stub.c
+)
+
+set(unittest-test-sources
+  drivers/MbedCRC/test_MbedCRC.cpp
+)
+
+# Exercise the slice-by-8 tables (must be the same for all sources using MbedCRC.h)
+set_source_files_properties(../drivers/MbedCRC.cpp ../drivers/TableCRC.cpp drivers/MbedCRC/test_MbedCRC.cpp
+  PROPERTIES COMPILE_DEFINITIONS MBED_CONF_DRIVERS_CRC_TABLE_SLICES=8)
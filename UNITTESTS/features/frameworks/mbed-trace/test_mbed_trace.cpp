@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "mbed-trace/mbed_trace.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#define TRACE_GROUP "test"
+
+static std::vector<std::string> printed;
+static size_t printed_bytes;
+
+static void print_store(const char *str)
+{
+    printed.push_back(str);
+}
+
+static void print_count(const char *str)
+{
+    printed_bytes += strlen(str);
+}
+
+static pthread_mutex_t trace_mutex;
+
+static void trace_mutex_wait()
+{
+    pthread_mutex_lock(&trace_mutex);
+}
+
+static void trace_mutex_release()
+{
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+class TestMbedTrace : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(0, mbed_trace_init());
+        mbed_trace_print_function_set(print_store);
+        mbed_trace_config_set(TRACE_MODE_PLAIN | TRACE_ACTIVE_LEVEL_ALL);
+        printed.clear();
+    }
+
+    virtual void TearDown()
+    {
+        mbed_trace_free();
+    }
+};
+
+TEST_F(TestMbedTrace, deferred_print_on_flush)
+{
+    tr_info("hello %d", 1);
+    EXPECT_TRUE(printed.empty());
+    EXPECT_EQ(1, mbed_trace_deferred_flush());
+    ASSERT_EQ(1U, printed.size());
+    EXPECT_EQ("hello 1", printed[0]);
+    EXPECT_EQ(0, mbed_trace_deferred_flush());
+}
+
+TEST_F(TestMbedTrace, deferred_same_output_as_direct)
+{
+    const char *str = "string";
+    long l = -123456789L;
+    long long ll = 1234567890123LL;
+    size_t z = 42;
+    uint32_t u32 = 0xDEADBEEF;
+    uint64_t u64 = 0x0123456789ABCDEFULL;
+
+    for (int deferred = 1; deferred >= 0; deferred--) {
+        ASSERT_EQ(0, mbed_trace_deferred_buffer_size(deferred ? 1024 : 0));
+        tr_info("%d %i %u %x %X %o %c %hhu %hd", -1, 2, 3U, 0xab, 0xcd, 8, 'c', 300, -2);
+        tr_info("%ld %lld %zu %" PRIu32 " %" PRIx64 " %p", l, ll, z, u32, u64, (void *)str);
+        tr_info("%s|%-8s|%8s|%.3s|%.*s|%*d|%-*.*d", str, str, str, str, 2, str, 5, 7, 6, 4, 9);
+        tr_info("%f %.2f %e %g %5.1f", 1.5, 2.25, 1e10, 0.0001, -3.14159);
+        tr_info("100%% %s%%", NULL);
+        tr_info("no args");
+        mbed_trace_deferred_flush();
+    }
+    ASSERT_EQ(12U, printed.size());
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(printed[6 + i], printed[i]);
+    }
+}
+
+TEST_F(TestMbedTrace, deferred_header)
+{
+    mbed_trace_config_set(TRACE_ACTIVE_LEVEL_ALL);
+    tr_warn("value %d", 5);
+    tr_debug("value %d", 6);
+    mbed_trace_deferred_flush();
+    ASSERT_EQ(2U, printed.size());
+    EXPECT_EQ("[WARN][test]: value 5", printed[0]);
+    EXPECT_EQ("[DBG ][test]: value 6", printed[1]);
+}
+
+TEST_F(TestMbedTrace, deferred_copies_strings)
+{
+    char str[] = "before";
+    tr_info("%s %s", str, mbed_trace_array((const uint8_t *)"\x01\x02", 2));
+    strcpy(str, "after");
+    mbed_trace_deferred_flush();
+    ASSERT_EQ(1U, printed.size());
+    EXPECT_EQ("before 01:02", printed[0]);
+}
+
+TEST_F(TestMbedTrace, deferred_filtered_when_recorded)
+{
+    mbed_trace_config_set(TRACE_MODE_PLAIN | TRACE_ACTIVE_LEVEL_WARN);
+    tr_debug("not recorded");
+    tr_warn("recorded");
+    mbed_trace_exclude_filters_set((char *)"test");
+    tr_err("not recorded");
+    EXPECT_EQ(1, mbed_trace_deferred_flush());
+    ASSERT_EQ(1U, printed.size());
+    EXPECT_EQ("recorded", printed[0]);
+}
+
+TEST_F(TestMbedTrace, deferred_drop_when_full)
+{
+    ASSERT_EQ(0, mbed_trace_deferred_buffer_size(256));
+    for (int i = 0; i < 100; i++) {
+        tr_info("trace %d", i);
+    }
+    uint32_t dropped = mbed_trace_deferred_dropped();
+    EXPECT_GT(dropped, 0U);
+    EXPECT_EQ(100U - dropped, (uint32_t)mbed_trace_deferred_flush());
+    ASSERT_FALSE(printed.empty());
+    EXPECT_EQ("trace 0", printed[0]);
+
+    // There is room again once flushed
+    tr_info("trace %d", 100);
+    EXPECT_EQ(1, mbed_trace_deferred_flush());
+    EXPECT_EQ("trace 100", printed.back());
+    EXPECT_EQ(dropped, mbed_trace_deferred_dropped());
+}
+
+TEST_F(TestMbedTrace, deferred_wrap_around)
+{
+    ASSERT_EQ(0, mbed_trace_deferred_buffer_size(256));
+    char expected[64];
+    for (int i = 0; i < 200; i++) {
+        // Records of varying length end up straddling the end of the buffer
+        tr_info("%d %.*s", i, i % 20, "abcdefghijklmnopqrstuvwxyz");
+        if (i % 3 == 2) {
+            EXPECT_EQ(3, mbed_trace_deferred_flush());
+        }
+    }
+    mbed_trace_deferred_flush();
+    EXPECT_EQ(0U, mbed_trace_deferred_dropped());
+    ASSERT_EQ(200U, printed.size());
+    for (int i = 0; i < 200; i++) {
+        snprintf(expected, sizeof(expected), "%d %.*s", i, i % 20, "abcdefghijklmnopqrstuvwxyz");
+        EXPECT_EQ(expected, printed[i]);
+    }
+}
+
+TEST_F(TestMbedTrace, deferred_disable)
+{
+    tr_info("pending");
+    ASSERT_EQ(0, mbed_trace_deferred_buffer_size(0));
+    ASSERT_EQ(1U, printed.size());
+    EXPECT_EQ("pending", printed[0]);
+
+    tr_info("direct");
+    ASSERT_EQ(2U, printed.size());
+    EXPECT_EQ("direct", printed[1]);
+    EXPECT_EQ(0, mbed_trace_deferred_flush());
+}
+
+static const int producers = 4;
+static const int traces = 2000;
+static bool producers_done;
+static int flushed;
+
+static void *producer(void *arg)
+{
+    int id = *(int *)arg;
+    for (int j = 0; j < traces; j++) {
+        tr_info("producer %d trace %d", id, j);
+        if (j % 16 == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    while (!__atomic_load_n(&producers_done, __ATOMIC_ACQUIRE)) {
+        flushed += mbed_trace_deferred_flush();
+        sched_yield();
+    }
+    flushed += mbed_trace_deferred_flush();
+    return NULL;
+}
+
+TEST_F(TestMbedTrace, deferred_multiple_producers)
+{
+    pthread_t threads[producers];
+    int ids[producers];
+    pthread_t flusher;
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&trace_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    producers_done = false;
+    flushed = 0;
+
+    ASSERT_EQ(0, mbed_trace_deferred_buffer_size(4096));
+    mbed_trace_mutex_wait_function_set(trace_mutex_wait);
+    mbed_trace_mutex_release_function_set(trace_mutex_release);
+    for (int i = 0; i < producers; i++) {
+        ids[i] = i;
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, producer, &ids[i]));
+    }
+    ASSERT_EQ(0, pthread_create(&flusher, NULL, consumer, NULL));
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    __atomic_store_n(&producers_done, true, __ATOMIC_RELEASE);
+    pthread_join(flusher, NULL);
+
+    EXPECT_EQ((uint32_t)(producers * traces), flushed + mbed_trace_deferred_dropped());
+    ASSERT_EQ((size_t)flushed, printed.size());
+
+    // Traces of each producer are printed in order
+    int next[producers] = {0};
+    for (size_t i = 0; i < printed.size(); i++) {
+        int producer, trace;
+        ASSERT_EQ(2, sscanf(printed[i].c_str(), "producer %d trace %d", &producer, &trace));
+        ASSERT_LT(producer, producers);
+        EXPECT_LE(next[producer], trace);
+        next[producer] = trace + 1;
+    }
+}
+
+TEST_F(TestMbedTrace, benchmark)
+{
+    const int iterations = 20000;
+    const char *grp = "bnch";
+    int recorded = 0;
+
+    mbed_trace_print_function_set(print_count);
+    mbed_trace_config_set(TRACE_MODE_COLOR | TRACE_ACTIVE_LEVEL_ALL | TRACE_CARRIAGE_RETURN);
+    printed_bytes = 0;
+
+    ASSERT_EQ(0, mbed_trace_deferred_buffer_size(0));
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        mbed_tracef(TRACE_LEVEL_DEBUG, grp, "rx %d bytes from %s, seq %u", i, "fe80::1", 1000U + i);
+    }
+    uint64_t mid = now_ns();
+    size_t direct_bytes = printed_bytes;
+
+    // Flush every 64 traces, as a low priority thread would
+    ASSERT_EQ(0, mbed_trace_deferred_buffer_size(8192));
+    uint64_t record = 0, flush = 0;
+    for (int i = 0; i < iterations; i += 64) {
+        uint64_t t0 = now_ns();
+        for (int j = i; j < i + 64 && j < iterations; j++) {
+            mbed_tracef(TRACE_LEVEL_DEBUG, grp, "rx %d bytes from %s, seq %u", j, "fe80::1", 1000U + j);
+        }
+        uint64_t t1 = now_ns();
+        recorded += mbed_trace_deferred_flush();
+        uint64_t t2 = now_ns();
+        record += t1 - t0;
+        flush += t2 - t1;
+    }
+
+    EXPECT_EQ(iterations, recorded);
+    EXPECT_EQ(direct_bytes, printed_bytes - direct_bytes);
+
+    double direct_ns = (double)(mid - start) / iterations;
+    double record_ns = (double)record / iterations;
+    double flush_ns = (double)flush / iterations;
+    printf("mbed_tracef direct: %.0f ns/trace\n", direct_ns);
+    printf("mbed_tracef deferred: %.0f ns/trace on the caller, %.0f ns/trace in flush\n", record_ns, flush_ns);
+
+    // The caller only packs the arguments, which takes about 150 ns on a
+    // desktop host. The bound leaves room for slow hosts and only catches the
+    // caller formatting or printing again.
+    EXPECT_LT(record_ns, 2000);
+}
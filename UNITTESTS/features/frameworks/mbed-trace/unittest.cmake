@@ -0,0 +1,20 @@
+
+####################
+# UNIT TESTS
+####################
+
+set(unittest-sources
+  ../features/frameworks/mbed-trace/source/mbed_trace.c
+)
+
+set(unittest-test-sources
+  features/frameworks/mbed-trace/test_mbed_trace.cpp
+)
+
+set(MBED_TRACE_CONFIG
+  MBED_CONF_MBED_TRACE_ENABLE=1
+  MBED_CONF_MBED_TRACE_FEA_IPV6=0
+  MBED_CONF_MBED_TRACE_DEFERRED=1
+)
+set_source_files_properties(features/frameworks/mbed-trace/test_mbed_trace.cpp PROPERTIES COMPILE_DEFINITIONS "${MBED_TRACE_CONFIG}")
+set_source_files_properties(../features/frameworks/mbed-trace/source/mbed_trace.c PROPERTIES COMPILE_DEFINITIONS "${MBED_TRACE_CONFIG}")
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern "C" uint16_t portable_checksum(const void *pData, int length);
+
+// 16 bits at a time reference model, in the byte order of lwip_standard_chksum
+static uint16_t reference_checksum(const uint8_t *data, int length)
+{
+    uint32_t sum = 0;
+    uint16_t word;
+
+    for (int i = 0; i + 1 < length; i += 2) {
+        memcpy(&word, data + i, sizeof(word));
+        sum += word;
+    }
+    if (length & 1) {
+        uint8_t last[2] = { data[length - 1], 0 };
+        memcpy(&word, last, sizeof(word));
+        sum += word;
+    }
+
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)sum;
+}
+
+class TestLwipChecksum : public testing::Test {
+protected:
+    uint8_t buffer[2048 + 8];
+
+    virtual void SetUp()
+    {
+        srand(0);
+        for (size_t i = 0; i < sizeof(buffer); i++) {
+            buffer[i] = rand();
+        }
+    }
+};
+
+TEST_F(TestLwipChecksum, empty)
+{
+    EXPECT_EQ(0, portable_checksum(buffer, 0));
+    EXPECT_EQ(0, portable_checksum(buffer + 1, 0));
+}
+
+TEST_F(TestLwipChecksum, all_ones)
+{
+    memset(buffer, 0xFF, sizeof(buffer));
+    for (int length = 1; length < 64; length++) {
+        for (int offset = 0; offset < 8; offset++) {
+            EXPECT_EQ(reference_checksum(buffer + offset, length), portable_checksum(buffer + offset, length));
+        }
+    }
+}
+
+TEST_F(TestLwipChecksum, all_lengths_and_alignments)
+{
+    for (int length = 1; length < 300; length++) {
+        for (int offset = 0; offset < 8; offset++) {
+            EXPECT_EQ(reference_checksum(buffer + offset, length), portable_checksum(buffer + offset, length))
+                    << "length " << length << " offset " << offset;
+        }
+    }
+}
+
+TEST_F(TestLwipChecksum, random_buffers)
+{
+    for (int i = 0; i < 1000; i++) {
+        int offset = rand() % 8;
+        int length = rand() % (sizeof(buffer) - 8);
+        for (int j = 0; j < length; j++) {
+            buffer[offset + j] = rand();
+        }
+        EXPECT_EQ(reference_checksum(buffer + offset, length), portable_checksum(buffer + offset, length))
+                << "length " << length << " offset " << offset;
+    }
+}
+
+static double now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+TEST_F(TestLwipChecksum, benchmark)
+{
+    const int iterations = 20000;
+    const int length = 1460;
+    uint32_t sum = 0;
+
+    double start = now_us();
+    for (int i = 0; i < iterations; i++) {
+        sum += portable_checksum(buffer, length);
+    }
+    double mid = now_us();
+    for (int i = 0; i < iterations; i++) {
+        sum += reference_checksum(buffer, length);
+    }
+    double end = now_us();
+
+    // Keep the results alive
+    EXPECT_NE(0U, sum);
+
+    double bytes = (double) iterations * length;
+    printf("Word at a time checksum: %.1f MB/s\n",
+           bytes / (mid - start));
+    printf("16 bits at a time checksum: %.1f MB/s\n",
+           bytes / (end - mid));
+}
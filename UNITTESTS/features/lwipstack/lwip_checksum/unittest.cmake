@@ -0,0 +1,17 @@
+
+####################
+# UNIT TESTS
+####################
+
+# Unit test suite name
+set(TEST_SUITE_NAME "features_lwipstack_lwip_checksum")
+
+# Source files
+set(unittest-sources
+  ../features/lwipstack/lwip-sys/arch/lwip_checksum.c
+)
+
+# Test files
+set(unittest-test-sources
+  features/lwipstack/lwip_checksum/test_lwip_checksum.cpp
+)
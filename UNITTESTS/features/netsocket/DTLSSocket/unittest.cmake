@@ -5,6 +5,7 @@
 
 set(unittest-sources
   ../features/netsocket/SocketAddress.cpp
+  ../features/netsocket/Socket.cpp
   ../features/netsocket/NetworkStack.cpp
   ../features/netsocket/InternetSocket.cpp
   ../features/netsocket/UDPSocket.cpp
@@ -33,10 +34,11 @@ set(unittest-test-sources
   stubs/ip4tos_stub.c
   stubs/Kernel_stub.cpp
   stubs/SocketStats_Stub.cpp
+  stubs/TLSSessionCache_stub.cpp
 )
 
 set(MBEDTLS_USER_CONFIG_FILE_PATH "\"../UNITTESTS/features/netsocket/DTLSSocket/dtls_test_config.h\"")
 set_source_files_properties(features/netsocket/DTLSSocket/test_DTLSSocket.cpp PROPERTIES COMPILE_DEFINITIONS MBEDTLS_USER_CONFIG_FILE=${MBEDTLS_USER_CONFIG_FILE_PATH})
 set_source_files_properties(../features/netsocket/DTLSSocket.cpp PROPERTIES COMPILE_DEFINITIONS MBEDTLS_USER_CONFIG_FILE=${MBEDTLS_USER_CONFIG_FILE_PATH})
 set_source_files_properties(../features/netsocket/DTLSSocketWrapper.cpp PROPERTIES COMPILE_DEFINITIONS MBEDTLS_USER_CONFIG_FILE=${MBEDTLS_USER_CONFIG_FILE_PATH})
-
+set_source_files_properties(stubs/TLSSessionCache_stub.cpp PROPERTIES COMPILE_DEFINITIONS MBEDTLS_USER_CONFIG_FILE=${MBEDTLS_USER_CONFIG_FILE_PATH})
@@ -5,6 +5,7 @@
 
 set(unittest-sources
   ../features/netsocket/SocketAddress.cpp
+  ../features/netsocket/Socket.cpp
   ../features/netsocket/NetworkStack.cpp
   ../features/netsocket/InternetSocket.cpp
   ../features/frameworks/nanostack-libservice/source/libip4string/ip4tos.c
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "features/netsocket/TCPSocket.h"
+#include "features/netsocket/UDPSocket.h"
+#include "features/netsocket/nsapi_dns.h"
+#include "LoopbackNetworkStack.h"
+#include <string.h>
+
+/* Stand-in DNS server, answering every A question with 192.0.2.1 from
+ * the sigio callback of its socket.
+ */
+class DNSServer {
+public:
+    UDPSocket socket;
+    int questions;
+
+    DNSServer(NetworkStack *stack) : questions(0)
+    {
+        socket.open(stack);
+        socket.bind(53);
+        socket.set_blocking(false);
+        socket.sigio(mbed::callback(this, &DNSServer::answer));
+    }
+
+    void answer()
+    {
+        uint8_t packet[512];
+        SocketAddress client;
+        nsapi_size_or_error_t size;
+
+        while ((size = socket.recvfrom(&client, packet, sizeof(packet) - 16)) > 0) {
+            questions++;
+            packet[2] = 0x81;
+            packet[3] = 0x80;
+            packet[7] = 1; // ancount
+            const uint8_t answer[] = { 0xc0, 12, 0, 1, 0, 1, 0, 0, 0, 60, 0, 4, 192, 0, 2, 1 };
+            memcpy(&packet[size], answer, sizeof(answer));
+            socket.sendto(client, packet, size + sizeof(answer));
+        }
+    }
+};
+
+class TestLoopbackNetworkStack : public testing::Test {
+protected:
+    LoopbackNetworkStack *loopback;
+    NetworkStack *stack;
+
+    virtual void SetUp()
+    {
+        loopback = new LoopbackNetworkStack;
+        stack = loopback;
+    }
+
+    virtual void TearDown()
+    {
+        delete loopback;
+    }
+
+    void set_link(uint32_t latency_us, uint32_t bandwidth, uint32_t loss_ppm)
+    {
+        LoopbackNetworkStack::link_config_t config = { latency_us, bandwidth, loss_ppm };
+        loopback->set_link_config(config);
+    }
+};
+
+TEST_F(TestLoopbackNetworkStack, udp)
+{
+    UDPSocket server;
+    UDPSocket client;
+    EXPECT_EQ(NSAPI_ERROR_OK, server.open(stack));
+    EXPECT_EQ(NSAPI_ERROR_OK, server.bind(7));
+    EXPECT_EQ(NSAPI_ERROR_OK, client.open(stack));
+
+    EXPECT_EQ(5, client.sendto(SocketAddress("127.0.0.1", 7), "hello", 5));
+    EXPECT_EQ(6, client.sendto(SocketAddress("127.0.0.1", 7), "world!", 6));
+
+    char buffer[16];
+    SocketAddress from;
+    EXPECT_EQ(5, server.recvfrom(&from, buffer, sizeof(buffer)));
+    EXPECT_EQ(0, memcmp(buffer, "hello", 5));
+    EXPECT_STREQ("127.0.0.1", from.get_ip_address());
+    EXPECT_NE(0, from.get_port());
+
+    // Datagrams are truncated to the buffer
+    EXPECT_EQ(3, server.recvfrom(&from, buffer, 3));
+    EXPECT_EQ(0, memcmp(buffer, "wor", 3));
+
+    // Reply to the source address
+    EXPECT_EQ(2, server.sendto(from, "ok", 2));
+    EXPECT_EQ(2, client.recvfrom(NULL, buffer, sizeof(buffer)));
+}
+
+TEST_F(TestLoopbackNetworkStack, udp_recvmmsg)
+{
+    UDPSocket server;
+    UDPSocket client;
+    server.open(stack);
+    server.bind(7);
+    server.set_blocking(false);
+    client.open(stack);
+    client.bind(1000);
+
+    char buf[4][16];
+    nsapi_msg_t msgs[4];
+    for (int i = 0; i < 4; i++) {
+        msgs[i].msg_buf = buf[i];
+        msgs[i].msg_size = sizeof(buf[i]);
+    }
+
+    // A burst of datagrams is received in one call, up to the size of the array
+    const char *words[] = { "one", "two", "three", "four", "five" };
+    for (int i = 0; i < 5; i++) {
+        client.sendto(SocketAddress("127.0.0.1", 7), words[i], strlen(words[i]));
+    }
+    loopback->run_until_idle();
+
+    EXPECT_EQ(4, server.recvmmsg(msgs, 4));
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(strlen(words[i]), msgs[i].msg_len);
+        EXPECT_EQ(0, memcmp(words[i], buf[i], msgs[i].msg_len));
+        EXPECT_EQ(1000, msgs[i].msg_port);
+    }
+    EXPECT_EQ(1, server.recvmmsg(msgs, 4));
+    EXPECT_EQ(NSAPI_ERROR_WOULD_BLOCK, server.recvmmsg(msgs, 4));
+}
+
+TEST_F(TestLoopbackNetworkStack, udp_bind_in_use)
+{
+    UDPSocket first;
+    UDPSocket second;
+    first.open(stack);
+    second.open(stack);
+    EXPECT_EQ(NSAPI_ERROR_OK, first.bind(7));
+    EXPECT_EQ(NSAPI_ERROR_PARAMETER, second.bind(7));
+}
+
+TEST_F(TestLoopbackNetworkStack, udp_latency)
+{
+    set_link(10000, 0, 0);
+
+    UDPSocket server;
+    UDPSocket client;
+    server.open(stack);
+    server.bind(7);
+    server.set_blocking(false);
+    client.open(stack);
+
+    char buffer[16];
+    loopback->set_auto_advance(false);
+    client.sendto(SocketAddress("127.0.0.1", 7), "hello", 5);
+    EXPECT_EQ(NSAPI_ERROR_WOULD_BLOCK, server.recvfrom(NULL, buffer, sizeof(buffer)));
+
+    loopback->advance_to(9999);
+    EXPECT_EQ(NSAPI_ERROR_WOULD_BLOCK, server.recvfrom(NULL, buffer, sizeof(buffer)));
+
+    loopback->advance_to(10000);
+    EXPECT_EQ(5, server.recvfrom(NULL, buffer, sizeof(buffer)));
+}
+
+TEST_F(TestLoopbackNetworkStack, udp_loss)
+{
+    set_link(1000, 0, 200000);
+    loopback->set_seed(1234);
+
+    UDPSocket server;
+    UDPSocket client;
+    server.open(stack);
+    server.bind(7);
+    server.set_blocking(false);
+    client.open(stack);
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(4, client.sendto(SocketAddress("127.0.0.1", 7), "ping", 4));
+    }
+    loopback->run_until_idle();
+
+    int received = 0;
+    char buffer[16];
+    while (server.recvfrom(NULL, buffer, sizeof(buffer)) == 4) {
+        received++;
+    }
+
+    LoopbackNetworkStack::link_stats_t stats;
+    loopback->get_link_stats(&stats);
+    EXPECT_EQ(100u, stats.packets_sent);
+    EXPECT_GT(stats.packets_lost, 0u);
+    EXPECT_LT(stats.packets_lost, 50u);
+    EXPECT_EQ(100 - (int)stats.packets_lost, received);
+}
+
+TEST_F(TestLoopbackNetworkStack, tcp_connect_refused)
+{
+    TCPSocket client;
+    client.open(stack);
+    EXPECT_EQ(NSAPI_ERROR_NO_CONNECTION, client.connect(SocketAddress("127.0.0.1", 80)));
+}
+
+TEST_F(TestLoopbackNetworkStack, tcp_stream)
+{
+    TCPSocket server;
+    TCPSocket client;
+    server.open(stack);
+    EXPECT_EQ(NSAPI_ERROR_OK, server.bind(80));
+    EXPECT_EQ(NSAPI_ERROR_OK, server.listen(1));
+    client.open(stack);
+    EXPECT_EQ(NSAPI_ERROR_OK, client.connect(SocketAddress("127.0.0.1", 80)));
+
+    nsapi_error_t err;
+    TCPSocket *connection = server.accept(&err);
+    ASSERT_EQ(NSAPI_ERROR_OK, err);
+    ASSERT_TRUE(connection != NULL);
+
+    uint8_t data[5000];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+    EXPECT_EQ((nsapi_size_or_error_t)sizeof(data), client.send(data, sizeof(data)));
+    client.close();
+
+    // Stream of bytes, in order, then the end of the stream
+    uint8_t received[sizeof(data)];
+    size_t total = 0;
+    nsapi_size_or_error_t size;
+    while ((size = connection->recv(received + total, 1000)) > 0) {
+        total += size;
+    }
+    EXPECT_EQ(0, size);
+    ASSERT_EQ(sizeof(data), total);
+    EXPECT_EQ(0, memcmp(data, received, sizeof(data)));
+
+    connection->close();
+}
+
+TEST_F(TestLoopbackNetworkStack, tcp_bandwidth)
+{
+    set_link(5000, 100000, 0);
+
+    TCPSocket server;
+    TCPSocket client;
+    server.open(stack);
+    server.bind(80);
+    server.listen(1);
+    client.open(stack);
+    client.connect(SocketAddress("127.0.0.1", 80));
+    TCPSocket *connection = server.accept();
+    ASSERT_TRUE(connection != NULL);
+
+    static uint8_t data[100000];
+    uint64_t start = loopback->get_time_us();
+    EXPECT_EQ((nsapi_size_or_error_t)sizeof(data), client.send(data, sizeof(data)));
+
+    size_t total = 0;
+    while (total < sizeof(data)) {
+        nsapi_size_or_error_t size = connection->recv(data, sizeof(data));
+        ASSERT_GT(size, 0);
+        total += size;
+    }
+
+    // One second of payload, plus headers and latency
+    uint64_t elapsed = loopback->get_time_us() - start;
+    EXPECT_GT(elapsed, 1000000u);
+    EXPECT_LT(elapsed, 1100000u);
+
+    connection->close();
+}
+
+TEST_F(TestLoopbackNetworkStack, tcp_loss_keeps_order)
+{
+    set_link(1000, 0, 100000);
+    loopback->set_seed(42);
+
+    TCPSocket server;
+    TCPSocket client;
+    server.open(stack);
+    server.bind(80);
+    server.listen(1);
+    client.open(stack);
+    client.connect(SocketAddress("127.0.0.1", 80));
+    TCPSocket *connection = server.accept();
+    ASSERT_TRUE(connection != NULL);
+
+    static uint8_t data[50000];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = i * 7;
+    }
+    client.send(data, sizeof(data));
+
+    static uint8_t received[sizeof(data)];
+    size_t total = 0;
+    while (total < sizeof(data)) {
+        nsapi_size_or_error_t size = connection->recv(received + total, sizeof(data) - total);
+        ASSERT_GT(size, 0);
+        total += size;
+    }
+    EXPECT_EQ(0, memcmp(data, received, sizeof(data)));
+
+    LoopbackNetworkStack::link_stats_t stats;
+    loopback->get_link_stats(&stats);
+    EXPECT_GT(stats.packets_lost, 0u);
+    EXPECT_GE(loopback->get_time_us(), 200000u);
+
+    connection->close();
+}
+
+TEST_F(TestLoopbackNetworkStack, dns_query_latency)
+{
+    set_link(20000, 0, 0);
+    DNSServer server(stack);
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query(stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.1", address.get_ip_address());
+    // Sent to two of the default servers in parallel, both end up here
+    EXPECT_EQ(2, server.questions);
+
+    // Question and answer both cross the link
+    EXPECT_EQ(40000u, loopback->get_time_us());
+}
+
+static int async_results;
+static SocketAddress async_address;
+
+static void async_callback(nsapi_error_t status, SocketAddress *address)
+{
+    if (status == NSAPI_ERROR_OK) {
+        async_results++;
+        async_address = *address;
+    }
+}
+
+TEST_F(TestLoopbackNetworkStack, dns_query_async)
+{
+    set_link(20000, 0, 0);
+    DNSServer server(stack);
+    nsapi_dns_reset();
+
+    EXPECT_GT(stack->gethostbyname_async("www.example.org", async_callback, NSAPI_IPv4), 0);
+    loopback->run_until_idle();
+
+    EXPECT_EQ(1, async_results);
+    EXPECT_STREQ("192.0.2.1", async_address.get_ip_address());
+}
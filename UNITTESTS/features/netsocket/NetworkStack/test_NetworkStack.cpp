@@ -19,6 +19,7 @@
 #include "features/netsocket/NetworkStack.h"
 #include "netsocket/nsapi_dns.h"
 #include "events/EventQueue.h"
+#include <deque>
 #include <string>
 
 #include "equeue_stub.h"
@@ -51,6 +52,11 @@ extern events::EventQueue *mbed_shared_queue_stub;
 
 // NetworkStack is an abstract class we need to provide a child class for tests.
 class NetworkStackChild : public NetworkStack {
+    friend class TestNetworkStack;
+    FRIEND_TEST(TestNetworkStack, socket_sendmsg);
+    FRIEND_TEST(TestNetworkStack, socket_recvmsg);
+    FRIEND_TEST(TestNetworkStack, socket_recvmmsg);
+
     virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto)
     {
         return NSAPI_ERROR_OK;
@@ -89,18 +95,33 @@ class NetworkStackChild : public NetworkStack {
     virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
                                                 const void *data, nsapi_size_t size)
     {
-        return NSAPI_ERROR_OK;
+        sent_data.assign(static_cast<const char *>(data), size);
+        return size;
     }
     virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
                                                   void *buffer, nsapi_size_t size)
     {
-        return NSAPI_ERROR_OK;
+        if (!datagrams.empty()) {
+            size = datagrams.front().copy(static_cast<char *>(buffer), size);
+            datagrams.pop_front();
+            address->set_ip_address("127.0.0.1");
+            address->set_port(1024);
+            return size;
+        }
+        if (recv_data.empty()) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+        size = recv_data.copy(static_cast<char *>(buffer), size);
+        return size;
     }
     virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data)
     {
     }
 public:
     std::string ip_address;
+    std::string sent_data;
+    std::string recv_data;
+    std::deque<std::string> datagrams;
     const char *get_ip_address()
     {
         return ip_address.c_str();
@@ -238,3 +259,63 @@ TEST_F(TestNetworkStack, setstackopt)
     EXPECT_EQ(stack->setstackopt(0, 0, 0, 0), NSAPI_ERROR_UNSUPPORTED);
 }
 
+TEST_F(TestNetworkStack, get_stack_stats_default)
+{
+    nsapi_stack_stats_t stats;
+    EXPECT_EQ(stack->get_stack_stats(&stats), NSAPI_ERROR_UNSUPPORTED);
+}
+
+TEST_F(TestNetworkStack, get_pool_stats_default)
+{
+    nsapi_pool_stats_t stats[4];
+    EXPECT_EQ(stack->get_pool_stats(stats, 4), 0U);
+}
+
+
+TEST_F(TestNetworkStack, socket_sendmsg)
+{
+    SocketAddress a("127.0.0.1", 1024);
+    char header[] = "head";
+    char payload[] = "payload";
+    nsapi_iovec_t iov[3] = {{header, 4}, {NULL, 0}, {payload, 7}};
+    EXPECT_EQ(stack->socket_sendmsg(NULL, &a, iov, 3), 11);
+    EXPECT_EQ(stack->sent_data, "headpayload");
+}
+
+TEST_F(TestNetworkStack, socket_recvmsg)
+{
+    SocketAddress a;
+    char header[4];
+    char payload[8];
+    nsapi_iovec_t iov[2] = {{header, sizeof header}, {payload, sizeof payload}};
+    stack->recv_data = "headpay";
+    EXPECT_EQ(stack->socket_recvmsg(NULL, &a, iov, 2), 7);
+    EXPECT_EQ(std::string(header, 4), "head");
+    EXPECT_EQ(std::string(payload, 3), "pay");
+}
+
+TEST_F(TestNetworkStack, socket_recvmmsg)
+{
+    char buf[3][8];
+    nsapi_msg_t msgs[3] = {{buf[0], 8}, {buf[1], 8}, {buf[2], 4}};
+    EXPECT_EQ(stack->socket_recvmmsg(NULL, msgs, 3), NSAPI_ERROR_WOULD_BLOCK);
+
+    stack->datagrams.push_back("first");
+    stack->datagrams.push_back("second");
+    EXPECT_EQ(stack->socket_recvmmsg(NULL, msgs, 3), 2);
+    EXPECT_EQ(msgs[0].msg_len, 5);
+    EXPECT_EQ(std::string(buf[0], 5), "first");
+    EXPECT_EQ(msgs[1].msg_len, 6);
+    EXPECT_EQ(std::string(buf[1], 6), "second");
+    EXPECT_EQ(SocketAddress(msgs[1].msg_addr, msgs[1].msg_port), SocketAddress("127.0.0.1", 1024));
+
+    // Truncated to the buffer, and no more than count
+    stack->datagrams.push_back("one");
+    stack->datagrams.push_back("two");
+    stack->datagrams.push_back("three");
+    stack->datagrams.push_back("four");
+    EXPECT_EQ(stack->socket_recvmmsg(NULL, msgs, 3), 3);
+    EXPECT_EQ(msgs[2].msg_len, 4);
+    EXPECT_EQ(std::string(buf[2], 4), "thre");
+    EXPECT_EQ(stack->socket_recvmmsg(NULL, msgs, 3), 1);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "netsocket/SocketStats.h"
+
+// Time returned by the microsecond ticker
+static us_timestamp_t now;
+
+us_timestamp_t ticker_read_us(const ticker_data_t *const ticker)
+{
+    return now;
+}
+
+class TestSocketStats : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        // Each test uses a new socket, the statistics of closed ones are kept
+        socket = reinterpret_cast<const Socket *>(++last_socket);
+        stats = new SocketStats();
+        stats->stats_new_socket_entry(socket);
+        now = 1000000;
+    }
+
+    virtual void TearDown()
+    {
+        stats->stats_update_socket_state(socket, SOCK_CLOSED);
+        delete stats;
+    }
+
+    mbed_stats_socket_t get()
+    {
+        mbed_stats_socket_t all[MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT];
+        size_t count = SocketStats::mbed_stats_socket_get_each(all, MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT);
+        for (size_t i = 0; i < count; i++) {
+            if (all[i].reference_id == socket) {
+                return all[i];
+            }
+        }
+        ADD_FAILURE() << "socket not found";
+        return all[0];
+    }
+
+    static uintptr_t last_socket;
+    const Socket *socket;
+    SocketStats *stats;
+};
+
+uintptr_t TestSocketStats::last_socket = 0x1000;
+
+TEST_F(TestSocketStats, latency_buckets)
+{
+    // Bucket n counts calls shorter than 4^(n+1) microseconds
+    const us_timestamp_t durations[] = {0, 3, 4, 15, 16, 63, 64, 1000, 1000000000};
+    const int buckets[] = {0, 0, 1, 1, 2, 2, 3, 4, MBED_STATS_SOCKET_LATENCY_BUCKETS - 1};
+    uint32_t expected[MBED_STATS_SOCKET_LATENCY_BUCKETS] = {};
+
+    for (size_t i = 0; i < sizeof(durations) / sizeof(durations[0]); i++) {
+        us_timestamp_t start = SocketStats::stats_get_time();
+        now += durations[i];
+        stats->stats_update_send(socket, start, 10);
+        expected[buckets[i]]++;
+    }
+
+    mbed_stats_socket_t s = get();
+    for (int i = 0; i < MBED_STATS_SOCKET_LATENCY_BUCKETS; i++) {
+        EXPECT_EQ(expected[i], s.send_latency[i]) << "bucket " << i;
+        EXPECT_EQ(0U, s.recv_latency[i]) << "bucket " << i;
+    }
+    EXPECT_EQ(90U, s.sent_bytes);
+}
+
+TEST_F(TestSocketStats, recv_latency_and_bytes)
+{
+    us_timestamp_t start = SocketStats::stats_get_time();
+    now += 20;
+    stats->stats_update_recv(socket, start, 0, 100);
+
+    start = SocketStats::stats_get_time();
+    stats->stats_update_recv(socket, start, 0, NSAPI_ERROR_WOULD_BLOCK);
+
+    mbed_stats_socket_t s = get();
+    EXPECT_EQ(1U, s.recv_latency[0]);
+    EXPECT_EQ(1U, s.recv_latency[2]);
+    EXPECT_EQ(100U, s.recv_bytes);
+    EXPECT_EQ(0U, s.send_latency[0]);
+}
+
+TEST_F(TestSocketStats, blocked_time_accumulates)
+{
+    for (int i = 1; i <= 3; i++) {
+        us_timestamp_t start = SocketStats::stats_get_time();
+        now += 100 * i;
+        stats->stats_update_recv(socket, start, 90 * i, 1);
+    }
+
+    mbed_stats_socket_t s = get();
+    EXPECT_EQ(540U, s.recv_blocked_time);
+    EXPECT_EQ(3U, s.recv_bytes);
+    EXPECT_EQ(3U, s.recv_latency[3] + s.recv_latency[4]);
+}
+
+TEST_F(TestSocketStats, errors_not_counted_as_bytes)
+{
+    us_timestamp_t start = SocketStats::stats_get_time();
+    stats->stats_update_send(socket, start, NSAPI_ERROR_NO_SOCKET);
+    stats->stats_update_recv(socket, start, 0, NSAPI_ERROR_NO_SOCKET);
+
+    mbed_stats_socket_t s = get();
+    EXPECT_EQ(0U, s.sent_bytes);
+    EXPECT_EQ(0U, s.recv_bytes);
+    // The calls are still timed
+    EXPECT_EQ(1U, s.send_latency[0]);
+    EXPECT_EQ(1U, s.recv_latency[0]);
+}
+
+TEST_F(TestSocketStats, unknown_socket_ignored)
+{
+    const Socket *other = reinterpret_cast<const Socket *>(0x10);
+    stats->stats_update_send(other, SocketStats::stats_get_time(), 10);
+
+    mbed_stats_socket_t s = get();
+    EXPECT_EQ(0U, s.sent_bytes);
+    EXPECT_EQ(0U, s.send_latency[0]);
+}
@@ -0,0 +1,30 @@
+
+####################
+# UNIT TESTS
+####################
+
+set(unittest-sources
+  ../features/netsocket/SocketStats.cpp
+  ../features/netsocket/SocketAddress.cpp
+  ../features/frameworks/nanostack-libservice/source/libip4string/ip4tos.c
+  ../features/frameworks/nanostack-libservice/source/libip6string/ip6tos.c
+  ../features/frameworks/nanostack-libservice/source/libip4string/stoip4.c
+  ../features/frameworks/nanostack-libservice/source/libip6string/stoip6.c
+  ../features/frameworks/nanostack-libservice/source/libBits/common_functions.c
+)
+
+set(unittest-test-sources
+  features/netsocket/SocketStats/test_SocketStats.cpp
+  stubs/Mutex_stub.cpp
+  stubs/mbed_assert_stub.c
+  stubs/mbed_error.c
+  stubs/us_ticker_stub.cpp
+)
+
+set(SOCKET_STATS_CONFIG
+  MBED_CONF_NSAPI_SOCKET_STATS_ENABLED=1
+  MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT=10
+  DEVICE_USTICKER=1
+)
+set_source_files_properties(features/netsocket/SocketStats/test_SocketStats.cpp PROPERTIES COMPILE_DEFINITIONS "${SOCKET_STATS_CONFIG}")
+set_source_files_properties(../features/netsocket/SocketStats.cpp PROPERTIES COMPILE_DEFINITIONS "${SOCKET_STATS_CONFIG}")
@@ -8,6 +8,7 @@ set(TEST_SUITE_NAME "features_netsocket_TCPServer")
 
 set(unittest-sources
   ../features/netsocket/SocketAddress.cpp
+  ../features/netsocket/Socket.cpp
   ../features/netsocket/NetworkStack.cpp
   ../features/netsocket/InternetSocket.cpp
   ../features/netsocket/TCPSocket.cpp
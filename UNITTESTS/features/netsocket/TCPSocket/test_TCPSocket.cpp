@@ -183,6 +183,167 @@ TEST_F(TestTCPSocket, send_to)
     EXPECT_EQ(socket->sendto(a, dataBuf, dataSize), dataSize);
 }
 
+/* sendmsg */
+
+TEST_F(TestTCPSocket, sendmsg_no_open)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), NSAPI_ERROR_NO_SOCKET);
+}
+
+TEST_F(TestTCPSocket, sendmsg_in_one_chunk)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = dataSize;
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), dataSize);
+}
+
+TEST_F(TestTCPSocket, sendmsg_in_three_chunks)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    stack.return_values.push_back(2); // Part of the first buffer
+    stack.return_values.push_back(2); // Rest of the first buffer
+    stack.return_values.push_back(dataSize - 4);
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), dataSize);
+}
+
+TEST_F(TestTCPSocket, sendmsg_error_would_block)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), NSAPI_ERROR_WOULD_BLOCK);
+}
+
+TEST_F(TestTCPSocket, sendmsg_partial_no_timeout)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    socket->set_blocking(false);
+    stack.return_values.push_back(6);
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), 6);
+}
+
+/* recvmsg */
+
+TEST_F(TestTCPSocket, recvmsg_no_open)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    EXPECT_EQ(socket->recvmsg(NULL, iov, 2), NSAPI_ERROR_NO_SOCKET);
+}
+
+TEST_F(TestTCPSocket, recvmsg)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = dataSize;
+    EXPECT_EQ(socket->recvmsg(NULL, iov, 2), dataSize);
+}
+
+TEST_F(TestTCPSocket, recvmsg_would_block)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(0);
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->recvmsg(NULL, iov, 2), NSAPI_ERROR_WOULD_BLOCK);
+}
+
+/* send_buf */
+
+TEST_F(TestTCPSocket, send_buf_no_open)
+{
+    NetStackMemoryManagerstub memory_manager;
+    net_stack_mem_buf_t *buf = memory_manager.alloc_heap(dataSize, 0);
+    EXPECT_EQ(socket->send_buf(buf), NSAPI_ERROR_NO_SOCKET);
+    memory_manager.free(buf);
+}
+
+TEST_F(TestTCPSocket, send_buf_unsupported)
+{
+    NetStackMemoryManagerstub memory_manager;
+    net_stack_mem_buf_t *buf = memory_manager.alloc_heap(dataSize, 0);
+    socket->open((NetworkStack *)&stack);
+    EXPECT_EQ(socket->get_memory_manager(), static_cast<NetStackMemoryManager *>(NULL));
+    EXPECT_EQ(socket->send_buf(buf), NSAPI_ERROR_UNSUPPORTED);
+    memory_manager.free(buf);
+}
+
+TEST_F(TestTCPSocket, send_buf_in_two_chunks)
+{
+    NetStackMemoryManagerstub memory_manager;
+    stack.memory_manager = &memory_manager;
+    net_stack_mem_buf_t *buf = memory_manager.alloc_heap(dataSize, 0);
+    socket->open((NetworkStack *)&stack);
+    EXPECT_EQ(socket->get_memory_manager(), &memory_manager);
+    stack.return_values.push_back(4);
+    stack.return_values.push_back(dataSize - 4);
+    EXPECT_EQ(socket->send_buf(buf), dataSize);
+    // The stub stack does not take the buffer over
+    memory_manager.free(buf);
+}
+
+TEST_F(TestTCPSocket, send_buf_offset)
+{
+    NetStackMemoryManagerstub memory_manager;
+    stack.memory_manager = &memory_manager;
+    net_stack_mem_buf_t *buf = memory_manager.alloc_heap(dataSize, 0);
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = dataSize - 4;
+    EXPECT_EQ(socket->send_buf(buf, 4), dataSize - 4);
+    EXPECT_EQ(socket->send_buf(buf, dataSize), NSAPI_ERROR_PARAMETER);
+    memory_manager.free(buf);
+}
+
+TEST_F(TestTCPSocket, send_buf_error_would_block)
+{
+    NetStackMemoryManagerstub memory_manager;
+    stack.memory_manager = &memory_manager;
+    net_stack_mem_buf_t *buf = memory_manager.alloc_heap(dataSize, 0);
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->send_buf(buf), NSAPI_ERROR_WOULD_BLOCK);
+    memory_manager.free(buf);
+}
+
+/* recv_buf */
+
+TEST_F(TestTCPSocket, recv_buf_no_open)
+{
+    net_stack_mem_buf_t *buf;
+    EXPECT_EQ(socket->recv_buf(&buf), NSAPI_ERROR_NO_SOCKET);
+    EXPECT_EQ(buf, static_cast<net_stack_mem_buf_t *>(NULL));
+}
+
+TEST_F(TestTCPSocket, recv_buf)
+{
+    NetStackMemoryManagerstub memory_manager;
+    net_stack_mem_buf_t *buf;
+    socket->open((NetworkStack *)&stack);
+    stack.return_buf = memory_manager.alloc_heap(dataSize, 0);
+    stack.return_value = dataSize;
+    EXPECT_EQ(socket->recv_buf(&buf), dataSize);
+    ASSERT_NE(buf, static_cast<net_stack_mem_buf_t *>(NULL));
+    EXPECT_EQ(memory_manager.get_total_len(buf), dataSize);
+    memory_manager.free(buf);
+}
+
+TEST_F(TestTCPSocket, recv_buf_would_block)
+{
+    net_stack_mem_buf_t *buf;
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(0);
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->recv_buf(&buf), NSAPI_ERROR_WOULD_BLOCK);
+    EXPECT_EQ(buf, static_cast<net_stack_mem_buf_t *>(NULL));
+}
+
 /* recv */
 
 TEST_F(TestTCPSocket, recv_no_open)
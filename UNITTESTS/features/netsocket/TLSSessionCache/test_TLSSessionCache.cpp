@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "features/netsocket/TLSSessionCache.h"
+#include "features/storage/kvstore/include/KVStore.h"
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// Minimal Mbed TLS session handling: set_session keeps a copy of the session
+static mbedtls_ssl_session offered_session;
+static int offered_count;
+
+extern "C" {
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session)
+{
+    memset(session, 0, sizeof(mbedtls_ssl_session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
+{
+    free(session->ticket);
+    memset(session, 0, sizeof(mbedtls_ssl_session));
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session *session)
+{
+    mbedtls_ssl_session_free(&offered_session);
+    offered_session = *session;
+    if (session->ticket) {
+        offered_session.ticket = (unsigned char *)malloc(session->ticket_len);
+        memcpy(offered_session.ticket, session->ticket, session->ticket_len);
+    }
+    offered_count++;
+    return 0;
+}
+
+void mbedtls_platform_zeroize(void *buf, size_t len)
+{
+    memset(buf, 0, len);
+}
+}
+
+class MemoryKVStore : public mbed::KVStore {
+public:
+    std::map<std::string, std::vector<uint8_t> > values;
+    uint32_t last_flags = 0;
+
+    virtual int init()
+    {
+        return 0;
+    }
+    virtual int deinit()
+    {
+        return 0;
+    }
+    virtual int reset()
+    {
+        values.clear();
+        return 0;
+    }
+    virtual int set(const char *key, const void *buffer, size_t size, uint32_t create_flags)
+    {
+        values[key].assign((const uint8_t *)buffer, (const uint8_t *)buffer + size);
+        last_flags = create_flags;
+        return 0;
+    }
+    virtual int get(const char *key, void *buffer, size_t buffer_size, size_t *actual_size = NULL, size_t offset = 0)
+    {
+        if (!values.count(key)) {
+            return -1;
+        }
+        std::vector<uint8_t> &value = values[key];
+        size_t size = std::min(buffer_size, value.size());
+        memcpy(buffer, value.data(), size);
+        if (actual_size) {
+            *actual_size = size;
+        }
+        return 0;
+    }
+    virtual int get_info(const char *key, info_t *info = NULL)
+    {
+        if (!values.count(key)) {
+            return -1;
+        }
+        if (info) {
+            info->size = values[key].size();
+            info->flags = 0;
+        }
+        return 0;
+    }
+    virtual int remove(const char *key)
+    {
+        return values.erase(key) ? 0 : -1;
+    }
+    virtual int batch(const batch_op_t *ops, size_t num_ops)
+    {
+        return -1;
+    }
+    virtual int set_start(set_handle_t *handle, const char *key, size_t final_data_size, uint32_t create_flags)
+    {
+        return -1;
+    }
+    virtual int set_add_data(set_handle_t handle, const void *value_data, size_t data_size)
+    {
+        return -1;
+    }
+    virtual int set_finalize(set_handle_t handle)
+    {
+        return -1;
+    }
+    virtual int iterator_open(iterator_t *it, const char *prefix = NULL)
+    {
+        *it = (iterator_t)new std::string(prefix ? prefix : "");
+        return 0;
+    }
+    virtual int iterator_next(iterator_t it, char *key, size_t key_size)
+    {
+        std::string *prefix = (std::string *)it;
+        for (std::map<std::string, std::vector<uint8_t> >::iterator i = values.begin(); i != values.end(); i++) {
+            if (i->first.compare(0, prefix->size(), *prefix) == 0) {
+                strncpy(key, i->first.c_str(), key_size);
+                return 0;
+            }
+        }
+        return -1;
+    }
+    virtual int iterator_close(iterator_t it)
+    {
+        delete (std::string *)it;
+        return 0;
+    }
+};
+
+class TestTLSSessionCache : public testing::Test {
+protected:
+    TLSSessionCache *cache;
+    mbedtls_ssl_config conf;
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_session session;
+    unsigned char ticket[100];
+
+    virtual void SetUp()
+    {
+        cache = new TLSSessionCache(2);
+        memset(&conf, 0, sizeof(conf));
+        conf.authmode = MBEDTLS_SSL_VERIFY_REQUIRED;
+        memset(&ssl, 0, sizeof(ssl));
+        memset(&session, 0, sizeof(session));
+        ssl.conf = &conf;
+        ssl.session = &session;
+        mbedtls_ssl_session_free(&offered_session);
+        offered_count = 0;
+    }
+
+    virtual void TearDown()
+    {
+        delete cache;
+        mbedtls_ssl_session_free(&offered_session);
+    }
+
+    void new_session(unsigned char seed)
+    {
+        session.ciphersuite = 0xC02B;
+        session.id_len = 32;
+        memset(session.id, seed, sizeof(session.id));
+        memset(session.master, seed + 1, sizeof(session.master));
+        for (unsigned i = 0; i < sizeof(ticket); i++) {
+            ticket[i] = seed + i;
+        }
+        session.ticket = ticket;
+        session.ticket_len = sizeof(ticket);
+        session.ticket_lifetime = 7200;
+    }
+
+    void expect_offered()
+    {
+        EXPECT_EQ(session.ciphersuite, offered_session.ciphersuite);
+        EXPECT_EQ(session.id_len, offered_session.id_len);
+        EXPECT_EQ(0, memcmp(session.id, offered_session.id, sizeof(session.id)));
+        EXPECT_EQ(0, memcmp(session.master, offered_session.master, sizeof(session.master)));
+        ASSERT_EQ(session.ticket_len, offered_session.ticket_len);
+        EXPECT_EQ(0, memcmp(session.ticket, offered_session.ticket, session.ticket_len));
+        EXPECT_EQ(session.ticket_lifetime, offered_session.ticket_lifetime);
+    }
+};
+
+TEST_F(TestTLSSessionCache, constructor)
+{
+    EXPECT_TRUE(cache);
+}
+
+TEST_F(TestTLSSessionCache, load_empty)
+{
+    EXPECT_FALSE(cache->load_session("example.com", &ssl));
+    EXPECT_FALSE(cache->load_session(NULL, &ssl));
+    EXPECT_EQ(0, offered_count);
+}
+
+TEST_F(TestTLSSessionCache, save_and_load)
+{
+    new_session(1);
+    EXPECT_FALSE(cache->save_session("example.com", &ssl));
+
+    EXPECT_TRUE(cache->load_session("example.com", &ssl));
+    EXPECT_EQ(1, offered_count);
+    expect_offered();
+
+    EXPECT_FALSE(cache->load_session("example.org", &ssl));
+}
+
+TEST_F(TestTLSSessionCache, unverified_not_cached)
+{
+    TLSSessionCache::stats_t stats;
+
+    new_session(1);
+    session.verify_result = MBEDTLS_X509_BADCERT_NOT_TRUSTED;
+    EXPECT_FALSE(cache->save_session("example.com", &ssl));
+    EXPECT_FALSE(cache->load_session("example.com", &ssl));
+
+    cache->get_stats(&stats);
+    EXPECT_EQ(1, stats.full_handshakes);
+    EXPECT_EQ(0, offered_count);
+}
+
+TEST_F(TestTLSSessionCache, verification_not_required)
+{
+    new_session(1);
+    conf.authmode = MBEDTLS_SSL_VERIFY_OPTIONAL;
+    EXPECT_FALSE(cache->save_session("example.com", &ssl));
+    EXPECT_FALSE(cache->load_session("example.com", &ssl));
+
+    // A session cached by a verified connection is not offered either
+    conf.authmode = MBEDTLS_SSL_VERIFY_REQUIRED;
+    EXPECT_FALSE(cache->save_session("example.com", &ssl));
+    conf.authmode = MBEDTLS_SSL_VERIFY_NONE;
+    EXPECT_FALSE(cache->load_session("example.com", &ssl));
+    EXPECT_EQ(0, offered_count);
+}
+
+TEST_F(TestTLSSessionCache, stats)
+{
+    TLSSessionCache::stats_t stats;
+
+    new_session(1);
+    EXPECT_FALSE(cache->save_session("example.com", &ssl));
+    EXPECT_TRUE(cache->load_session("example.com", &ssl));
+    // Same master secret: the server accepted the session
+    EXPECT_TRUE(cache->save_session("example.com", &ssl));
+    EXPECT_TRUE(cache->load_session("example.com", &ssl));
+    // New master secret: the server did a full handshake
+    new_session(2);
+    EXPECT_FALSE(cache->save_session("example.com", &ssl));
+
+    cache->get_stats(&stats);
+    EXPECT_EQ(2, stats.full_handshakes);
+    EXPECT_EQ(1, stats.resumed_handshakes);
+
+    EXPECT_TRUE(cache->load_session("example.com", &ssl));
+    expect_offered();
+}
+
+TEST_F(TestTLSSessionCache, least_recently_used_dropped)
+{
+    new_session(1);
+    cache->save_session("a.example.com", &ssl);
+    new_session(2);
+    cache->save_session("b.example.com", &ssl);
+    EXPECT_TRUE(cache->load_session("a.example.com", &ssl));
+    new_session(3);
+    cache->save_session("c.example.com", &ssl);
+
+    EXPECT_TRUE(cache->load_session("a.example.com", &ssl));
+    EXPECT_FALSE(cache->load_session("b.example.com", &ssl));
+    EXPECT_TRUE(cache->load_session("c.example.com", &ssl));
+    expect_offered();
+}
+
+TEST_F(TestTLSSessionCache, remove)
+{
+    new_session(1);
+    cache->save_session("example.com", &ssl);
+    cache->remove("example.com");
+    EXPECT_FALSE(cache->load_session("example.com", &ssl));
+}
+
+TEST_F(TestTLSSessionCache, large_ticket_not_cached)
+{
+    unsigned char large_ticket[2000] = {0};
+    new_session(1);
+    session.ticket = large_ticket;
+    session.ticket_len = sizeof(large_ticket);
+    cache->save_session("example.com", &ssl);
+
+    // The session ID is still offered
+    EXPECT_TRUE(cache->load_session("example.com", &ssl));
+    EXPECT_EQ(0, memcmp(session.id, offered_session.id, sizeof(session.id)));
+    EXPECT_EQ(0, offered_session.ticket_len);
+    EXPECT_EQ(NULL, offered_session.ticket);
+}
+
+TEST_F(TestTLSSessionCache, kvstore)
+{
+    MemoryKVStore kvstore;
+    cache->set_kvstore(&kvstore);
+
+    new_session(1);
+    cache->save_session("example.com", &ssl);
+    EXPECT_EQ(1, kvstore.values.count("tls_example.com"));
+    EXPECT_EQ(mbed::KVStore::REQUIRE_CONFIDENTIALITY_FLAG, kvstore.last_flags);
+
+    // A new cache, as after a reset, reads the session from the KVStore
+    delete cache;
+    cache = new TLSSessionCache(2);
+    cache->set_kvstore(&kvstore);
+    EXPECT_TRUE(cache->load_session("example.com", &ssl));
+    expect_offered();
+
+    cache->remove("example.com");
+    EXPECT_EQ(0, kvstore.values.count("tls_example.com"));
+}
+
+TEST_F(TestTLSSessionCache, kvstore_corrupted)
+{
+    MemoryKVStore kvstore;
+    cache->set_kvstore(&kvstore);
+    kvstore.values["tls_example.com"] = std::vector<uint8_t>(200, 0xFF);
+    EXPECT_FALSE(cache->load_session("example.com", &ssl));
+    EXPECT_EQ(0, offered_count);
+}
+
+TEST_F(TestTLSSessionCache, clear)
+{
+    MemoryKVStore kvstore;
+    cache->set_kvstore(&kvstore);
+    kvstore.values["other"] = std::vector<uint8_t>(1, 0);
+
+    new_session(1);
+    cache->save_session("a.example.com", &ssl);
+    cache->save_session("b.example.com", &ssl);
+    cache->clear();
+
+    EXPECT_FALSE(cache->load_session("a.example.com", &ssl));
+    EXPECT_FALSE(cache->load_session("b.example.com", &ssl));
+    EXPECT_EQ(1, kvstore.values.size());
+}
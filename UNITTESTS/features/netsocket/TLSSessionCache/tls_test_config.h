@@ -0,0 +1,11 @@
+/*
+ * tls_test_config.h
+ */
+
+#ifndef UNITTESTS_FEATURES_NETSOCKET_TLSSESSIONCACHE_TLS_TEST_CONFIG_H_
+#define UNITTESTS_FEATURES_NETSOCKET_TLSSESSIONCACHE_TLS_TEST_CONFIG_H_
+
+#define MBEDTLS_SSL_CLI_C
+#define MBEDTLS_SSL_SESSION_TICKETS
+
+#endif /* UNITTESTS_FEATURES_NETSOCKET_TLSSESSIONCACHE_TLS_TEST_CONFIG_H_ */
@@ -0,0 +1,17 @@
+
+####################
+# UNIT TESTS
+####################
+
+set(unittest-sources
+  ../features/netsocket/TLSSessionCache.cpp
+)
+
+set(unittest-test-sources
+  features/netsocket/TLSSessionCache/test_TLSSessionCache.cpp
+  stubs/Mutex_stub.cpp
+)
+
+set(MBEDTLS_USER_CONFIG_FILE_PATH "\"../UNITTESTS/features/netsocket/TLSSessionCache/tls_test_config.h\"")
+set_source_files_properties(features/netsocket/TLSSessionCache/test_TLSSessionCache.cpp PROPERTIES COMPILE_DEFINITIONS MBEDTLS_USER_CONFIG_FILE=${MBEDTLS_USER_CONFIG_FILE_PATH})
+set_source_files_properties(../features/netsocket/TLSSessionCache.cpp PROPERTIES COMPILE_DEFINITIONS MBEDTLS_USER_CONFIG_FILE=${MBEDTLS_USER_CONFIG_FILE_PATH})
@@ -406,6 +406,19 @@ TEST_F(TestTLSSocketWrapper, getsockopt)
     EXPECT_EQ(wrapper->getsockopt(0, 0, 0, 0), NSAPI_ERROR_UNSUPPORTED);
 }
 
+/* max_fragment_length */
+
+TEST_F(TestTLSSocketWrapper, set_max_frag_len)
+{
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    EXPECT_EQ(wrapper->set_max_frag_len(100), NSAPI_ERROR_PARAMETER);
+    EXPECT_EQ(wrapper->set_max_frag_len(1024), NSAPI_ERROR_OK);
+    EXPECT_EQ(wrapper->set_max_frag_len(0), NSAPI_ERROR_OK);
+#else
+    EXPECT_EQ(wrapper->set_max_frag_len(1024), NSAPI_ERROR_UNSUPPORTED);
+#endif
+}
+
 /* unsupported */
 
 TEST_F(TestTLSSocketWrapper, listen_unsupported)
@@ -19,6 +19,8 @@
 #include "features/netsocket/UDPSocket.h"
 #include "features/netsocket/nsapi_dns.h"
 #include "NetworkStack_stub.h"
+#include <stdio.h>
+#include <string>
 
 /**
  * This test needs to access a private function
@@ -142,6 +144,190 @@ TEST_F(TestUDPSocket, recv_address_filtering)
     EXPECT_EQ(socket->recvfrom(&a1, &dataBuf, dataSize), 100);
 }
 
+TEST_F(TestUDPSocket, sendmsg)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    const nsapi_addr_t a = {NSAPI_IPv4, {127, 0, 0, 1} };
+    SocketAddress addr(a, 1024);
+    EXPECT_EQ(socket->sendmsg(&addr, iov, 2), NSAPI_ERROR_NO_SOCKET);
+
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = dataSize;
+    EXPECT_EQ(socket->sendmsg(&addr, iov, 2), dataSize);
+
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), NSAPI_ERROR_NO_ADDRESS);
+    EXPECT_EQ(socket->connect(addr), NSAPI_ERROR_OK);
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), dataSize);
+
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->sendmsg(NULL, iov, 2), NSAPI_ERROR_WOULD_BLOCK);
+}
+
+TEST_F(TestUDPSocket, recvmsg_address_filtering)
+{
+    nsapi_iovec_t iov[2] = {{dataBuf, 4}, {dataBuf + 4, dataSize - 4}};
+    socket->open((NetworkStack *)&stack);
+    const nsapi_addr_t addr1 = {NSAPI_IPv4, {127, 0, 0, 1} };
+    const nsapi_addr_t addr2 = {NSAPI_IPv4, {127, 0, 0, 2} };
+    SocketAddress a1(addr1, 1024);
+    SocketAddress a2(addr2, 1024);
+
+    EXPECT_EQ(socket->connect(a1), NSAPI_ERROR_OK);
+
+    stack.return_values.push_back(100); //This will not return, because wrong address is used.
+    stack.return_values.push_back(NSAPI_ERROR_NO_MEMORY); //Break the loop of waiting for data from a1.
+    EXPECT_EQ(socket->recvmsg(&a2, iov, 2), NSAPI_ERROR_NO_MEMORY);
+
+    stack.return_values.push_back(100);
+    EXPECT_EQ(socket->recvmsg(&a1, iov, 2), 100);
+}
+
+TEST_F(TestUDPSocket, recvmmsg)
+{
+    char buf[2][100];
+    nsapi_msg_t msgs[2] = {{buf[0], sizeof buf[0]}, {buf[1], sizeof buf[1]}};
+    EXPECT_EQ(socket->recvmmsg(msgs, 2), NSAPI_ERROR_NO_SOCKET);
+
+    socket->open((NetworkStack *)&stack);
+    stack.return_values.push_back(100);
+    stack.return_values.push_back(50);
+    EXPECT_EQ(socket->recvmmsg(msgs, 2), 2);
+    EXPECT_EQ(msgs[0].msg_len, 100);
+    EXPECT_EQ(msgs[1].msg_len, 50);
+
+    // Takes what is queued, without waiting for a full batch
+    stack.return_values.push_back(30);
+    stack.return_values.push_back(NSAPI_ERROR_WOULD_BLOCK);
+    EXPECT_EQ(socket->recvmmsg(msgs, 2), 1);
+    EXPECT_EQ(msgs[0].msg_len, 30);
+
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(0);
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->recvmmsg(msgs, 2), NSAPI_ERROR_WOULD_BLOCK);
+}
+
+TEST_F(TestUDPSocket, recvmmsg_address_filtering)
+{
+    char buf[2][100];
+    nsapi_msg_t msgs[2] = {{buf[0], sizeof buf[0]}, {buf[1], sizeof buf[1]}};
+    socket->open((NetworkStack *)&stack);
+    const nsapi_addr_t addr1 = {NSAPI_IPv4, {127, 0, 0, 1} };
+    const nsapi_addr_t addr2 = {NSAPI_IPv4, {127, 0, 0, 2} };
+    SocketAddress a1(addr1, 1024);
+    SocketAddress a2(addr2, 1024);
+
+    EXPECT_EQ(socket->connect(a1), NSAPI_ERROR_OK);
+
+    stack.return_socketAddress = a2;
+    stack.return_values.push_back(100); //This will not return, because wrong address is used.
+    stack.return_values.push_back(NSAPI_ERROR_WOULD_BLOCK);
+    stack.return_values.push_back(NSAPI_ERROR_NO_MEMORY); //Break the loop of waiting for data from a1.
+    EXPECT_EQ(socket->recvmmsg(msgs, 2), NSAPI_ERROR_NO_MEMORY);
+
+    stack.return_socketAddress = a1;
+    stack.return_values.push_back(100);
+    stack.return_values.push_back(NSAPI_ERROR_WOULD_BLOCK);
+    EXPECT_EQ(socket->recvmmsg(msgs, 2), 1);
+}
+
+// Returns a batch of datagrams from alternating peers
+class NetworkStackBatch : public NetworkStackstub {
+    virtual nsapi_size_or_error_t socket_recvmmsg(nsapi_socket_t handle, nsapi_msg_t *msgs, unsigned count)
+    {
+        const nsapi_addr_t addr1 = {NSAPI_IPv4, {127, 0, 0, 1} };
+        const nsapi_addr_t addr2 = {NSAPI_IPv4, {127, 0, 0, 2} };
+        for (unsigned i = 0; i < count; i++) {
+            msgs[i].msg_len = snprintf(static_cast<char *>(msgs[i].msg_buf), msgs[i].msg_size, "msg%u", i);
+            msgs[i].msg_addr = i % 2 ? addr1 : addr2;
+            msgs[i].msg_port = 1024;
+        }
+        return count;
+    }
+};
+
+TEST_F(TestUDPSocket, recvmmsg_address_filtering_batch)
+{
+    NetworkStackBatch batch;
+    char buf[4][8];
+    nsapi_msg_t msgs[4] = {{buf[0], 8}, {buf[1], 8}, {buf[2], 8}, {buf[3], 8}};
+    socket->open((NetworkStack *)&batch);
+    const nsapi_addr_t addr1 = {NSAPI_IPv4, {127, 0, 0, 1} };
+    EXPECT_EQ(socket->connect(SocketAddress(addr1, 1024)), NSAPI_ERROR_OK);
+
+    // Datagrams from the connected peer are moved to the front
+    EXPECT_EQ(socket->recvmmsg(msgs, 4), 2);
+    EXPECT_EQ(std::string(buf[0], msgs[0].msg_len), "msg1");
+    EXPECT_EQ(std::string(buf[1], msgs[1].msg_len), "msg3");
+    EXPECT_EQ(SocketAddress(msgs[1].msg_addr, msgs[1].msg_port), SocketAddress(addr1, 1024));
+    socket->close();
+}
+
+TEST_F(TestUDPSocket, sendto_buf)
+{
+    NetStackMemoryManagerstub memory_manager;
+    net_stack_mem_buf_t *buf = memory_manager.alloc_heap(dataSize, 0);
+    const nsapi_addr_t a = {NSAPI_IPv4, {127, 0, 0, 1} };
+    SocketAddress addr(a, 1024);
+    EXPECT_EQ(socket->sendto_buf(addr, buf), NSAPI_ERROR_NO_SOCKET);
+
+    socket->open((NetworkStack *)&stack);
+    stack.return_value = dataSize;
+    EXPECT_EQ(socket->sendto_buf(addr, buf), dataSize);
+
+    EXPECT_EQ(socket->send_buf(buf), NSAPI_ERROR_NO_ADDRESS);
+    EXPECT_EQ(socket->connect(addr), NSAPI_ERROR_OK);
+    EXPECT_EQ(socket->send_buf(buf), dataSize);
+    memory_manager.free(buf);
+}
+
+TEST_F(TestUDPSocket, recv_buf)
+{
+    net_stack_mem_buf_t *buf;
+    NetStackMemoryManagerstub memory_manager;
+    EXPECT_EQ(socket->recv_buf(&buf), NSAPI_ERROR_NO_SOCKET);
+
+    socket->open((NetworkStack *)&stack);
+
+    stack.return_buf = memory_manager.alloc_heap(100, 0);
+    stack.return_value = 100;
+    EXPECT_EQ(socket->recv_buf(&buf), 100);
+    EXPECT_EQ(memory_manager.get_total_len(buf), 100);
+    memory_manager.free(buf);
+
+    stack.return_value = NSAPI_ERROR_WOULD_BLOCK;
+    eventFlagsStubNextRetval.push_back(0);
+    eventFlagsStubNextRetval.push_back(osFlagsError); // Break the wait loop
+    EXPECT_EQ(socket->recv_buf(&buf), NSAPI_ERROR_WOULD_BLOCK);
+    EXPECT_EQ(buf, static_cast<net_stack_mem_buf_t *>(NULL));
+}
+
+TEST_F(TestUDPSocket, recv_buf_address_filtering)
+{
+    net_stack_mem_buf_t *buf;
+    NetStackMemoryManagerstub memory_manager;
+    stack.memory_manager = &memory_manager;
+    socket->open((NetworkStack *)&stack);
+    const nsapi_addr_t addr1 = {NSAPI_IPv4, {127, 0, 0, 1} };
+    const nsapi_addr_t addr2 = {NSAPI_IPv4, {127, 0, 0, 2} };
+    SocketAddress a1(addr1, 1024);
+    SocketAddress a2(addr2, 1024);
+
+    EXPECT_EQ(socket->connect(a1), NSAPI_ERROR_OK);
+
+    stack.return_buf = memory_manager.alloc_heap(100, 0);
+    stack.return_values.push_back(100); //This will be dropped, because wrong address is used.
+    stack.return_values.push_back(NSAPI_ERROR_NO_MEMORY); //Break the loop of waiting for data from a1.
+    EXPECT_EQ(socket->recvfrom_buf(&a2, &buf), NSAPI_ERROR_NO_MEMORY);
+    EXPECT_EQ(memory_manager.free_count, 1);
+
+    stack.return_buf = memory_manager.alloc_heap(100, 0);
+    stack.return_values.push_back(100);
+    EXPECT_EQ(socket->recvfrom_buf(&a1, &buf), 100);
+    memory_manager.free(buf);
+}
+
 TEST_F(TestUDPSocket, unsupported_api)
 {
     nsapi_error_t error;
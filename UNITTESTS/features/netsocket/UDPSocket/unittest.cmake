@@ -5,7 +5,9 @@
 
 set(unittest-sources
   ../features/netsocket/SocketAddress.cpp
+  ../features/netsocket/Socket.cpp
   ../features/netsocket/NetworkStack.cpp
+  ../features/netsocket/NetStackMemoryManager.cpp
   ../features/netsocket/InternetSocket.cpp
   ../features/netsocket/UDPSocket.cpp
   ../features/frameworks/nanostack-libservice/source/libip4string/ip4tos.c
@@ -10,6 +10,7 @@ set(unittest-includes ${unittest-includes}
 
 set(unittest-sources
   ../features/netsocket/cellular/CellularNonIPSocket.cpp
+  ../features/netsocket/Socket.cpp
 )
 
 set(unittest-test-sources
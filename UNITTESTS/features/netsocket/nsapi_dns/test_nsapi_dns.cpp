@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "features/netsocket/nsapi_dns.h"
+#include "features/netsocket/NetworkStack.h"
+#include "rtos/EventFlags.h"
+#include "rtos/Kernel.h"
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+// Virtual time, read by the DNS cache
+static uint64_t ms_count = 0;
+
+uint64_t rtos::Kernel::get_ms_count()
+{
+    return ms_count;
+}
+
+// Blocking socket calls time out at once, instead of waiting for data
+rtos::EventFlags::EventFlags() {}
+rtos::EventFlags::~EventFlags() {}
+uint32_t rtos::EventFlags::set(uint32_t flags)
+{
+    return 0;
+}
+uint32_t rtos::EventFlags::clear(uint32_t flags)
+{
+    return 0;
+}
+uint32_t rtos::EventFlags::get() const
+{
+    return 0;
+}
+uint32_t rtos::EventFlags::wait_all(uint32_t flags, uint32_t timeout, bool clear)
+{
+    return osFlagsErrorTimeout;
+}
+uint32_t rtos::EventFlags::wait_any(uint32_t flags, uint32_t timeout, bool clear)
+{
+    return osFlagsErrorTimeout;
+}
+
+/* Network stack with DNS servers behind it, which answer a sent question
+ * by queuing the response to be received on the same socket.
+ */
+class DNSServerStack : public NetworkStack {
+public:
+    enum server_behaviour_t {
+        ANSWER,
+        SERVFAIL,
+        SILENT
+    };
+
+    struct record_t {
+        std::vector<uint8_t> ipv4;
+        uint32_t ttl;
+    };
+
+    std::vector<SocketAddress> servers;
+    std::map<std::string, server_behaviour_t> behaviour;
+    std::map<std::string, record_t> records;
+    uint32_t soa_ttl;
+    std::vector<std::string> queries;
+    std::map<nsapi_socket_t, std::list<std::vector<uint8_t> > > responses;
+    uintptr_t sockets;
+    void (*sigio)(void *);
+    void *sigio_data;
+
+    DNSServerStack() : soa_ttl(300), sockets(0), sigio(NULL), sigio_data(NULL)
+    {
+        servers.push_back(SocketAddress("10.0.0.1", 53));
+        servers.push_back(SocketAddress("10.0.0.2", 53));
+    }
+
+    void add_record(const char *host, uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint32_t ttl)
+    {
+        record_t record;
+        record.ipv4.push_back(a);
+        record.ipv4.push_back(b);
+        record.ipv4.push_back(c);
+        record.ipv4.push_back(d);
+        record.ttl = ttl;
+        records[host] = record;
+    }
+
+    virtual const char *get_ip_address()
+    {
+        return "10.0.0.100";
+    }
+
+    virtual nsapi_error_t get_dns_server(int index, SocketAddress *address, const char *interface_name)
+    {
+        if (index >= (int)servers.size()) {
+            return NSAPI_ERROR_NO_ADDRESS;
+        }
+        *address = servers[index];
+        return NSAPI_ERROR_OK;
+    }
+
+protected:
+    virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto)
+    {
+        *handle = reinterpret_cast<nsapi_socket_t>(++sockets);
+        return NSAPI_ERROR_OK;
+    }
+    virtual nsapi_error_t socket_close(nsapi_socket_t handle)
+    {
+        responses.erase(handle);
+        return NSAPI_ERROR_OK;
+    }
+    virtual nsapi_error_t socket_bind(nsapi_socket_t handle, const SocketAddress &address)
+    {
+        return NSAPI_ERROR_OK;
+    }
+    virtual nsapi_error_t socket_listen(nsapi_socket_t handle, int backlog)
+    {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+    virtual nsapi_error_t socket_connect(nsapi_socket_t handle, const SocketAddress &address)
+    {
+        return NSAPI_ERROR_OK;
+    }
+    virtual nsapi_error_t socket_accept(nsapi_socket_t server, nsapi_socket_t *handle, SocketAddress *address = 0)
+    {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+    virtual nsapi_size_or_error_t socket_send(nsapi_socket_t handle, const void *data, nsapi_size_t size)
+    {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+    virtual nsapi_size_or_error_t socket_recv(nsapi_socket_t handle, void *data, nsapi_size_t size)
+    {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
+                                                const void *data, nsapi_size_t size)
+    {
+        const uint8_t *question = static_cast<const uint8_t *>(data);
+
+        // Host name from the labels of the question
+        std::string host;
+        size_t pos = 12;
+        while (question[pos]) {
+            if (!host.empty()) {
+                host += '.';
+            }
+            host.append(reinterpret_cast<const char *>(&question[pos + 1]), question[pos]);
+            pos += question[pos] + 1;
+        }
+        size_t question_end = pos + 5;
+
+        queries.push_back(std::string(address.get_ip_address()) + " " + host);
+
+        server_behaviour_t server = ANSWER;
+        if (behaviour.count(address.get_ip_address())) {
+            server = behaviour[address.get_ip_address()];
+        }
+        if (server == SILENT) {
+            return size;
+        }
+
+        std::vector<uint8_t> response(question, question + question_end);
+        response[2] = 0x81;
+        response[3] = 0x80;
+
+        std::map<std::string, record_t>::iterator record = records.find(host);
+        if (server == SERVFAIL) {
+            response[3] |= 2;
+        } else if (record != records.end()) {
+            response[7] = 1; // ancount
+            const uint8_t answer[] = {
+                0xc0, 12, 0, 1, 0, 1,
+                uint8_t(record->second.ttl >> 24), uint8_t(record->second.ttl >> 16),
+                uint8_t(record->second.ttl >> 8), uint8_t(record->second.ttl),
+                0, 4
+            };
+            response.insert(response.end(), answer, answer + sizeof(answer));
+            response.insert(response.end(), record->second.ipv4.begin(), record->second.ipv4.end());
+        } else {
+            // NXDOMAIN, with the SOA record of the zone in the authority section
+            response[3] |= 3;
+            response[9] = 1; // nscount
+            const uint8_t authority[] = {
+                0xc0, 12, 0, 6, 0, 1, 0, 0, 0x0e, 0x10, 0, 22,
+                0, 0, // mname, rname
+                0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                uint8_t(soa_ttl >> 24), uint8_t(soa_ttl >> 16), uint8_t(soa_ttl >> 8), uint8_t(soa_ttl)
+            };
+            response.insert(response.end(), authority, authority + sizeof(authority));
+        }
+
+        responses[handle].push_back(response);
+        if (sigio) {
+            sigio(sigio_data);
+        }
+
+        return size;
+    }
+
+    virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
+                                                  void *buffer, nsapi_size_t size)
+    {
+        std::list<std::vector<uint8_t> > &queue = responses[handle];
+        if (queue.empty()) {
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+
+        std::vector<uint8_t> response = queue.front();
+        queue.pop_front();
+        if (response.size() < size) {
+            size = response.size();
+        }
+        memcpy(buffer, response.data(), size);
+        return size;
+    }
+
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data)
+    {
+        sigio = callback;
+        sigio_data = data;
+    }
+};
+
+// Events of the asynchronous resolver, run in virtual time
+struct event_t {
+    uint64_t time;
+    mbed::Callback<void()> func;
+};
+
+static std::list<event_t> events;
+
+static nsapi_error_t call_in(int delay, mbed::Callback<void()> func)
+{
+    event_t event = { ms_count + delay, func };
+    std::list<event_t>::iterator it = events.begin();
+    while (it != events.end() && it->time <= event.time) {
+        it++;
+    }
+    events.insert(it, event);
+    return NSAPI_ERROR_OK;
+}
+
+static void run_events(uint64_t until)
+{
+    while (!events.empty() && events.front().time <= until) {
+        event_t event = events.front();
+        events.pop_front();
+        ms_count = event.time;
+        event.func();
+    }
+    ms_count = until;
+}
+
+static int async_results;
+static nsapi_error_t async_status;
+static SocketAddress async_address;
+
+static void async_callback(nsapi_error_t status, SocketAddress *address)
+{
+    async_results++;
+    async_status = status;
+    if (address) {
+        async_address = *address;
+    }
+}
+
+class Test_nsapi_dns : public testing::Test {
+protected:
+    DNSServerStack stack;
+
+    virtual void SetUp()
+    {
+        ms_count = 1000;
+        events.clear();
+        async_results = 0;
+        async_status = NSAPI_ERROR_OK;
+        async_address = SocketAddress();
+        nsapi_dns_reset();
+        stack.add_record("www.example.com", 192, 0, 2, 1, 60);
+    }
+
+    virtual void TearDown()
+    {
+        // Lets pending queries finish, so that they do not leak into the next test
+        run_events(ms_count + 60000);
+    }
+};
+
+TEST_F(Test_nsapi_dns, query)
+{
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.1", address.get_ip_address());
+}
+
+TEST_F(Test_nsapi_dns, query_invalid_host)
+{
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_PARAMETER, nsapi_dns_query((NetworkStack *)&stack, "", &address, NSAPI_IPv4));
+    EXPECT_EQ(0u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, query_servers_in_parallel)
+{
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    ASSERT_EQ(2u, stack.queries.size());
+    EXPECT_EQ("10.0.0.1 www.example.com", stack.queries[0]);
+    EXPECT_EQ("10.0.0.2 www.example.com", stack.queries[1]);
+}
+
+TEST_F(Test_nsapi_dns, query_first_answer_wins)
+{
+    stack.behaviour["10.0.0.1"] = DNSServerStack::SILENT;
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.1", address.get_ip_address());
+    EXPECT_EQ(2u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, query_server_failure_tries_next_servers)
+{
+    stack.behaviour["10.0.0.1"] = DNSServerStack::SERVFAIL;
+    stack.behaviour["10.0.0.2"] = DNSServerStack::SERVFAIL;
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.1", address.get_ip_address());
+    // Answered by the first of the default servers
+    ASSERT_EQ(3u, stack.queries.size());
+    EXPECT_EQ("8.8.8.8 www.example.com", stack.queries[2]);
+}
+
+TEST_F(Test_nsapi_dns, query_no_answer)
+{
+    stack.behaviour["10.0.0.1"] = DNSServerStack::SILENT;
+    stack.behaviour["10.0.0.2"] = DNSServerStack::SILENT;
+    stack.behaviour["8.8.8.8"] = DNSServerStack::SILENT;
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    // Limited by the total number of attempts
+    EXPECT_EQ(3u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, cache)
+{
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    stack.queries.clear();
+
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.1", address.get_ip_address());
+    EXPECT_EQ(0u, stack.queries.size());
+
+    // Cached as long as the TTL of the record
+    ms_count += 60 * 1000;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(0u, stack.queries.size());
+
+    ms_count += 1;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(2u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, cache_zero_ttl)
+{
+    stack.add_record("www.example.com", 192, 0, 2, 1, 0);
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(4u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, cache_least_recently_used)
+{
+    char host[] = "host0.example.com";
+    SocketAddress address;
+
+    for (int i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE + 1; i++) {
+        host[4] = '0' + i;
+        stack.add_record(host, 192, 0, 2, 10 + i, 3600);
+    }
+
+    for (int i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        host[4] = '0' + i;
+        EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, host, &address, NSAPI_IPv4));
+    }
+
+    // Uses host0, so that host1 becomes the least recently used
+    host[4] = '0';
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, host, &address, NSAPI_IPv4));
+
+    host[4] = '0' + MBED_CONF_NSAPI_DNS_CACHE_SIZE;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, host, &address, NSAPI_IPv4));
+    stack.queries.clear();
+
+    host[4] = '0';
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, host, &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.10", address.get_ip_address());
+    EXPECT_EQ(0u, stack.queries.size());
+
+    host[4] = '1';
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, host, &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.11", address.get_ip_address());
+    EXPECT_EQ(2u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, negative_cache)
+{
+    stack.soa_ttl = 30;
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(2u, stack.queries.size());
+
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(2u, stack.queries.size());
+
+    // Cached for the minimum TTL of the SOA record
+    ms_count += 30 * 1000 + 1;
+    stack.add_record("missing.example.com", 192, 0, 2, 2, 60);
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    EXPECT_STREQ("192.0.2.2", address.get_ip_address());
+}
+
+TEST_F(Test_nsapi_dns, negative_cache_max_ttl)
+{
+    stack.soa_ttl = 3600;
+
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+
+    ms_count += MBED_CONF_NSAPI_DNS_CACHE_NEGATIVE_MAX_TTL * 1000 + 1;
+    stack.queries.clear();
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(2u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, negative_cache_per_version)
+{
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    stack.queries.clear();
+
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv6));
+    EXPECT_EQ(2u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, reset)
+{
+    SocketAddress address;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    stack.queries.clear();
+
+    nsapi_dns_reset();
+
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query((NetworkStack *)&stack, "www.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, nsapi_dns_query((NetworkStack *)&stack, "missing.example.com", &address, NSAPI_IPv4));
+    EXPECT_EQ(4u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, query_async)
+{
+    nsapi_value_or_error_t id = nsapi_dns_query_async((NetworkStack *)&stack, "www.example.com", async_callback, call_in, NSAPI_IPv4);
+    EXPECT_GT(id, 0);
+
+    run_events(ms_count + 1000);
+    EXPECT_EQ(1, async_results);
+    EXPECT_EQ(NSAPI_ERROR_OK, async_status);
+    EXPECT_STREQ("192.0.2.1", async_address.get_ip_address());
+    EXPECT_EQ(2u, stack.queries.size());
+
+    // Answered from the cache
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query_async((NetworkStack *)&stack, "www.example.com", async_callback, call_in, NSAPI_IPv4));
+    EXPECT_EQ(2, async_results);
+    EXPECT_EQ(2u, stack.queries.size());
+}
+
+TEST_F(Test_nsapi_dns, query_async_concurrent)
+{
+    stack.add_record("www.example.org", 192, 0, 2, 3, 60);
+
+    EXPECT_GT(nsapi_dns_query_async((NetworkStack *)&stack, "www.example.com", async_callback, call_in, NSAPI_IPv4), 0);
+    EXPECT_GT(nsapi_dns_query_async((NetworkStack *)&stack, "www.example.org", async_callback, call_in, NSAPI_IPv4), 0);
+
+    // Both questions are sent before either is answered
+    run_events(ms_count);
+    EXPECT_EQ(4u, stack.queries.size());
+
+    run_events(ms_count + 1000);
+    EXPECT_EQ(2, async_results);
+    EXPECT_EQ(NSAPI_ERROR_OK, async_status);
+}
+
+TEST_F(Test_nsapi_dns, query_async_server_failure)
+{
+    stack.behaviour["10.0.0.1"] = DNSServerStack::SERVFAIL;
+    stack.behaviour["10.0.0.2"] = DNSServerStack::SERVFAIL;
+
+    EXPECT_GT(nsapi_dns_query_async((NetworkStack *)&stack, "www.example.com", async_callback, call_in, NSAPI_IPv4), 0);
+
+    run_events(ms_count + 1000);
+    EXPECT_EQ(1, async_results);
+    EXPECT_EQ(NSAPI_ERROR_OK, async_status);
+    EXPECT_STREQ("192.0.2.1", async_address.get_ip_address());
+    ASSERT_EQ(3u, stack.queries.size());
+    EXPECT_EQ("8.8.8.8 www.example.com", stack.queries[2]);
+}
+
+TEST_F(Test_nsapi_dns, query_async_negative_cache)
+{
+    EXPECT_GT(nsapi_dns_query_async((NetworkStack *)&stack, "missing.example.com", async_callback, call_in, NSAPI_IPv4), 0);
+
+    run_events(ms_count + 1000);
+    EXPECT_EQ(1, async_results);
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, async_status);
+
+    // Answered from the cache, through the callback
+    async_status = NSAPI_ERROR_OK;
+    EXPECT_EQ(NSAPI_ERROR_OK, nsapi_dns_query_async((NetworkStack *)&stack, "missing.example.com", async_callback, call_in, NSAPI_IPv4));
+    EXPECT_EQ(2, async_results);
+    EXPECT_EQ(NSAPI_ERROR_DNS_FAILURE, async_status);
+    EXPECT_EQ(2u, stack.queries.size());
+}
@@ -0,0 +1,42 @@
+
+####################
+# UNIT TESTS
+####################
+
+set(unittest-sources
+  ../features/netsocket/SocketAddress.cpp
+  ../features/netsocket/Socket.cpp
+  ../features/netsocket/NetworkStack.cpp
+  ../features/netsocket/NetStackMemoryManager.cpp
+  ../features/netsocket/InternetSocket.cpp
+  ../features/netsocket/UDPSocket.cpp
+  ../features/netsocket/nsapi_dns.cpp
+  ../features/frameworks/nanostack-libservice/source/libip4string/ip4tos.c
+  ../features/frameworks/nanostack-libservice/source/libip6string/ip6tos.c
+  ../features/frameworks/nanostack-libservice/source/libip4string/stoip4.c
+  ../features/frameworks/nanostack-libservice/source/libip6string/stoip6.c
+  ../features/frameworks/nanostack-libservice/source/libBits/common_functions.c
+)
+
+set(unittest-test-sources
+  features/netsocket/nsapi_dns/test_nsapi_dns.cpp
+  stubs/Mutex_stub.cpp
+  stubs/mbed_assert_stub.c
+  stubs/mbed_critical_stub.c
+  stubs/equeue_stub.c
+  stubs/EventQueue_stub.cpp
+  stubs/mbed_error.c
+  stubs/mbed_shared_queues_stub.cpp
+  stubs/SocketStats_Stub.cpp
+)
+
+set(NSAPI_DNS_CONFIG
+  MBED_CONF_NSAPI_DNS_RESPONSE_WAIT_TIME=5000
+  MBED_CONF_NSAPI_DNS_TOTAL_ATTEMPTS=3
+  MBED_CONF_NSAPI_DNS_RETRIES=0
+  MBED_CONF_NSAPI_DNS_CACHE_SIZE=3
+  MBED_CONF_NSAPI_DNS_CACHE_NEGATIVE_MAX_TTL=60
+  MBED_CONF_NSAPI_DNS_PARALLEL_SERVERS=2
+)
+set_source_files_properties(features/netsocket/nsapi_dns/test_nsapi_dns.cpp PROPERTIES COMPILE_DEFINITIONS "${NSAPI_DNS_CONFIG}")
+set_source_files_properties(../features/netsocket/nsapi_dns.cpp PROPERTIES COMPILE_DEFINITIONS "${NSAPI_DNS_CONFIG}")
@@ -17,6 +17,11 @@
 
 #include "gtest/gtest.h"
 #include "platform/CircularBuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 class TestCircularBuffer : public testing::Test {
 protected:
@@ -37,3 +42,203 @@ TEST_F(TestCircularBuffer, constructor)
 {
     EXPECT_TRUE(buf);
 }
+
+class TestSPSCCircularBuffer : public testing::Test {
+protected:
+    mbed::SPSCCircularBuffer<int, 10> *buf;
+
+    virtual void SetUp()
+    {
+        buf = new mbed::SPSCCircularBuffer<int, 10>;
+    }
+
+    virtual void TearDown()
+    {
+        delete buf;
+    }
+};
+
+TEST_F(TestSPSCCircularBuffer, push_pop)
+{
+    int data;
+    EXPECT_TRUE(buf->empty());
+    EXPECT_FALSE(buf->pop(data));
+    EXPECT_FALSE(buf->peek(data));
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(buf->push(i));
+    }
+    EXPECT_TRUE(buf->full());
+    EXPECT_EQ(10U, buf->size());
+
+    // Full buffer is not overwritten
+    EXPECT_FALSE(buf->push(10));
+
+    EXPECT_TRUE(buf->peek(data));
+    EXPECT_EQ(0, data);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(buf->pop(data));
+        EXPECT_EQ(i, data);
+    }
+    EXPECT_TRUE(buf->empty());
+    EXPECT_FALSE(buf->pop(data));
+}
+
+TEST_F(TestSPSCCircularBuffer, wrap_around)
+{
+    int data;
+    // Go round the buffer several times, with up to 7 elements stored
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(buf->push(i));
+        if (i >= 6) {
+            EXPECT_EQ(7U, buf->size());
+            EXPECT_TRUE(buf->pop(data));
+            EXPECT_EQ(i - 6, data);
+        }
+    }
+    EXPECT_EQ(6U, buf->size());
+    EXPECT_FALSE(buf->full());
+
+    buf->reset();
+    EXPECT_TRUE(buf->empty());
+}
+
+TEST_F(TestSPSCCircularBuffer, bulk_push_pop)
+{
+    int in[15];
+    int out[15];
+    for (int i = 0; i < 15; i++) {
+        in[i] = i;
+    }
+
+    // Only as many as there is room for, and as many as are stored
+    EXPECT_EQ(10U, buf->push(in, 15));
+    EXPECT_EQ(0U, buf->push(in, 15));
+    EXPECT_EQ(4U, buf->pop(out, 4));
+    EXPECT_EQ(0, memcmp(in, out, 4 * sizeof(int)));
+
+    // Spans the end of the buffer
+    EXPECT_EQ(4U, buf->push(&in[10], 5));
+    EXPECT_TRUE(buf->full());
+    EXPECT_EQ(10U, buf->pop(out, 15));
+    EXPECT_EQ(0, memcmp(&in[4], out, 10 * sizeof(int)));
+    EXPECT_EQ(0U, buf->pop(out, 15));
+
+    // Single and bulk calls mix
+    int data;
+    EXPECT_TRUE(buf->push(1));
+    EXPECT_EQ(2U, buf->push(in, 2));
+    EXPECT_TRUE(buf->pop(data));
+    EXPECT_EQ(1, data);
+    EXPECT_EQ(2U, buf->pop(out, 15));
+    EXPECT_EQ(0, out[0]);
+    EXPECT_EQ(1, out[1]);
+}
+
+static const uint32_t producer_total = 100000;
+
+static void *producer(void *arg)
+{
+    mbed::SPSCCircularBuffer<uint32_t, 256> *spsc = (mbed::SPSCCircularBuffer<uint32_t, 256> *)arg;
+    uint32_t chunk[37];
+    uint32_t next = 0;
+    while (next < producer_total) {
+        uint32_t len = 0;
+        while (len < 37 && next + len < producer_total) {
+            chunk[len] = next + len;
+            len++;
+        }
+        uint32_t pushed = spsc->push(chunk, len);
+        if (!pushed) {
+            sched_yield();
+        }
+        next += pushed;
+    }
+    return NULL;
+}
+
+TEST_F(TestSPSCCircularBuffer, producer_consumer_threads)
+{
+    mbed::SPSCCircularBuffer<uint32_t, 256> *spsc = new mbed::SPSCCircularBuffer<uint32_t, 256>;
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, producer, spsc));
+
+    // Everything arrives once and in order
+    uint32_t expected = 0;
+    bool in_order = true;
+    uint32_t chunk[53];
+    while (expected < producer_total) {
+        uint32_t len = spsc->pop(chunk, 53);
+        if (!len) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            in_order = in_order && chunk[i] == expected;
+            expected++;
+        }
+    }
+    pthread_join(thread, NULL);
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(spsc->empty());
+    delete spsc;
+}
+
+static double now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+TEST(CircularBufferBenchmark, throughput)
+{
+    const int iterations = 20000;
+    static mbed::CircularBuffer<char, 256> locked;
+    static mbed::SPSCCircularBuffer<char, 256> spsc;
+    char data[200];
+    char out[200];
+    memset(data, 0, sizeof(data));
+    uint32_t sum = 0;
+
+    double start = now_us();
+    for (int i = 0; i < iterations; i++) {
+        for (size_t j = 0; j < sizeof(data); j++) {
+            locked.push(data[j]);
+        }
+        for (size_t j = 0; j < sizeof(out); j++) {
+            locked.pop(out[j]);
+        }
+        sum += out[i % sizeof(out)];
+    }
+    double mid = now_us();
+    for (int i = 0; i < iterations; i++) {
+        for (size_t j = 0; j < sizeof(data); j++) {
+            spsc.push(data[j]);
+        }
+        for (size_t j = 0; j < sizeof(out); j++) {
+            spsc.pop(out[j]);
+        }
+        sum += out[i % sizeof(out)];
+    }
+    double mid2 = now_us();
+    for (int i = 0; i < iterations; i++) {
+        spsc.push(data, sizeof(data));
+        spsc.pop(out, sizeof(out));
+        sum += out[i % sizeof(out)];
+    }
+    double end = now_us();
+
+    // Keep the results alive
+    EXPECT_EQ(0U, sum);
+
+    // Critical sections are stubbed out on the host, so the locked buffer
+    // is measured without the cost of masking interrupts
+    double bytes = (double) iterations * sizeof(data);
+    printf("CircularBuffer push/pop: %.1f MB/s\n",
+           bytes / (mid - start));
+    printf("SPSCCircularBuffer push/pop: %.1f MB/s\n",
+           bytes / (mid2 - mid));
+    printf("SPSCCircularBuffer bulk push/pop: %.1f MB/s\n",
+           bytes / (end - mid2));
+}
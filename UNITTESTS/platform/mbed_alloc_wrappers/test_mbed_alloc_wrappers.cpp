@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "platform/mbed_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <set>
+#include <vector>
+
+// The wrappers are called directly, on top of the C library allocator
+extern "C" {
+    uint32_t mbed_heap_size = 0;
+
+    void *__real__malloc_r(struct _reent *r, size_t size)
+    {
+        return malloc(size);
+    }
+
+    void *__real__memalign_r(struct _reent *r, size_t alignment, size_t bytes)
+    {
+        return NULL;
+    }
+
+    void *__real__realloc_r(struct _reent *r, void *ptr, size_t size)
+    {
+        return realloc(ptr, size);
+    }
+
+    void __real__free_r(struct _reent *r, void *ptr)
+    {
+        free(ptr);
+    }
+
+    void *__real__calloc_r(struct _reent *r, size_t nmemb, size_t size)
+    {
+        return calloc(nmemb, size);
+    }
+
+    void *__wrap__malloc_r(struct _reent *r, size_t size);
+    void *__wrap__realloc_r(struct _reent *r, void *ptr, size_t size);
+    void __wrap__free_r(struct _reent *r, void *ptr);
+    void *__wrap__calloc_r(struct _reent *r, size_t nmemb, size_t size);
+}
+
+// Size of the heap statistics header in front of each allocation
+#define HEADER_SIZE 8
+
+static void *mbed_malloc(size_t size)
+{
+    return __wrap__malloc_r(NULL, size);
+}
+
+static void *mbed_realloc(void *ptr, size_t size)
+{
+    return __wrap__realloc_r(NULL, ptr, size);
+}
+
+static void *mbed_calloc(size_t nmemb, size_t size)
+{
+    return __wrap__calloc_r(NULL, nmemb, size);
+}
+
+static void mbed_free(void *ptr)
+{
+    __wrap__free_r(NULL, ptr);
+}
+
+class TestMbedAllocWrappers : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        mbed_stats_heap_get(&start);
+    }
+
+    virtual void TearDown()
+    {
+        mbed_stats_heap_t stats;
+        mbed_stats_heap_get(&stats);
+        EXPECT_EQ(start.current_size, stats.current_size);
+        for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+            EXPECT_EQ(start.pool[i].alloc_cnt, stats.pool[i].alloc_cnt);
+        }
+    }
+
+    mbed_stats_heap_t start;
+};
+
+TEST_F(TestMbedAllocWrappers, pool_configuration)
+{
+    const uint32_t block_size[MBED_HEAP_POOL_CLASSES] = {16, 32, 64, 128};
+    const uint32_t block_cnt[MBED_HEAP_POOL_CLASSES] = {8, 8, 64, 64};
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        EXPECT_EQ(block_size[i], start.pool[i].block_size);
+        EXPECT_EQ(block_cnt[i], start.pool[i].block_cnt);
+    }
+}
+
+TEST_F(TestMbedAllocWrappers, smallest_pool_that_fits)
+{
+    const size_t sizes[MBED_HEAP_POOL_CLASSES] = {16, 32, 64, 128};
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        void *smallest = mbed_malloc(sizes[i] - HEADER_SIZE);
+        void *next = mbed_malloc(sizes[i] - HEADER_SIZE + 1);
+        ASSERT_TRUE(smallest != NULL);
+        ASSERT_TRUE(next != NULL);
+        EXPECT_EQ(0U, (uintptr_t)smallest % 8);
+
+        mbed_stats_heap_t stats;
+        mbed_stats_heap_get(&stats);
+        EXPECT_EQ(start.pool[i].alloc_cnt + 1, stats.pool[i].alloc_cnt);
+        if (i + 1 < MBED_HEAP_POOL_CLASSES) {
+            EXPECT_EQ(start.pool[i + 1].alloc_cnt + 1, stats.pool[i + 1].alloc_cnt);
+        }
+        EXPECT_EQ(start.current_size + 2 * (sizes[i] - HEADER_SIZE) + 1, stats.current_size);
+
+        mbed_free(smallest);
+        mbed_free(next);
+    }
+}
+
+TEST_F(TestMbedAllocWrappers, freed_block_reused)
+{
+    void *ptr = mbed_malloc(4);
+    mbed_free(ptr);
+    EXPECT_EQ(ptr, mbed_malloc(8));
+    mbed_free(ptr);
+
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    EXPECT_EQ(start.pool[0].alloc_cnt, stats.pool[0].alloc_cnt);
+    EXPECT_LE(1U, stats.pool[0].max_cnt);
+}
+
+TEST_F(TestMbedAllocWrappers, full_pool_falls_back_to_heap)
+{
+    std::vector<void *> blocks;
+    std::set<void *> unique;
+    for (int i = 0; i < 10; i++) {
+        void *ptr = mbed_malloc(8);
+        ASSERT_TRUE(ptr != NULL);
+        memset(ptr, i, 8);
+        blocks.push_back(ptr);
+        unique.insert(ptr);
+    }
+    EXPECT_EQ(blocks.size(), unique.size());
+
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    EXPECT_EQ(8U, stats.pool[0].alloc_cnt);
+    EXPECT_EQ(8U, stats.pool[0].max_cnt);
+    EXPECT_EQ(start.pool[0].fallback_cnt + 2, stats.pool[0].fallback_cnt);
+    // Larger pools are not used for smaller sizes
+    EXPECT_EQ(start.pool[1].alloc_cnt, stats.pool[1].alloc_cnt);
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        for (int j = 0; j < 8; j++) {
+            EXPECT_EQ(i, ((uint8_t *)blocks[i])[j]);
+        }
+        mbed_free(blocks[i]);
+    }
+}
+
+TEST_F(TestMbedAllocWrappers, large_allocation_from_heap)
+{
+    void *ptr = mbed_malloc(128);
+    ASSERT_TRUE(ptr != NULL);
+
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        EXPECT_EQ(start.pool[i].alloc_cnt, stats.pool[i].alloc_cnt);
+        EXPECT_EQ(start.pool[i].fallback_cnt, stats.pool[i].fallback_cnt);
+    }
+    EXPECT_EQ(start.current_size + 128, stats.current_size);
+    mbed_free(ptr);
+}
+
+TEST_F(TestMbedAllocWrappers, realloc_between_pool_and_heap)
+{
+    uint8_t *ptr = (uint8_t *)mbed_realloc(NULL, 8);
+    ASSERT_TRUE(ptr != NULL);
+    for (int i = 0; i < 8; i++) {
+        ptr[i] = i;
+    }
+
+    // Grow into a larger pool, then into the heap, then back into the smallest pool
+    const size_t sizes[] = {100, 1000, 4};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        ptr = (uint8_t *)mbed_realloc(ptr, sizes[s]);
+        ASSERT_TRUE(ptr != NULL);
+        for (size_t i = 0; i < 8 && i < sizes[s]; i++) {
+            EXPECT_EQ(i, ptr[i]);
+        }
+        mbed_stats_heap_t stats;
+        mbed_stats_heap_get(&stats);
+        EXPECT_EQ(start.current_size + sizes[s], stats.current_size);
+    }
+
+    mbed_free(ptr);
+}
+
+TEST_F(TestMbedAllocWrappers, calloc_zeroes_reused_block)
+{
+    uint8_t *ptr = (uint8_t *)mbed_malloc(20);
+    memset(ptr, 0xff, 20);
+    mbed_free(ptr);
+
+    uint8_t *zeroed = (uint8_t *)mbed_calloc(4, 5);
+    ASSERT_EQ(ptr, zeroed);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(0, zeroed[i]);
+    }
+    mbed_free(zeroed);
+}
+
+TEST_F(TestMbedAllocWrappers, overhead_of_pool_block)
+{
+    void *ptr = mbed_malloc(40);
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    // The rest of the 64-byte block is overhead
+    EXPECT_EQ(start.overhead_size + 64 - 40, stats.overhead_size);
+    mbed_free(ptr);
+
+    mbed_stats_heap_get(&stats);
+    EXPECT_EQ(start.overhead_size, stats.overhead_size);
+}
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Allocation pattern of a network stack: many short-lived small buffers and
+ * events, interleaved with long-lived objects of various sizes that pin the
+ * heap between them. Returns the number of small allocations served by the heap.
+ */
+static uint32_t fragmentation_stress(int iterations, uint64_t *elapsed_ns)
+{
+    std::vector<void *> live(48, (void *)NULL);
+    std::vector<void *> pinned;
+    uint32_t seed = 1;
+    uint32_t heap_allocs = 0;
+    mbed_stats_heap_t before, after;
+
+    mbed_stats_heap_get(&before);
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        seed = seed * 1103515245 + 12345;
+        size_t slot = (seed >> 16) % live.size();
+        size_t size = 1 + (seed >> 8) % 120;
+        mbed_free(live[slot]);
+        live[slot] = mbed_malloc(size);
+        if (i % 64 == 0) {
+            pinned.push_back(mbed_malloc(128 + (seed >> 4) % 512));
+        }
+    }
+    *elapsed_ns = now_ns() - start;
+    mbed_stats_heap_get(&after);
+
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        heap_allocs += after.pool[i].fallback_cnt - before.pool[i].fallback_cnt;
+    }
+    for (size_t i = 0; i < live.size(); i++) {
+        mbed_free(live[i]);
+    }
+    for (size_t i = 0; i < pinned.size(); i++) {
+        mbed_free(pinned[i]);
+    }
+    return heap_allocs;
+}
+
+TEST_F(TestMbedAllocWrappers, fragmentation_stress)
+{
+    const int iterations = 100000;
+    uint64_t pools, heap;
+
+    uint32_t pools_heap_allocs = fragmentation_stress(iterations, &pools);
+
+    // Hold all the pool blocks, so that every allocation goes to the heap
+    std::vector<void *> held;
+    const size_t sizes[MBED_HEAP_POOL_CLASSES] = {16, 32, 64, 128};
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        for (uint32_t j = 0; j < start.pool[i].block_cnt; j++) {
+            held.push_back(mbed_malloc(sizes[i] - HEADER_SIZE));
+        }
+    }
+    uint32_t heap_heap_allocs = fragmentation_stress(iterations, &heap);
+    for (size_t i = 0; i < held.size(); i++) {
+        mbed_free(held[i]);
+    }
+
+    double pools_ns = (double)pools / iterations;
+    double heap_ns = (double)heap / iterations;
+    printf("small allocations from the heap: %u of %d with pools, %u of %d without\n",
+           pools_heap_allocs, iterations, heap_heap_allocs, iterations);
+    printf("free and malloc: %.0f ns with pools, %.0f ns without\n", pools_ns, heap_ns);
+
+    // Small allocations are kept off the heap while the pools have room
+    EXPECT_LT(pools_heap_allocs, heap_heap_allocs / 10);
+    EXPECT_EQ((uint32_t)iterations, heap_heap_allocs);
+}
@@ -0,0 +1,25 @@
+####################
+# UNIT TESTS
+####################
+
+set(unittest-sources
+  ../platform/mbed_alloc_wrappers.cpp
+)
+
+set(unittest-test-sources
+  platform/mbed_alloc_wrappers/test_mbed_alloc_wrappers.cpp
+  stubs/Mutex_stub.cpp
+  stubs/mbed_assert_stub.c
+  stubs/mbed_critical_stub.c
+)
+
+set(MBED_ALLOC_WRAPPERS_CONFIG
+  TOOLCHAIN_GCC
+  MBED_HEAP_STATS_ENABLED
+  MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS=8
+  MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS=8
+  MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS=64
+  MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS=64
+)
+set_source_files_properties(platform/mbed_alloc_wrappers/test_mbed_alloc_wrappers.cpp PROPERTIES COMPILE_DEFINITIONS "${MBED_ALLOC_WRAPPERS_CONFIG}")
+set_source_files_properties(../platform/mbed_alloc_wrappers.cpp PROPERTIES COMPILE_DEFINITIONS "${MBED_ALLOC_WRAPPERS_CONFIG}")
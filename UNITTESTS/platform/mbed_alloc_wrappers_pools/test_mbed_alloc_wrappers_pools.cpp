@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "platform/mbed_stats.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Pools without heap statistics, built here rather than as a library so that
+// MBED_HEAP_STATS_ENABLED is not set
+#include "platform/mbed_alloc_wrappers.cpp"
+
+// The wrappers are called directly, on top of the C library allocator
+extern "C" {
+    uint32_t mbed_heap_size = 0;
+
+    void *__real__malloc_r(struct _reent *r, size_t size)
+    {
+        return malloc(size);
+    }
+
+    void *__real__memalign_r(struct _reent *r, size_t alignment, size_t bytes)
+    {
+        return NULL;
+    }
+
+    void *__real__realloc_r(struct _reent *r, void *ptr, size_t size)
+    {
+        return realloc(ptr, size);
+    }
+
+    void __real__free_r(struct _reent *r, void *ptr)
+    {
+        free(ptr);
+    }
+
+    void *__real__calloc_r(struct _reent *r, size_t nmemb, size_t size)
+    {
+        return calloc(nmemb, size);
+    }
+}
+
+static void *mbed_malloc(size_t size)
+{
+    return __wrap__malloc_r(NULL, size);
+}
+
+static void *mbed_realloc(void *ptr, size_t size)
+{
+    return __wrap__realloc_r(NULL, ptr, size);
+}
+
+static void *mbed_calloc(size_t nmemb, size_t size)
+{
+    return __wrap__calloc_r(NULL, nmemb, size);
+}
+
+static void mbed_free(void *ptr)
+{
+    __wrap__free_r(NULL, ptr);
+}
+
+class TestMbedAllocWrappersPools : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        mbed_stats_heap_get(&start);
+    }
+
+    virtual void TearDown()
+    {
+        mbed_stats_heap_t stats;
+        mbed_stats_heap_get(&stats);
+        for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+            EXPECT_EQ(start.pool[i].alloc_cnt, stats.pool[i].alloc_cnt);
+        }
+    }
+
+    uint32_t pool_alloc_cnt(int pool)
+    {
+        mbed_stats_heap_t stats;
+        mbed_stats_heap_get(&stats);
+        return stats.pool[pool].alloc_cnt - start.pool[pool].alloc_cnt;
+    }
+
+    mbed_stats_heap_t start;
+};
+
+TEST_F(TestMbedAllocWrappersPools, pool_stats_without_heap_stats)
+{
+    EXPECT_EQ(0U, start.current_size);
+    EXPECT_EQ(0U, start.overhead_size);
+    EXPECT_EQ(16U, start.pool[0].block_size);
+    EXPECT_EQ(8U, start.pool[0].block_cnt);
+
+    // Without the statistics header, the full block size is available
+    void *ptr = mbed_malloc(16);
+    ASSERT_TRUE(ptr != NULL);
+    EXPECT_EQ(0U, (uintptr_t)ptr % 8);
+    EXPECT_EQ(1U, pool_alloc_cnt(0));
+    mbed_free(ptr);
+}
+
+TEST_F(TestMbedAllocWrappersPools, realloc_between_pool_and_heap)
+{
+    uint8_t *ptr = (uint8_t *)mbed_realloc(NULL, 8);
+    ASSERT_TRUE(ptr != NULL);
+    EXPECT_EQ(1U, pool_alloc_cnt(0));
+    for (int i = 0; i < 8; i++) {
+        ptr[i] = i;
+    }
+
+    // Grow into a larger pool, shrink back into the smallest pool, then grow
+    // into the heap. Heap blocks are resized by the heap, even when shrunk.
+    const size_t sizes[] = {100, 4, 1000, 4};
+    const uint32_t pool_cnt[][MBED_HEAP_POOL_CLASSES] = {
+        {0, 0, 0, 1},
+        {1, 0, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 0, 0},
+    };
+    size_t kept = 8;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        ptr = (uint8_t *)mbed_realloc(ptr, sizes[s]);
+        ASSERT_TRUE(ptr != NULL);
+        if (sizes[s] < kept) {
+            kept = sizes[s];
+        }
+        for (size_t i = 0; i < kept; i++) {
+            EXPECT_EQ(i, ptr[i]);
+        }
+        for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+            EXPECT_EQ(pool_cnt[s][i], pool_alloc_cnt(i));
+        }
+    }
+
+    mbed_free(ptr);
+}
+
+TEST_F(TestMbedAllocWrappersPools, realloc_pool_block_to_zero)
+{
+    void *ptr = mbed_malloc(20);
+    ASSERT_TRUE(ptr != NULL);
+    EXPECT_EQ(1U, pool_alloc_cnt(1));
+
+    // The block is freed, and nothing is allocated in its place
+    EXPECT_TRUE(mbed_realloc(ptr, 0) == NULL);
+    EXPECT_EQ(0U, pool_alloc_cnt(1));
+}
+
+TEST_F(TestMbedAllocWrappersPools, realloc_full_pool_falls_back_to_heap)
+{
+    void *blocks[8];
+    for (int i = 0; i < 8; i++) {
+        blocks[i] = mbed_malloc(16);
+        ASSERT_TRUE(blocks[i] != NULL);
+    }
+
+    // The smallest pool is full, so the block moves to the heap
+    memset(blocks[0], 0x5a, 16);
+    uint8_t *ptr = (uint8_t *)mbed_realloc(blocks[0], 12);
+    ASSERT_TRUE(ptr != NULL);
+    for (int i = 0; i < 12; i++) {
+        EXPECT_EQ(0x5a, ptr[i]);
+    }
+    EXPECT_EQ(7U, pool_alloc_cnt(0));
+
+    mbed_free(ptr);
+    for (int i = 1; i < 8; i++) {
+        mbed_free(blocks[i]);
+    }
+}
+
+TEST_F(TestMbedAllocWrappersPools, calloc_zeroes_reused_block)
+{
+    uint8_t *ptr = (uint8_t *)mbed_malloc(20);
+    memset(ptr, 0xff, 20);
+    mbed_free(ptr);
+
+    uint8_t *zeroed = (uint8_t *)mbed_calloc(4, 5);
+    ASSERT_EQ(ptr, zeroed);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(0, zeroed[i]);
+    }
+    mbed_free(zeroed);
+}
+
+TEST_F(TestMbedAllocWrappersPools, calloc_overflow_not_served_by_pool)
+{
+    // The product wraps around to 16 bytes, which would fit the smallest pool
+    const size_t nmemb = ((size_t)1 << (sizeof(size_t) * 8 - 4)) + 1;
+    EXPECT_EQ(16U, nmemb * 16);
+    EXPECT_TRUE(mbed_calloc(nmemb, 16) == NULL);
+    EXPECT_TRUE(mbed_calloc(16, nmemb) == NULL);
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        EXPECT_EQ(0U, pool_alloc_cnt(i));
+    }
+}
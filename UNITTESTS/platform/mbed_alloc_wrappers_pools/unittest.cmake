@@ -0,0 +1,24 @@
+####################
+# UNIT TESTS
+####################
+
+# mbed_alloc_wrappers.cpp is built into the test source, so that it can have
+# a different configuration than in the mbed_alloc_wrappers test suite
+set(unittest-sources
+)
+
+set(unittest-test-sources
+  platform/mbed_alloc_wrappers_pools/test_mbed_alloc_wrappers_pools.cpp
+  stubs/Mutex_stub.cpp
+  stubs/mbed_assert_stub.c
+  stubs/mbed_critical_stub.c
+)
+
+set(MBED_ALLOC_WRAPPERS_POOLS_CONFIG
+  TOOLCHAIN_GCC
+  MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS=8
+  MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS=8
+  MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS=64
+  MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS=64
+)
+set_source_files_properties(platform/mbed_alloc_wrappers_pools/test_mbed_alloc_wrappers_pools.cpp PROPERTIES COMPILE_DEFINITIONS "${MBED_ALLOC_WRAPPERS_POOLS_CONFIG}")
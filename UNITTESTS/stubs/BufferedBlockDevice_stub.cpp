@@ -26,7 +26,8 @@ static inline uint32_t align_down(bd_size_t val, bd_size_t size)
     return 0;
 }
 
-BufferedBlockDevice::BufferedBlockDevice(BlockDevice *bd)
+BufferedBlockDevice::BufferedBlockDevice(BlockDevice *bd, uint32_t write_lines, uint32_t read_lines,
+                                         bd_size_t read_line_size)
 {
 }
 
@@ -103,3 +104,7 @@ bd_size_t BufferedBlockDevice::size() const
 {
     return 0;
 }
+
+void BufferedBlockDevice::get_cache_stats(cache_stats_t *stats) const
+{
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackNetworkStack.h"
+#include <string.h>
+#include <algorithm>
+
+#define LOOPBACK_IP_ADDRESS "127.0.0.1"
+#define EPHEMERAL_PORT_FIRST 49152
+#define TCP_MSS 1460
+#define TCP_HEADER_SIZE 40
+#define UDP_HEADER_SIZE 28
+// Lost TCP segments arrive after a retransmission timeout
+#define TCP_RTO_US 200000
+
+static nsapi_socket_t to_handle(uint32_t id)
+{
+    return reinterpret_cast<nsapi_socket_t>(static_cast<uintptr_t>(id));
+}
+
+static uint32_t to_id(nsapi_socket_t handle)
+{
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(handle));
+}
+
+LoopbackNetworkStack::LoopbackNetworkStack() :
+    _now(0),
+    _link_free(0),
+    _next_id(1),
+    _next_port(EPHEMERAL_PORT_FIRST),
+    _random(1),
+    _auto_advance(true),
+    _in_event(false)
+{
+    memset(&_config, 0, sizeof(_config));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+LoopbackNetworkStack::~LoopbackNetworkStack()
+{
+    for (std::map<uint32_t, socket_t *>::iterator it = _sockets.begin(); it != _sockets.end(); it++) {
+        delete it->second;
+    }
+}
+
+void LoopbackNetworkStack::set_link_config(const link_config_t &config)
+{
+    _config = config;
+}
+
+void LoopbackNetworkStack::set_seed(uint32_t seed)
+{
+    _random = seed ? seed : 1;
+}
+
+void LoopbackNetworkStack::set_auto_advance(bool enabled)
+{
+    _auto_advance = enabled;
+}
+
+uint64_t LoopbackNetworkStack::get_time_us() const
+{
+    return _now;
+}
+
+bool LoopbackNetworkStack::advance()
+{
+    if (_events.empty()) {
+        return false;
+    }
+
+    // Removed before it is run, so that the event can schedule and run others
+    std::multimap<uint64_t, event_t>::iterator it = _events.begin();
+    event_t event = it->second;
+    _now = std::max(_now, it->first);
+    _events.erase(it);
+
+    bool in_event = _in_event;
+    _in_event = true;
+    run(event);
+    _in_event = in_event;
+    return true;
+}
+
+void LoopbackNetworkStack::advance_to(uint64_t time_us)
+{
+    while (!_events.empty() && _events.begin()->first <= time_us) {
+        advance();
+    }
+    _now = std::max(_now, time_us);
+}
+
+void LoopbackNetworkStack::run_until_idle()
+{
+    while (advance()) {
+    }
+}
+
+bool LoopbackNetworkStack::wait()
+{
+    // Callbacks run from events must not wait, like in the context of a real stack
+    return _auto_advance && !_in_event && advance();
+}
+
+void LoopbackNetworkStack::get_link_stats(link_stats_t *stats) const
+{
+    *stats = _stats;
+}
+
+const char *LoopbackNetworkStack::get_ip_address()
+{
+    return LOOPBACK_IP_ADDRESS;
+}
+
+LoopbackNetworkStack::socket_t *LoopbackNetworkStack::find(uint32_t id)
+{
+    std::map<uint32_t, socket_t *>::iterator it = _sockets.find(id);
+    return it != _sockets.end() ? it->second : NULL;
+}
+
+LoopbackNetworkStack::socket_t *LoopbackNetworkStack::find_port(nsapi_protocol_t proto, uint16_t port)
+{
+    for (std::map<uint32_t, socket_t *>::iterator it = _sockets.begin(); it != _sockets.end(); it++) {
+        socket_t *socket = it->second;
+        // Accepted TCP sockets share the port of the listening socket
+        if (socket->proto == proto && socket->port == port && !(proto == NSAPI_TCP && socket->connected)) {
+            return socket;
+        }
+    }
+    return NULL;
+}
+
+uint16_t LoopbackNetworkStack::ephemeral_port(nsapi_protocol_t proto)
+{
+    while (find_port(proto, _next_port)) {
+        _next_port = _next_port == 0xffff ? EPHEMERAL_PORT_FIRST : _next_port + 1;
+    }
+    uint16_t port = _next_port;
+    _next_port = _next_port == 0xffff ? EPHEMERAL_PORT_FIRST : _next_port + 1;
+    return port;
+}
+
+uint64_t LoopbackNetworkStack::transmit(size_t size, bool *lost)
+{
+    // Packets are serialized on the link one after the other
+    uint64_t start = std::max(_now, _link_free);
+    uint64_t duration = _config.bandwidth ? (uint64_t) size * 1000000 / _config.bandwidth : 0;
+    _link_free = start + duration;
+
+    // xorshift32
+    _random ^= _random << 13;
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    *lost = _config.loss_ppm && (_random % 1000000) < _config.loss_ppm;
+
+    _stats.packets_sent++;
+    if (*lost) {
+        _stats.packets_lost++;
+    }
+
+    return _link_free + _config.latency_us;
+}
+
+void LoopbackNetworkStack::schedule(uint64_t time, const event_t &event)
+{
+    // Events at the same time run in the order they were scheduled
+    _events.insert(std::make_pair(time, event));
+}
+
+void LoopbackNetworkStack::run(event_t &event)
+{
+    if (event.type == EVENT_CALL) {
+        event.func();
+        return;
+    }
+
+    socket_t *socket = find(event.socket);
+    if (!socket) {
+        return;
+    }
+
+    switch (event.type) {
+        case EVENT_PACKET:
+            socket->rx.push_back(std::make_pair(event.address, event.data));
+            break;
+        case EVENT_ACCEPT:
+            socket->accept_queue.push_back(event.from);
+            break;
+        case EVENT_FIN:
+            socket->peer_closed = true;
+            break;
+        default:
+            break;
+    }
+
+    signal(socket);
+}
+
+void LoopbackNetworkStack::signal(socket_t *socket)
+{
+    if (socket->callback) {
+        socket->callback(socket->data);
+    }
+}
+
+bool LoopbackNetworkStack::readable(socket_t *socket)
+{
+    return !socket->rx.empty() || !socket->accept_queue.empty() || socket->peer_closed;
+}
+
+nsapi_error_t LoopbackNetworkStack::socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto)
+{
+    if (proto != NSAPI_TCP && proto != NSAPI_UDP) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    socket_t *socket = new socket_t;
+    socket->id = _next_id++;
+    socket->proto = proto;
+    socket->port = 0;
+    socket->listening = false;
+    socket->connected = false;
+    socket->peer_closed = false;
+    socket->peer = 0;
+    socket->peer_port = 0;
+    socket->backlog = 0;
+    socket->rx_offset = 0;
+    socket->last_delivery = 0;
+    socket->callback = NULL;
+    socket->data = NULL;
+    _sockets[socket->id] = socket;
+
+    *handle = to_handle(socket->id);
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t LoopbackNetworkStack::socket_close(nsapi_socket_t handle)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    // Peer reads the end of the stream after the data already sent
+    socket_t *peer = socket->connected ? find(socket->peer) : NULL;
+    if (peer) {
+        event_t event;
+        event.type = EVENT_FIN;
+        event.socket = peer->id;
+        event.from = socket->id;
+        schedule(std::max(_now + _config.latency_us, socket->last_delivery), event);
+    }
+
+    // Connections never accepted are reset
+    for (size_t i = 0; i < socket->accept_queue.size(); i++) {
+        socket_close(to_handle(socket->accept_queue[i]));
+    }
+
+    _sockets.erase(socket->id);
+    delete socket;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t LoopbackNetworkStack::socket_bind(nsapi_socket_t handle, const SocketAddress &address)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->port) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    uint16_t port = address.get_port();
+    if (!port) {
+        port = ephemeral_port(socket->proto);
+    } else if (find_port(socket->proto, port)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    socket->port = port;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t LoopbackNetworkStack::socket_listen(nsapi_socket_t handle, int backlog)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->proto != NSAPI_TCP || !socket->port || socket->connected) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    socket->listening = true;
+    socket->backlog = backlog > 0 ? backlog : 1;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t LoopbackNetworkStack::socket_connect(nsapi_socket_t handle, const SocketAddress &address)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->proto == NSAPI_UDP) {
+        return NSAPI_ERROR_OK;
+    }
+
+    if (socket->connected) {
+        return NSAPI_ERROR_IS_CONNECTED;
+    }
+
+    socket_t *server = find_port(NSAPI_TCP, address.get_port());
+    if (!server || !server->listening || server->accept_queue.size() >= (size_t) server->backlog) {
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    if (!socket->port) {
+        socket->port = ephemeral_port(NSAPI_TCP);
+    }
+
+    // Server side of the connection, accepted after the handshake
+    nsapi_socket_t accepted_handle;
+    socket_open(&accepted_handle, NSAPI_TCP);
+    socket_t *accepted = find(to_id(accepted_handle));
+    accepted->port = server->port;
+    accepted->connected = true;
+    accepted->peer = socket->id;
+    accepted->peer_port = socket->port;
+
+    socket->connected = true;
+    socket->peer = accepted->id;
+    socket->peer_port = server->port;
+
+    bool lost;
+    event_t event;
+    event.type = EVENT_ACCEPT;
+    event.socket = server->id;
+    event.from = accepted->id;
+    schedule(transmit(TCP_HEADER_SIZE, &lost), event);
+
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t LoopbackNetworkStack::socket_accept(nsapi_socket_t server,
+                                                  nsapi_socket_t *handle, SocketAddress *address)
+{
+    socket_t *socket = find(to_id(server));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (!socket->listening) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    while (socket->accept_queue.empty() && wait()) {
+        socket = find(to_id(server));
+        if (!socket) {
+            return NSAPI_ERROR_NO_SOCKET;
+        }
+    }
+
+    while (!socket->accept_queue.empty()) {
+        socket_t *accepted = find(socket->accept_queue.front());
+        socket->accept_queue.pop_front();
+        // Skips connections closed by the client before being accepted
+        if (accepted) {
+            *handle = to_handle(accepted->id);
+            if (address) {
+                address->set_ip_address(LOOPBACK_IP_ADDRESS);
+                address->set_port(accepted->peer_port);
+            }
+            return NSAPI_ERROR_OK;
+        }
+    }
+
+    return NSAPI_ERROR_WOULD_BLOCK;
+}
+
+nsapi_size_or_error_t LoopbackNetworkStack::socket_send(nsapi_socket_t handle,
+                                                        const void *data, nsapi_size_t size)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->proto != NSAPI_TCP || !socket->connected) {
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    socket_t *peer = find(socket->peer);
+    if (!peer) {
+        return NSAPI_ERROR_CONNECTION_LOST;
+    }
+
+    // Segments are delivered in order, a lost one holds back the ones after it
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    nsapi_size_t sent = 0;
+    while (sent < size) {
+        nsapi_size_t len = std::min<nsapi_size_t>(size - sent, TCP_MSS);
+
+        bool lost;
+        uint64_t delivery = transmit(len + TCP_HEADER_SIZE, &lost);
+        if (lost) {
+            delivery += TCP_RTO_US;
+        }
+        delivery = std::max(delivery, socket->last_delivery);
+        socket->last_delivery = delivery;
+
+        event_t event;
+        event.type = EVENT_PACKET;
+        event.socket = peer->id;
+        event.from = socket->id;
+        event.data.assign(bytes + sent, bytes + sent + len);
+        schedule(delivery, event);
+
+        _stats.bytes_sent += len;
+        sent += len;
+    }
+
+    return sent;
+}
+
+nsapi_size_or_error_t LoopbackNetworkStack::socket_recv(nsapi_socket_t handle,
+                                                        void *data, nsapi_size_t size)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->proto != NSAPI_TCP || !socket->connected) {
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    while (!readable(socket) && wait()) {
+        socket = find(to_id(handle));
+        if (!socket) {
+            return NSAPI_ERROR_NO_SOCKET;
+        }
+    }
+
+    // Stream, so reads across segments
+    uint8_t *bytes = static_cast<uint8_t *>(data);
+    nsapi_size_t received = 0;
+    while (received < size && !socket->rx.empty()) {
+        std::vector<uint8_t> &segment = socket->rx.front().second;
+        size_t len = std::min<size_t>(size - received, segment.size() - socket->rx_offset);
+        memcpy(bytes + received, &segment[socket->rx_offset], len);
+        received += len;
+        socket->rx_offset += len;
+        if (socket->rx_offset == segment.size()) {
+            socket->rx.pop_front();
+            socket->rx_offset = 0;
+        }
+    }
+
+    if (received == 0 && size > 0 && !socket->peer_closed) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    return received;
+}
+
+nsapi_size_or_error_t LoopbackNetworkStack::socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
+                                                          const void *data, nsapi_size_t size)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->proto == NSAPI_TCP) {
+        return socket_send(handle, data, size);
+    }
+
+    if (!socket->port) {
+        socket->port = ephemeral_port(NSAPI_UDP);
+    }
+
+    bool lost;
+    uint64_t delivery = transmit(size + UDP_HEADER_SIZE, &lost);
+    _stats.bytes_sent += size;
+
+    // Packets to ports nobody listens on are dropped like lost ones
+    socket_t *destination = find_port(NSAPI_UDP, address.get_port());
+    if (!lost && destination) {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        event_t event;
+        event.type = EVENT_PACKET;
+        event.socket = destination->id;
+        event.from = socket->id;
+        event.address.set_ip_address(LOOPBACK_IP_ADDRESS);
+        event.address.set_port(socket->port);
+        event.data.assign(bytes, bytes + size);
+        schedule(delivery, event);
+    }
+
+    return size;
+}
+
+nsapi_size_or_error_t LoopbackNetworkStack::socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
+                                                            void *buffer, nsapi_size_t size)
+{
+    socket_t *socket = find(to_id(handle));
+    if (!socket) {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    if (socket->proto == NSAPI_TCP) {
+        return socket_recv(handle, buffer, size);
+    }
+
+    while (socket->rx.empty() && wait()) {
+        socket = find(to_id(handle));
+        if (!socket) {
+            return NSAPI_ERROR_NO_SOCKET;
+        }
+    }
+
+    if (socket->rx.empty()) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    // Datagrams larger than the buffer are truncated
+    std::vector<uint8_t> &packet = socket->rx.front().second;
+    nsapi_size_t len = std::min<nsapi_size_t>(size, packet.size());
+    if (len) {
+        memcpy(buffer, &packet[0], len);
+    }
+    if (address) {
+        *address = socket->rx.front().first;
+    }
+    socket->rx.pop_front();
+
+    return len;
+}
+
+void LoopbackNetworkStack::socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data)
+{
+    socket_t *socket = find(to_id(handle));
+    if (socket) {
+        socket->callback = callback;
+        socket->data = data;
+    }
+}
+
+nsapi_error_t LoopbackNetworkStack::call_in(int delay, mbed::Callback<void()> func)
+{
+    event_t event;
+    event.type = EVENT_CALL;
+    event.socket = 0;
+    event.from = 0;
+    event.func = func;
+    schedule(_now + (uint64_t)(delay > 0 ? delay : 0) * 1000, event);
+    return NSAPI_ERROR_OK;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019, Arm Limited and affiliates
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOOPBACKNETWORKSTACK_H
+#define LOOPBACKNETWORKSTACK_H
+
+#include "netsocket/NetworkStack.h"
+#include <deque>
+#include <map>
+#include <vector>
+
+/* In-memory network stack, where every socket can reach every other socket
+ * opened on the same stack.
+ *
+ * Packets are delivered by destination port only, whatever the destination
+ * IP address, so a server bound to port 53 also answers DNS questions sent
+ * to public DNS servers. TCP is a reliable, ordered byte stream; UDP keeps
+ * datagram boundaries and loses packets.
+ *
+ * Time is virtual: packets are delivered, and call_in callbacks called, only
+ * when the stack is advanced. With auto-advance enabled (the default), a
+ * receive or accept that would block advances time until the socket has
+ * something to return or the network is idle, unless called from an event
+ * such as a sigio callback. Blocking socket calls then complete in a
+ * single-threaded test, and get_time_us() tells how long they would have
+ * taken on the configured link.
+ */
+class LoopbackNetworkStack : public NetworkStack {
+public:
+    /** Link shared by all traffic of the stack */
+    typedef struct {
+        uint32_t latency_us;    /**< One-way delay of each packet */
+        uint32_t bandwidth;     /**< Bytes per second, 0 for unlimited */
+        uint32_t loss_ppm;      /**< Lost packets, in parts per million */
+    } link_config_t;
+
+    /** Link statistics */
+    typedef struct {
+        uint32_t packets_sent;  /**< Packets sent, including lost ones */
+        uint32_t packets_lost;  /**< UDP packets dropped and TCP segments retransmitted */
+        uint64_t bytes_sent;    /**< Payload bytes sent */
+    } link_stats_t;
+
+    LoopbackNetworkStack();
+    virtual ~LoopbackNetworkStack();
+
+    /** Set latency, bandwidth and loss of the link, for packets sent from now on */
+    void set_link_config(const link_config_t &config);
+
+    /** Seed the pseudo-random packet loss, so that runs can be repeated */
+    void set_seed(uint32_t seed);
+
+    /** Enable or disable advancing time from blocked receives and accepts */
+    void set_auto_advance(bool enabled);
+
+    /** Get the virtual time in microseconds */
+    uint64_t get_time_us() const;
+
+    /** Advance time to the next event and run it
+     *
+     *  @return         True if an event was run, false if the network is idle
+     */
+    bool advance();
+
+    /** Run all events due until the given time, then set the time to it */
+    void advance_to(uint64_t time_us);
+
+    /** Run events until the network is idle */
+    void run_until_idle();
+
+    /** Get link statistics */
+    void get_link_stats(link_stats_t *stats) const;
+
+    virtual const char *get_ip_address();
+
+protected:
+    virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto);
+    virtual nsapi_error_t socket_close(nsapi_socket_t handle);
+    virtual nsapi_error_t socket_bind(nsapi_socket_t handle, const SocketAddress &address);
+    virtual nsapi_error_t socket_listen(nsapi_socket_t handle, int backlog);
+    virtual nsapi_error_t socket_connect(nsapi_socket_t handle, const SocketAddress &address);
+    virtual nsapi_error_t socket_accept(nsapi_socket_t server,
+                                        nsapi_socket_t *handle, SocketAddress *address = 0);
+    virtual nsapi_size_or_error_t socket_send(nsapi_socket_t handle,
+                                              const void *data, nsapi_size_t size);
+    virtual nsapi_size_or_error_t socket_recv(nsapi_socket_t handle,
+                                              void *data, nsapi_size_t size);
+    virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address,
+                                                const void *data, nsapi_size_t size);
+    virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
+                                                  void *buffer, nsapi_size_t size);
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data);
+
+private:
+    struct socket_t {
+        uint32_t id;
+        nsapi_protocol_t proto;
+        uint16_t port;
+        bool listening;
+        bool connected;
+        bool peer_closed;
+        uint32_t peer;
+        uint16_t peer_port;
+        int backlog;
+        std::deque<uint32_t> accept_queue;
+        std::deque<std::pair<SocketAddress, std::vector<uint8_t> > > rx;
+        size_t rx_offset;
+        uint64_t last_delivery;
+        void (*callback)(void *);
+        void *data;
+    };
+
+    enum event_type_t {
+        EVENT_PACKET,
+        EVENT_ACCEPT,
+        EVENT_FIN,
+        EVENT_CALL
+    };
+
+    struct event_t {
+        event_type_t type;
+        uint32_t socket;
+        uint32_t from;
+        SocketAddress address;
+        std::vector<uint8_t> data;
+        mbed::Callback<void()> func;
+    };
+
+    virtual nsapi_error_t call_in(int delay, mbed::Callback<void()> func);
+
+    socket_t *find(uint32_t id);
+    socket_t *find_port(nsapi_protocol_t proto, uint16_t port);
+    uint16_t ephemeral_port(nsapi_protocol_t proto);
+    uint64_t transmit(size_t size, bool *lost);
+    void schedule(uint64_t time, const event_t &event);
+    void run(event_t &event);
+    bool wait();
+    void signal(socket_t *socket);
+    bool readable(socket_t *socket);
+
+    std::map<uint32_t, socket_t *> _sockets;
+    std::multimap<uint64_t, event_t> _events;
+    link_config_t _config;
+    link_stats_t _stats;
+    uint64_t _now;
+    uint64_t _link_free;
+    uint32_t _next_id;
+    uint16_t _next_port;
+    uint32_t _random;
+    bool _auto_advance;
+    bool _in_event;
+};
+
+#endif // LOOPBACKNETWORKSTACK_H
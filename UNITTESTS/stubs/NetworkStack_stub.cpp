@@ -57,6 +57,50 @@ nsapi_error_t NetworkStack::getsockopt(void *handle, int level, int optname, voi
     return NSAPI_ERROR_UNSUPPORTED;
 }
 
+nsapi_size_or_error_t NetworkStack::socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+                                                   const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+                                                   const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recvmmsg(nsapi_socket_t handle, nsapi_msg_t *msgs, unsigned count)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+NetStackMemoryManager *NetworkStack::get_memory_manager()
+{
+    return NULL;
+}
+
+nsapi_error_t NetworkStack::get_stack_stats(nsapi_stack_stats_t *stats)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+size_t NetworkStack::get_pool_stats(nsapi_pool_stats_t *stats, size_t count)
+{
+    return 0;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_send_buf(nsapi_socket_t handle, const SocketAddress *address,
+                                                    net_stack_mem_buf_t *buf, nsapi_size_t offset)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recv_buf(nsapi_socket_t handle, SocketAddress *address,
+                                                    net_stack_mem_buf_t **buf)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
 // Conversion function for network stacks
 NetworkStack *nsapi_create_stack(nsapi_stack_t *stack)
 {
@@ -19,17 +19,79 @@
 #define NETWORKSTACKSTUB_H
 
 #include "netsocket/NetworkStack.h"
+#include "netsocket/NetStackMemoryManager.h"
 #include <list>
+#include <vector>
+
+// Memory manager of single, contiguous buffers
+class NetStackMemoryManagerstub : public NetStackMemoryManager {
+public:
+    int free_count;
+
+    NetStackMemoryManagerstub() :
+        free_count(0)
+    {
+    }
+
+    virtual net_stack_mem_buf_t *alloc_heap(uint32_t size, uint32_t align)
+    {
+        return new std::vector<uint8_t>(size);
+    }
+    virtual net_stack_mem_buf_t *alloc_pool(uint32_t size, uint32_t align)
+    {
+        return alloc_heap(size, align);
+    }
+    virtual uint32_t get_pool_alloc_unit(uint32_t align) const
+    {
+        return 1536;
+    }
+    virtual void free(net_stack_mem_buf_t *buf)
+    {
+        free_count++;
+        delete static_cast<std::vector<uint8_t> *>(buf);
+    }
+    virtual uint32_t get_total_len(const net_stack_mem_buf_t *buf) const
+    {
+        return get_len(buf);
+    }
+    virtual void copy(net_stack_mem_buf_t *to_buf, const net_stack_mem_buf_t *from_buf)
+    {
+        *static_cast<std::vector<uint8_t> *>(to_buf) = *static_cast<const std::vector<uint8_t> *>(from_buf);
+    }
+    virtual void cat(net_stack_mem_buf_t *to_buf, net_stack_mem_buf_t *cat_buf)
+    {
+    }
+    virtual net_stack_mem_buf_t *get_next(const net_stack_mem_buf_t *buf) const
+    {
+        return NULL;
+    }
+    virtual void *get_ptr(const net_stack_mem_buf_t *buf) const
+    {
+        return const_cast<uint8_t *>(static_cast<const std::vector<uint8_t> *>(buf)->data());
+    }
+    virtual uint32_t get_len(const net_stack_mem_buf_t *buf) const
+    {
+        return static_cast<const std::vector<uint8_t> *>(buf)->size();
+    }
+    virtual void set_len(net_stack_mem_buf_t *buf, uint32_t len)
+    {
+        static_cast<std::vector<uint8_t> *>(buf)->resize(len);
+    }
+};
 
 class NetworkStackstub : public NetworkStack {
 public:
     std::list<nsapi_error_t> return_values;
     nsapi_error_t return_value;
     SocketAddress return_socketAddress;
+    NetStackMemoryManager *memory_manager;
+    net_stack_mem_buf_t *return_buf;
 
     NetworkStackstub() :
         return_value(0),
-        return_socketAddress()
+        return_socketAddress(),
+        memory_manager(NULL),
+        return_buf(NULL)
     {
     }
 
@@ -42,6 +104,10 @@ public:
     {
         return return_value;
     }
+    virtual NetStackMemoryManager *get_memory_manager()
+    {
+        return memory_manager;
+    }
     virtual nsapi_value_or_error_t gethostbyname_async(const char *host, hostbyname_cb_t callback, nsapi_version_t version,
                                                        const char *interface_name)
     {
@@ -133,6 +199,56 @@ protected:
         }
         return return_value;
     };
+    virtual nsapi_size_or_error_t socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt)
+    {
+        if (!return_values.empty()) {
+            nsapi_error_t ret = return_values.front();
+            return_values.pop_front();
+            return ret;
+        }
+        return return_value;
+    };
+    virtual nsapi_size_or_error_t socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt)
+    {
+        if (address && return_socketAddress != SocketAddress()) {
+            *address = return_socketAddress;
+        }
+        if (!return_values.empty()) {
+            nsapi_error_t ret = return_values.front();
+            return_values.pop_front();
+            return ret;
+        }
+        return return_value;
+    };
+    virtual nsapi_size_or_error_t socket_send_buf(nsapi_socket_t handle, const SocketAddress *address,
+                                                  net_stack_mem_buf_t *buf, nsapi_size_t offset)
+    {
+        if (!return_values.empty()) {
+            nsapi_error_t ret = return_values.front();
+            return_values.pop_front();
+            return ret;
+        }
+        return return_value;
+    };
+    virtual nsapi_size_or_error_t socket_recv_buf(nsapi_socket_t handle, SocketAddress *address,
+                                                  net_stack_mem_buf_t **buf)
+    {
+        if (address && return_socketAddress != SocketAddress()) {
+            *address = return_socketAddress;
+        }
+        nsapi_error_t ret = return_value;
+        if (!return_values.empty()) {
+            ret = return_values.front();
+            return_values.pop_front();
+        }
+        if (ret >= 0) {
+            *buf = return_buf;
+            return_buf = NULL;
+        }
+        return ret;
+    };
     virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data) {};
 
 private:
@@ -61,3 +61,19 @@ void SocketStats::stats_update_recv_bytes(const Socket *const reference_id, size
 {
     return;
 }
+
+us_timestamp_t SocketStats::stats_get_time()
+{
+    return 0;
+}
+
+void SocketStats::stats_update_send(const Socket *const reference_id, us_timestamp_t start, nsapi_size_or_error_t sent_bytes)
+{
+    return;
+}
+
+void SocketStats::stats_update_recv(const Socket *const reference_id, us_timestamp_t start,
+                                    us_timestamp_t blocked_time, nsapi_size_or_error_t recv_bytes)
+{
+    return;
+}
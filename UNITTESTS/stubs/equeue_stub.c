@@ -32,6 +32,17 @@ int equeue_create_inplace(equeue_t *queue, size_t size, void *buffer)
     return 0;
 }
 
+int equeue_create_flags(equeue_t *queue, size_t size, unsigned flags)
+{
+    return 0;
+}
+
+int equeue_create_inplace_flags(equeue_t *queue, size_t size, void *buffer,
+                                unsigned flags)
+{
+    return 0;
+}
+
 void equeue_destroy(equeue_t *queue)
 {
 
@@ -42,6 +53,11 @@ void equeue_dispatch(equeue_t *queue, int ms)
 
 }
 
+void equeue_dispatch_worker(equeue_t *queue, int ms)
+{
+
+}
+
 void equeue_break(equeue_t *queue)
 {
 
@@ -67,6 +83,11 @@ void equeue_dealloc(equeue_t *queue, void *event)
 
 }
 
+void equeue_stats(equeue_t *queue, equeue_stats_t *stats)
+{
+
+}
+
 void equeue_event_delay(void *event, int ms)
 {
 
@@ -3,3 +3,8 @@ int mbed_error(int error_status, const char *error_msg, unsigned int error_value
 {
     return 0;
 }
+
+int mbed_warning(int error_status, const char *error_msg, unsigned int error_value, const char *filename, int line_number)
+{
+    return 0;
+}
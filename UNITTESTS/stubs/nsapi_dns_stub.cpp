@@ -46,3 +46,7 @@ extern "C" nsapi_error_t nsapi_dns_add_server(nsapi_addr_t addr, const char *int
 {
     return NSAPI_ERROR_OK;
 }
+
+extern "C" void nsapi_dns_reset(void)
+{
+}
@@ -113,7 +113,8 @@ QSPIFBlockDevice::QSPIFBlockDevice(PinName io0, PinName io1, PinName io2, PinNam
                                    int clock_mode, int freq)
     : _qspi(io0, io1, io2, io3, sclk, csel, clock_mode), _csel(csel), _freq(freq), _device_size_bytes(0),
       _init_ref_count(0),
-      _is_initialized(false)
+      _is_initialized(false),
+      _async_queue(this, MBED_CONF_QSPIF_ASYNC_QUEUE_DEPTH)
 {
     _unique_device_status = add_new_csel_instance(csel);
 
@@ -481,6 +482,26 @@ const char *QSPIFBlockDevice::get_type() const
     return "QSPIF";
 }
 
+int QSPIFBlockDevice::read_async(void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return _async_queue.read(buffer, addr, size, callback);
+}
+
+int QSPIFBlockDevice::program_async(const void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return _async_queue.program(buffer, addr, size, callback);
+}
+
+int QSPIFBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return _async_queue.erase(addr, size, callback);
+}
+
+uint32_t QSPIFBlockDevice::get_async_queue_depth() const
+{
+    return _async_queue.get_depth();
+}
+
 // Find minimal erase size supported by the region to which the address belongs to
 bd_size_t QSPIFBlockDevice::get_erase_size(bd_addr_t addr)
 {
@@ -18,6 +18,7 @@
 
 #include "QSPI.h"
 #include "BlockDevice.h"
+#include "BlockDeviceAsyncQueue.h"
 
 /** Enum qspif standard error codes
  *
@@ -123,6 +124,8 @@ public:
       */
     ~QSPIFBlockDevice()
     {
+        // Let pending asynchronous operations finish before the device goes away
+        _async_queue.stop();
         deinit();
     }
 
@@ -166,6 +169,52 @@ public:
      */
     virtual int erase(mbed::bd_addr_t addr, mbed::bd_size_t size);
 
+    /** Read blocks from a block device asynchronously
+     *
+     *  The read is executed by the block device worker thread, queuing up to MBED_CONF_QSPIF_ASYNC_QUEUE_DEPTH operations.
+     *  With the default depth of 0, the read completes synchronously.
+     *
+     *  @param buffer   Buffer to write blocks to, must stay valid until the callback is called
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @param callback Called from the block device worker thread with the result of read
+     *  @return         QSPIF_BD_ERROR_OK(0) - read was started
+     */
+    virtual int read_async(void *buffer, mbed::bd_addr_t addr, mbed::bd_size_t size,
+                           mbed::Callback<void(int)> callback);
+
+    /** Program blocks to a block device asynchronously
+     *
+     *  The program is executed by the block device worker thread, queuing up to MBED_CONF_QSPIF_ASYNC_QUEUE_DEPTH operations.
+     *  With the default depth of 0, the program completes synchronously.
+     *
+     *  @param buffer   Buffer of data to write to blocks, must stay valid until the callback is called
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @param callback Called from the block device worker thread with the result of program
+     *  @return         QSPIF_BD_ERROR_OK(0) - program was started
+     */
+    virtual int program_async(const void *buffer, mbed::bd_addr_t addr, mbed::bd_size_t size,
+                              mbed::Callback<void(int)> callback);
+
+    /** Erase blocks on a block device asynchronously
+     *
+     *  The erase is executed by the block device worker thread, queuing up to MBED_CONF_QSPIF_ASYNC_QUEUE_DEPTH operations.
+     *  With the default depth of 0, the erase completes synchronously.
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @param callback Called from the block device worker thread with the result of erase
+     *  @return         QSPIF_BD_ERROR_OK(0) - erase was started
+     */
+    virtual int erase_async(mbed::bd_addr_t addr, mbed::bd_size_t size, mbed::Callback<void(int)> callback);
+
+    /** Get the number of asynchronous operations that can be pending at once
+     *
+     *  @return         Queue depth, 0 if asynchronous operations complete synchronously
+     */
+    virtual uint32_t get_async_queue_depth() const;
+
     /** Get the size of a readable block
      *
      *  @return         Size of a readable block in bytes
@@ -363,6 +412,9 @@ private:
 
     uint32_t _init_ref_count;
     bool _is_initialized;
+
+    // Asynchronous operations
+    mbed::BlockDeviceAsyncQueue _async_queue;
 };
 
 #endif
@@ -82,11 +82,16 @@
  * just always use the Standard Capacity cards with a block size of 512 bytes.
  * This is set with CMD16.
  *
- * You can read and write single blocks (CMD17, CMD25) or multiple blocks
- * (CMD18, CMD25). For simplicity, I'll just use single block accesses. When
+ * You can read and write single blocks (CMD17, CMD24) or multiple blocks
+ * (CMD18, CMD25). Any access of more than one block uses the multiple block
+ * commands, so a contiguous range is transferred with a single command. When
  * the card gets a read command, it responds with a response token, and then
  * a data token or an error.
  *
+ * Data blocks are transferred in bulk. With the async-spi option, on targets
+ * supporting asynchronous SPI (DMA where available), the CRC16 of a block is
+ * computed while the next block is being transferred.
+ *
  * SPI Command Format
  * ------------------
  * Commands are 6-bytes long, containing the command, 32-bit argument, and CRC.
@@ -146,6 +151,7 @@
 #endif
 #include <inttypes.h>
 #include <errno.h>
+#include <string.h>
 
 using namespace mbed;
 
@@ -166,6 +172,7 @@ using namespace mbed;
 #define SD_CMD0_GO_IDLE_STATE_RETRIES            MBED_CONF_SD_CMD0_IDLE_STATE_RETRIES
 #define SD_DBG                                   0      /*!< 1 - Enable debugging */
 #define SD_CMD_TRACE                             0      /*!< 1 - Enable SD command tracing */
+#define SD_ASYNC_SPI                             (DEVICE_SPI_ASYNCH && MBED_CONF_SD_ASYNC_SPI)  /*!< Transfer data blocks with asynchronous SPI */
 
 #define SD_BLOCK_DEVICE_ERROR_WOULD_BLOCK        -5001  /*!< operation would block */
 #define SD_BLOCK_DEVICE_ERROR_UNSUPPORTED        -5002  /*!< unsupported operation */
@@ -481,7 +488,7 @@ int SDBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
         }
 
         // Write data
-        response = _write(buffer, SPI_START_BLOCK, _block_size);
+        response = _write_blocks(buffer, SPI_START_BLOCK, 1);
 
         // Only CRC and general write error are communicated via response token
         if (response != SPI_DATA_ACCEPTED) {
@@ -498,15 +505,12 @@ int SDBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
             return status;
         }
 
-        // Write the data: one block at a time
-        do {
-            response = _write(buffer, SPI_START_BLK_MUL_WRITE, _block_size);
-            if (response != SPI_DATA_ACCEPTED) {
-                debug_if(SD_DBG, "Multiple Block Write failed: 0x%x \n", response);
-                break;
-            }
-            buffer += _block_size;
-        } while (--blockCnt);     // Receive all blocks of data
+        // Write the data
+        response = _write_blocks(buffer, SPI_START_BLK_MUL_WRITE, blockCnt);
+        if (response != SPI_DATA_ACCEPTED) {
+            debug_if(SD_DBG, "Multiple Block Write failed: 0x%x \n", response);
+            status = SD_BLOCK_DEVICE_ERROR_WRITE;
+        }
 
         /* In a Multiple Block write operation, the stop transmission will be done by
          * sending 'Stop Tran' token instead of 'Start Block' token at the beginning
@@ -553,20 +557,16 @@ int SDBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
         return status;
     }
 
-    // receive the data : one block at a time
-    while (blockCnt) {
-        if (0 != _read(buffer, _block_size)) {
-            status = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
-            break;
-        }
-        buffer += _block_size;
-        --blockCnt;
-    }
+    // receive the data
+    status = _read_blocks(buffer, blockCnt);
     _deselect();
 
     // Send CMD12(0x00000000) to stop the transmission for multi-block transfer
     if (size > _block_size) {
-        status = _cmd(CMD12_STOP_TRANSMISSION, 0x0);
+        int stop_status = _cmd(CMD12_STOP_TRANSMISSION, 0x0);
+        if (BD_ERROR_OK == status) {
+            status = stop_status;
+        }
     }
     unlock();
     return status;
@@ -889,9 +889,7 @@ int SDBlockDevice::_read_bytes(uint8_t *buffer, uint32_t length)
     }
 
     // read data
-    for (uint32_t i = 0; i < length; i++) {
-        buffer[i] = _spi.write(SPI_FILL_CHAR);
-    }
+    _spi.write(NULL, 0, (char *)buffer, length);
 
     // Read the CRC16 checksum for the data block
     crc = (_spi.write(SPI_FILL_CHAR) << 8);
@@ -915,73 +913,182 @@ int SDBlockDevice::_read_bytes(uint8_t *buffer, uint32_t length)
     return 0;
 }
 
-int SDBlockDevice::_read(uint8_t *buffer, uint32_t length)
-{
-    uint16_t crc;
-
-    // read until start byte (0xFE)
-    if (false == _wait_token(SPI_START_BLOCK)) {
-        debug_if(SD_DBG, "Read timeout\n");
-        return SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
-    }
-
-    // read data
-    _spi.write(NULL, 0, (char *)buffer, length);
-
-    // Read the CRC16 checksum for the data block
-    crc = (_spi.write(SPI_FILL_CHAR) << 8);
-    crc |= _spi.write(SPI_FILL_CHAR);
-
 #if MBED_CONF_SD_CRC_ENABLED
+int SDBlockDevice::_check_crc(const uint8_t *buffer, uint16_t crc)
+{
     if (_crc_on) {
         uint32_t crc_result;
         // Compute and verify checksum
-        _crc16.compute((void *)buffer, length, &crc_result);
+        _crc16.compute((void *)buffer, _block_size, &crc_result);
         if ((uint16_t)crc_result != crc) {
-            debug_if(SD_DBG, "_read_bytes: Invalid CRC received 0x%" PRIx16 " result of computation 0x%" PRIx16 "\n",
+            debug_if(SD_DBG, "_read_blocks: Invalid CRC received 0x%" PRIx16 " result of computation 0x%" PRIx16 "\n",
                      crc, (uint16_t)crc_result);
             return SD_BLOCK_DEVICE_ERROR_CRC;
         }
     }
-#endif
-
     return 0;
 }
+#endif
 
-uint8_t SDBlockDevice::_write(const uint8_t *buffer, uint8_t token, uint32_t length)
+int SDBlockDevice::_read_blocks(uint8_t *buffer, uint32_t count)
 {
+    int status = 0;
+#if MBED_CONF_SD_CRC_ENABLED
+    const uint8_t *prev_buffer = NULL;
+    uint16_t prev_crc = 0;
+#endif
 
-    uint32_t crc = (~0);
-    uint8_t response = 0xFF;
+    while (count--) {
+        uint16_t crc;
+
+        // read until start byte (0xFE)
+        if (false == _wait_token(SPI_START_BLOCK)) {
+            debug_if(SD_DBG, "Read timeout\n");
+            return SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+        }
 
-    // indicate start of block
-    _spi.write(token);
+        // read data
+        _start_transfer(NULL, buffer, _block_size);
 
-    // write the data
-    _spi.write((char *)buffer, length, NULL, 0);
+#if MBED_CONF_SD_CRC_ENABLED
+        // Verify the previous block while this one is being transferred
+        if (prev_buffer) {
+            status = _check_crc(prev_buffer, prev_crc);
+        }
+#endif
+
+        if (false == _wait_transfer()) {
+            debug_if(SD_DBG, "Read transfer failed\n");
+            return SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+        }
+        if (status) {
+            return status;
+        }
+
+        // Read the CRC16 checksum for the data block
+        crc = (_spi.write(SPI_FILL_CHAR) << 8);
+        crc |= _spi.write(SPI_FILL_CHAR);
+
+#if MBED_CONF_SD_CRC_ENABLED
+        prev_buffer = buffer;
+        prev_crc = crc;
+#endif
+        buffer += _block_size;
+    }
+
+#if MBED_CONF_SD_CRC_ENABLED
+    if (prev_buffer) {
+        status = _check_crc(prev_buffer, prev_crc);
+    }
+#endif
+    return status;
+}
+
+uint8_t SDBlockDevice::_write_blocks(const uint8_t *buffer, uint8_t token, uint32_t count)
+{
+    uint32_t crc = (~0);
+    uint32_t next_crc = (~0);
+    uint8_t response = 0xFF;
 
 #if MBED_CONF_SD_CRC_ENABLED
     if (_crc_on) {
         // Compute CRC
-        _crc16.compute((void *)buffer, length, &crc);
+        _crc16.compute((void *)buffer, _block_size, &crc);
     }
 #endif
 
-    // write the checksum CRC16
-    _spi.write(crc >> 8);
-    _spi.write(crc);
+    while (count--) {
+        // indicate start of block
+        _spi.write(token);
+
+        // write the data
+        _start_transfer(buffer, NULL, _block_size);
+
+#if MBED_CONF_SD_CRC_ENABLED
+        // Compute the CRC of the next block while this one is being transferred
+        if (_crc_on && count) {
+            _crc16.compute((void *)(buffer + _block_size), _block_size, &next_crc);
+        }
+#endif
+
+        if (false == _wait_transfer()) {
+            debug_if(SD_DBG, "Write transfer failed\n");
+            response = SPI_DATA_WRITE_ERROR;
+            break;
+        }
+
+        // write the checksum CRC16
+        _spi.write(crc >> 8);
+        _spi.write(crc);
+
+        // check the response token
+        response = _spi.write(SPI_FILL_CHAR) & SPI_DATA_RESPONSE_MASK;
+
+        // Wait for last block to be written
+        if (false == _wait_ready(SD_COMMAND_TIMEOUT)) {
+            debug_if(SD_DBG, "Card not ready yet \n");
+        }
+
+        if (response != SPI_DATA_ACCEPTED) {
+            break;
+        }
+        buffer += _block_size;
+        crc = next_crc;
+    }
 
+    return response;
+}
 
-    // check the response token
-    response = _spi.write(SPI_FILL_CHAR);
+void SDBlockDevice::_start_transfer(const uint8_t *tx_buffer, uint8_t *rx_buffer, uint32_t length)
+{
+#if SD_ASYNC_SPI
+    if (!tx_buffer) {
+        // The fill character must be clocked out while receiving. Received bytes
+        // always lag transmitted ones, so the receive buffer can hold it.
+        memset(rx_buffer, SPI_FILL_CHAR, length);
+        tx_buffer = rx_buffer;
+    }
+
+    _transfer_event = 0;
+    if (0 == _spi.transfer(tx_buffer, length, rx_buffer, rx_buffer ? length : 0,
+                           callback(this, &SDBlockDevice::_transfer_complete),
+                           SPI_EVENT_COMPLETE | SPI_EVENT_ERROR)) {
+        return;
+    }
+
+    // The asynchronous transfer could not be started, fall back to a blocking one
+    _spi.write((const char *)tx_buffer, length, (char *)rx_buffer, rx_buffer ? length : 0);
+    _transfer_event = SPI_EVENT_COMPLETE;
+#else
+    _spi.write((const char *)tx_buffer, tx_buffer ? length : 0, (char *)rx_buffer, rx_buffer ? length : 0);
+#endif
+}
 
-    // Wait for last block to be written
-    if (false == _wait_ready(SD_COMMAND_TIMEOUT)) {
-        debug_if(SD_DBG, "Card not ready yet \n");
+bool SDBlockDevice::_wait_transfer()
+{
+#if SD_ASYNC_SPI
+    _spi_timer.reset();
+    _spi_timer.start();
+    while (0 == _transfer_event) {
+        if (_spi_timer.read_ms() >= SD_COMMAND_TIMEOUT) {
+            _spi_timer.stop();
+            _spi.abort_transfer();
+            return false;
+        }
     }
+    _spi_timer.stop();
+    return !(_transfer_event & SPI_EVENT_ERROR);
+#else
+    return true;
+#endif
+}
 
-    return (response & SPI_DATA_RESPONSE_MASK);
+#if SD_ASYNC_SPI
+void SDBlockDevice::_transfer_complete(int event)
+{
+    _transfer_event = event;
 }
+#endif
 
 static uint32_t ext_bits(unsigned char *data, int msb, int lsb)
 {
@@ -28,6 +28,10 @@
 #include "platform/platform.h"
 #include "platform/PlatformMutex.h"
 
+#ifndef MBED_CONF_SD_ASYNC_SPI
+#define MBED_CONF_SD_ASYNC_SPI 0
+#endif
+
 /** SDBlockDevice class
  *
  * Access an SD Card using SPI bus
@@ -227,9 +231,15 @@ private:
 
     bool _wait_token(uint8_t token);        /**< Wait for token */
     bool _wait_ready(uint16_t ms = 300);    /**< 300ms default wait for card to be ready */
-    int _read(uint8_t *buffer, uint32_t length);
     int _read_bytes(uint8_t *buffer, uint32_t length);
-    uint8_t _write(const uint8_t *buffer, uint8_t token, uint32_t length);
+    int _read_blocks(uint8_t *buffer, uint32_t count);          /**< Receive data blocks, after a read command */
+    uint8_t _write_blocks(const uint8_t *buffer, uint8_t token, uint32_t count);    /**< Send data blocks, after a write command */
+    void _start_transfer(const uint8_t *tx_buffer, uint8_t *rx_buffer, uint32_t length);   /**< Start a bulk transfer */
+    bool _wait_transfer();                  /**< Wait for the bulk transfer to complete, false on error or timeout */
+#if DEVICE_SPI_ASYNCH && MBED_CONF_SD_ASYNC_SPI
+    void _transfer_complete(int event);
+    volatile int _transfer_event;           /**< Events of the bulk transfer, 0 while in progress */
+#endif
     int _freq(void);
 
     /* Chip Select and SPI mode select */
@@ -258,6 +268,8 @@ private:
     bool _crc_on;
     mbed::MbedCRC<POLY_7BIT_SD, 7> _crc7;
     mbed::MbedCRC<POLY_16BIT_CCITT, 16> _crc16;
+
+    int _check_crc(const uint8_t *buffer, uint16_t crc);     /**< Verify the CRC16 of a data block */
 #endif
 };
 
@@ -0,0 +1,110 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "SDBlockDevice.h"
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+// test configuration
+#ifndef MBED_TEST_BUFFER
+#define MBED_TEST_BUFFER MBED_CONF_SD_TEST_BUFFER
+#endif
+
+#ifndef MBED_TEST_TIMEOUT
+#define MBED_TEST_TIMEOUT 300
+#endif
+
+#ifndef MBED_TEST_SD_FREQUENCY
+#define MBED_TEST_SD_FREQUENCY 25000000
+#endif
+
+// Total amount of data transferred by each benchmark
+#ifndef MBED_TEST_TRANSFER_SIZE
+#define MBED_TEST_TRANSFER_SIZE (256 * 1024)
+#endif
+
+SDBlockDevice bd(MBED_CONF_SD_SPI_MOSI, MBED_CONF_SD_SPI_MISO, MBED_CONF_SD_SPI_CLK, MBED_CONF_SD_SPI_CS,
+                 MBED_TEST_SD_FREQUENCY, MBED_CONF_SD_CRC_ENABLED);
+
+uint8_t rbuffer[MBED_TEST_BUFFER];
+uint8_t wbuffer[MBED_TEST_BUFFER];
+
+// Program and read back MBED_TEST_TRANSFER_SIZE bytes, in accesses of transfer_size bytes
+template <bd_size_t transfer_size>
+void test_throughput()
+{
+    TEST_SKIP_UNLESS_MESSAGE(transfer_size <= MBED_TEST_BUFFER, "Not enough memory for test");
+
+    int res = bd.init();
+    TEST_ASSERT_EQUAL(0, res);
+
+    srand(transfer_size);
+    for (bd_size_t i = 0; i < transfer_size; i++) {
+        wbuffer[i] = rand() & 0xff;
+    }
+
+    Timer timer;
+    timer.start();
+    for (bd_addr_t addr = 0; addr < MBED_TEST_TRANSFER_SIZE; addr += transfer_size) {
+        res = bd.program(wbuffer, addr, transfer_size);
+        TEST_ASSERT_EQUAL(0, res);
+    }
+    timer.stop();
+    int program_us = timer.read_us();
+
+    timer.reset();
+    timer.start();
+    for (bd_addr_t addr = 0; addr < MBED_TEST_TRANSFER_SIZE; addr += transfer_size) {
+        res = bd.read(rbuffer, addr, transfer_size);
+        TEST_ASSERT_EQUAL(0, res);
+    }
+    timer.stop();
+    int read_us = timer.read_us();
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(wbuffer, rbuffer, transfer_size);
+
+    printf("%6lu byte accesses: program %7lu KiB/s, read %7lu KiB/s\n", (unsigned long)transfer_size,
+           (unsigned long)((uint64_t)MBED_TEST_TRANSFER_SIZE * 1000000 / 1024 / program_us),
+           (unsigned long)((uint64_t)MBED_TEST_TRANSFER_SIZE * 1000000 / 1024 / read_us));
+
+    res = bd.deinit();
+    TEST_ASSERT_EQUAL(0, res);
+}
+
+// test setup
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(MBED_TEST_TIMEOUT, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Single block throughput", test_throughput<512>),
+    Case("4 block throughput", test_throughput<2048>),
+    Case("8 block throughput", test_throughput<4096>),
+    Case("16 block throughput", test_throughput<8192>),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -103,7 +103,8 @@ static unsigned int local_math_power(int base, int exp);
 //***********************
 SPIFBlockDevice::SPIFBlockDevice(
     PinName mosi, PinName miso, PinName sclk, PinName csel, int freq)
-    : _spi(mosi, miso, sclk), _cs(csel), _device_size_bytes(0), _is_initialized(false), _init_ref_count(0)
+    : _spi(mosi, miso, sclk), _cs(csel), _device_size_bytes(0), _is_initialized(false), _init_ref_count(0),
+      _async_queue(this, MBED_CONF_SPIF_DRIVER_ASYNC_QUEUE_DEPTH)
 {
     _address_size = SPIF_ADDR_SIZE_3_BYTES;
     // Initial SFDP read tables are read with 8 dummy cycles
@@ -478,6 +479,26 @@ const char *SPIFBlockDevice::get_type() const
     return "SPIF";
 }
 
+int SPIFBlockDevice::read_async(void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return _async_queue.read(buffer, addr, size, callback);
+}
+
+int SPIFBlockDevice::program_async(const void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return _async_queue.program(buffer, addr, size, callback);
+}
+
+int SPIFBlockDevice::erase_async(bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return _async_queue.erase(addr, size, callback);
+}
+
+uint32_t SPIFBlockDevice::get_async_queue_depth() const
+{
+    return _async_queue.get_depth();
+}
+
 /***************************************************/
 /*********** SPI Driver API Functions **************/
 /***************************************************/
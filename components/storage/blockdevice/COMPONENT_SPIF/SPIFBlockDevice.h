@@ -20,6 +20,7 @@
 #include "SPI.h"
 #include "DigitalOut.h"
 #include "BlockDevice.h"
+#include "BlockDeviceAsyncQueue.h"
 
 /** Enum spif standard error codes
  *
@@ -104,6 +105,8 @@ public:
       */
     ~SPIFBlockDevice()
     {
+        // Let pending asynchronous operations finish before the device goes away
+        _async_queue.stop();
         deinit();
     }
 
@@ -144,6 +147,52 @@ public:
      */
     virtual int erase(mbed::bd_addr_t addr, mbed::bd_size_t size);
 
+    /** Read blocks from a block device asynchronously
+     *
+     *  The read is executed by the block device worker thread, queuing up to MBED_CONF_SPIF_DRIVER_ASYNC_QUEUE_DEPTH operations.
+     *  With the default depth of 0, the read completes synchronously.
+     *
+     *  @param buffer   Buffer to write blocks to, must stay valid until the callback is called
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of read block size
+     *  @param callback Called from the block device worker thread with the result of read
+     *  @return         SPIF_BD_ERROR_OK(0) - read was started
+     */
+    virtual int read_async(void *buffer, mbed::bd_addr_t addr, mbed::bd_size_t size,
+                           mbed::Callback<void(int)> callback);
+
+    /** Program blocks to a block device asynchronously
+     *
+     *  The program is executed by the block device worker thread, queuing up to MBED_CONF_SPIF_DRIVER_ASYNC_QUEUE_DEPTH operations.
+     *  With the default depth of 0, the program completes synchronously.
+     *
+     *  @param buffer   Buffer of data to write to blocks, must stay valid until the callback is called
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of program block size
+     *  @param callback Called from the block device worker thread with the result of program
+     *  @return         SPIF_BD_ERROR_OK(0) - program was started
+     */
+    virtual int program_async(const void *buffer, mbed::bd_addr_t addr, mbed::bd_size_t size,
+                              mbed::Callback<void(int)> callback);
+
+    /** Erase blocks on a block device asynchronously
+     *
+     *  The erase is executed by the block device worker thread, queuing up to MBED_CONF_SPIF_DRIVER_ASYNC_QUEUE_DEPTH operations.
+     *  With the default depth of 0, the erase completes synchronously.
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of erase block size
+     *  @param callback Called from the block device worker thread with the result of erase
+     *  @return         SPIF_BD_ERROR_OK(0) - erase was started
+     */
+    virtual int erase_async(mbed::bd_addr_t addr, mbed::bd_size_t size, mbed::Callback<void(int)> callback);
+
+    /** Get the number of asynchronous operations that can be pending at once
+     *
+     *  @return         Queue depth, 0 if asynchronous operations complete synchronously
+     */
+    virtual uint32_t get_async_queue_depth() const;
+
     /** Get the size of a readable block
      *
      *  @return         Size of a readable block in bytes
@@ -301,6 +350,9 @@ private:
     unsigned int _dummy_and_mode_cycles; // Number of Dummy and Mode Bits required by Current Bus Mode
     uint32_t _init_ref_count;
     bool _is_initialized;
+
+    // Asynchronous operations
+    mbed::BlockDeviceAsyncQueue _async_queue;
 };
 
 #endif  /* MBED_SPIF_BLOCK_DEVICE_H */
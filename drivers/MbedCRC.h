@@ -22,6 +22,11 @@
 #include "platform/mbed_assert.h"
 #include "platform/SingletonPtr.h"
 #include "platform/PlatformMutex.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 /* This is invalid warning from the compiler for below section of code
 if ((width < 8) && (NULL == _crc_table)) {
@@ -481,10 +486,11 @@ private:
         } else {
             uint32_t *crc_table = (uint32_t *)_crc_table;
             if (POLY_32BIT_REV_ANSI == polynomial) {
-                for (crc_data_size_t i = 0; i < size; i++) {
-                    p_crc = (p_crc >> 4) ^ crc_table[(p_crc ^ (data[i] >> 0)) & 0xf];
-                    p_crc = (p_crc >> 4) ^ crc_table[(p_crc ^ (data[i] >> 4)) & 0xf];
-                }
+                p_crc = reflected_compute_partial(data, size, p_crc);
+            } else if ((POLY_32BIT_ANSI == polynomial) && _reflect_data) {
+                // With reflected data, the remainder of the reflected algorithm (LSB first) is
+                // the bit reflection of the remainder of the normal one
+                p_crc = reflect_32(reflected_compute_partial(data, size, reflect_32(p_crc)));
             } else {
                 for (crc_data_size_t byte = 0; byte < size; byte++) {
                     data_byte = reflect_bytes(data[byte]) ^ (p_crc >> (width - 8));
@@ -496,6 +502,76 @@ private:
         return 0;
     }
 
+    /** Reflect all 32 bits of a word.
+     *
+     * @param  data  value to be reflected
+     * @return  Reflected value
+     */
+    static uint32_t reflect_32(uint32_t data)
+    {
+        data = ((data >> 1) & 0x55555555) | ((data & 0x55555555) << 1);
+        data = ((data >> 2) & 0x33333333) | ((data & 0x33333333) << 2);
+        data = ((data >> 4) & 0x0F0F0F0F) | ((data & 0x0F0F0F0F) << 4);
+        data = ((data >> 8) & 0x00FF00FF) | ((data & 0x00FF00FF) << 8);
+        return (data >> 16) | (data << 16);
+    }
+
+    /** Reflected (LSB first) 32-bit CRC computation for POLY_32BIT_REV_ANSI.
+     *
+     *  Uses the CRC32 instructions where the core has them, otherwise the slice tables
+     *  (crc-table-slices bytes per iteration) or the nibble table.
+     *
+     * @param  data  data buffer
+     * @param  size  size of the data
+     * @param  p_crc  current CRC value
+     * @return  updated CRC value
+     */
+    static uint32_t reflected_compute_partial(const uint8_t *data, crc_data_size_t size, uint32_t p_crc)
+    {
+#if defined(__ARM_FEATURE_CRC32)
+        while (size && ((uintptr_t)data & 3)) {
+            p_crc = __crc32b(p_crc, *data++);
+            size--;
+        }
+        while (size >= 4) {
+            uint32_t word;
+            memcpy(&word, data, sizeof(word));
+            p_crc = __crc32w(p_crc, word);
+            data += 4;
+            size -= 4;
+        }
+        while (size--) {
+            p_crc = __crc32b(p_crc, *data++);
+        }
+#elif MBED_CRC_TABLE_SLICES > 1
+        const uint32_t (*table)[MBED_CRC_TABLE_SIZE] = Table_CRC_32bit_Rev_ANSI_Slice;
+        while (size >= MBED_CRC_TABLE_SLICES) {
+            uint32_t low = p_crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24));
+#if MBED_CRC_TABLE_SLICES > 4
+            uint32_t high = data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t)data[7] << 24);
+            p_crc = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^
+                    table[5][(low >> 16) & 0xff] ^ table[4][low >> 24] ^
+                    table[3][high & 0xff] ^ table[2][(high >> 8) & 0xff] ^
+                    table[1][(high >> 16) & 0xff] ^ table[0][high >> 24];
+#else
+            p_crc = table[3][low & 0xff] ^ table[2][(low >> 8) & 0xff] ^
+                    table[1][(low >> 16) & 0xff] ^ table[0][low >> 24];
+#endif
+            data += MBED_CRC_TABLE_SLICES;
+            size -= MBED_CRC_TABLE_SLICES;
+        }
+        while (size--) {
+            p_crc = (p_crc >> 8) ^ table[0][(p_crc ^ *data++) & 0xff];
+        }
+#else
+        for (crc_data_size_t i = 0; i < size; i++) {
+            p_crc = (p_crc >> 4) ^ Table_CRC_32bit_Rev_ANSI[(p_crc ^ (data[i] >> 0)) & 0xf];
+            p_crc = (p_crc >> 4) ^ Table_CRC_32bit_Rev_ANSI[(p_crc ^ (data[i] >> 4)) & 0xf];
+        }
+#endif
+        return p_crc;
+    }
+
     /** Constructor init called from all specialized cases of constructor.
      *  Note: All constructor common code should be in this function.
      */
@@ -27,12 +27,28 @@ namespace mbed {
 #define MBED_CRC_TABLE_SIZE             256
 #define MBED_OPTIMIZED_CRC_TABLE_SIZE   16
 
+/* Number of bytes the software 32-bit CRC consumes per table iteration. 1 uses the
+ * 64 byte nibble table, 4 and 8 use 4KB and 8KB slice tables.
+ */
+#ifdef MBED_CONF_DRIVERS_CRC_TABLE_SLICES
+#define MBED_CRC_TABLE_SLICES           MBED_CONF_DRIVERS_CRC_TABLE_SLICES
+#else
+#define MBED_CRC_TABLE_SLICES           1
+#endif
+
+#if (MBED_CRC_TABLE_SLICES != 1) && (MBED_CRC_TABLE_SLICES != 4) && (MBED_CRC_TABLE_SLICES != 8)
+#error "drivers.crc-table-slices must be 1, 4 or 8"
+#endif
+
 extern const uint8_t Table_CRC_7Bit_SD[MBED_CRC_TABLE_SIZE];
 extern const uint8_t Table_CRC_8bit_CCITT[MBED_CRC_TABLE_SIZE];
 extern const uint16_t Table_CRC_16bit_CCITT[MBED_CRC_TABLE_SIZE];
 extern const uint16_t Table_CRC_16bit_IBM[MBED_CRC_TABLE_SIZE];
 extern const uint32_t Table_CRC_32bit_ANSI[MBED_CRC_TABLE_SIZE];
 extern const uint32_t Table_CRC_32bit_Rev_ANSI[MBED_OPTIMIZED_CRC_TABLE_SIZE];
+#if MBED_CRC_TABLE_SLICES > 1
+extern const uint32_t Table_CRC_32bit_Rev_ANSI_Slice[MBED_CRC_TABLE_SLICES][MBED_CRC_TABLE_SIZE];
+#endif
 
 /** @}*/
 } // namespace mbed
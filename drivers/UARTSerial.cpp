@@ -184,10 +184,7 @@ ssize_t UARTSerial::write(const void *buffer, size_t length)
             } while (_txbuf.full());
         }
 
-        while (data_written < length && !_txbuf.full()) {
-            _txbuf.push(*buf_ptr++);
-            data_written++;
-        }
+        data_written += _txbuf.push(buf_ptr + data_written, length - data_written);
 
         core_util_critical_section_enter();
         if (_tx_enabled && !_tx_irq_enabled) {
@@ -226,10 +223,7 @@ ssize_t UARTSerial::read(void *buffer, size_t length)
         api_lock();
     }
 
-    while (data_read < length && !_rxbuf.empty()) {
-        _rxbuf.pop(*ptr++);
-        data_read++;
-    }
+    data_read = _rxbuf.pop(ptr, length);
 
     core_util_critical_section_enter();
     if (_rx_enabled && !_rx_irq_enabled) {
@@ -279,9 +279,13 @@ private:
 
     /** Software serial buffers
      *  By default buffer size is 256 for TX and 256 for RX. Configurable through mbed_app.json
+     *
+     *  The interrupt handlers are the only producer of _rxbuf and consumer
+     *  of _txbuf, and read and write run under _mutex, so the buffers need
+     *  no critical section per character.
      */
-    CircularBuffer<char, MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE> _rxbuf;
-    CircularBuffer<char, MBED_CONF_DRIVERS_UART_SERIAL_TXBUF_SIZE> _txbuf;
+    SPSCCircularBuffer<char, MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE> _rxbuf;
+    SPSCCircularBuffer<char, MBED_CONF_DRIVERS_UART_SERIAL_TXBUF_SIZE> _txbuf;
 
     PlatformMutex _mutex;
 
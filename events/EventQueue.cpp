@@ -21,12 +21,12 @@ using mbed::Callback;
 
 namespace events {
 
-EventQueue::EventQueue(unsigned event_size, unsigned char *event_pointer)
+EventQueue::EventQueue(unsigned event_size, unsigned char *event_pointer, unsigned flags)
 {
     if (!event_pointer) {
-        equeue_create(&_equeue, event_size);
+        equeue_create_flags(&_equeue, event_size, flags);
     } else {
-        equeue_create_inplace(&_equeue, event_size, event_pointer);
+        equeue_create_inplace_flags(&_equeue, event_size, event_pointer, flags);
     }
 }
 
@@ -40,6 +40,11 @@ void EventQueue::dispatch(int ms)
     return equeue_dispatch(&_equeue, ms);
 }
 
+void EventQueue::dispatch_worker(int ms)
+{
+    return equeue_dispatch_worker(&_equeue, ms);
+}
+
 void EventQueue::break_dispatch()
 {
     return equeue_break(&_equeue);
@@ -60,6 +65,11 @@ int EventQueue::time_left(int id)
     return equeue_timeleft(&_equeue, id);
 }
 
+void EventQueue::get_stats(equeue_stats_t *stats)
+{
+    return equeue_stats(&_equeue, stats);
+}
+
 void EventQueue::background(Callback<void(int)> update)
 {
     _update = update;
@@ -60,8 +60,14 @@ public:
      *                  (default to EVENTS_QUEUE_SIZE)
      *  @param buffer   Pointer to buffer to use for events
      *                  (default to NULL)
+     *  @param flags    Queue creation flags, EQUEUE_SCHED_HEAP selects a
+     *                  scheduler better suited to many pending delayed events,
+     *                  EQUEUE_IMMEDIATE_LANE posts undelayed events without
+     *                  entering a critical section
+     *                  (default to EQUEUE_SCHED_LIST)
      */
-    EventQueue(unsigned size = EVENTS_QUEUE_SIZE, unsigned char *buffer = NULL);
+    EventQueue(unsigned size = EVENTS_QUEUE_SIZE, unsigned char *buffer = NULL,
+               unsigned flags = EQUEUE_SCHED_LIST);
 
     /** Destroy an EventQueue
      */
@@ -95,6 +101,35 @@ public:
         dispatch();
     }
 
+    /** Dispatch events as one of several workers
+     *
+     *  Executes events like the dispatch function, but may be called from
+     *  multiple threads on the same queue at once. Each worker keeps a
+     *  local list of expired events and steals from other workers once its
+     *  own list runs out, while delayed events stay ordered in the queue.
+     *
+     *  Events dispatched by different workers may execute concurrently and
+     *  in any order. A call to break_dispatch stops every worker that is
+     *  dispatching at the time of the call.
+     *
+     *  @param ms       Time to wait for events in milliseconds, a negative
+     *                  value will dispatch events indefinitely
+     *                  (default to -1)
+     */
+    void dispatch_worker(int ms = -1);
+
+    /** Dispatch events as one of several workers without a timeout
+     *
+     *  This is equivalent to EventQueue::dispatch_worker with no arguments,
+     *  but avoids overload ambiguities when passed as a callback.
+     *
+     *  @see EventQueue::dispatch_worker
+     */
+    void dispatch_worker_forever()
+    {
+        dispatch_worker();
+    }
+
     /** Break out of a running event loop
      *
      *  Forces the specified event queue's dispatch loop to terminate. Pending
@@ -149,6 +184,18 @@ public:
      */
     int time_left(int id);
 
+    /** Query event allocator statistics
+     *
+     *  Fills in a snapshot of the event buffer usage, including its
+     *  high-water mark and the number of allocations that failed due to
+     *  fragmentation, so that the queue size can be chosen from measurements.
+     *
+     *  This function is IRQ safe.
+     *
+     *  @param stats    Pointer to the statistics to fill in
+     */
+    void get_stats(equeue_stats_t *stats);
+
     /** Background an event queue onto a single-shot timer-interrupt
      *
      *  When updated, the event queue will call the provided update function
@@ -48,6 +48,16 @@ static inline void equeue_incid(equeue_t *q, struct equeue_event *e)
 
 // equeue lifetime management
 int equeue_create(equeue_t *q, size_t size)
+{
+    return equeue_create_flags(q, size, EQUEUE_SCHED_LIST);
+}
+
+int equeue_create_inplace(equeue_t *q, size_t size, void *buffer)
+{
+    return equeue_create_inplace_flags(q, size, buffer, EQUEUE_SCHED_LIST);
+}
+
+int equeue_create_flags(equeue_t *q, size_t size, unsigned flags)
 {
     // dynamically allocate the specified buffer
     void *buffer = malloc(size);
@@ -55,29 +65,39 @@ int equeue_create(equeue_t *q, size_t size)
         return -1;
     }
 
-    int err = equeue_create_inplace(q, size, buffer);
+    int err = equeue_create_inplace_flags(q, size, buffer, flags);
     q->allocated = buffer;
     return err;
 }
 
-int equeue_create_inplace(equeue_t *q, size_t size, void *buffer)
+int equeue_create_inplace_flags(equeue_t *q, size_t size, void *buffer,
+                                unsigned flags)
 {
     // setup queue around provided buffer
     q->buffer = buffer;
     q->allocated = 0;
+    q->flags = flags;
 
     q->npw2 = 0;
     for (unsigned s = size; s; s >>= 1) {
         q->npw2++;
     }
 
-    q->chunks = 0;
+    for (int i = 0; i < EQUEUE_CHUNK_CLASSES; i++) {
+        q->chunks[i] = 0;
+    }
     q->slab.size = size;
     q->slab.data = buffer;
+    memset(&q->mem_stats, 0, sizeof(q->mem_stats));
 
     q->queue = 0;
+    q->lane = 0;
+    q->workers = 0;
+    q->donor = 0;
+    q->break_waiting = 0;
     q->tick = equeue_tick();
     q->generation = 0;
+    q->seq = 0;
     q->break_requested = false;
 
     q->background.active = false;
@@ -107,14 +127,39 @@ int equeue_create_inplace(equeue_t *q, size_t size, void *buffer)
 void equeue_destroy(equeue_t *q)
 {
     // call destructors on pending events
-    for (struct equeue_event *es = q->queue; es; es = es->next) {
-        for (struct equeue_event *e = es->sibling; e; e = e->sibling) {
-            if (e->dtor) {
-                e->dtor(e + 1);
+    if (q->flags & EQUEUE_SCHED_HEAP) {
+        // the heap is a binary tree of children (next) and siblings
+        // (sibling), rotate children out of the way to walk it in place
+        struct equeue_event *e = q->queue;
+        while (e) {
+            if (e->next) {
+                struct equeue_event *c = e->next;
+                e->next = c->sibling;
+                c->sibling = e;
+                e = c;
+            } else {
+                struct equeue_event *sibling = e->sibling;
+                if (e->dtor) {
+                    e->dtor(e + 1);
+                }
+                e = sibling;
+            }
+        }
+    } else {
+        for (struct equeue_event *es = q->queue; es; es = es->next) {
+            for (struct equeue_event *e = es->sibling; e; e = e->sibling) {
+                if (e->dtor) {
+                    e->dtor(e + 1);
+                }
+            }
+            if (es->dtor) {
+                es->dtor(es + 1);
             }
         }
-        if (es->dtor) {
-            es->dtor(es + 1);
+    }
+    for (struct equeue_event *e = q->lane; e; e = e->next) {
+        if (e->dtor) {
+            e->dtor(e + 1);
         }
     }
     // notify background timer
@@ -131,6 +176,26 @@ void equeue_destroy(equeue_t *q)
 
 
 // equeue chunk allocation functions
+static inline unsigned equeue_chunk_class(size_t size)
+{
+    // class n holds chunks of 2^n up to 2^(n+1) event headers
+    unsigned c = 0;
+    for (size_t s = size / sizeof(struct equeue_event);
+            s > 1 && c < EQUEUE_CHUNK_CLASSES - 1; s >>= 1) {
+        c++;
+    }
+    return c;
+}
+
+static inline void equeue_mem_account(equeue_t *q, struct equeue_event *e)
+{
+    q->mem_stats.used += e->size;
+    if (q->mem_stats.used > q->mem_stats.max_used) {
+        q->mem_stats.max_used = q->mem_stats.used;
+    }
+    q->mem_stats.alloc_count += 1;
+}
+
 static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size)
 {
     // add event overhead
@@ -139,8 +204,15 @@ static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size)
 
     equeue_mutex_lock(&q->memlock);
 
-    // check if a good chunk is available
-    for (struct equeue_event **p = &q->chunks; *p; p = &(*p)->next) {
+    // check if a good chunk is available in the size's own class, chunks
+    // are kept in free order with same-sized neighbours stacked as siblings
+    //
+    // this is a first fit over the chunks of the class, requests are not
+    // rounded up to the class size since that would waste up to half of
+    // each chunk and a queue of n EQUEUE_EVENT_SIZE bytes would no longer
+    // fit n events
+    unsigned c = equeue_chunk_class(size);
+    for (struct equeue_event **p = &q->chunks[c]; *p; p = &(*p)->next) {
         if ((*p)->size >= size) {
             struct equeue_event *e = *p;
             if (e->sibling) {
@@ -150,6 +222,25 @@ static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size)
                 *p = e->next;
             }
 
+            equeue_mem_account(q, e);
+            equeue_mutex_unlock(&q->memlock);
+            return e;
+        }
+    }
+
+    // any chunk in a larger class fits, take the smallest class
+    for (unsigned i = c + 1; i < EQUEUE_CHUNK_CLASSES; i++) {
+        struct equeue_event **p = &q->chunks[i];
+        if (*p) {
+            struct equeue_event *e = *p;
+            if (e->sibling) {
+                *p = e->sibling;
+                (*p)->next = e->next;
+            } else {
+                *p = e->next;
+            }
+
+            equeue_mem_account(q, e);
             equeue_mutex_unlock(&q->memlock);
             return e;
         }
@@ -163,10 +254,18 @@ static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size)
         e->size = size;
         e->id = 1;
 
+        equeue_mem_account(q, e);
         equeue_mutex_unlock(&q->memlock);
         return e;
     }
 
+    // record whether we failed due to fragmentation
+    size_t carved = q->slab.data - q->buffer;
+    if (carved - q->mem_stats.used + q->slab.size >= size) {
+        q->mem_stats.frag_fail_count += 1;
+    }
+    q->mem_stats.alloc_fail_count += 1;
+
     equeue_mutex_unlock(&q->memlock);
     return 0;
 }
@@ -175,12 +274,9 @@ static void equeue_mem_dealloc(equeue_t *q, struct equeue_event *e)
 {
     equeue_mutex_lock(&q->memlock);
 
-    // stick chunk into list of chunks
-    struct equeue_event **p = &q->chunks;
-    while (*p && (*p)->size < e->size) {
-        p = &(*p)->next;
-    }
-
+    // push chunk onto the front of its class, stacking it on the first
+    // chunk if they have the same size, in constant time
+    struct equeue_event **p = &q->chunks[equeue_chunk_class(e->size)];
     if (*p && (*p)->size == e->size) {
         e->sibling = *p;
         e->next = (*p)->next;
@@ -190,6 +286,22 @@ static void equeue_mem_dealloc(equeue_t *q, struct equeue_event *e)
     }
     *p = e;
 
+    q->mem_stats.used -= e->size;
+    equeue_mutex_unlock(&q->memlock);
+}
+
+void equeue_stats(equeue_t *q, equeue_stats_t *stats)
+{
+    equeue_mutex_lock(&q->memlock);
+    size_t carved = q->slab.data - q->buffer;
+    stats->size = carved + q->slab.size;
+    stats->used = q->mem_stats.used;
+    stats->max_used = q->mem_stats.max_used;
+    stats->cached = carved - q->mem_stats.used;
+    stats->slab = q->slab.size;
+    stats->alloc_count = q->mem_stats.alloc_count;
+    stats->alloc_fail_count = q->mem_stats.alloc_fail_count;
+    stats->frag_fail_count = q->mem_stats.frag_fail_count;
     equeue_mutex_unlock(&q->memlock);
 }
 
@@ -219,16 +331,111 @@ void equeue_dealloc(equeue_t *q, void *p)
 }
 
 
-// equeue scheduling functions
-static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick)
+// equeue pairing heap functions
+//
+// In heap mode each event is a node of a pairing heap, with next pointing
+// to the first child, sibling pointing to the next sibling, and ref
+// pointing to whichever pointer refers to the event. q->queue is the root
+// and therefore always the earliest event.
+static inline bool equeue_heap_before(struct equeue_event *a,
+                                      struct equeue_event *b)
 {
-    // setup event and hash local id with buffer offset for unique id
-    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
-    e->target = tick + equeue_clampdiff(e->target, tick);
-    e->generation = q->generation;
+    // order by deadline, then by post order, the sequence number is
+    // compared with wraparound so only its recent history matters
+    int diff = equeue_tickdiff(a->target, b->target);
+    return diff < 0 || (diff == 0 && (int16_t)(uint16_t)(a->seq - b->seq) < 0);
+}
 
-    equeue_mutex_lock(&q->queuelock);
+static struct equeue_event *equeue_heap_meld(struct equeue_event *a,
+                                             struct equeue_event *b)
+{
+    if (!a) {
+        return b;
+    } else if (!b) {
+        return a;
+    }
 
+    if (equeue_heap_before(b, a)) {
+        struct equeue_event *t = a;
+        a = b;
+        b = t;
+    }
+
+    // b becomes the first child of a
+    b->sibling = a->next;
+    if (b->sibling) {
+        b->sibling->ref = &b->sibling;
+    }
+    a->next = b;
+    b->ref = &a->next;
+    return a;
+}
+
+static struct equeue_event *equeue_heap_mergepairs(struct equeue_event *es)
+{
+    // meld pairs left to right, collecting them in reverse order
+    struct equeue_event *pairs = 0;
+    while (es) {
+        struct equeue_event *a = es;
+        struct equeue_event *b = a->sibling;
+        es = b ? b->sibling : 0;
+
+        a = equeue_heap_meld(a, b);
+        a->sibling = pairs;
+        pairs = a;
+    }
+
+    // meld the pairs right to left into a single heap
+    struct equeue_event *root = 0;
+    while (pairs) {
+        struct equeue_event *a = pairs;
+        pairs = a->sibling;
+        a->sibling = 0;
+        root = equeue_heap_meld(root, a);
+    }
+
+    return root;
+}
+
+static inline void equeue_heap_setroot(equeue_t *q, struct equeue_event *e)
+{
+    q->queue = e;
+    if (e) {
+        e->sibling = 0;
+        e->ref = &q->queue;
+    }
+}
+
+static void equeue_heap_insert(equeue_t *q, struct equeue_event *e)
+{
+    e->seq = q->seq++;
+    e->next = 0;
+    e->sibling = 0;
+    equeue_heap_setroot(q, equeue_heap_meld(q->queue, e));
+}
+
+static void equeue_heap_remove(equeue_t *q, struct equeue_event *e)
+{
+    *e->ref = e->sibling;
+    if (e->sibling) {
+        e->sibling->ref = e->ref;
+    }
+
+    equeue_heap_setroot(q, equeue_heap_meld(q->queue,
+                                            equeue_heap_mergepairs(e->next)));
+}
+
+static struct equeue_event *equeue_heap_pop(equeue_t *q)
+{
+    struct equeue_event *e = q->queue;
+    equeue_heap_setroot(q, equeue_heap_mergepairs(e->next));
+    return e;
+}
+
+
+// equeue scheduling functions
+static void equeue_list_insert(equeue_t *q, struct equeue_event *e)
+{
     // find the event slot
     struct equeue_event **p = &q->queue;
     while (*p && equeue_tickdiff((*p)->target, e->target) < 0) {
@@ -255,6 +462,22 @@ static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick)
 
     *p = e;
     e->ref = p;
+}
+
+static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick)
+{
+    // setup event and hash local id with buffer offset for unique id
+    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
+    e->target = tick + equeue_clampdiff(e->target, tick);
+
+    equeue_mutex_lock(&q->queuelock);
+    e->generation = q->generation;
+
+    if (q->flags & EQUEUE_SCHED_HEAP) {
+        equeue_heap_insert(q, e);
+    } else {
+        equeue_list_insert(q, e);
+    }
 
     // notify background timer
     if ((q->background.update && q->background.active) &&
@@ -268,6 +491,49 @@ static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick)
     return id;
 }
 
+static int equeue_lane_push(equeue_t *q, struct equeue_event *e, unsigned tick)
+{
+    // setup event and hash local id with buffer offset for unique id, a null
+    // ref marks the event as not yet in the queue
+    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
+    e->target = tick;
+    e->ref = 0;
+
+    // a failed swap loads the current head
+    void *head = 0;
+    do {
+        e->next = head;
+    } while (!equeue_atomic_cas_ptr(&q->lane, &head, e));
+
+    return id;
+}
+
+static void equeue_lane_drain(equeue_t *q, unsigned tick)
+{
+    // take the whole lane, it is a stack so reverse it to match post order
+    struct equeue_event *lane = equeue_atomic_exchange_ptr(&q->lane, 0);
+    struct equeue_event *es = 0;
+    while (lane) {
+        struct equeue_event *e = lane;
+        lane = e->next;
+        e->next = es;
+        es = e;
+    }
+
+    while (es) {
+        struct equeue_event *e = es;
+        es = e->next;
+
+        e->target = tick + equeue_clampdiff(e->target, tick);
+        e->generation = q->generation;
+        if (q->flags & EQUEUE_SCHED_HEAP) {
+            equeue_heap_insert(q, e);
+        } else {
+            equeue_list_insert(q, e);
+        }
+    }
+}
+
 static struct equeue_event *equeue_unqueue(equeue_t *q, int id)
 {
     // decode event from unique id and check that the local id matches
@@ -290,8 +556,16 @@ static struct equeue_event *equeue_unqueue(equeue_t *q, int id)
         return 0;
     }
 
+    // events still in the lane are released by the dispatch loop
+    if (!e->ref) {
+        equeue_mutex_unlock(&q->queuelock);
+        return 0;
+    }
+
     // disentangle from queue
-    if (e->sibling) {
+    if (q->flags & EQUEUE_SCHED_HEAP) {
+        equeue_heap_remove(q, e);
+    } else if (e->sibling) {
         e->sibling->next = e->next;
         if (e->sibling->next) {
             e->sibling->next->ref = &e->sibling->next;
@@ -316,12 +590,31 @@ static struct equeue_event *equeue_dequeue(equeue_t *q, unsigned target)
 {
     equeue_mutex_lock(&q->queuelock);
 
+    // pick up immediate events posted without the lock
+    if (q->flags & EQUEUE_IMMEDIATE_LANE) {
+        equeue_lane_drain(q, target);
+    }
+
     // find all expired events and mark a new generation
     q->generation += 1;
     if (equeue_tickdiff(q->tick, target) <= 0) {
         q->tick = target;
     }
 
+    if (q->flags & EQUEUE_SCHED_HEAP) {
+        // pop expired events in order, these are already flat
+        struct equeue_event *head = 0;
+        struct equeue_event **tail = &head;
+        while (q->queue && equeue_tickdiff(q->queue->target, target) <= 0) {
+            *tail = equeue_heap_pop(q);
+            tail = &(*tail)->next;
+        }
+        *tail = 0;
+
+        equeue_mutex_unlock(&q->queuelock);
+        return head;
+    }
+
     struct equeue_event *head = q->queue;
     struct equeue_event **p = &head;
     while (*p && equeue_tickdiff((*p)->target, target) <= 0) {
@@ -362,9 +655,16 @@ int equeue_post(equeue_t *q, void (*cb)(void *), void *p)
     struct equeue_event *e = (struct equeue_event *)p - 1;
     unsigned tick = equeue_tick();
     e->cb = cb;
-    e->target = tick + e->target;
 
-    int id = equeue_enqueue(q, e, tick);
+    int id;
+    if ((q->flags & EQUEUE_IMMEDIATE_LANE) && !e->target &&
+            !q->background.update) {
+        id = equeue_lane_push(q, e, tick);
+    } else {
+        e->target = tick + e->target;
+        id = equeue_enqueue(q, e, tick);
+    }
+
     equeue_sema_signal(&q->eventsema);
     return id;
 }
@@ -404,39 +704,201 @@ int equeue_timeleft(equeue_t *q, int id)
 void equeue_break(equeue_t *q)
 {
     equeue_mutex_lock(&q->queuelock);
-    q->break_requested = true;
+    if (!q->workers) {
+        q->break_requested = true;
+    }
+
+    // each worker present now leaves exactly once, workers that are
+    // waiting need a wakeup which they pass on to each other
+    for (struct equeue_worker *w = q->workers; w; w = w->next) {
+        if (!w->break_requested) {
+            w->break_requested = true;
+            q->break_waiting += w->waiting;
+        }
+    }
     equeue_mutex_unlock(&q->queuelock);
     equeue_sema_signal(&q->eventsema);
 }
 
-void equeue_dispatch(equeue_t *q, int ms)
+static void equeue_dispatch_event(equeue_t *q, struct equeue_event *e)
+{
+    // actually dispatch the callbacks
+    void (*cb)(void *) = e->cb;
+    if (cb) {
+        cb(e + 1);
+    }
+
+    // reenqueue periodic events or deallocate
+    if (e->period >= 0) {
+        e->target += e->period;
+        equeue_enqueue(q, e, equeue_tick());
+    } else {
+        equeue_incid(q, e);
+        equeue_dealloc(q, e + 1);
+    }
+}
+
+
+// equeue worker functions
+static void equeue_worker_push(equeue_t *q, struct equeue_worker *w,
+                               struct equeue_event *es,
+                               struct equeue_event *tail, unsigned count)
+{
+    if (!es) {
+        return;
+    }
+
+    equeue_mutex_lock(&w->lock);
+    tail->next = w->head;
+    if (!w->head) {
+        w->tail = tail;
+    }
+    w->head = es;
+    w->count += count;
+    count = w->count;
+    equeue_mutex_unlock(&w->lock);
+
+    // offer the local events to an idle worker
+    if (count > 1) {
+        equeue_mutex_lock(&q->queuelock);
+        q->donor = w;
+        equeue_mutex_unlock(&q->queuelock);
+        equeue_sema_signal(&q->eventsema);
+    }
+}
+
+static struct equeue_event *equeue_worker_pop(struct equeue_worker *w)
+{
+    equeue_mutex_lock(&w->lock);
+    struct equeue_event *e = w->head;
+    if (e) {
+        w->head = e->next;
+        w->count -= 1;
+        if (!w->head) {
+            w->tail = 0;
+        }
+    }
+    equeue_mutex_unlock(&w->lock);
+
+    return e;
+}
+
+static struct equeue_event *equeue_worker_steal(equeue_t *q,
+                                                struct equeue_worker *w)
+{
+    struct equeue_event *es = 0;
+    struct equeue_event *tail = 0;
+    unsigned count = 0;
+
+    // take all but the next event of the donor, queuelock keeps the
+    // donor from leaving while we look at it
+    equeue_mutex_lock(&q->queuelock);
+    struct equeue_worker *v = q->donor;
+    if (v && v != w) {
+        equeue_mutex_lock(&v->lock);
+        if (v->count > 1) {
+            es = v->head->next;
+            tail = v->tail;
+            count = v->count - 1;
+
+            v->head->next = 0;
+            v->tail = v->head;
+            v->count = 1;
+        }
+        equeue_mutex_unlock(&v->lock);
+    }
+    equeue_mutex_unlock(&q->queuelock);
+
+    if (!es) {
+        return 0;
+    }
+
+    // keep the first stolen event, queue up the rest
+    if (es != tail) {
+        equeue_worker_push(q, w, es->next, tail, count - 1);
+    }
+    es->next = 0;
+    return es;
+}
+
+static void equeue_worker_leave(equeue_t *q, struct equeue_worker *w)
+{
+    // must be called with queuelock held
+    struct equeue_worker **p = &q->workers;
+    while (*p != w) {
+        p = &(*p)->next;
+    }
+    *p = w->next;
+
+    if (q->donor == w) {
+        q->donor = 0;
+    }
+}
+
+static bool equeue_worker_wait(equeue_t *q, struct equeue_worker *w,
+                               int deadline)
+{
+    // must be called with queuelock held, returns true if the worker
+    // left because of a break
+    if (w->break_requested) {
+        equeue_worker_leave(q, w);
+        return true;
+    }
+
+    w->waiting = true;
+    equeue_mutex_unlock(&q->queuelock);
+    equeue_sema_wait(&q->eventsema, deadline);
+    equeue_mutex_lock(&q->queuelock);
+    w->waiting = false;
+
+    bool leave = w->break_requested;
+    if (leave) {
+        q->break_waiting -= 1;
+        equeue_worker_leave(q, w);
+    }
+
+    // the wakeup may have been meant for another waiting worker
+    if (q->break_waiting) {
+        equeue_sema_signal(&q->eventsema);
+    }
+
+    return leave;
+}
+
+static void equeue_dispatch_loop(equeue_t *q, int ms, struct equeue_worker *w)
 {
     unsigned tick = equeue_tick();
     unsigned timeout = tick + ms;
-    q->background.active = false;
+    if (!w) {
+        q->background.active = false;
+    }
 
     while (1) {
         // collect all the available events and next deadline
         struct equeue_event *es = equeue_dequeue(q, tick);
 
         // dispatch events
-        while (es) {
-            struct equeue_event *e = es;
-            es = e->next;
-
-            // actually dispatch the callbacks
-            void (*cb)(void *) = e->cb;
-            if (cb) {
-                cb(e + 1);
+        if (!w) {
+            while (es) {
+                struct equeue_event *e = es;
+                es = e->next;
+                equeue_dispatch_event(q, e);
+            }
+        } else {
+            // workers run their local events first, then help out
+            // other workers until there is nothing left to steal
+            struct equeue_event *tail = es;
+            unsigned count = es ? 1 : 0;
+            while (tail && tail->next) {
+                tail = tail->next;
+                count++;
             }
+            equeue_worker_push(q, w, es, tail, count);
 
-            // reenqueue periodic events or deallocate
-            if (e->period >= 0) {
-                e->target += e->period;
-                equeue_enqueue(q, e, equeue_tick());
-            } else {
-                equeue_incid(q, e);
-                equeue_dealloc(q, e + 1);
+            struct equeue_event *e;
+            while ((e = equeue_worker_pop(w)) ||
+                    (e = equeue_worker_steal(q, w))) {
+                equeue_dispatch_event(q, e);
             }
         }
 
@@ -457,7 +919,14 @@ void equeue_dispatch(equeue_t *q, int ms)
                     q->background.active = true;
                     equeue_mutex_unlock(&q->queuelock);
                 }
-                q->break_requested = false;
+
+                if (w) {
+                    equeue_mutex_lock(&q->queuelock);
+                    equeue_worker_leave(q, w);
+                    equeue_mutex_unlock(&q->queuelock);
+                } else {
+                    q->break_requested = false;
+                }
                 return;
             }
         }
@@ -470,20 +939,28 @@ void equeue_dispatch(equeue_t *q, int ms)
                 deadline = diff;
             }
         }
-        equeue_mutex_unlock(&q->queuelock);
 
-        // wait for events
-        equeue_sema_wait(&q->eventsema, deadline);
+        // wait for events, workers check for a break of their own
+        if (w) {
+            bool leave = equeue_worker_wait(q, w, deadline);
+            equeue_mutex_unlock(&q->queuelock);
+            if (leave) {
+                return;
+            }
+        } else {
+            equeue_mutex_unlock(&q->queuelock);
+            equeue_sema_wait(&q->eventsema, deadline);
 
-        // check if we were notified to break out of dispatch
-        if (q->break_requested) {
-            equeue_mutex_lock(&q->queuelock);
+            // check if we were notified to break out of dispatch
             if (q->break_requested) {
-                q->break_requested = false;
+                equeue_mutex_lock(&q->queuelock);
+                if (q->break_requested) {
+                    q->break_requested = false;
+                    equeue_mutex_unlock(&q->queuelock);
+                    return;
+                }
                 equeue_mutex_unlock(&q->queuelock);
-                return;
             }
-            equeue_mutex_unlock(&q->queuelock);
         }
 
         // update tick for next iteration
@@ -491,6 +968,34 @@ void equeue_dispatch(equeue_t *q, int ms)
     }
 }
 
+void equeue_dispatch(equeue_t *q, int ms)
+{
+    equeue_dispatch_loop(q, ms, 0);
+}
+
+void equeue_dispatch_worker(equeue_t *q, int ms)
+{
+    struct equeue_worker w;
+    w.head = 0;
+    w.tail = 0;
+    w.count = 0;
+    w.waiting = false;
+    w.break_requested = false;
+    if (equeue_mutex_create(&w.lock) < 0) {
+        return;
+    }
+
+    equeue_mutex_lock(&q->queuelock);
+    w.next = q->workers;
+    q->workers = &w;
+    q->background.active = false;
+    equeue_mutex_unlock(&q->queuelock);
+
+    equeue_dispatch_loop(q, ms, &w);
+
+    equeue_mutex_destroy(&w.lock);
+}
+
 
 // event functions
 void equeue_event_delay(void *p, int ms)
@@ -576,7 +1081,9 @@ void equeue_background(equeue_t *q,
     q->background.update = update;
     q->background.timer = timer;
 
-    if (q->background.update && q->queue) {
+    if (q->background.update && q->lane) {
+        q->background.update(q->background.timer, 0);
+    } else if (q->background.update && q->queue) {
         q->background.update(q->background.timer,
                              equeue_clampdiff(q->queue->target, equeue_tick()));
     }
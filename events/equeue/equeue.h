@@ -36,11 +36,20 @@ extern "C" {
 // This size is guaranteed to fit events created by event_call
 #define EQUEUE_EVENT_SIZE (sizeof(struct equeue_event) + 2*sizeof(void*))
 
+// The number of size classes used by the event allocator
+//
+// Freed events are kept in power-of-two size classes starting at the size of
+// the event header, larger events all share the last class.
+#ifndef EQUEUE_CHUNK_CLASSES
+#define EQUEUE_CHUNK_CLASSES 8
+#endif
+
 // Internal event structure
 struct equeue_event {
     unsigned size;
     uint8_t id;
     uint8_t generation;
+    uint16_t seq;
 
     struct equeue_event *next;
     struct equeue_event *sibling;
@@ -54,23 +63,48 @@ struct equeue_event {
     // data follows
 };
 
+// Worker state used by equeue_dispatch_worker
+struct equeue_worker {
+    struct equeue_worker *next;
+    struct equeue_event *head;
+    struct equeue_event *tail;
+    unsigned count;
+    bool waiting;
+    bool break_requested;
+    equeue_mutex_t lock;
+};
+
 // Event queue structure
 typedef struct equeue {
     struct equeue_event *queue;
+    void *volatile lane;
+    struct equeue_worker *workers;
+    struct equeue_worker *donor;
+    unsigned break_waiting;
     unsigned tick;
     bool break_requested;
     uint8_t generation;
+    uint16_t seq;
+    unsigned flags;
 
     unsigned char *buffer;
     unsigned npw2;
     void *allocated;
 
-    struct equeue_event *chunks;
+    struct equeue_event *chunks[EQUEUE_CHUNK_CLASSES];
     struct equeue_slab {
         size_t size;
         unsigned char *data;
     } slab;
 
+    struct equeue_mem_stats {
+        size_t used;
+        size_t max_used;
+        unsigned alloc_count;
+        unsigned alloc_fail_count;
+        unsigned frag_fail_count;
+    } mem_stats;
+
     struct equeue_background {
         bool active;
         void (*update)(void *timer, int ms);
@@ -83,16 +117,47 @@ typedef struct equeue {
 } equeue_t;
 
 
+// Queue creation flags
+//
+// EQUEUE_SCHED_LIST - Keep pending events in a sorted list of time slots.
+//                     Posting is linear in the number of distinct pending
+//                     deadlines, collecting expired events is constant.
+//                     This is the default.
+// EQUEUE_SCHED_HEAP - Keep pending events in an intrusive pairing heap.
+//                     Posting is constant, cancelling and collecting each
+//                     expired event is logarithmic (amortized) in the number
+//                     of pending events. Better suited to queues with many
+//                     pending delayed events.
+//
+// Both schedulers dispatch events in deadline order, and events with the
+// same deadline in the order they were posted.
+//
+// EQUEUE_IMMEDIATE_LANE - Post events without a delay onto a lock-free
+//                         stack instead of taking the queue lock. The
+//                         dispatch loop moves them into the queue, so posting
+//                         from interrupts does not disable interrupts for the
+//                         length of a queue insertion. Queues with a
+//                         background timer post through the locked path.
+#define EQUEUE_SCHED_LIST 0x0
+#define EQUEUE_SCHED_HEAP 0x1
+#define EQUEUE_IMMEDIATE_LANE 0x2
+
 // Queue lifetime operations
 //
 // Creates and destroys an event queue. The event queue either allocates a
 // buffer of the specified size with malloc or uses a user provided buffer
 // if constructed with equeue_create_inplace.
 //
+// The _flags variants accept a combination of queue creation flags, the
+// plain variants use the defaults.
+//
 // If the event queue creation fails, equeue_create returns a negative,
 // platform-specific error code.
 int equeue_create(equeue_t *queue, size_t size);
 int equeue_create_inplace(equeue_t *queue, size_t size, void *buffer);
+int equeue_create_flags(equeue_t *queue, size_t size, unsigned flags);
+int equeue_create_inplace_flags(equeue_t *queue, size_t size, void *buffer,
+                                unsigned flags);
 void equeue_destroy(equeue_t *queue);
 
 // Dispatch events
@@ -106,6 +171,19 @@ void equeue_destroy(equeue_t *queue);
 // equeue_dispatch does not wait and is irq safe.
 void equeue_dispatch(equeue_t *queue, int ms);
 
+// Dispatch events as one of several workers
+//
+// Executes events like equeue_dispatch, but may be called from multiple
+// threads on the same queue at once. Each worker moves expired events into
+// a local list and workers that run out of events take over all but the
+// next pending event of the worker that last queued up local events, while
+// delayed events stay ordered in the shared queue.
+//
+// Events dispatched by different workers may execute concurrently and in
+// any order. A call to equeue_break stops every worker dispatching at the
+// time of the call, workers that start afterwards are not affected.
+void equeue_dispatch_worker(equeue_t *queue, int ms);
+
 // Break out of a running event loop
 //
 // Forces the specified event queue's dispatch loop to terminate. Pending
@@ -142,8 +220,10 @@ int equeue_call_every(equeue_t *queue, int ms, void (*cb)(void *), void *data);
 //
 // The equeue allocator is designed to minimize jitter in interrupt contexts as
 // well as avoid memory fragmentation on small devices. The allocator achieves
-// both constant-runtime and zero-fragmentation for fixed-size events, however
-// grows linearly as the quantity of different sized allocations increases.
+// both constant-runtime and zero-fragmentation for fixed-size events. Freed
+// events are pushed onto power-of-two size classes in constant time, so the
+// allocation runtime only grows with the quantity of different sized
+// allocations within one class.
 //
 // The equeue_alloc function returns a pointer to the event's allocated memory
 // and acts as a handle to the underlying event. If there is not enough memory
@@ -151,6 +231,36 @@ int equeue_call_every(equeue_t *queue, int ms, void (*cb)(void *), void *data);
 void *equeue_alloc(equeue_t *queue, size_t size);
 void equeue_dealloc(equeue_t *queue, void *event);
 
+// Event allocator statistics
+//
+// size             - Size of the event buffer in bytes
+// used             - Bytes currently allocated to events, including headers
+// max_used         - High-water mark of used bytes
+// cached           - Bytes in freed events kept for reuse
+// slab             - Bytes that have never been allocated
+// alloc_count      - Number of successful allocations
+// alloc_fail_count - Number of failed allocations
+// frag_fail_count  - Number of failed allocations that would have fit in the
+//                    total free memory, an indication of fragmentation
+typedef struct equeue_stats {
+    size_t size;
+    size_t used;
+    size_t max_used;
+    size_t cached;
+    size_t slab;
+    unsigned alloc_count;
+    unsigned alloc_fail_count;
+    unsigned frag_fail_count;
+} equeue_stats_t;
+
+// Query event allocator statistics
+//
+// The equeue_stats function fills in a snapshot of the allocator state,
+// allowing event queue buffers to be sized from measurements.
+//
+// The equeue_stats function is irq safe.
+void equeue_stats(equeue_t *queue, equeue_stats_t *stats);
+
 // Configure an allocated event
 //
 // equeue_event_delay  - Millisecond delay before dispatching an event
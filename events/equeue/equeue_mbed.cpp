@@ -119,6 +119,18 @@ void equeue_mutex_unlock(equeue_mutex_t *m)
 }
 
 
+// Atomic operations
+bool equeue_atomic_cas_ptr(void *volatile *ptr, void **expected, void *desired)
+{
+    return core_util_atomic_cas_ptr(ptr, expected, desired);
+}
+
+void *equeue_atomic_exchange_ptr(void *volatile *ptr, void *desired)
+{
+    return core_util_atomic_exchange_ptr(ptr, desired);
+}
+
+
 // Semaphore operations
 #ifdef MBED_CONF_RTOS_PRESENT
 
@@ -143,6 +143,22 @@ void equeue_sema_signal(equeue_sema_t *sema);
 bool equeue_sema_wait(equeue_sema_t *sema, int ms);
 
 
+// Platform atomic operations
+//
+// The equeue library uses atomic pointer operations to post immediate events
+// without taking a lock when created with EQUEUE_IMMEDIATE_LANE. Both
+// operations must be safe to call from interrupt contexts.
+//
+// The equeue_atomic_cas_ptr function replaces *ptr with desired if *ptr
+// equals *expected and returns true. Otherwise the current value of *ptr is
+// stored in *expected and equeue_atomic_cas_ptr returns false.
+//
+// The equeue_atomic_exchange_ptr function replaces *ptr with desired and
+// returns the previous value of *ptr.
+bool equeue_atomic_cas_ptr(void *volatile *ptr, void **expected, void *desired);
+void *equeue_atomic_exchange_ptr(void *volatile *ptr, void *desired);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -112,4 +112,17 @@ bool equeue_sema_wait(equeue_sema_t *s, int ms)
     return signal;
 }
 
+
+// Atomic operations
+bool equeue_atomic_cas_ptr(void *volatile *ptr, void **expected, void *desired)
+{
+    return __atomic_compare_exchange_n(ptr, expected, desired, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+void *equeue_atomic_exchange_ptr(void *volatile *ptr, void *desired)
+{
+    return __atomic_exchange_n(ptr, desired, __ATOMIC_SEQ_CST);
+}
+
 #endif
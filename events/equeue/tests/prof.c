@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include <sys/time.h>
+#include <pthread.h>
+#include <sched.h>
 
 
 // Performance measurement utils
@@ -180,6 +182,32 @@ void equeue_alloc_many_prof(int count)
     equeue_destroy(&q);
 }
 
+void equeue_alloc_varied_prof(int count)
+{
+    struct equeue q;
+    equeue_create(&q, count * (EQUEUE_EVENT_SIZE + count * sizeof(int)));
+
+    void *es[count];
+
+    for (int i = 0; i < count; i++) {
+        es[i] = equeue_alloc(&q, i * sizeof(int));
+    }
+
+    for (int i = 0; i < count; i++) {
+        equeue_dealloc(&q, es[i]);
+    }
+
+    prof_loop() {
+        prof_start();
+        void *e = equeue_alloc(&q, (count - 1) * sizeof(int));
+        prof_stop();
+
+        equeue_dealloc(&q, e);
+    }
+
+    equeue_destroy(&q);
+}
+
 void equeue_post_prof(void)
 {
     struct equeue q;
@@ -198,6 +226,24 @@ void equeue_post_prof(void)
     equeue_destroy(&q);
 }
 
+void equeue_post_lane_prof(void)
+{
+    struct equeue q;
+    equeue_create_flags(&q, EQUEUE_EVENT_SIZE, EQUEUE_IMMEDIATE_LANE);
+
+    prof_loop() {
+        void *e = equeue_alloc(&q, 0);
+
+        prof_start();
+        equeue_post(&q, no_func, e);
+        prof_stop();
+
+        equeue_dispatch(&q, 0);
+    }
+
+    equeue_destroy(&q);
+}
+
 void equeue_post_many_prof(int count)
 {
     struct equeue q;
@@ -332,6 +378,162 @@ void equeue_cancel_many_prof(int count)
     equeue_destroy(&q);
 }
 
+// Scheduler comparisons, each queue is filled with delayed events at
+// distinct deadlines so the list scheduler has to walk its slots
+static void equeue_fill_spread(struct equeue *q, int count)
+{
+    for (int i = 0; i < count - 1; i++) {
+        equeue_call_in(q, 1000 + i, no_func, 0);
+    }
+}
+
+static void equeue_post_spread(unsigned flags, int count)
+{
+    struct equeue q;
+    equeue_create_flags(&q, count * EQUEUE_EVENT_SIZE, flags);
+    equeue_fill_spread(&q, count);
+
+    prof_loop() {
+        void *e = equeue_alloc(&q, 0);
+        equeue_event_delay(e, 1000 + count / 2);
+
+        prof_start();
+        int id = equeue_post(&q, no_func, e);
+        prof_stop();
+
+        equeue_cancel(&q, id);
+    }
+
+    equeue_destroy(&q);
+}
+
+static void equeue_cancel_spread(unsigned flags, int count)
+{
+    struct equeue q;
+    equeue_create_flags(&q, count * EQUEUE_EVENT_SIZE, flags);
+    equeue_fill_spread(&q, count);
+
+    prof_loop() {
+        int id = equeue_call_in(&q, 1000 + count / 2, no_func, 0);
+
+        prof_start();
+        equeue_cancel(&q, id);
+        prof_stop();
+    }
+
+    equeue_destroy(&q);
+}
+
+static void equeue_dispatch_spread(unsigned flags, int count)
+{
+    struct equeue q;
+    equeue_create_flags(&q, count * EQUEUE_EVENT_SIZE, flags);
+    equeue_fill_spread(&q, count);
+
+    prof_loop() {
+        equeue_call(&q, no_func, 0);
+
+        prof_start();
+        equeue_dispatch(&q, 0);
+        prof_stop();
+    }
+
+    equeue_destroy(&q);
+}
+
+void equeue_post_spread_prof(int count)
+{
+    equeue_post_spread(EQUEUE_SCHED_LIST, count);
+}
+
+void equeue_post_spread_heap_prof(int count)
+{
+    equeue_post_spread(EQUEUE_SCHED_HEAP, count);
+}
+
+void equeue_cancel_spread_prof(int count)
+{
+    equeue_cancel_spread(EQUEUE_SCHED_LIST, count);
+}
+
+void equeue_cancel_spread_heap_prof(int count)
+{
+    equeue_cancel_spread(EQUEUE_SCHED_HEAP, count);
+}
+
+void equeue_dispatch_spread_prof(int count)
+{
+    equeue_dispatch_spread(EQUEUE_SCHED_LIST, count);
+}
+
+void equeue_dispatch_spread_heap_prof(int count)
+{
+    equeue_dispatch_spread(EQUEUE_SCHED_HEAP, count);
+}
+
+// Worker scaling, events are posted in bulk and the time until the last
+// one completes is reported per event
+#define PROF_WORKER_EVENTS 1000
+
+static void *prof_worker_thread(void *p)
+{
+    equeue_dispatch_worker((struct equeue *)p, -1);
+    return 0;
+}
+
+static void prof_spin_func(void *p)
+{
+    for (prof_volatile(int) i = 0; i < 10000; i++);
+    __atomic_add_fetch((int *)p, 1, __ATOMIC_SEQ_CST);
+}
+
+static void prof_sleep_func(void *p)
+{
+    usleep(100);
+    __atomic_add_fetch((int *)p, 1, __ATOMIC_SEQ_CST);
+}
+
+static void equeue_dispatch_workers(void (*func)(void *), int workers)
+{
+    struct equeue q;
+    equeue_create(&q, PROF_WORKER_EVENTS * EQUEUE_EVENT_SIZE);
+
+    pthread_t threads[workers];
+    for (int i = 0; i < workers; i++) {
+        pthread_create(&threads[i], 0, prof_worker_thread, &q);
+    }
+
+    int done = 0;
+    prof_cycle_t start = prof_cycle();
+    for (int i = 0; i < PROF_WORKER_EVENTS; i++) {
+        equeue_call(&q, func, &done);
+    }
+
+    while (__atomic_load_n(&done, __ATOMIC_SEQ_CST) < PROF_WORKER_EVENTS) {
+        sched_yield();
+    }
+    prof_cycle_t stop = prof_cycle();
+
+    equeue_break(&q);
+    for (int i = 0; i < workers; i++) {
+        pthread_join(threads[i], 0);
+    }
+
+    prof_result((stop - start) / PROF_WORKER_EVENTS, "cycles");
+
+    equeue_destroy(&q);
+}
+
+void equeue_dispatch_workers_prof(int workers)
+{
+    equeue_dispatch_workers(prof_spin_func, workers);
+}
+
+void equeue_dispatch_workers_blocking_prof(int workers)
+{
+    equeue_dispatch_workers(prof_sleep_func, workers);
+}
+
 void equeue_alloc_size_prof(void)
 {
     size_t size = 32 * EQUEUE_EVENT_SIZE;
@@ -407,15 +609,37 @@ int main()
     prof_measure(equeue_alloc_prof);
     prof_measure(equeue_post_prof);
     prof_measure(equeue_post_future_prof);
+    prof_measure(equeue_post_lane_prof);
     prof_measure(equeue_dispatch_prof);
     prof_measure(equeue_cancel_prof);
 
     prof_measure(equeue_alloc_many_prof, 1000);
+    prof_measure(equeue_alloc_varied_prof, 100);
     prof_measure(equeue_post_many_prof, 1000);
     prof_measure(equeue_post_future_many_prof, 1000);
     prof_measure(equeue_dispatch_many_prof, 100);
     prof_measure(equeue_cancel_many_prof, 100);
 
+    prof_measure(equeue_post_spread_prof, 100);
+    prof_measure(equeue_post_spread_heap_prof, 100);
+    prof_measure(equeue_post_spread_prof, 1000);
+    prof_measure(equeue_post_spread_heap_prof, 1000);
+    prof_measure(equeue_cancel_spread_prof, 100);
+    prof_measure(equeue_cancel_spread_heap_prof, 100);
+    prof_measure(equeue_cancel_spread_prof, 1000);
+    prof_measure(equeue_cancel_spread_heap_prof, 1000);
+    prof_measure(equeue_dispatch_spread_prof, 100);
+    prof_measure(equeue_dispatch_spread_heap_prof, 100);
+    prof_measure(equeue_dispatch_spread_prof, 1000);
+    prof_measure(equeue_dispatch_spread_heap_prof, 1000);
+
+    prof_measure(equeue_dispatch_workers_prof, 1);
+    prof_measure(equeue_dispatch_workers_prof, 2);
+    prof_measure(equeue_dispatch_workers_prof, 4);
+    prof_measure(equeue_dispatch_workers_blocking_prof, 1);
+    prof_measure(equeue_dispatch_workers_blocking_prof, 2);
+    prof_measure(equeue_dispatch_workers_blocking_prof, 4);
+
     prof_measure(equeue_alloc_size_prof);
     prof_measure(equeue_alloc_many_size_prof, 1000);
     prof_measure(equeue_alloc_fragmented_size_prof, 1000);
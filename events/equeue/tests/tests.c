@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <sched.h>
 
 
 // Testing setup
@@ -802,6 +803,656 @@ void sibling_test(void)
     equeue_destroy(&q);
 }
 
+// Heap scheduler tests
+struct order {
+    unsigned count;
+    unsigned target[256];
+    int index[256];
+};
+
+struct ordered {
+    struct order *order;
+    int index;
+};
+
+void ordered_func(void *p)
+{
+    struct ordered *o = (struct ordered *)p;
+    struct equeue_event *e = (struct equeue_event *)p - 1;
+    o->order->target[o->order->count] = e->target;
+    o->order->index[o->order->count] = o->index;
+    o->order->count++;
+}
+
+static void check_order(struct order *order)
+{
+    for (unsigned i = 1; i < order->count; i++) {
+        int diff = (int)(order->target[i] - order->target[i - 1]);
+        test_assert(diff >= 0);
+        test_assert(diff > 0 || order->index[i] > order->index[i - 1]);
+    }
+}
+
+void heap_order_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q,
+                                  N * (EQUEUE_EVENT_SIZE + sizeof(struct ordered)),
+                                  EQUEUE_SCHED_HEAP);
+    test_assert(!err);
+
+    struct order order;
+    order.count = 0;
+
+    for (int i = 0; i < N; i++) {
+        struct ordered *o = equeue_alloc(&q, sizeof(struct ordered));
+        test_assert(o);
+
+        o->order = &order;
+        o->index = i;
+        equeue_event_delay(o, (i * 7) % 13);
+        int id = equeue_post(&q, ordered_func, o);
+        test_assert(id);
+    }
+
+    equeue_dispatch(&q, 20);
+    test_assert(order.count == (unsigned)N);
+    check_order(&order);
+
+    equeue_destroy(&q);
+}
+
+void heap_cancel_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q,
+                                  N * (EQUEUE_EVENT_SIZE + sizeof(struct ordered)),
+                                  EQUEUE_SCHED_HEAP);
+    test_assert(!err);
+
+    struct order order;
+    order.count = 0;
+    int *ids = malloc(N * sizeof(int));
+
+    for (int i = 0; i < N; i++) {
+        struct ordered *o = equeue_alloc(&q, sizeof(struct ordered));
+        test_assert(o);
+
+        o->order = &order;
+        o->index = i;
+        equeue_event_delay(o, (i * 7) % 13);
+        ids[i] = equeue_post(&q, ordered_func, o);
+        test_assert(ids[i]);
+    }
+
+    // cancel every third event, visiting the heap in a scattered order
+    for (int i = 0; i < N; i++) {
+        int j = (i * 7) % N;
+        if (j % 3 == 0) {
+            equeue_cancel(&q, ids[j]);
+        }
+    }
+
+    // cancelling twice must be harmless
+    equeue_cancel(&q, ids[0]);
+
+    equeue_dispatch(&q, 20);
+    test_assert(order.count == (unsigned)(N - (N + 2) / 3));
+    check_order(&order);
+    for (unsigned i = 0; i < order.count; i++) {
+        test_assert(order.index[i] % 3 != 0);
+    }
+
+    free(ids);
+    equeue_destroy(&q);
+}
+
+void heap_barrage_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q,
+                                  N * (EQUEUE_EVENT_SIZE + sizeof(struct timing)),
+                                  EQUEUE_SCHED_HEAP);
+    test_assert(!err);
+
+    for (int i = 0; i < N; i++) {
+        struct timing *timing = equeue_alloc(&q, sizeof(struct timing));
+        test_assert(timing);
+
+        timing->tick = equeue_tick();
+        timing->delay = (i + 1) * 100;
+        equeue_event_delay(timing, timing->delay);
+        equeue_event_period(timing, timing->delay);
+
+        int id = equeue_post(&q, timing_func, timing);
+        test_assert(id);
+    }
+
+    equeue_dispatch(&q, N * 100);
+
+    equeue_destroy(&q);
+}
+
+void heap_destructor_test(void)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q, 2048, EQUEUE_SCHED_HEAP);
+    test_assert(!err);
+
+    int touched = 0;
+    for (int i = 0; i < 8; i++) {
+        struct indirect *e = equeue_alloc(&q, sizeof(struct indirect));
+        test_assert(e);
+
+        e->touched = &touched;
+        equeue_event_delay(e, 1000 + (i % 3));
+        equeue_event_dtor(e, indirect_func);
+        int id = equeue_post(&q, pass_func, e);
+        test_assert(id);
+    }
+
+    equeue_destroy(&q);
+    test_assert(touched == 8);
+}
+
+// Immediate lane tests
+void lane_order_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q,
+                                  N * (EQUEUE_EVENT_SIZE + sizeof(struct ordered)),
+                                  EQUEUE_IMMEDIATE_LANE);
+    test_assert(!err);
+
+    struct order order;
+    order.count = 0;
+
+    for (int i = 0; i < N; i++) {
+        struct ordered *o = equeue_alloc(&q, sizeof(struct ordered));
+        test_assert(o);
+
+        o->order = &order;
+        o->index = i;
+        equeue_event_delay(o, (i % 2) ? 0 : (i * 7) % 13);
+        int id = equeue_post(&q, ordered_func, o);
+        test_assert(id);
+    }
+
+    equeue_dispatch(&q, 20);
+    test_assert(order.count == (unsigned)N);
+    check_order(&order);
+
+    equeue_destroy(&q);
+}
+
+void lane_cancel_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q, N * EQUEUE_EVENT_SIZE,
+                                  EQUEUE_IMMEDIATE_LANE | EQUEUE_SCHED_HEAP);
+    test_assert(!err);
+
+    int touched = 0;
+    int *ids = malloc(N * sizeof(int));
+
+    for (int r = 0; r < 3; r++) {
+        for (int i = 0; i < N; i++) {
+            ids[i] = equeue_call(&q, simple_func, &touched);
+            test_assert(ids[i]);
+        }
+
+        for (int i = 0; i < N; i++) {
+            equeue_cancel(&q, ids[i]);
+        }
+
+        // cancelled events are only released by dispatch, so the queue
+        // must be reusable after each round
+        equeue_dispatch(&q, 0);
+        test_assert(touched == 0);
+    }
+
+    free(ids);
+    equeue_destroy(&q);
+}
+
+void lane_destructor_test(void)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q, 2048, EQUEUE_IMMEDIATE_LANE);
+    test_assert(!err);
+
+    int touched = 0;
+    for (int i = 0; i < 3; i++) {
+        struct indirect *e = equeue_alloc(&q, sizeof(struct indirect));
+        test_assert(e);
+
+        e->touched = &touched;
+        equeue_event_dtor(e, indirect_func);
+        int id = equeue_post(&q, pass_func, e);
+        test_assert(id);
+    }
+
+    equeue_destroy(&q);
+    test_assert(touched == 3);
+}
+
+#define LANE_THREADS 8
+#define LANE_EVENTS 10000
+
+struct lane_stress {
+    equeue_t *q;
+    int total;
+    int last[LANE_THREADS];
+    uint8_t seen[LANE_THREADS][LANE_EVENTS];
+    bool failed;
+};
+
+struct lane_producer {
+    pthread_t thread;
+    struct lane_stress *stress;
+    int index;
+};
+
+struct lane_event {
+    struct lane_stress *stress;
+    int thread;
+    int seq;
+};
+
+static void lane_stress_func(void *p)
+{
+    struct lane_event *e = (struct lane_event *)p;
+    struct lane_stress *stress = e->stress;
+
+    // posts from one producer must arrive exactly once and in order
+    stress->seen[e->thread][e->seq]++;
+    if (stress->seen[e->thread][e->seq] != 1 ||
+            e->seq <= stress->last[e->thread]) {
+        stress->failed = true;
+    }
+    stress->last[e->thread] = e->seq;
+
+    stress->total++;
+    if (stress->total == LANE_THREADS * LANE_EVENTS) {
+        equeue_break(stress->q);
+    }
+}
+
+static void *lane_producer_thread(void *p)
+{
+    struct lane_producer *t = (struct lane_producer *)p;
+
+    for (int i = 0; i < LANE_EVENTS; i++) {
+        struct lane_event *e;
+        while (!(e = equeue_alloc(t->stress->q, sizeof(struct lane_event)))) {
+            sched_yield();
+        }
+
+        e->stress = t->stress;
+        e->thread = t->index;
+        e->seq = i;
+        equeue_post(t->stress->q, lane_stress_func, e);
+    }
+
+    return 0;
+}
+
+void lane_stress_test(void)
+{
+    equeue_t q;
+    int err = equeue_create_flags(&q,
+                                  64 * (EQUEUE_EVENT_SIZE + sizeof(struct lane_event)),
+                                  EQUEUE_IMMEDIATE_LANE);
+    test_assert(!err);
+
+    struct lane_stress *stress = calloc(1, sizeof(struct lane_stress));
+    test_assert(stress);
+    stress->q = &q;
+    for (int i = 0; i < LANE_THREADS; i++) {
+        stress->last[i] = -1;
+    }
+
+    struct lane_producer producers[LANE_THREADS];
+    for (int i = 0; i < LANE_THREADS; i++) {
+        producers[i].stress = stress;
+        producers[i].index = i;
+        err = pthread_create(&producers[i].thread, 0,
+                             lane_producer_thread, &producers[i]);
+        test_assert(!err);
+    }
+
+    equeue_dispatch(&q, 10000);
+
+    for (int i = 0; i < LANE_THREADS; i++) {
+        err = pthread_join(producers[i].thread, 0);
+        test_assert(!err);
+    }
+
+    test_assert(!stress->failed);
+    test_assert(stress->total == LANE_THREADS * LANE_EVENTS);
+    for (int i = 0; i < LANE_THREADS; i++) {
+        for (int j = 0; j < LANE_EVENTS; j++) {
+            test_assert(stress->seen[i][j] == 1);
+        }
+    }
+
+    free(stress);
+    equeue_destroy(&q);
+}
+
+// Allocator statistics tests
+void stats_test(void)
+{
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    equeue_stats_t stats;
+    equeue_stats(&q, &stats);
+    test_assert(stats.size == 2048);
+    test_assert(stats.used == 0);
+    test_assert(stats.max_used == 0);
+    test_assert(stats.slab == 2048);
+
+    void *e1 = equeue_alloc(&q, 8);
+    void *e2 = equeue_alloc(&q, 64);
+    void *e3 = equeue_alloc(&q, 256);
+    test_assert(e1 && e2 && e3);
+
+    equeue_stats(&q, &stats);
+    size_t used = stats.used;
+    test_assert(used >= 3 * sizeof(struct equeue_event) + 8 + 64 + 256);
+    test_assert(stats.max_used == used);
+    test_assert(stats.cached == 0);
+    test_assert(stats.slab == 2048 - used);
+    test_assert(stats.alloc_count == 3);
+
+    equeue_dealloc(&q, e2);
+    equeue_dealloc(&q, e3);
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.used < used);
+    test_assert(stats.max_used == used);
+    test_assert(stats.cached == used - stats.used);
+
+    // reallocating the same sizes reuses the cached chunks
+    e2 = equeue_alloc(&q, 64);
+    e3 = equeue_alloc(&q, 256);
+    test_assert(e2 && e3);
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.used == used);
+    test_assert(stats.cached == 0);
+    test_assert(stats.slab == 2048 - used);
+
+    equeue_dealloc(&q, e1);
+    equeue_dealloc(&q, e2);
+    equeue_dealloc(&q, e3);
+    equeue_destroy(&q);
+}
+
+void size_class_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create(&q, N * (EQUEUE_EVENT_SIZE + N * sizeof(int)));
+    test_assert(!err);
+
+    void **es = malloc(N * sizeof(void *));
+
+    for (int i = 0; i < N; i++) {
+        es[i] = equeue_alloc(&q, i * sizeof(int));
+        test_assert(es[i]);
+    }
+
+    equeue_stats_t stats;
+    equeue_stats(&q, &stats);
+    size_t slab = stats.slab;
+
+    for (int i = 0; i < N; i++) {
+        equeue_dealloc(&q, es[i]);
+    }
+
+    // every size must find its own chunk again without touching the slab
+    for (int i = N - 1; i >= 0; i--) {
+        es[i] = equeue_alloc(&q, i * sizeof(int));
+        test_assert(es[i]);
+    }
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.slab == slab);
+    test_assert(stats.cached == 0);
+
+    for (int i = 0; i < N; i++) {
+        equeue_dealloc(&q, es[i]);
+    }
+
+    free(es);
+    equeue_destroy(&q);
+}
+
+void fragmentation_stats_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create(&q, N * EQUEUE_EVENT_SIZE);
+    test_assert(!err);
+
+    void **es = malloc(N * sizeof(void *));
+
+    for (int i = 0; i < N; i++) {
+        es[i] = equeue_alloc(&q, EQUEUE_EVENT_SIZE - sizeof(struct equeue_event));
+        test_assert(es[i]);
+    }
+
+    test_assert(!equeue_alloc(&q, 1));
+
+    equeue_stats_t stats;
+    equeue_stats(&q, &stats);
+    test_assert(stats.alloc_fail_count == 1);
+    test_assert(stats.frag_fail_count == 0);
+
+    for (int i = 0; i < N; i++) {
+        equeue_dealloc(&q, es[i]);
+    }
+
+    // plenty of memory is free, but only in small chunks
+    test_assert(!equeue_alloc(&q, 2 * EQUEUE_EVENT_SIZE));
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.used == 0);
+    test_assert(stats.alloc_fail_count == 2);
+    test_assert(stats.frag_fail_count == 1);
+
+    free(es);
+    equeue_destroy(&q);
+}
+
+// Worker tests
+struct worker_thread {
+    pthread_t thread;
+    equeue_t *q;
+    int ms;
+};
+
+static void *worker_dispatch(void *p)
+{
+    struct worker_thread *t = (struct worker_thread *)p;
+    equeue_dispatch_worker(t->q, t->ms);
+    return 0;
+}
+
+static void start_workers(struct worker_thread *workers, int count,
+                          equeue_t *q, int ms)
+{
+    for (int i = 0; i < count; i++) {
+        workers[i].q = q;
+        workers[i].ms = ms;
+        int err = pthread_create(&workers[i].thread, 0,
+                                 worker_dispatch, &workers[i]);
+        test_assert(!err);
+    }
+}
+
+static void join_workers(struct worker_thread *workers, int count)
+{
+    for (int i = 0; i < count; i++) {
+        int err = pthread_join(workers[i].thread, 0);
+        test_assert(!err);
+    }
+}
+
+void atomic_func(void *p)
+{
+    __atomic_add_fetch((int *)p, 1, __ATOMIC_SEQ_CST);
+}
+
+void atomic_sloth_func(void *p)
+{
+    usleep(10000);
+    __atomic_add_fetch((int *)p, 1, __ATOMIC_SEQ_CST);
+}
+
+void worker_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create(&q, N * EQUEUE_EVENT_SIZE);
+    test_assert(!err);
+
+    struct worker_thread workers[4];
+    start_workers(workers, 4, &q, -1);
+
+    int touched = 0;
+    for (int i = 0; i < N; i++) {
+        int id = equeue_call(&q, atomic_func, &touched);
+        test_assert(id);
+    }
+
+    while (__atomic_load_n(&touched, __ATOMIC_SEQ_CST) < N) {
+        usleep(1000);
+    }
+
+    // a single break stops every worker
+    equeue_break(&q);
+    join_workers(workers, 4);
+    test_assert(touched == N);
+
+    equeue_destroy(&q);
+}
+
+void worker_steal_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create(&q, N * EQUEUE_EVENT_SIZE);
+    test_assert(!err);
+
+    struct worker_thread workers[4];
+    start_workers(workers, 4, &q, -1);
+    usleep(10000);
+
+    // all events expire at once, so without stealing a single
+    // worker would end up running all of them
+    int touched = 0;
+    unsigned tick = equeue_tick();
+    for (int i = 0; i < N; i++) {
+        int id = equeue_call(&q, atomic_sloth_func, &touched);
+        test_assert(id);
+    }
+
+    while (__atomic_load_n(&touched, __ATOMIC_SEQ_CST) < N) {
+        usleep(1000);
+    }
+    unsigned elapsed = equeue_tick() - tick;
+
+    equeue_break(&q);
+    join_workers(workers, 4);
+    test_assert(touched == N);
+    test_assert(elapsed < (unsigned)N * 10 / 2);
+
+    equeue_destroy(&q);
+}
+
+void worker_break_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    // break while some workers are busy and others are idle, every
+    // worker present must leave
+    int touched = 0;
+    for (int i = 0; i < N; i++) {
+        struct worker_thread workers[4];
+        start_workers(workers, 4, &q, -1);
+
+        int id = equeue_call(&q, atomic_sloth_func, &touched);
+        test_assert(id);
+        usleep(i % 2 ? 1000 : 0);
+
+        equeue_break(&q);
+        join_workers(workers, 4);
+        test_assert(!q.workers);
+    }
+
+    // workers that start after a break are not stopped by it
+    equeue_break(&q);
+    equeue_dispatch(&q, 0);
+
+    struct worker_thread workers[2];
+    start_workers(workers, 1, &q, -1);
+    usleep(10000);
+    equeue_break(&q);
+    start_workers(&workers[1], 1, &q, 20);
+    join_workers(workers, 2);
+    test_assert(!q.workers);
+
+    equeue_destroy(&q);
+}
+
+void worker_timeout_test(void)
+{
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    int touched = 0;
+    equeue_call_every(&q, 10, atomic_func, &touched);
+
+    struct worker_thread workers[4];
+    start_workers(workers, 4, &q, 55);
+    join_workers(workers, 4);
+
+    test_assert(touched > 1 && touched < 10);
+    test_assert(!q.workers);
+
+    equeue_destroy(&q);
+}
+
+void worker_barrage_test(int N)
+{
+    equeue_t q;
+    int err = equeue_create(&q, N * (EQUEUE_EVENT_SIZE + sizeof(struct timing)));
+    test_assert(!err);
+
+    struct worker_thread workers[4];
+    start_workers(workers, 4, &q, N * 100);
+
+    for (int i = 0; i < N; i++) {
+        struct timing *timing = equeue_alloc(&q, sizeof(struct timing));
+        test_assert(timing);
+
+        timing->tick = equeue_tick();
+        timing->delay = (i + 1) * 100;
+        equeue_event_delay(timing, timing->delay);
+        equeue_event_period(timing, timing->delay);
+
+        int id = equeue_post(&q, timing_func, timing);
+        test_assert(id);
+    }
+
+    join_workers(workers, 4);
+
+    equeue_destroy(&q);
+}
+
 int main()
 {
     printf("beginning tests...\n");
@@ -830,6 +1481,22 @@ int main()
     test_run(multithreaded_barrage_test, 20);
     test_run(break_request_cleared_on_timeout);
     test_run(sibling_test);
+    test_run(heap_order_test, 200);
+    test_run(heap_cancel_test, 200);
+    test_run(heap_barrage_test, 20);
+    test_run(heap_destructor_test);
+    test_run(lane_order_test, 200);
+    test_run(lane_cancel_test, 20);
+    test_run(lane_destructor_test);
+    test_run(lane_stress_test);
+    test_run(stats_test);
+    test_run(size_class_test, 40);
+    test_run(fragmentation_stats_test, 20);
+    test_run(worker_test, 1000);
+    test_run(worker_steal_test, 40);
+    test_run(worker_break_test, 20);
+    test_run(worker_timeout_test);
+    test_run(worker_barrage_test, 20);
     printf("done!\n");
     return test_failure;
 }
@@ -26,12 +26,39 @@ using namespace events;
 namespace mbed {
 
 #ifdef MBED_CONF_RTOS_PRESENT
+#if MBED_CONF_EVENTS_SHARED_WORKERS > 1
+/* Start the additional threads that dispatch the shared event queue next to
+ * its own thread. They are only ever started once and never destroyed, so
+ * they live in static storage like the rest of the shared queue.
+ */
+template
+<osPriority Priority, size_t StackSize, unsigned Workers>
+void do_shared_event_queue_workers(EventQueue *queue, const char *name)
+{
+    static uint64_t stacks[Workers][StackSize / sizeof(uint64_t)];
+    static uint64_t threads[Workers][(sizeof(Thread) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    static bool started = false;
+
+    if (started) {
+        return;
+    }
+    started = true;
+
+    for (unsigned i = 0; i < Workers; i++) {
+        Thread *thread = new (threads[i]) Thread(Priority, StackSize, (unsigned char *) stacks[i], name);
+        osStatus status = thread->start(callback(queue, &EventQueue::dispatch_worker_forever));
+        MBED_ASSERT(status == osOK);
+        (void) status;
+    }
+}
+#endif
+
 /* Create an event queue, and start the thread that dispatches it. Static
  * variables mean this happens once the first time each template instantiation
  * is called. This is currently instantiated no more than twice.
  */
 template
-<osPriority Priority, size_t QueueSize, size_t StackSize>
+<osPriority Priority, size_t QueueSize, size_t StackSize, unsigned Workers>
 EventQueue *do_shared_event_queue_with_thread(const char *name)
 {
     static uint64_t queue_buffer[QueueSize / sizeof(uint64_t)];
@@ -42,11 +69,22 @@ EventQueue *do_shared_event_queue_with_thread(const char *name)
 
     Thread::State state = thread.get_state();
     if (state == Thread::Inactive || state == Thread::Deleted) {
-        osStatus status = thread.start(callback(&queue, &EventQueue::dispatch_forever));
+        osStatus status;
+        if (Workers > 1) {
+            status = thread.start(callback(&queue, &EventQueue::dispatch_worker_forever));
+        } else {
+            status = thread.start(callback(&queue, &EventQueue::dispatch_forever));
+        }
         MBED_ASSERT(status == osOK);
         if (status != osOK) {
             return NULL;
         }
+
+#if MBED_CONF_EVENTS_SHARED_WORKERS > 1
+        if (Workers > 1) {
+            do_shared_event_queue_workers<Priority, StackSize, MBED_CONF_EVENTS_SHARED_WORKERS - 1>(&queue, name);
+        }
+#endif
     }
 
     return &queue;
@@ -62,14 +100,14 @@ EventQueue *mbed_event_queue()
 
     return &queue;
 #else
-    return do_shared_event_queue_with_thread<osPriorityNormal, MBED_CONF_EVENTS_SHARED_EVENTSIZE, MBED_CONF_EVENTS_SHARED_STACKSIZE>("shared_event_queue");
+    return do_shared_event_queue_with_thread<osPriorityNormal, MBED_CONF_EVENTS_SHARED_EVENTSIZE, MBED_CONF_EVENTS_SHARED_STACKSIZE, MBED_CONF_EVENTS_SHARED_WORKERS>("shared_event_queue");
 #endif
 }
 
 #ifdef MBED_CONF_RTOS_PRESENT
 EventQueue *mbed_highprio_event_queue()
 {
-    return do_shared_event_queue_with_thread<osPriorityHigh, MBED_CONF_EVENTS_SHARED_HIGHPRIO_EVENTSIZE, MBED_CONF_EVENTS_SHARED_HIGHPRIO_STACKSIZE>("shared_highprio_event_queue");
+    return do_shared_event_queue_with_thread<osPriorityHigh, MBED_CONF_EVENTS_SHARED_HIGHPRIO_EVENTSIZE, MBED_CONF_EVENTS_SHARED_HIGHPRIO_STACKSIZE, 1>("shared_highprio_event_queue");
 }
 #endif
 
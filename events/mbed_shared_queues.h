@@ -45,6 +45,11 @@ namespace mbed {
  * necessary for the event loop to work without an RTOS, or an RTOS system can
  * save memory by reusing the main stack.
  *
+ * @warning
+ * If the configuration option `events.shared-workers` is above 1, the queue
+ * is dispatched by that many threads, so its events may run concurrently and
+ * out of order. Only set it if every user of the shared queue tolerates that.
+ *
  * @note
  * mbed_event_queue is not itself IRQ safe. To use the mbed_event_queue in
  * interrupt context, you must first call `mbed_event_queue()` in threaded
@@ -39,6 +39,8 @@
  * Activate with compiler flag: YOTTA_CFG_MBED_TRACE
  * Configure trace line buffer size with compiler flag: YOTTA_CFG_MBED_TRACE_LINE_LENGTH. Default length: 1024.
  * Limit the size of flash by setting MBED_TRACE_MAX_LEVEL value. Default is TRACE_LEVEL_DEBUG (all included)
+ * Record traces to print them later with the mbed-trace.deferred configuration option, see mbed_trace_deferred_flush().
+ * Configure the deferred trace buffer size with compiler flag: MBED_TRACE_DEFERRED_BUFFER_SIZE. Default size: 2048.
  *
  */
 #ifndef MBED_TRACE_H_
@@ -77,6 +79,10 @@ extern "C" {
 #define MBED_CONF_MBED_TRACE_FEA_IPV6 1
 #endif
 
+#ifndef MBED_CONF_MBED_TRACE_DEFERRED
+#define MBED_CONF_MBED_TRACE_DEFERRED 0
+#endif
+
 /** 3 upper bits are trace modes related,
     and 5 lower bits are trace level configuration */
 
@@ -366,6 +372,42 @@ char *mbed_trace_ipv6_prefix(const uint8_t *prefix, uint8_t prefix_len);
  */
 char *mbed_trace_array(const uint8_t *buf, uint16_t len);
 
+#if MBED_CONF_MBED_TRACE_DEFERRED
+/**
+ * Resize the deferred trace buffer
+ * In deferred mode, which mbed_trace_init() enables, trace calls only copy the
+ * format and group pointers, the level and the arguments to a ring buffer, and
+ * traces are formatted and printed by mbed_trace_deferred_flush(). Format and
+ * group must therefore be string constants, string arguments are copied up to
+ * MBED_TRACE_DEFERRED_STRING_LENGTH (default 128) characters and the prefix
+ * function is called when the trace is printed. Traces are dropped while the
+ * buffer is full.
+ * Traces still in the old buffer are printed first. Do not call this function
+ * while other threads are tracing.
+ *
+ * @param size  new buffer size in bytes, rounded down to a power of two (0 = print traces directly)
+ * @return 0 when all success, otherwise non zero
+ */
+int mbed_trace_deferred_buffer_size(uint32_t size);
+/**
+ * Format and print the deferred traces
+ * Call it periodically from a single low priority thread, for example:
+ * @code
+ *  while (true) {
+ *      mbed_trace_deferred_flush();
+ *      ThisThread::sleep_for(10);
+ *  }
+ * @endcode
+ *
+ * @return number of traces printed
+ */
+int mbed_trace_deferred_flush(void);
+/**
+ * Get the number of deferred traces dropped because the buffer was full
+ */
+uint32_t mbed_trace_deferred_dropped(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -404,6 +446,9 @@ char *mbed_trace_array(const uint8_t *buf, uint16_t len);
 #undef mbed_trace_ipv6
 #undef mbed_trace_ipv6_prefix
 #undef mbed_trace_array
+#undef mbed_trace_deferred_buffer_size
+#undef mbed_trace_deferred_flush
+#undef mbed_trace_deferred_dropped
 
 #elif !defined(MBED_TRACE_DUMMIES_DEFINED)
 // define dummies, hiding the real functions
@@ -426,6 +471,9 @@ char *mbed_trace_array(const uint8_t *buf, uint16_t len);
 #define mbed_trace_last(...)                        ((const char *) 0)
 #define mbed_tracef(...)                            ((void) 0)
 #define mbed_vtracef(...)                           ((void) 0)
+#define mbed_trace_deferred_buffer_size(...)        ((int) 0)
+#define mbed_trace_deferred_flush(...)              ((int) 0)
+#define mbed_trace_deferred_dropped(...)            ((uint32_t) 0)
 /**
  * These helper functions accumulate strings in a buffer that is only flushed by actual trace calls. Using these
  * functions outside trace calls could cause the buffer to overflow.
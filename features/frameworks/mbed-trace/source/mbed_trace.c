@@ -85,6 +85,20 @@
 #define DEFAULT_TRACE_FILTER_LENGTH       24
 #endif
 
+/** default max length of a string argument copied to a deferred trace record */
+#ifdef MBED_TRACE_DEFERRED_STRING_LENGTH
+#define DEFAULT_TRACE_DEFERRED_STRING_LEN MBED_TRACE_DEFERRED_STRING_LENGTH
+#else
+#define DEFAULT_TRACE_DEFERRED_STRING_LEN 128
+#endif
+
+/** default deferred trace ring buffer size in bytes, rounded down to a power of two */
+#ifdef MBED_TRACE_DEFERRED_BUFFER_SIZE
+#define DEFAULT_TRACE_DEFERRED_BUFFER_SIZE MBED_TRACE_DEFERRED_BUFFER_SIZE
+#else
+#define DEFAULT_TRACE_DEFERRED_BUFFER_SIZE 2048
+#endif
+
 /** default trace configuration bitmask */
 #ifdef MBED_TRACE_CONFIG
 #define DEFAULT_TRACE_CONFIG              MBED_TRACE_CONFIG
@@ -92,10 +106,46 @@
 #define DEFAULT_TRACE_CONFIG              TRACE_MODE_COLOR | TRACE_ACTIVE_LEVEL_ALL | TRACE_CARRIAGE_RETURN
 #endif
 
+#if MBED_CONF_MBED_TRACE_DEFERRED
+#if defined(__MBED__)
+#include "platform/mbed_critical.h"
+#define trace_atomic_load(ptr)                  core_util_atomic_load_u32(ptr)
+#define trace_atomic_store(ptr, value)          core_util_atomic_store_u32(ptr, value)
+#define trace_atomic_cas(ptr, expected, value)  core_util_atomic_cas_u32(ptr, expected, value)
+#define trace_atomic_incr(ptr)                  core_util_atomic_incr_u32(ptr, 1)
+#else
+#define trace_atomic_load(ptr)                  __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+#define trace_atomic_store(ptr, value)          __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST)
+#define trace_atomic_cas(ptr, expected, value)  __atomic_compare_exchange_n(ptr, expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define trace_atomic_incr(ptr)                  __atomic_add_fetch(ptr, 1, __ATOMIC_SEQ_CST)
+#endif
+
+/** deferred trace record, followed by the packed arguments */
+typedef struct trace_record_s {
+    /** record length in bytes and TRACE_RECORD_ flags, 0 while being written */
+    volatile uint32_t state;
+    /** trace level */
+    uint8_t dlevel;
+    /** trace group, must be a string constant */
+    const char *grp;
+    /** trace format, must be a string constant */
+    const char *fmt;
+} trace_record_t;
+
+#define TRACE_RECORD_COMMITTED  0x80000000
+#define TRACE_RECORD_PADDING    0x40000000
+#define TRACE_RECORD_LEN_MASK   0x3FFFFFFF
+#define TRACE_RECORD_ALIGN      8
+#define TRACE_DEFERRED_MIN_SIZE 64
+
+static void mbed_trace_deferred_record(uint8_t dlevel, const char *grp, const char *fmt, va_list ap);
+#endif
+
 /** default print function, just redirect str to printf */
 static void mbed_trace_realloc(char **buffer, int *length_ptr, int new_length);
 static void mbed_trace_default_print(const char *str);
 static void mbed_trace_reset_tmp(void);
+static void mbed_trace_vprint(uint8_t dlevel, const char *grp, const char *fmt, va_list ap);
 
 typedef struct trace_s {
     /** trace configuration bits */
@@ -131,6 +181,22 @@ typedef struct trace_s {
     void (*mutex_release_f)(void);
     /** number of times the mutex has been locked */
     int mutex_lock_count;
+#if MBED_CONF_MBED_TRACE_DEFERRED
+    /** deferred trace ring buffer, NULL when traces are printed directly */
+    uint8_t *deferred_buf;
+    /** deferred trace ring buffer size, a power of two */
+    uint32_t deferred_size;
+    /** running write position, advanced by the producers */
+    volatile uint32_t deferred_head;
+    /** running read position, advanced by mbed_trace_deferred_flush() */
+    volatile uint32_t deferred_tail;
+    /** number of traces dropped because the ring buffer was full */
+    volatile uint32_t deferred_dropped;
+    /** trace body formatted from a deferred record */
+    char *deferred_line;
+    /** deferred trace body length */
+    int deferred_line_length;
+#endif
 } trace_t;
 
 static trace_t m_trace = {
@@ -149,7 +215,16 @@ static trace_t m_trace = {
     .cmd_printf = 0,
     .mutex_wait_f = 0,
     .mutex_release_f = 0,
-    .mutex_lock_count = 0
+    .mutex_lock_count = 0,
+#if MBED_CONF_MBED_TRACE_DEFERRED
+    .deferred_buf = 0,
+    .deferred_size = 0,
+    .deferred_head = 0,
+    .deferred_tail = 0,
+    .deferred_dropped = 0,
+    .deferred_line = 0,
+    .deferred_line_length = 0
+#endif
 };
 
 int mbed_trace_init(void)
@@ -183,6 +258,14 @@ int mbed_trace_init(void)
     memset(m_trace.filters_include, 0, m_trace.filters_length);
     memset(m_trace.line, 0, m_trace.line_length);
 
+#if MBED_CONF_MBED_TRACE_DEFERRED
+    if (m_trace.deferred_buf == NULL &&
+            mbed_trace_deferred_buffer_size(DEFAULT_TRACE_DEFERRED_BUFFER_SIZE) != 0) {
+        mbed_trace_free();
+        return -1;
+    }
+#endif
+
     return 0;
 }
 void mbed_trace_free(void)
@@ -209,6 +292,18 @@ void mbed_trace_free(void)
     m_trace.mutex_wait_f = 0;
     m_trace.mutex_release_f = 0;
     m_trace.mutex_lock_count = 0;
+
+#if MBED_CONF_MBED_TRACE_DEFERRED
+    MBED_TRACE_MEM_FREE(m_trace.deferred_buf);
+    MBED_TRACE_MEM_FREE(m_trace.deferred_line);
+    m_trace.deferred_buf = 0;
+    m_trace.deferred_size = 0;
+    m_trace.deferred_head = 0;
+    m_trace.deferred_tail = 0;
+    m_trace.deferred_dropped = 0;
+    m_trace.deferred_line = 0;
+    m_trace.deferred_line_length = 0;
+#endif
 }
 static void mbed_trace_realloc(char **buffer, int *length_ptr, int new_length)
 {
@@ -319,16 +414,51 @@ void mbed_vtracef(uint8_t dlevel, const char *grp, const char *fmt, va_list ap)
         m_trace.mutex_lock_count++;
     }
 
+#if MBED_CONF_MBED_TRACE_DEFERRED
+    if (m_trace.deferred_buf) {
+        mbed_trace_deferred_record(dlevel, grp, fmt, ap);
+    } else
+#endif
+    if (mbed_trace_skip(dlevel, grp)) {
+        if (m_trace.line) {
+            m_trace.line[0] = 0; //by default trace is empty
+        }
+    } else {
+        mbed_trace_vprint(dlevel, grp, fmt, ap);
+    }
+    //return tmp data pointer back to the beginning
+    mbed_trace_reset_tmp();
+
+    if (m_trace.mutex_release_f) {
+        // Store the mutex lock count to temp variable so that it won't get
+        // clobbered during last loop iteration when mutex gets released
+        int count = m_trace.mutex_lock_count;
+        m_trace.mutex_lock_count = 0;
+        // Since the helper functions (eg. mbed_trace_array) are used like this:
+        //   mbed_tracef(TRACE_LEVEL_INFO, "grp", "%s", mbed_trace_array(some_array))
+        // The helper function MUST acquire the mutex if it modifies any buffers. However
+        // it CANNOT unlock the mutex because that would allow another thread to acquire
+        // the mutex after helper function unlocks it and before mbed_tracef acquires it
+        // for itself. This means that here we have to unlock the mutex as many times
+        // as it was acquired by trace function and any possible helper functions.
+        do {
+            m_trace.mutex_release_f();
+        } while (--count > 0);
+    }
+}
+/* Format and print a trace line, which has passed the filters. Called with the
+ * mutex held, as the line buffer is shared.
+ */
+static void mbed_trace_vprint(uint8_t dlevel, const char *grp, const char *fmt, va_list ap)
+{
     if (NULL == m_trace.line) {
-        goto end;
+        return;
     }
 
     m_trace.line[0] = 0; //by default trace is empty
 
-    if (mbed_trace_skip(dlevel, grp) || fmt == 0 || grp == 0 || !m_trace.printf) {
-        //return tmp data pointer back to the beginning
-        mbed_trace_reset_tmp();
-        goto end;
+    if (fmt == 0 || grp == 0 || !m_trace.printf) {
+        return;
     }
     if ((m_trace.trace_config & TRACE_MASK_LEVEL) &  dlevel) {
         bool color = (m_trace.trace_config & TRACE_MODE_COLOR) != 0;
@@ -472,26 +602,6 @@ void mbed_vtracef(uint8_t dlevel, const char *grp, const char *fmt, va_list ap)
             //print out whole data
             m_trace.printf(m_trace.line);
         }
-        //return tmp data pointer back to the beginning
-        mbed_trace_reset_tmp();
-    }
-
-end:
-    if (m_trace.mutex_release_f) {
-        // Store the mutex lock count to temp variable so that it won't get
-        // clobbered during last loop iteration when mutex gets released
-        int count = m_trace.mutex_lock_count;
-        m_trace.mutex_lock_count = 0;
-        // Since the helper functions (eg. mbed_trace_array) are used like this:
-        //   mbed_tracef(TRACE_LEVEL_INFO, "grp", "%s", mbed_trace_array(some_array))
-        // The helper function MUST acquire the mutex if it modifies any buffers. However
-        // it CANNOT unlock the mutex because that would allow another thread to acquire
-        // the mutex after helper function unlocks it and before mbed_tracef acquires it
-        // for itself. This means that here we have to unlock the mutex as many times
-        // as it was acquired by trace function and any possible helper functions.
-        do {
-            m_trace.mutex_release_f();
-        } while (--count > 0);
     }
 }
 static void mbed_trace_reset_tmp(void)
@@ -594,3 +704,528 @@ char *mbed_trace_array(const uint8_t *buf, uint16_t len)
     m_trace.tmp_data_ptr = wptr;
     return str;
 }
+#if MBED_CONF_MBED_TRACE_DEFERRED
+/* Deferred traces
+ *
+ * mbed_vtracef() only packs the arguments of the trace into a record of the
+ * ring buffer, copying strings because they may not outlive the call, and
+ * mbed_trace_deferred_flush() formats and prints the records later on. The
+ * ring buffer is lock-free for any number of producers and a single consumer:
+ * a producer reserves its record by moving the head with compare-and-swap and
+ * commits it by setting its state, and the consumer clears each record before
+ * moving the tail past it.
+ */
+typedef enum {
+    TRACE_ARG_NONE,     // "%%" or malformed conversion, no argument
+    TRACE_ARG_INT,
+    TRACE_ARG_LONG,
+    TRACE_ARG_LLONG,
+    TRACE_ARG_SIZE,
+    TRACE_ARG_INTMAX,
+    TRACE_ARG_PTRDIFF,
+    TRACE_ARG_DOUBLE,
+    TRACE_ARG_LDOUBLE,
+    TRACE_ARG_PTR,
+    TRACE_ARG_STR,
+    TRACE_ARG_IGNORED   // "%n" and wide strings, pointer consumed but nothing printed
+} trace_arg_t;
+
+typedef struct {
+    /** one past the conversion character */
+    const char *end;
+    /** trace_arg_t of the converted argument */
+    uint8_t arg;
+    /** number of '*' width and precision arguments, which come before the converted one */
+    uint8_t stars;
+    /** precision given with '*' */
+    bool star_precision;
+    /** precision, -1 when not given */
+    int precision;
+} trace_spec_t;
+
+/** parse the conversion specification starting at the '%' pointed by fmt */
+static void mbed_trace_spec_parse(const char *fmt, trace_spec_t *spec)
+{
+    const char *p = fmt + 1;
+    char length = 0;
+
+    spec->stars = 0;
+    spec->star_precision = false;
+    spec->precision = -1;
+
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            spec->star_precision = true;
+            p++;
+        } else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                spec->precision = spec->precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+    switch (*p) {
+        case 'h':
+            // char and short are promoted to int
+            p += p[1] == 'h' ? 2 : 1;
+            break;
+        case 'l':
+            length = 'l';
+            if (*++p == 'l') {
+                length = 'q';
+                p++;
+            }
+            break;
+        case 'j':
+        case 'z':
+        case 't':
+        case 'L':
+            length = *p++;
+            break;
+        default:
+            break;
+    }
+    spec->end = *p ? p + 1 : p;
+
+    switch (*p) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch (length) {
+                case 'l':
+                    spec->arg = TRACE_ARG_LONG;
+                    break;
+                case 'q':
+                    spec->arg = TRACE_ARG_LLONG;
+                    break;
+                case 'j':
+                    spec->arg = TRACE_ARG_INTMAX;
+                    break;
+                case 'z':
+                    spec->arg = TRACE_ARG_SIZE;
+                    break;
+                case 't':
+                    spec->arg = TRACE_ARG_PTRDIFF;
+                    break;
+                default:
+                    spec->arg = TRACE_ARG_INT;
+                    break;
+            }
+            break;
+        case 'c':
+            spec->arg = TRACE_ARG_INT;
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec->arg = length == 'L' ? TRACE_ARG_LDOUBLE : TRACE_ARG_DOUBLE;
+            break;
+        case 'p':
+            spec->arg = TRACE_ARG_PTR;
+            break;
+        case 's':
+            spec->arg = length == 'l' ? TRACE_ARG_IGNORED : TRACE_ARG_STR;
+            break;
+        case 'n':
+            spec->arg = TRACE_ARG_IGNORED;
+            break;
+        default:
+            spec->arg = TRACE_ARG_NONE;
+            break;
+    }
+}
+
+#define TRACE_PACK(value) do {                          \
+        if (buf) {                                      \
+            if (len + sizeof(value) > buf_len) {        \
+                return len;                             \
+            }                                           \
+            memcpy(buf + len, &(value), sizeof(value)); \
+        }                                               \
+        len += sizeof(value);                           \
+    } while (0)
+
+/** pack the arguments converted by fmt into buf, or only count their size when buf is NULL */
+static uint32_t mbed_trace_deferred_pack(const char *fmt, va_list ap, uint8_t *buf, uint32_t buf_len)
+{
+    uint32_t len = 0;
+    trace_spec_t spec;
+    int i;
+
+    while ((fmt = strchr(fmt, '%')) != NULL) {
+        mbed_trace_spec_parse(fmt, &spec);
+        fmt = spec.end;
+        if (spec.arg == TRACE_ARG_NONE) {
+            continue;
+        }
+        for (i = 0; i < spec.stars; i++) {
+            int star = va_arg(ap, int);
+            if (spec.star_precision && i == spec.stars - 1) {
+                spec.precision = star;
+            }
+            TRACE_PACK(star);
+        }
+        switch (spec.arg) {
+            case TRACE_ARG_INT: {
+                int value = va_arg(ap, int);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_LONG: {
+                long value = va_arg(ap, long);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_LLONG: {
+                long long value = va_arg(ap, long long);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_SIZE: {
+                size_t value = va_arg(ap, size_t);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_INTMAX: {
+                intmax_t value = va_arg(ap, intmax_t);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_PTRDIFF: {
+                ptrdiff_t value = va_arg(ap, ptrdiff_t);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_DOUBLE: {
+                double value = va_arg(ap, double);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_LDOUBLE: {
+                long double value = va_arg(ap, long double);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_PTR: {
+                void *value = va_arg(ap, void *);
+                TRACE_PACK(value);
+                break;
+            }
+            case TRACE_ARG_STR: {
+                const char *str = va_arg(ap, const char *);
+                uint32_t n = 0, max = DEFAULT_TRACE_DEFERRED_STRING_LEN;
+                if (str == NULL) {
+                    str = "(null)";
+                }
+                if (spec.precision >= 0 && (uint32_t)spec.precision < max) {
+                    max = spec.precision;
+                }
+                if (buf) {
+                    if (len >= buf_len) {
+                        return len;
+                    }
+                    if (max > buf_len - len - 1) {
+                        max = buf_len - len - 1;
+                    }
+                }
+                while (n < max && str[n]) {
+                    n++;
+                }
+                if (buf) {
+                    memcpy(buf + len, str, n);
+                    buf[len + n] = 0;
+                }
+                len += n + 1;
+                break;
+            }
+            default:
+                (void)va_arg(ap, void *);
+                break;
+        }
+    }
+    return len;
+}
+
+static void mbed_trace_deferred_record(uint8_t dlevel, const char *grp, const char *fmt, va_list ap)
+{
+    trace_record_t *record;
+    uint32_t size = m_trace.deferred_size;
+    uint32_t head, offset, padding, len;
+    va_list ap2;
+
+    if (mbed_trace_skip(dlevel, grp) || fmt == 0 || grp == 0 ||
+            ((m_trace.trace_config & TRACE_MASK_LEVEL) & dlevel) == 0) {
+        return;
+    }
+
+    va_copy(ap2, ap);
+    len = mbed_trace_deferred_pack(fmt, ap2, NULL, 0);
+    va_end(ap2);
+    len = (sizeof(trace_record_t) + len + TRACE_RECORD_ALIGN - 1) & ~(TRACE_RECORD_ALIGN - 1);
+
+    // records are contiguous, skip the end of the buffer if the record does not fit in it
+    head = trace_atomic_load(&m_trace.deferred_head);
+    do {
+        offset = head & (size - 1);
+        padding = offset + len > size ? size - offset : 0;
+        if (padding + len > size - (head - trace_atomic_load(&m_trace.deferred_tail))) {
+            trace_atomic_incr(&m_trace.deferred_dropped);
+            return;
+        }
+    } while (!trace_atomic_cas(&m_trace.deferred_head, &head, head + padding + len));
+
+    if (padding) {
+        record = (trace_record_t *)(m_trace.deferred_buf + offset);
+        trace_atomic_store(&record->state, padding | TRACE_RECORD_PADDING | TRACE_RECORD_COMMITTED);
+        offset = 0;
+    }
+    record = (trace_record_t *)(m_trace.deferred_buf + offset);
+    record->dlevel = dlevel;
+    record->grp = grp;
+    record->fmt = fmt;
+    mbed_trace_deferred_pack(fmt, ap, (uint8_t *)(record + 1), len - sizeof(trace_record_t));
+    trace_atomic_store(&record->state, len | TRACE_RECORD_COMMITTED);
+}
+
+#define TRACE_UNPACK(value) do {                        \
+        if (args + sizeof(value) > args_end) {          \
+            goto end;                                   \
+        }                                               \
+        memcpy(&(value), args, sizeof(value));          \
+        args += sizeof(value);                          \
+    } while (0)
+
+#define TRACE_SNPRINTF(value)                                           \
+    (spec.stars == 0 ? snprintf(str, bLeft, conv, value) :              \
+     spec.stars == 1 ? snprintf(str, bLeft, conv, star[0], value) :     \
+     snprintf(str, bLeft, conv, star[0], star[1], value))
+
+/** format fmt with the arguments packed by mbed_trace_deferred_pack() */
+static void mbed_trace_deferred_format(char *str, int bLeft, const char *fmt,
+                                       const uint8_t *args, const uint8_t *args_end)
+{
+    trace_spec_t spec;
+    char conv[16];
+    int star[2];
+    int i, retval;
+
+    while (bLeft > 1 && *fmt) {
+        const char *pct = strchr(fmt, '%');
+        size_t n = pct ? (size_t)(pct - fmt) : strlen(fmt);
+        if (n > (size_t)bLeft - 1) {
+            n = bLeft - 1;
+        }
+        memcpy(str, fmt, n);
+        str += n;
+        bLeft -= n;
+        if (pct == NULL || bLeft <= 1) {
+            break;
+        }
+
+        mbed_trace_spec_parse(pct, &spec);
+        fmt = spec.end;
+        if (spec.arg == TRACE_ARG_NONE) {
+            if (spec.end - pct >= 2 && spec.end[-1] == '%') {
+                *str++ = '%';
+                bLeft--;
+            }
+            continue;
+        }
+        if ((size_t)(spec.end - pct) >= sizeof(conv)) {
+            break;
+        }
+        memcpy(conv, pct, spec.end - pct);
+        conv[spec.end - pct] = 0;
+        for (i = 0; i < spec.stars; i++) {
+            TRACE_UNPACK(star[i]);
+        }
+
+        switch (spec.arg) {
+            case TRACE_ARG_INT: {
+                int value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_LONG: {
+                long value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_LLONG: {
+                long long value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_SIZE: {
+                size_t value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_INTMAX: {
+                intmax_t value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_PTRDIFF: {
+                ptrdiff_t value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_DOUBLE: {
+                double value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_LDOUBLE: {
+                long double value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_PTR: {
+                void *value;
+                TRACE_UNPACK(value);
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            case TRACE_ARG_STR: {
+                const char *value = (const char *)args;
+                const char *nul = memchr(args, 0, args_end - args);
+                if (nul == NULL) {
+                    goto end;
+                }
+                args = (const uint8_t *)nul + 1;
+                retval = TRACE_SNPRINTF(value);
+                break;
+            }
+            default:
+                retval = 0;
+                break;
+        }
+        if (retval < 0) {
+            retval = 0;
+        }
+        if (retval >= bLeft) {
+            retval = bLeft - 1;
+        }
+        str += retval;
+        bLeft -= retval;
+    }
+end:
+    *str = 0;
+}
+
+static void mbed_trace_print(uint8_t dlevel, const char *grp, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    mbed_trace_vprint(dlevel, grp, fmt, ap);
+    va_end(ap);
+}
+int mbed_trace_deferred_buffer_size(uint32_t size)
+{
+    uint8_t *buf = NULL;
+    char *line = NULL;
+
+    // print the traces recorded with the previous buffer
+    mbed_trace_deferred_flush();
+
+    if (size > 0) {
+        while (size & (size - 1)) {
+            size &= size - 1;
+        }
+        if (size < TRACE_DEFERRED_MIN_SIZE) {
+            size = TRACE_DEFERRED_MIN_SIZE;
+        }
+        buf = MBED_TRACE_MEM_ALLOC(size);
+        line = MBED_TRACE_MEM_ALLOC(m_trace.line_length);
+        if (buf == NULL || line == NULL) {
+            MBED_TRACE_MEM_FREE(buf);
+            MBED_TRACE_MEM_FREE(line);
+            return -1;
+        }
+        memset(buf, 0, size);
+    }
+
+    MBED_TRACE_MEM_FREE(m_trace.deferred_buf);
+    MBED_TRACE_MEM_FREE(m_trace.deferred_line);
+    m_trace.deferred_buf = buf;
+    m_trace.deferred_size = size;
+    m_trace.deferred_head = 0;
+    m_trace.deferred_tail = 0;
+    m_trace.deferred_line = line;
+    m_trace.deferred_line_length = size > 0 ? m_trace.line_length : 0;
+    return 0;
+}
+int mbed_trace_deferred_flush(void)
+{
+    trace_record_t *record;
+    uint32_t tail = m_trace.deferred_tail;
+    uint32_t state, len;
+    int count = 0;
+
+    if (m_trace.deferred_buf == NULL) {
+        return 0;
+    }
+    while (tail != trace_atomic_load(&m_trace.deferred_head)) {
+        record = (trace_record_t *)(m_trace.deferred_buf + (tail & (m_trace.deferred_size - 1)));
+        state = trace_atomic_load(&record->state);
+        if (!(state & TRACE_RECORD_COMMITTED)) {
+            // the producer is still writing it
+            break;
+        }
+        len = state & TRACE_RECORD_LEN_MASK;
+        if (!(state & TRACE_RECORD_PADDING)) {
+            // the line is printed through the line buffer that traces printed
+            // directly also use
+            if (m_trace.mutex_wait_f) {
+                m_trace.mutex_wait_f();
+            }
+            mbed_trace_deferred_format(m_trace.deferred_line, m_trace.deferred_line_length, record->fmt,
+                                       (const uint8_t *)(record + 1), (const uint8_t *)record + len);
+            mbed_trace_print(record->dlevel, record->grp, "%s", m_trace.deferred_line);
+            if (m_trace.mutex_release_f) {
+                m_trace.mutex_release_f();
+            }
+            count++;
+        }
+        // producers expect a cleared state where their record starts
+        memset(record, 0, len);
+        tail += len;
+        trace_atomic_store(&m_trace.deferred_tail, tail);
+    }
+    return count;
+}
+uint32_t mbed_trace_deferred_dropped(void)
+{
+    return trace_atomic_load(&m_trace.deferred_dropped);
+}
+#endif //MBED_CONF_MBED_TRACE_DEFERRED
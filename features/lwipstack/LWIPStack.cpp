@@ -33,6 +33,7 @@
 #include "lwip/dns.h"
 #include "lwip/udp.h"
 #include "lwip/raw.h"
+#include "lwip/stats.h"
 #include "lwip/lwip_errno.h"
 #include "lwip-sys/arch/sys_arch.h"
 
@@ -54,10 +55,34 @@ void LWIP::socket_callback(struct netconn *nc, enum netconn_evt eh, u16_t len)
     lwip.adaptation.lock();
 
     for (int i = 0; i < MEMP_NUM_NETCONN; i++) {
-        if (lwip.arena[i].in_use
-                && lwip.arena[i].conn == nc
-                && lwip.arena[i].cb) {
-            lwip.arena[i].cb(lwip.arena[i].data);
+        struct mbed_lwip_socket *s = &lwip.arena[i];
+        if (!s->in_use || s->conn != nc) {
+            continue;
+        }
+
+        // Count the datagrams queued on UDP sockets. With NSAPI_COALESCE_RECV_EVENTS,
+        // a burst of datagrams wakes the application once: after the first
+        // datagram, the callback is not called again until the application
+        // calls receive. Datagrams being taken off the queue by the
+        // application itself are not news.
+        if (NETCONNTYPE_GROUP(nc->type) == NETCONN_UDP) {
+            if (eh == NETCONN_EVT_RCVPLUS) {
+                s->rx_queued++;
+                if (s->rx_coalesce && core_util_atomic_flag_test_and_set(&s->rx_signalled)) {
+                    continue;
+                }
+            } else if (eh == NETCONN_EVT_RCVMINUS) {
+                if (s->rx_queued) {
+                    s->rx_queued--;
+                }
+                if (s->rx_coalesce) {
+                    continue;
+                }
+            }
+        }
+
+        if (s->cb) {
+            s->cb(s->data);
         }
     }
 
@@ -231,6 +256,67 @@ LWIP::call_in_callback_cb_t LWIP::get_call_in_callback()
     return cb;
 }
 
+NetStackMemoryManager *LWIP::get_memory_manager()
+{
+    return &memory_manager;
+}
+
+nsapi_error_t LWIP::get_stack_stats(nsapi_stack_stats_t *stats)
+{
+#if LWIP_STATS
+    memset(stats, 0, sizeof(nsapi_stack_stats_t));
+#if TCP_STATS
+    stats->tcp_sent = lwip_stats.tcp.xmit;
+    stats->tcp_received = lwip_stats.tcp.recv;
+    stats->tcp_dropped = lwip_stats.tcp.drop;
+#endif
+#if MIB2_STATS
+    stats->tcp_retransmits = lwip_stats.mib2.tcpretranssegs;
+#endif
+#if UDP_STATS
+    stats->udp_sent = lwip_stats.udp.xmit;
+    stats->udp_received = lwip_stats.udp.recv;
+    stats->udp_dropped = lwip_stats.udp.drop;
+#endif
+    return NSAPI_ERROR_OK;
+#else
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif
+}
+
+#if MEMP_STATS
+static const char *const memp_names[] = {
+#define LWIP_MEMPOOL(name, num, size, desc) desc,
+#include "lwip/priv/memp_std.h"
+};
+#endif
+
+size_t LWIP::get_pool_stats(nsapi_pool_stats_t *stats, size_t count)
+{
+    size_t i = 0;
+#if LWIP_STATS && MEM_STATS
+    if (i < count) {
+        stats[i].name = "HEAP";
+        stats[i].size = lwip_stats.mem.avail;
+        stats[i].used = lwip_stats.mem.used;
+        stats[i].max_used = lwip_stats.mem.max;
+        stats[i].errors = lwip_stats.mem.err;
+        i++;
+    }
+#endif
+#if LWIP_STATS && MEMP_STATS
+    for (int j = 0; j < MEMP_MAX && i < count; j++, i++) {
+        const struct stats_mem *pool = lwip_stats.memp[j];
+        stats[i].name = memp_names[j];
+        stats[i].size = pool->avail;
+        stats[i].used = pool->used;
+        stats[i].max_used = pool->max;
+        stats[i].errors = pool->err;
+    }
+#endif
+    return i;
+}
+
 const char *LWIP::get_ip_address()
 {
     if (!default_interface) {
@@ -415,6 +501,7 @@ nsapi_size_or_error_t LWIP::socket_send(nsapi_socket_t handle, const void *data,
 nsapi_size_or_error_t LWIP::socket_recv(nsapi_socket_t handle, void *data, nsapi_size_t size)
 {
     struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+    core_util_atomic_flag_clear(&s->rx_signalled);
 
     if (!s->buf) {
         err_t err = netconn_recv(s->conn, &s->buf);
@@ -466,6 +553,7 @@ nsapi_size_or_error_t LWIP::socket_sendto(nsapi_socket_t handle, const SocketAdd
 nsapi_size_or_error_t LWIP::socket_recvfrom(nsapi_socket_t handle, SocketAddress *address, void *data, nsapi_size_t size)
 {
     struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+    core_util_atomic_flag_clear(&s->rx_signalled);
     struct netbuf *buf;
 
     err_t err = netconn_recv(s->conn, &buf);
@@ -486,6 +574,327 @@ nsapi_size_or_error_t LWIP::socket_recvfrom(nsapi_socket_t handle, SocketAddress
     return recv;
 }
 
+nsapi_size_or_error_t LWIP::socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+                                           const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+
+    if (NETCONNTYPE_GROUP(s->conn->type) == NETCONN_TCP) {
+        nsapi_size_t sent = 0;
+        for (unsigned i = 0; i < iovcnt; i++) {
+            if (!iov[i].iov_len) {
+                continue;
+            }
+
+            size_t bytes_written = 0;
+            err_t err = netconn_write_partly(s->conn, iov[i].iov_base, iov[i].iov_len,
+                                             NETCONN_COPY | (i + 1 < iovcnt ? NETCONN_MORE : 0), &bytes_written);
+            if (err != ERR_OK) {
+                if (sent) {
+                    break;
+                }
+                return err_remap(err);
+            }
+
+            sent += bytes_written;
+            if (bytes_written < iov[i].iov_len) {
+                break;
+            }
+        }
+        return sent;
+    }
+
+    ip_addr_t ip_addr;
+    if (address) {
+        nsapi_addr_t addr = address->get_addr();
+        if (!convert_mbed_addr_to_lwip(&ip_addr, &addr)) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+    }
+
+    nsapi_size_t size = 0;
+    for (unsigned i = 0; i < iovcnt; i++) {
+        size += iov[i].iov_len;
+    }
+    if (size > 0xFFFF) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    struct netbuf *buf = netbuf_new();
+    if (!buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    // Chain pbufs referring to each buffer, as netbuf_ref does for one
+    for (unsigned i = 0; i < iovcnt; i++) {
+        if (!iov[i].iov_len) {
+            continue;
+        }
+
+        struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)iov[i].iov_len, PBUF_REF);
+        if (!p) {
+            netbuf_delete(buf);
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+        p->payload = iov[i].iov_base;
+
+        if (buf->p) {
+            pbuf_cat(buf->p, p);
+        } else {
+            buf->p = p;
+            buf->ptr = p;
+        }
+    }
+
+    err_t err = ERR_OK;
+    if (!buf->p) {
+        // Empty datagram
+        err = netbuf_ref(buf, NULL, 0);
+    }
+    if (err == ERR_OK) {
+        if (address) {
+            err = netconn_sendto(s->conn, buf, &ip_addr, address->get_port());
+        } else {
+            err = netconn_send(s->conn, buf);
+        }
+    }
+    netbuf_delete(buf);
+    if (err != ERR_OK) {
+        return err_remap(err);
+    }
+
+    return size;
+}
+
+nsapi_size_or_error_t LWIP::socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+                                           const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+    core_util_atomic_flag_clear(&s->rx_signalled);
+    nsapi_size_t recv = 0;
+
+    if (NETCONNTYPE_GROUP(s->conn->type) == NETCONN_TCP) {
+        if (!s->buf) {
+            err_t err = netconn_recv(s->conn, &s->buf);
+            s->offset = 0;
+
+            if (err != ERR_OK) {
+                return err_remap(err);
+            }
+        }
+
+        for (unsigned i = 0; i < iovcnt && s->offset < netbuf_len(s->buf); i++) {
+            u16_t len = netbuf_copy_partial(s->buf, iov[i].iov_base, (u16_t)iov[i].iov_len, s->offset);
+            s->offset += len;
+            recv += len;
+        }
+
+        if (s->offset >= netbuf_len(s->buf)) {
+            netbuf_delete(s->buf);
+            s->buf = 0;
+        }
+
+        return recv;
+    }
+
+    struct netbuf *buf;
+    err_t err = netconn_recv(s->conn, &buf);
+    if (err != ERR_OK) {
+        return err_remap(err);
+    }
+
+    if (address) {
+        nsapi_addr_t addr;
+        convert_lwip_addr_to_mbed(&addr, netbuf_fromaddr(buf));
+        address->set_addr(addr);
+        address->set_port(netbuf_fromport(buf));
+    }
+
+    for (unsigned i = 0; i < iovcnt && recv < netbuf_len(buf); i++) {
+        recv += netbuf_copy_partial(buf, iov[i].iov_base, (u16_t)iov[i].iov_len, (u16_t)recv);
+    }
+    netbuf_delete(buf);
+
+    return recv;
+}
+
+nsapi_size_or_error_t LWIP::socket_recvmmsg(nsapi_socket_t handle, nsapi_msg_t *msgs, unsigned count)
+{
+    struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+    core_util_atomic_flag_clear(&s->rx_signalled);
+
+    if (NETCONNTYPE_GROUP(s->conn->type) != NETCONN_UDP) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    unsigned received = 0;
+    while (received < count) {
+        // Only the first netconn_recv may wait for the receive timeout,
+        // the rest of the batch is what is already queued
+        if (received && !core_util_atomic_load_u32(&s->rx_queued)) {
+            break;
+        }
+
+        struct netbuf *buf;
+        err_t err = netconn_recv(s->conn, &buf);
+        if (err != ERR_OK) {
+            if (received) {
+                break;
+            }
+            return err_remap(err);
+        }
+
+        nsapi_msg_t *msg = &msgs[received++];
+        convert_lwip_addr_to_mbed(&msg->msg_addr, netbuf_fromaddr(buf));
+        msg->msg_port = netbuf_fromport(buf);
+        // A datagram is at most 65535 bytes, larger buffers would be truncated
+        msg->msg_len = netbuf_copy(buf, msg->msg_buf, msg->msg_size > 0xFFFF ? 0xFFFF : (u16_t)msg->msg_size);
+        netbuf_delete(buf);
+    }
+
+    return received;
+}
+
+nsapi_size_or_error_t LWIP::socket_send_buf(nsapi_socket_t handle, const SocketAddress *address,
+                                            net_stack_mem_buf_t *buf, nsapi_size_t offset)
+{
+    struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+    struct pbuf *p = static_cast<struct pbuf *>(buf);
+
+    if (NETCONNTYPE_GROUP(s->conn->type) == NETCONN_TCP) {
+        struct pbuf *q = p;
+        while (q && offset >= q->len) {
+            offset -= q->len;
+            q = q->next;
+        }
+        if (!q) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+
+        // lwIP builds TCP segments from application data rather than pbufs,
+        // so the data is copied, but straight from the pbufs
+        nsapi_size_t sent = 0;
+        while (q) {
+            size_t bytes_written = 0;
+            err_t err = netconn_write_partly(s->conn, static_cast<u8_t *>(q->payload) + offset, q->len - offset,
+                                             NETCONN_COPY | (q->next ? NETCONN_MORE : 0), &bytes_written);
+            if (err != ERR_OK) {
+                if (sent) {
+                    break;
+                }
+                return err_remap(err);
+            }
+
+            sent += bytes_written;
+            if (bytes_written < q->len - offset) {
+                break;
+            }
+            offset = 0;
+            q = q->next;
+        }
+
+        if (!q) {
+            pbuf_free(p);
+        }
+        return sent;
+    }
+
+    if (offset != 0) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    ip_addr_t ip_addr;
+    if (address) {
+        nsapi_addr_t addr = address->get_addr();
+        if (!convert_mbed_addr_to_lwip(&ip_addr, &addr)) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+    }
+
+    struct netbuf *nbuf = netbuf_new();
+    if (!nbuf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    u16_t len = p->tot_len;
+    nbuf->p = p;
+    nbuf->ptr = p;
+
+    err_t err;
+    if (address) {
+        err = netconn_sendto(s->conn, nbuf, &ip_addr, address->get_port());
+    } else {
+        err = netconn_send(s->conn, nbuf);
+    }
+
+    if (err != ERR_OK) {
+        // The buffer still belongs to the caller, so drop any headers
+        // added in front of the payload
+        if (p->tot_len > len) {
+            pbuf_header(p, -(s16_t)(p->tot_len - len));
+        }
+        nbuf->p = NULL;
+        nbuf->ptr = NULL;
+        netbuf_delete(nbuf);
+        return err_remap(err);
+    }
+
+    // Frees the pbuf chain
+    netbuf_delete(nbuf);
+
+    return len;
+}
+
+nsapi_size_or_error_t LWIP::socket_recv_buf(nsapi_socket_t handle, SocketAddress *address,
+                                            net_stack_mem_buf_t **buf)
+{
+    struct mbed_lwip_socket *s = (struct mbed_lwip_socket *)handle;
+    core_util_atomic_flag_clear(&s->rx_signalled);
+    struct netbuf *nbuf = s->buf;
+
+    if (nbuf) {
+        s->buf = 0;
+
+        // Data partly read by socket_recv can not be handed over in
+        // place, so only the rest of it is copied
+        if (s->offset) {
+            u16_t len = netbuf_len(nbuf) - s->offset;
+            struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+            if (!p) {
+                s->buf = nbuf;
+                return NSAPI_ERROR_NO_MEMORY;
+            }
+
+            netbuf_copy_partial(nbuf, p->payload, len, s->offset);
+            netbuf_delete(nbuf);
+
+            *buf = static_cast<net_stack_mem_buf_t *>(p);
+            return len;
+        }
+    } else {
+        err_t err = netconn_recv(s->conn, &nbuf);
+        if (err != ERR_OK) {
+            return err_remap(err);
+        }
+    }
+
+    if (address) {
+        nsapi_addr_t addr;
+        convert_lwip_addr_to_mbed(&addr, netbuf_fromaddr(nbuf));
+        address->set_addr(addr);
+        address->set_port(netbuf_fromport(nbuf));
+    }
+
+    // Take the pbuf chain over from the netbuf
+    struct pbuf *p = nbuf->p;
+    nbuf->p = NULL;
+    nbuf->ptr = NULL;
+    netbuf_delete(nbuf);
+
+    *buf = static_cast<net_stack_mem_buf_t *>(p);
+    return p->tot_len;
+}
+
 int32_t LWIP::find_multicast_member(const struct mbed_lwip_socket *s, const nsapi_ip_mreq_t *imr)
 {
     uint32_t count = 0;
@@ -554,6 +963,14 @@ nsapi_error_t LWIP::setsockopt(nsapi_socket_t handle, int level, int optname, co
             return 0;
 #endif
 
+        case NSAPI_COALESCE_RECV_EVENTS:
+            if (optlen != sizeof(int) || NETCONNTYPE_GROUP(s->conn->type) != NETCONN_UDP) {
+                return NSAPI_ERROR_UNSUPPORTED;
+            }
+
+            s->rx_coalesce = *(int *)optval != 0;
+            return 0;
+
         case NSAPI_REUSEADDR:
             if (optlen != sizeof(int)) {
                 return NSAPI_ERROR_UNSUPPORTED;
@@ -28,6 +28,7 @@
 #include "netsocket/L3IP.h"
 #include "netsocket/OnboardNetworkStack.h"
 #include "LWIPMemoryManager.h"
+#include "mbed_critical.h"
 
 
 class LWIP : public OnboardNetworkStack, private mbed::NonCopyable<LWIP> {
@@ -278,6 +279,33 @@ public:
      *                  or null if not yet connected
      */
     virtual const char *get_ip_address();
+
+    /** Get the memory manager of the stack
+     *
+     *  @return         Memory manager of lwIP pbufs
+     */
+    virtual NetStackMemoryManager *get_memory_manager();
+
+    /** Get protocol counters of the stack
+     *
+     *  Requires nsapi.socket-stats-enabled, which enables lwIP statistics.
+     *
+     *  @param stats    Destination for the counters
+     *  @return         NSAPI_ERROR_OK on success, NSAPI_ERROR_UNSUPPORTED
+     *                  if lwIP statistics are disabled
+     */
+    virtual nsapi_error_t get_stack_stats(nsapi_stack_stats_t *stats);
+
+    /** Get usage of the lwIP heap and memory pools
+     *
+     *  Requires nsapi.socket-stats-enabled, which enables lwIP statistics.
+     *
+     *  @param stats    Array of structures to fill
+     *  @param count    Number of structures in the array
+     *  @return         Number of structures filled
+     */
+    virtual size_t get_pool_stats(nsapi_pool_stats_t *stats, size_t count);
+
     /** Set the network interface as default one
       */
     virtual void set_default_interface(OnboardNetworkStack::Interface *interface);
@@ -435,12 +463,88 @@ protected:
     virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
                                                   void *buffer, nsapi_size_t size);
 
+    /** Send a message gathered from a list of buffers
+     *
+     *  UDP datagrams are sent as a chain of pbufs referring to the buffers,
+     *  without gathering them first. TCP data is written buffer by buffer.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host or NULL
+     *  @param iov      Buffers of data to send to the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a message scattered into a list of buffers
+     *
+     *  Data is copied from the received netbuf straight into the buffers.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param iov      Destination buffers for data received from the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a batch of datagrams over a UDP socket
+     *
+     *  Takes the netbufs queued on the netconn without waiting, once the
+     *  first one has been received.
+     *
+     *  @param handle   Socket handle
+     *  @param msgs     Array of datagram buffers
+     *  @param count    Number of entries in msgs
+     *  @return         Number of received datagrams on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recvmmsg(nsapi_socket_t handle, nsapi_msg_t *msgs, unsigned count);
+
+    /** Send data from a pbuf chain
+     *
+     *  UDP datagrams are sent without copying. lwIP TCP cannot take over
+     *  pbufs from the application, so TCP data is copied into the send
+     *  buffer as for socket_send.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host, or NULL to send
+     *                  to the connected peer
+     *  @param buf      pbuf chain to send
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_send_buf(nsapi_socket_t handle, const SocketAddress *address,
+                                                  net_stack_mem_buf_t *buf, nsapi_size_t offset);
+
+    /** Receive data as a pbuf chain
+     *
+     *  Hands over the pbuf chain of the next received netbuf without copying.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for the received pbuf chain
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recv_buf(nsapi_socket_t handle, SocketAddress *address,
+                                                  net_stack_mem_buf_t **buf);
+
     /** Register a callback on state change of the socket
      *
      *  The specified callback will be called on state changes such as when
      *  the socket can recv/send/accept successfully and on when an error
      *  occurs. The callback may also be called spuriously without reason.
      *
+     *  On UDP sockets with the NSAPI_COALESCE_RECV_EVENTS option set, the
+     *  callback is called for the first datagram received after a receive
+     *  call, but not for the datagrams following it.
+     *
      *  The callback may be called in an interrupt context and should not
      *  perform expensive operations such as recv/send calls.
      *
@@ -524,6 +628,12 @@ private:
         void (*cb)(void *);
         void *data;
 
+        // Datagrams queued on a UDP netconn, whether receive events are
+        // coalesced, and whether the callback has been called since the last receive
+        uint32_t rx_queued;
+        bool rx_coalesce;
+        core_util_atomic_flag rx_signalled;
+
         // Track multicast addresses subscribed to by this socket
         nsapi_ip_mreq_t *multicast_memberships;
         uint32_t         multicast_memberships_count;
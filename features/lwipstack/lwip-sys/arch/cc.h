@@ -80,16 +80,18 @@
 #if defined(TOOLCHAIN_GCC) && defined(__thumb2__)
     #define MEMCPY(dst,src,len)     thumb2_memcpy(dst,src,len)
     #define LWIP_CHKSUM             thumb2_checksum
-    /* Set algorithm to 0 so that unused lwip_standard_chksum function
-       doesn't generate compiler warning */
-    #define LWIP_CHKSUM_ALGORITHM   0
 
     void* thumb2_memcpy(void* pDest, const void* pSource, size_t length);
     uint16_t thumb2_checksum(const void* pData, int length);
 #else
-    /* Used with IP headers only */
-    #define LWIP_CHKSUM_ALGORITHM   1
+    /* Word-at-a-time C routine for other toolchains */
+    #define LWIP_CHKSUM             portable_checksum
+
+    uint16_t portable_checksum(const void* pData, int length);
 #endif
+/* Set algorithm to 0 so that unused lwip_standard_chksum function
+   doesn't generate compiler warning */
+#define LWIP_CHKSUM_ALGORITHM   0
 
 
 #ifdef LWIP_DEBUG
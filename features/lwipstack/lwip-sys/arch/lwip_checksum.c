@@ -12,13 +12,16 @@
    See the License for the specific language governing permissions and
    limitations under the License.
 */
+#include <stdint.h>
+
 #if defined(TOOLCHAIN_GCC) && defined(__thumb2__)
 
 
 /* This is a hand written Thumb-2 assembly language version of the
    algorithm 3 version of lwip_standard_chksum in lwIP's inet_chksum.c.  It
-   performs the checksumming 32-bits at a time and even unrolls the loop to
-   perform two of these 32-bit adds per loop iteration.
+   performs the checksumming 32-bits at a time and unrolls the loop to
+   load four words with a single LDM and add them in one carry chain per
+   loop iteration.
    
    Returns:
         16-bit 1's complement summation (not inversed).
@@ -35,7 +38,7 @@ __attribute__((naked)) void /*uint16_t*/ thumb2_checksum(const void* pData, int
 
         // Push non-volatile registers we use on stack.  Push link register too to
         // keep stack 8-byte aligned and allow single pop to restore and return.
-        "    push        {r4, lr}\n"
+        "    push        {r4, r5, r6, lr}\n"
         // Initialize sum, r2, to 0.
         "    movs    r2, #0\n"
         // Remember whether pData was at odd address in r3.  This is used later to
@@ -69,21 +72,32 @@ __attribute__((naked)) void /*uint16_t*/ thumb2_checksum(const void* pData, int
         "    adds    r2, r2, r4\n"
         "    subs    r1, r1, #2\n"
 
-        // Main summing loop which sums up data 2 words at a time.
-        // Make sure that we have more than 7 bytes left to sum.
+        // Main summing loop which sums up data 4 words at a time.
+        // Make sure that we have more than 15 bytes left to sum.
         "2$:\n"
-        "    cmp     r1, #8\n"
-        "    blt     3$\n"
-        // Sum next two words.  Applying previous upper 16-bit carry to
-        // lower 16-bits.
-        "    ldr     r4, [r0], #4\n"
+        "    cmp     r1, #16\n"
+        "    blt     4$\n"
+        // Sum next four words in a single carry chain.  Applying the final
+        // upper 16-bit carry to lower 16-bits.
+        "    ldmia   r0!, {r4, r5, r6, r12}\n"
         "    adds    r2, r4\n"
+        "    adcs    r2, r5\n"
+        "    adcs    r2, r6\n"
+        "    adcs    r2, r12\n"
         "    adc     r2, r2, #0\n"
+        "    subs    r1, r1, #16\n"
+        "    b       2$\n"
+
+        // Sum up any remaining words.
+        "4$:\n"
+        // Make sure that we have more than 3 bytes left to sum.
+        "    cmp     r1, #4\n"
+        "    blt     3$\n"
         "    ldr     r4, [r0], #4\n"
         "    adds    r2, r4\n"
         "    adc     r2, r2, #0\n"
-        "    subs    r1, r1, #8\n"
-        "    b       2$\n"
+        "    subs    r1, r1, #4\n"
+        "    b       4$\n"
 
         // Sum up any remaining half-words.
         "3$:\n"
@@ -119,8 +133,81 @@ __attribute__((naked)) void /*uint16_t*/ thumb2_checksum(const void* pData, int
 
         // Return final sum.
         "9$: mov     r0, r2\n"
-        "    pop     {r4, pc}\n"
+        "    pop     {r4, r5, r6, pc}\n"
     );
 }
 
+#else
+
+/* Portable C version of the algorithm 3 version of lwip_standard_chksum,
+   used by toolchains that can't build the Thumb-2 routine above and by host
+   builds.  32-bit words are summed into a 64-bit accumulator, so no carries
+   need to be applied inside the loop, and the loop is unrolled to sum four
+   words per iteration.
+
+   Returns:
+        16-bit 1's complement summation (not inversed).
+*/
+uint16_t portable_checksum(const void *pData, int length)
+{
+    const uint8_t *pb = (const uint8_t *)pData;
+    const uint16_t *ps;
+    const uint32_t *pl;
+    uint64_t sum = 0;
+    uint16_t t = 0;
+    int odd = ((uintptr_t)pb & 1);
+
+    // Place the first byte in the odd summation location, the result is
+    // swapped later since the summation is done at an offset of 1
+    if (odd && length > 0) {
+        ((uint8_t *)&t)[1] = *pb++;
+        length--;
+    }
+
+    // 4-byte align
+    ps = (const uint16_t *)(const void *)pb;
+    if (((uintptr_t)ps & 3) && length > 1) {
+        sum += *ps++;
+        length -= 2;
+    }
+
+    // Main summing loop which sums up data 4 words at a time
+    pl = (const uint32_t *)(const void *)ps;
+    while (length > 15) {
+        sum += (uint64_t)pl[0] + pl[1] + pl[2] + pl[3];
+        pl += 4;
+        length -= 16;
+    }
+
+    // Sum up any remaining words and half-words
+    while (length > 3) {
+        sum += *pl++;
+        length -= 4;
+    }
+    ps = (const uint16_t *)(const void *)pl;
+    if (length > 1) {
+        sum += *ps++;
+        length -= 2;
+    }
+
+    // Handle trailing byte, if it exists
+    if (length > 0) {
+        ((uint8_t *)&t)[0] = *(const uint8_t *)ps;
+    }
+    sum += t;
+
+    // Fold 64-bit checksum into 16-bit checksum
+    sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+
+    // Swap bytes if started at odd address
+    if (odd) {
+        sum = ((sum & 0xFF) << 8) | (sum >> 8);
+    }
+
+    return (uint16_t)sum;
+}
+
 #endif
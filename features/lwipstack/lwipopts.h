@@ -320,8 +320,18 @@
 #define LWIP_DBG_MIN_LEVEL          LWIP_DBG_LEVEL_ALL
 #else
 #define LWIP_NOASSERT               1
+#if !MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
 #define LWIP_STATS                  0
 #endif
+#endif
+
+// Protocol counters and memory pool high-water marks,
+// reported by LWIP::get_stack_stats() and LWIP::get_pool_stats()
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+#define LWIP_STATS                  1
+#define LWIP_STATS_LARGE            1
+#define MIB2_STATS                  1
+#endif
 
 #define TRACE_TO_ASCII_HEX_DUMP     0
 
@@ -377,8 +387,13 @@
 #ifndef LWIP_ARP
 #define LWIP_ARP                    0
 #endif
-// Checksum-on-copy disabled due to https://savannah.nongnu.org/bugs/?50914
+// Calculate the TCP checksum of copied data while copying it into the
+// segment, instead of making a second pass over the segment when it is sent
+#if MBED_CONF_LWIP_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY       1
+#else
 #define LWIP_CHECKSUM_ON_COPY       0
+#endif
 
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETIF_STATUS_CALLBACK  1
@@ -517,6 +517,26 @@ Nanostack::call_in_callback_cb_t Nanostack::get_call_in_callback()
     return cb;
 }
 
+NetStackMemoryManager *Nanostack::get_memory_manager()
+{
+    return &memory_manager;
+}
+
+size_t Nanostack::get_pool_stats(nsapi_pool_stats_t *stats, size_t count)
+{
+    const mem_stat_t *heap = ns_dyn_mem_get_mem_stat();
+    if (!heap || count == 0) {
+        return 0;
+    }
+
+    stats[0].name = "HEAP";
+    stats[0].size = heap->heap_sector_size;
+    stats[0].used = heap->heap_sector_allocated_bytes;
+    stats[0].max_used = heap->heap_sector_allocated_bytes_max;
+    stats[0].errors = heap->heap_alloc_fail_cnt;
+    return 1;
+}
+
 const char *Nanostack::get_ip_address()
 {
     NanostackLockGuard lock;
@@ -589,6 +609,16 @@ nsapi_error_t Nanostack::socket_close(void *handle)
 }
 
 nsapi_size_or_error_t Nanostack::do_sendto(void *handle, const ns_address_t *address, const void *data, nsapi_size_t size)
+{
+    ns_iovec_t iov;
+    iov.iov_base = const_cast<void *>(data);
+    iov.iov_len = size;
+
+    /*No lock gaurd needed here as do_sendmsg() will handle locks.*/
+    return do_sendmsg(handle, address, &iov, 1);
+}
+
+nsapi_size_or_error_t Nanostack::do_sendmsg(void *handle, const ns_address_t *address, ns_iovec_t *iov, uint_fast16_t iovlen)
 {
     // Validate parameters
     NanostackSocket *socket = static_cast<NanostackSocket *>(handle);
@@ -613,27 +643,20 @@ nsapi_size_or_error_t Nanostack::do_sendto(void *handle, const ns_address_t *add
     }
 
     int retcode;
-#if 0
-    retcode = ::socket_sendto(socket->socket_id, address,
-                              data, size);
-#else
-    // Use sendmsg purely to get the new return style
+    // Use sendmsg to get the new return style
     // of returning data written rather than 0 on success,
     // which means TCP can do partial writes. (Sadly,
     // it's the only call which takes flags so we can
-    // leave the NS_MSG_LEGACY0 flag clear).
+    // leave the NS_MSG_LEGACY0 flag clear). It also
+    // takes scatter lists.
     ns_msghdr_t msg;
-    ns_iovec_t iov;
-    iov.iov_base = const_cast<void *>(data);
-    iov.iov_len = size;
     msg.msg_name = const_cast<ns_address_t *>(address);
     msg.msg_namelen = address ? sizeof * address : 0;
-    msg.msg_iov = &iov;
-    msg.msg_iovlen = 1;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovlen;
     msg.msg_control = NULL;
     msg.msg_controllen = 0;
     retcode = ::socket_sendmsg(socket->socket_id, &msg, 0);
-#endif
 
     /*
      * \return length if entire amount written (which could be 0)
@@ -973,6 +996,246 @@ nsapi_size_or_error_t Nanostack::socket_recv(void *handle, void *data, nsapi_siz
     return socket_recvfrom(handle, NULL, data, size);
 }
 
+/* Convert a scatter list, using the local array if it is long enough */
+static ns_iovec_t *convert_iov(const nsapi_iovec_t *iov, unsigned iovcnt, ns_iovec_t *local, unsigned local_cnt)
+{
+    ns_iovec_t *ns_iov = local;
+    if (iovcnt > local_cnt) {
+        ns_iov = static_cast<ns_iovec_t *>(ns_dyn_mem_temporary_alloc(iovcnt * sizeof(ns_iovec_t)));
+        if (!ns_iov) {
+            return NULL;
+        }
+    }
+
+    for (unsigned i = 0; i < iovcnt; i++) {
+        ns_iov[i].iov_base = iov[i].iov_base;
+        ns_iov[i].iov_len = iov[i].iov_len;
+    }
+    return ns_iov;
+}
+
+nsapi_size_or_error_t Nanostack::socket_sendmsg(void *handle, const SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    ns_address_t ns_address;
+    if (address) {
+        if (address->get_ip_version() != NSAPI_IPv6) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+        convert_mbed_addr_to_ns(&ns_address, address);
+    }
+
+    ns_iovec_t iov_local[4];
+    ns_iovec_t *ns_iov = convert_iov(iov, iovcnt, iov_local, sizeof iov_local / sizeof iov_local[0]);
+    if (!ns_iov) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    /*No lock gaurd needed here as do_sendmsg() will handle locks.*/
+    nsapi_size_or_error_t ret = do_sendmsg(handle, address ? &ns_address : NULL, ns_iov, iovcnt);
+
+    if (ns_iov != iov_local) {
+        ns_dyn_mem_free(ns_iov);
+    }
+
+    return ret;
+}
+
+nsapi_size_or_error_t Nanostack::socket_recvmsg(void *handle, SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    // Validate parameters
+    NanostackSocket *socket = static_cast<NanostackSocket *>(handle);
+    if (handle == NULL) {
+        MBED_ASSERT(false);
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    ns_iovec_t iov_local[4];
+    ns_iovec_t *ns_iov = convert_iov(iov, iovcnt, iov_local, sizeof iov_local / sizeof iov_local[0]);
+    if (!ns_iov) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    nsapi_size_or_error_t ret;
+
+    NanostackLockGuard lock;
+
+    if (socket->closed()) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+        goto out;
+    }
+
+    ns_address_t ns_address;
+    ns_msghdr_t msg;
+    msg.msg_name = &ns_address;
+    msg.msg_namelen = sizeof ns_address;
+    msg.msg_iov = ns_iov;
+    msg.msg_iovlen = iovcnt;
+    msg.msg_control = NULL;
+    msg.msg_controllen = 0;
+    msg.msg_flags = 0;
+
+    int retcode;
+    retcode = ::socket_recvmsg(socket->socket_id, &msg, 0);
+
+    if (retcode == NS_EWOULDBLOCK) {
+        ret = NSAPI_ERROR_WOULD_BLOCK;
+    } else if (retcode < 0) {
+        ret = NSAPI_ERROR_PARAMETER;
+    } else {
+        ret = retcode;
+        if (address != NULL) {
+            convert_ns_addr_to_mbed(address, &ns_address);
+        }
+    }
+
+out:
+    if (ns_iov != iov_local) {
+        ns_dyn_mem_free(ns_iov);
+    }
+
+    tr_debug("socket_recvmsg(socket=%p) sock_id=%d, ret=%i", socket, socket->socket_id, ret);
+
+    return ret;
+}
+
+nsapi_size_or_error_t Nanostack::socket_send_buf(void *handle, const SocketAddress *address, net_stack_mem_buf_t *buf, nsapi_size_t offset)
+{
+    // Validate parameters
+    NanostackSocket *socket = static_cast<NanostackSocket *>(handle);
+    if (handle == NULL) {
+        MBED_ASSERT(false);
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    ns_address_t ns_address;
+    if (address) {
+        if (address->get_ip_version() != NSAPI_IPv6) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+        convert_mbed_addr_to_ns(&ns_address, address);
+    }
+
+    if (offset && socket->proto != SOCKET_TCP) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    net_stack_mem_buf_t *first = buf;
+    while (first && offset >= memory_manager.get_len(first)) {
+        offset -= memory_manager.get_len(first);
+        first = memory_manager.get_next(first);
+    }
+    if (!first) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    uint_fast16_t iovlen = 0;
+    for (net_stack_mem_buf_t *seg = first; seg; seg = memory_manager.get_next(seg)) {
+        iovlen++;
+    }
+
+    // Short chains are described on the stack
+    ns_iovec_t iov_local[4];
+    ns_iovec_t *iov = iov_local;
+    if (iovlen > sizeof iov_local / sizeof iov_local[0]) {
+        iov = static_cast<ns_iovec_t *>(ns_dyn_mem_temporary_alloc(iovlen * sizeof(ns_iovec_t)));
+        if (!iov) {
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+    }
+
+    nsapi_size_t size = 0;
+    uint_fast16_t i = 0;
+    for (net_stack_mem_buf_t *seg = first; seg; seg = memory_manager.get_next(seg), i++) {
+        iov[i].iov_base = static_cast<uint8_t *>(memory_manager.get_ptr(seg)) + offset;
+        iov[i].iov_len = memory_manager.get_len(seg) - offset;
+        size += iov[i].iov_len;
+        offset = 0;
+    }
+
+    /*No lock gaurd needed here as do_sendmsg() will handle locks.*/
+    nsapi_size_or_error_t ret = do_sendmsg(handle, address ? &ns_address : NULL, iov, iovlen);
+
+    if (iov != iov_local) {
+        ns_dyn_mem_free(iov);
+    }
+
+    // Nanostack has copied the data, and the buffer is ours once it is all sent
+    if (ret >= 0 && (nsapi_size_t)ret == size) {
+        memory_manager.free(buf);
+    }
+
+    return ret;
+}
+
+nsapi_size_or_error_t Nanostack::socket_recv_buf(void *handle, SocketAddress *address, net_stack_mem_buf_t **buf)
+{
+    // Validate parameters
+    NanostackSocket *socket = static_cast<NanostackSocket *>(handle);
+    if (handle == NULL) {
+        MBED_ASSERT(false);
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    nsapi_size_or_error_t ret;
+    net_stack_mem_buf_t *mem = NULL;
+    uint32_t size;
+
+    NanostackLockGuard lock;
+
+    if (socket->closed()) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+        goto out;
+    }
+
+    int retcode;
+    if (socket->proto == SOCKET_TCP) {
+        size = memory_manager.get_pool_alloc_unit(0);
+    } else {
+        // Peek for the length of the next datagram
+        retcode = ::socket_recvfrom(socket->socket_id, NULL, 0, NS_MSG_PEEK | NS_MSG_TRUNC, NULL);
+        if (retcode == NS_EWOULDBLOCK) {
+            ret = NSAPI_ERROR_WOULD_BLOCK;
+            goto out;
+        } else if (retcode < 0) {
+            ret = NSAPI_ERROR_PARAMETER;
+            goto out;
+        }
+        size = retcode;
+    }
+
+    mem = memory_manager.alloc_heap(size, 0);
+    if (!mem) {
+        ret = NSAPI_ERROR_NO_MEMORY;
+        goto out;
+    }
+
+    ns_address_t ns_address;
+    retcode = ::socket_recvfrom(socket->socket_id, memory_manager.get_ptr(mem), size, 0, &ns_address);
+
+    if (retcode == NS_EWOULDBLOCK) {
+        ret = NSAPI_ERROR_WOULD_BLOCK;
+    } else if (retcode < 0) {
+        ret = NSAPI_ERROR_PARAMETER;
+    } else {
+        ret = retcode;
+        if (address != NULL) {
+            convert_ns_addr_to_mbed(address, &ns_address);
+        }
+    }
+
+    if (ret > 0 || (ret == 0 && socket->proto != SOCKET_TCP)) {
+        memory_manager.set_len(mem, ret);
+        *buf = mem;
+    } else {
+        memory_manager.free(mem);
+    }
+
+out:
+    tr_debug("socket_recv_buf(socket=%p) sock_id=%d, ret=%i", socket, socket->socket_id, ret);
+
+    return ret;
+}
+
 void Nanostack::socket_attach(void *handle, void (*callback)(void *), void *id)
 {
     // Validate parameters
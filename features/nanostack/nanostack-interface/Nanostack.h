@@ -44,6 +44,22 @@ public:
     /* Local variant with stronger typing and manual address specification */
     nsapi_error_t add_ethernet_interface(EMAC &emac, bool default_if, Nanostack::EthernetInterface **interface_out, const uint8_t *mac_addr = NULL);
 
+    /** Get the memory manager of the stack
+     *
+     *  @return         Memory manager for zero-copy socket buffers
+     */
+    virtual NetStackMemoryManager *get_memory_manager();
+
+    /** Get usage of the Nanostack heap
+     *
+     *  Requires mbed-mesh-api.heap-stat-info to be set.
+     *
+     *  @param stats    Array of structures to fill
+     *  @param count    Number of structures in the array
+     *  @return         Number of structures filled
+     */
+    virtual size_t get_pool_stats(nsapi_pool_stats_t *stats, size_t count);
+
 protected:
 
     Nanostack();
@@ -199,6 +215,66 @@ protected:
      */
     virtual nsapi_size_or_error_t socket_recvfrom(void *handle, SocketAddress *address, void *buffer, nsapi_size_t size);
 
+    /** Send a message gathered from a list of buffers
+     *
+     *  The buffers are passed to the socket as a scatter list.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host or NULL
+     *  @param iov      Buffers of data to send to the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_sendmsg(void *handle, const SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a message scattered into a list of buffers
+     *
+     *  The buffers are passed to the socket as a scatter list.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param iov      Destination buffers for data received from the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recvmsg(void *handle, SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Send data from a memory buffer chain
+     *
+     *  The buffers of the chain are passed to the socket as a scatter list,
+     *  without gathering them into one buffer first. Nanostack copies the
+     *  data into its own buffers.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host, or NULL to send
+     *                  to the connected peer
+     *  @param buf      Memory buffer chain to send
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_send_buf(void *handle, const SocketAddress *address,
+                                                  net_stack_mem_buf_t *buf, nsapi_size_t offset);
+
+    /** Receive data into a memory buffer chain
+     *
+     *  Nanostack can not hand over its own buffers, so the data is read
+     *  straight into a buffer allocated to fit the next datagram, or one
+     *  allocation unit of stream data.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for the received buffer
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recv_buf(void *handle, SocketAddress *address,
+                                                  net_stack_mem_buf_t **buf);
+
     /** Register a callback on state change of the socket
      *
      *  The specified callback will be called on state changes such as when
@@ -282,6 +358,7 @@ private:
     };
 
     nsapi_size_or_error_t do_sendto(void *handle, const struct ns_address *address, const void *data, nsapi_size_t size);
+    nsapi_size_or_error_t do_sendmsg(void *handle, const struct ns_address *address, struct ns_iovec *iov, uint_fast16_t iovlen);
     static void call_event_tasklet_main(arm_event_s *event);
     char text_ip_address[40];
     NanostackMemoryManager memory_manager;
@@ -232,3 +232,44 @@ nsapi_error_t InternetSocket::getpeername(SocketAddress *address)
     *address = _remote_peer;
     return NSAPI_ERROR_OK;
 }
+
+NetStackMemoryManager *InternetSocket::get_memory_manager()
+{
+    if (!_stack) {
+        return NULL;
+    }
+    return _stack->get_memory_manager();
+}
+
+nsapi_size_or_error_t InternetSocket::blocking_call(socket_call_t call, uint32_t flag, us_timestamp_t *blocked_time)
+{
+    while (true) {
+        if (!_socket) {
+            return NSAPI_ERROR_NO_SOCKET;
+        }
+
+        core_util_atomic_flag_clear(&_pending);
+        nsapi_size_or_error_t ret = call(_stack, _socket);
+        // Non-blocking sockets always return. Blocking only returns when success or errors other than WOULD_BLOCK
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != ret)) {
+            return ret;
+        }
+
+        us_timestamp_t wait_start = _socket_stats.stats_get_time();
+
+        // Release lock before blocking so other threads
+        // accessing this object aren't blocked
+        _lock.unlock();
+        uint32_t flags = _event_flag.wait_any(flag, _timeout);
+        _lock.lock();
+
+        if (blocked_time) {
+            *blocked_time += _socket_stats.stats_get_time() - wait_start;
+        }
+
+        if (flags & osFlagsError) {
+            // Timeout break
+            return NSAPI_ERROR_WOULD_BLOCK;
+        }
+    }
+}
@@ -123,6 +123,17 @@ public:
      */
     virtual nsapi_error_t getpeername(SocketAddress *address);
 
+    /** Get the memory manager for zero-copy buffers
+     *
+     *  Buffers sent with send_buf or sendto_buf must be allocated with this
+     *  memory manager, and buffers returned by recv_buf or recvfrom_buf must
+     *  be freed with it.
+     *
+     *  @return         Memory manager of the network stack, or NULL if the socket
+     *                  is not open or the stack does not support zero-copy calls
+     */
+    NetStackMemoryManager *get_memory_manager();
+
     /** Register a callback on state change of the socket.
      *
      *  @see Socket::sigio
@@ -158,6 +169,23 @@ protected:
     virtual nsapi_protocol_t get_proto() = 0;
     virtual void event();
     int modify_multicast_group(const SocketAddress &address, nsapi_socket_option_t socketopt);
+
+    /** Call on the stack and socket of this socket, made by blocking_call */
+    typedef mbed::Callback<nsapi_size_or_error_t(NetworkStack *, nsapi_socket_t)> socket_call_t;
+
+    /** Make a call on the socket, waiting for an event and trying again while it would block
+     *
+     *  Must be called with the lock held, which is released while waiting.
+     *
+     *  @param call         Call to make, tried again while it returns NSAPI_ERROR_WOULD_BLOCK
+     *                      and the socket is blocking
+     *  @param flag         Event to wait for between tries, READ_FLAG or WRITE_FLAG
+     *  @param blocked_time Time spent waiting is added to it, if not NULL
+     *  @return             Result of the call, NSAPI_ERROR_WOULD_BLOCK on timeout,
+     *                      or NSAPI_ERROR_NO_SOCKET if the socket is closed
+     */
+    nsapi_size_or_error_t blocking_call(socket_call_t call, uint32_t flag, us_timestamp_t *blocked_time);
+
     char _interface_name[NSAPI_INTERFACE_NAME_MAX_SIZE];
     NetworkStack *_stack;
     nsapi_socket_t _socket;
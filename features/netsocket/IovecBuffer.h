@@ -0,0 +1,97 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IOVEC_BUFFER_H
+#define IOVEC_BUFFER_H
+
+#include "netsocket/nsapi_types.h"
+#include "platform/NonCopyable.h"
+#include <string.h>
+#include <new>
+
+/** Contiguous copy of the data described by an I/O vector
+ *
+ *  Implements sendmsg() and recvmsg() on top of calls that take a single
+ *  buffer: gather() before sending, scatter() after receiving.
+ */
+class IovecBuffer : private mbed::NonCopyable<IovecBuffer> {
+public:
+    /** Allocate a buffer for the total length of an I/O vector
+     *
+     *  @param iov      Array of buffers
+     *  @param iovcnt   Number of buffers in iov
+     */
+    IovecBuffer(const nsapi_iovec_t *iov, unsigned iovcnt) :
+        _iov(iov), _iovcnt(iovcnt), _size(0)
+    {
+        for (unsigned i = 0; i < iovcnt; i++) {
+            _size += iov[i].iov_len;
+        }
+        _data = new (std::nothrow) uint8_t[_size ? _size : 1];
+    }
+
+    ~IovecBuffer()
+    {
+        delete[] _data;
+    }
+
+    /** Contiguous buffer, NULL if it could not be allocated */
+    uint8_t *data() const
+    {
+        return _data;
+    }
+
+    /** Total length of the I/O vector */
+    nsapi_size_t size() const
+    {
+        return _size;
+    }
+
+    /** Copy the I/O vector buffers into the contiguous buffer */
+    void gather()
+    {
+        nsapi_size_t offset = 0;
+        for (unsigned i = 0; i < _iovcnt; i++) {
+            memcpy(_data + offset, _iov[i].iov_base, _iov[i].iov_len);
+            offset += _iov[i].iov_len;
+        }
+    }
+
+    /** Copy received data from the contiguous buffer into the I/O vector buffers
+     *
+     *  @param received Number of bytes received, or a negative error code
+     */
+    void scatter(nsapi_size_or_error_t received)
+    {
+        nsapi_size_t offset = 0;
+        for (unsigned i = 0; i < _iovcnt && received > 0 && offset < (nsapi_size_t)received; i++) {
+            nsapi_size_t len = (nsapi_size_t)received - offset;
+            if (len > _iov[i].iov_len) {
+                len = _iov[i].iov_len;
+            }
+            memcpy(_iov[i].iov_base, _data + offset, len);
+            offset += len;
+        }
+    }
+
+private:
+    const nsapi_iovec_t *_iov;
+    unsigned _iovcnt;
+    nsapi_size_t _size;
+    uint8_t *_data;
+};
+
+#endif
@@ -226,9 +226,9 @@ public:
      *  will be resolve using a UDP socket on the stack.
      *
      *  Call is non-blocking. Result of the DNS operation is returned by the callback.
-     *  If this function returns failure, callback will not be called. In case result
-     *  is success (IP address was found from DNS cache), callback will be called
-     *  before function returns.
+     *  If this function returns failure, callback will not be called. In case the
+     *  result is found from DNS cache (the IP address, or that the host could not be
+     *  found), callback will be called before function returns.
      *
      *  @param host     Hostname to resolve.
      *  @param callback Callback that is called for result.
@@ -15,8 +15,10 @@
  */
 
 #include "NetworkStack.h"
+#include "IovecBuffer.h"
 #include "nsapi_dns.h"
 #include "stddef.h"
+#include <string.h>
 #include <new>
 #include "events/EventQueue.h"
 #include "mbed_shared_queues.h"
@@ -129,6 +131,90 @@ nsapi_error_t NetworkStack::getsockopt(void *handle, int level, int optname, voi
     return NSAPI_ERROR_UNSUPPORTED;
 }
 
+nsapi_size_or_error_t NetworkStack::socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+                                                   const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    IovecBuffer buffer(iov, iovcnt);
+    if (!buffer.data()) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    buffer.gather();
+    if (address) {
+        return socket_sendto(handle, *address, buffer.data(), buffer.size());
+    }
+    return socket_send(handle, buffer.data(), buffer.size());
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+                                                   const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    IovecBuffer buffer(iov, iovcnt);
+    if (!buffer.data()) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    nsapi_size_or_error_t ret;
+    if (address) {
+        ret = socket_recvfrom(handle, address, buffer.data(), buffer.size());
+    } else {
+        ret = socket_recv(handle, buffer.data(), buffer.size());
+    }
+    buffer.scatter(ret);
+    return ret;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recvmmsg(nsapi_socket_t handle, nsapi_msg_t *msgs, unsigned count)
+{
+    unsigned received = 0;
+    while (received < count) {
+        SocketAddress address;
+        nsapi_size_or_error_t ret = socket_recvfrom(handle, &address, msgs[received].msg_buf,
+                                                    msgs[received].msg_size);
+        if (ret < 0) {
+            // Report the error with the next batch if some datagrams were received
+            if (received) {
+                break;
+            }
+            return ret;
+        }
+
+        msgs[received].msg_len = ret;
+        msgs[received].msg_addr = address.get_addr();
+        msgs[received].msg_port = address.get_port();
+        received++;
+    }
+
+    return received;
+}
+
+NetStackMemoryManager *NetworkStack::get_memory_manager()
+{
+    return NULL;
+}
+
+nsapi_error_t NetworkStack::get_stack_stats(nsapi_stack_stats_t *stats)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+size_t NetworkStack::get_pool_stats(nsapi_pool_stats_t *stats, size_t count)
+{
+    return 0;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_send_buf(nsapi_socket_t handle, const SocketAddress *address,
+                                                    net_stack_mem_buf_t *buf, nsapi_size_t offset)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+nsapi_size_or_error_t NetworkStack::socket_recv_buf(nsapi_socket_t handle, SocketAddress *address,
+                                                    net_stack_mem_buf_t **buf)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
 nsapi_error_t NetworkStack::call_in(int delay, mbed::Callback<void()> func)
 {
     static events::EventQueue *event_queue = mbed::mbed_event_queue();
@@ -29,6 +29,8 @@
 
 // Predeclared classes
 class OnboardNetworkStack;
+class NetStackMemoryManager;
+typedef void net_stack_mem_buf_t;
 
 /** NetworkStack class
  *
@@ -98,9 +100,9 @@ public:
      *  will be resolve using a UDP socket on the stack.
      *
      *  Call is non-blocking. Result of the DNS operation is returned by the callback.
-     *  If this function returns failure, callback will not be called. In case result
-     *  is success (IP address was found from DNS cache), callback will be called
-     *  before function returns.
+     *  If this function returns failure, callback will not be called. In case the
+     *  result is found from DNS cache (the IP address, or that the host could not be
+     *  found), callback will be called before function returns.
      *
      *  @param host     Hostname to resolve
      *  @param callback Callback that is called for result
@@ -175,6 +177,38 @@ public:
      */
     virtual nsapi_error_t getstackopt(int level, int optname, void *optval, unsigned *optlen);
 
+    /** Get the memory manager of the stack
+     *
+     *  The memory manager allocates and frees the buffers passed to and
+     *  from the zero-copy socket calls, and gives access to their data.
+     *
+     *  @return         Memory manager, or NULL if the stack does not
+     *                  support zero-copy socket calls
+     */
+    virtual NetStackMemoryManager *get_memory_manager();
+
+    /** Get protocol counters of the stack
+     *
+     *  The counters are sampled while the stack keeps running.
+     *
+     *  @param stats    Destination for the counters
+     *  @return         NSAPI_ERROR_OK on success, NSAPI_ERROR_UNSUPPORTED
+     *                  if the stack does not collect statistics
+     */
+    virtual nsapi_error_t get_stack_stats(nsapi_stack_stats_t *stats);
+
+    /** Get usage of the memory pools of the stack
+     *
+     *  Fills the passed array with the usage and high-water mark of each
+     *  of the stack's packet buffer and control block pools, and its heap.
+     *
+     *  @param stats    Array of structures to fill
+     *  @param count    Number of structures in the array
+     *  @return         Number of structures filled, 0 if the stack does not
+     *                  collect statistics
+     */
+    virtual size_t get_pool_stats(nsapi_pool_stats_t *stats, size_t count);
+
     /** Dynamic downcast to a OnboardNetworkStack */
     virtual OnboardNetworkStack *onboardNetworkStack()
     {
@@ -336,6 +370,112 @@ protected:
     virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address,
                                                   void *buffer, nsapi_size_t size) = 0;
 
+    /** Send a message gathered from a list of buffers
+     *
+     *  Sends the buffers in order, as one datagram on a UDP socket. If address
+     *  is NULL, the message is sent as by socket_send, otherwise as by
+     *  socket_sendto. Returns the number of bytes sent.
+     *
+     *  The default implementation gathers the buffers into a temporary buffer.
+     *
+     *  This call is non-blocking. If sendmsg would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host or NULL
+     *  @param iov      Buffers of data to send to the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a message scattered into a list of buffers
+     *
+     *  Receives as by socket_recvfrom if address is not NULL, otherwise as by
+     *  socket_recv, filling the buffers in order. Returns the number of bytes
+     *  received.
+     *
+     *  The default implementation receives into a temporary buffer.
+     *
+     *  This call is non-blocking. If recvmsg would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param iov      Destination buffers for data received from the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+                                                 const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a batch of datagrams over a UDP socket
+     *
+     *  Receives datagrams into msgs in order, as by socket_recvfrom, until
+     *  count datagrams have been received or no more are queued on the socket.
+     *  Each datagram is truncated to msg_size, and msg_len, msg_addr and
+     *  msg_port are set.
+     *
+     *  The default implementation calls socket_recvfrom once per datagram.
+     *
+     *  This call is non-blocking. If no datagram is queued,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param msgs     Array of datagram buffers
+     *  @param count    Number of entries in msgs
+     *  @return         Number of received datagrams on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recvmmsg(nsapi_socket_t handle, nsapi_msg_t *msgs, unsigned count);
+
+    /** Send data from a memory buffer chain without copying
+     *
+     *  Sends the contents of the buffer chain, starting at offset. Returns the
+     *  number of bytes sent. The buffer must have been allocated with the
+     *  memory manager of the stack.
+     *
+     *  Once the whole buffer has been sent (offset plus the returned size equals
+     *  its total length), the stack owns the buffer and frees it. Otherwise, the
+     *  buffer still belongs to the caller, and the rest of the data can be sent
+     *  by calling again with the new offset. Datagrams are sent whole, so offset
+     *  must be 0 for UDP.
+     *
+     *  This call is non-blocking. If send would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host, or NULL to send
+     *                  to the connected peer
+     *  @param buf      Memory buffer chain to send
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_send_buf(nsapi_socket_t handle, const SocketAddress *address,
+                                                  net_stack_mem_buf_t *buf, nsapi_size_t offset);
+
+    /** Receive data into a memory buffer chain without copying
+     *
+     *  Hands over the next received datagram, or the next block of stream
+     *  data, as a buffer chain that must be freed with the memory manager of
+     *  the stack. Stores the source address in address if address is not NULL.
+     *
+     *  This call is non-blocking. If recv would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for the received buffer chain
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t socket_recv_buf(nsapi_socket_t handle, SocketAddress *address,
+                                                  net_stack_mem_buf_t **buf);
+
     /** Register a callback on state change of the socket
      *
      *  The specified callback will be called on state changes such as when
@@ -0,0 +1,44 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Socket.h"
+#include "IovecBuffer.h"
+
+nsapi_size_or_error_t Socket::sendmsg(const SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    IovecBuffer buffer(iov, iovcnt);
+    if (!buffer.data()) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    buffer.gather();
+    if (address) {
+        return sendto(*address, buffer.data(), buffer.size());
+    }
+    return send(buffer.data(), buffer.size());
+}
+
+nsapi_size_or_error_t Socket::recvmsg(SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    IovecBuffer buffer(iov, iovcnt);
+    if (!buffer.data()) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    nsapi_size_or_error_t ret = recvfrom(address, buffer.data(), buffer.size());
+    buffer.scatter(ret);
+    return ret;
+}
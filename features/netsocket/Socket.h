@@ -154,6 +154,40 @@ public:
     virtual nsapi_size_or_error_t recvfrom(SocketAddress *address,
                                            void *data, nsapi_size_t size) = 0;
 
+    /** Send a message gathered from a list of buffers.
+     *
+     *  Sends the buffers in order, as one datagram on a connectionless-mode
+     *  socket. If address is NULL, the message is sent as by send(), otherwise
+     *  as by sendto().
+     *
+     *  The default implementation gathers the buffers into a temporary
+     *  buffer. Sockets of stacks with scatter/gather support override it.
+     *
+     *  @param address  Remote address or NULL
+     *  @param iov      Buffers of data to send to the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t sendmsg(const SocketAddress *address,
+                                          const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a message scattered into a list of buffers.
+     *
+     *  Receives as by recvfrom(), filling the buffers in order.
+     *
+     *  The default implementation receives into a temporary buffer.
+     *  Sockets of stacks with scatter/gather support override it.
+     *
+     *  @param address  Destination for the source address or NULL
+     *  @param iov      Destination buffers for data received from the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t recvmsg(SocketAddress *address,
+                                          const nsapi_iovec_t *iov, unsigned iovcnt);
+
     /** Bind a specific address to a socket.
      *
      *  Binding a socket specifies the address and port on which to receive
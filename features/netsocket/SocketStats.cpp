@@ -20,6 +20,9 @@
 #ifdef MBED_CONF_RTOS_PRESENT
 #include "rtos/Kernel.h"
 #endif
+#if DEVICE_USTICKER
+#include "hal/us_ticker_api.h"
+#endif
 
 #include <string.h>
 #include <stdlib.h>
@@ -31,6 +34,9 @@ uint32_t SocketStats::_size = 0;
 
 int SocketStats::get_entry_position(const Socket *const reference_id)
 {
+    if ((_position >= 0) && (_stats[_position].reference_id == reference_id)) {
+        return _position;
+    }
     for (uint32_t j = 0; j < _size; j++) {
         if (_stats[j].reference_id == reference_id) {
             return j;
@@ -38,6 +44,16 @@ int SocketStats::get_entry_position(const Socket *const reference_id)
     }
     return -1;
 }
+
+void SocketStats::update_latency(uint32_t *histogram, us_timestamp_t duration)
+{
+    int bucket = 0;
+    while ((duration >= 4) && (bucket < MBED_STATS_SOCKET_LATENCY_BUCKETS - 1)) {
+        duration >>= 2;
+        bucket++;
+    }
+    histogram[bucket]++;
+}
 #endif
 
 size_t SocketStats::mbed_stats_socket_get_each(mbed_stats_socket_t *stats, size_t count)
@@ -47,7 +63,7 @@ size_t SocketStats::mbed_stats_socket_get_each(mbed_stats_socket_t *stats, size_
 #if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
     memset(stats, 0, count * sizeof(mbed_stats_socket_t));
     _mutex->lock();
-    for (uint32_t j = 0; j < count; j++) {
+    for (uint32_t j = 0; (j < _size) && (i < count); j++) {
         if (_stats[j].reference_id) {
             memcpy(&stats[i], &_stats[j], sizeof(mbed_stats_socket_t));
             i++;
@@ -59,6 +75,9 @@ size_t SocketStats::mbed_stats_socket_get_each(mbed_stats_socket_t *stats, size_
 }
 
 SocketStats::SocketStats()
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+    : _position(-1)
+#endif
 {
 }
 
@@ -68,10 +87,11 @@ void SocketStats::stats_new_socket_entry(const Socket *const reference_id)
     _mutex->lock();
     if (get_entry_position(reference_id) >= 0) {
         // Duplicate entry
-        MBED_WARNING1(MBED_MAKE_ERROR(MBED_MODULE_NETWORK_STATS, MBED_ERROR_CODE_INVALID_INDEX), "Duplicate socket Reference ID ", reference_id);
+        MBED_WARNING1(MBED_MAKE_ERROR(MBED_MODULE_NETWORK_STATS, MBED_ERROR_CODE_INVALID_INDEX), "Duplicate socket Reference ID ", (uintptr_t)reference_id);
     } else if (_size < MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT) {
         // Add new entry
         _stats[_size].reference_id = (Socket *)reference_id;
+        _position = _size;
         _size++;
     } else {
         int position = -1;
@@ -90,6 +110,7 @@ void SocketStats::stats_new_socket_entry(const Socket *const reference_id)
         }
         memset(&_stats[position], 0, sizeof(mbed_stats_socket_t));
         _stats[position].reference_id = (Socket *)reference_id;
+        _position = position;
     }
     _mutex->unlock();
 #endif
@@ -158,3 +179,46 @@ void SocketStats::stats_update_recv_bytes(const Socket *const reference_id, size
     _mutex->unlock();
 #endif
 }
+
+us_timestamp_t SocketStats::stats_get_time()
+{
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED && DEVICE_USTICKER
+    return ticker_read_us(get_us_ticker_data());
+#else
+    return 0;
+#endif
+}
+
+void SocketStats::stats_update_send(const Socket *const reference_id, us_timestamp_t start, nsapi_size_or_error_t sent_bytes)
+{
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+    us_timestamp_t duration = stats_get_time() - start;
+    _mutex->lock();
+    int position = get_entry_position(reference_id);
+    if (position >= 0) {
+        update_latency(_stats[position].send_latency, duration);
+        if (sent_bytes > 0) {
+            _stats[position].sent_bytes += sent_bytes;
+        }
+    }
+    _mutex->unlock();
+#endif
+}
+
+void SocketStats::stats_update_recv(const Socket *const reference_id, us_timestamp_t start,
+                                    us_timestamp_t blocked_time, nsapi_size_or_error_t recv_bytes)
+{
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+    us_timestamp_t duration = stats_get_time() - start;
+    _mutex->lock();
+    int position = get_entry_position(reference_id);
+    if (position >= 0) {
+        update_latency(_stats[position].recv_latency, duration);
+        _stats[position].recv_blocked_time += blocked_time;
+        if (recv_bytes > 0) {
+            _stats[position].recv_bytes += recv_bytes;
+        }
+    }
+    _mutex->unlock();
+#endif
+}
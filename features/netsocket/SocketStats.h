@@ -27,6 +27,13 @@
 #define MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT      10
 #endif
 
+/** Number of buckets in the socket call duration histograms
+  *
+  * Bucket n counts the calls that took less than 4^(n+1) microseconds,
+  * the last bucket counts all the longer calls.
+  */
+#define MBED_STATS_SOCKET_LATENCY_BUCKETS           10
+
 /** Enum of socket states
   *
   * Can be used to specify current state of socket - open, closed, connected or listen.
@@ -50,6 +57,9 @@ typedef struct {
     size_t sent_bytes;              /**< Data sent through this socket */
     size_t recv_bytes;              /**< Data received through this socket */
     us_timestamp_t last_change_tick;/**< osKernelGetTick() when state last changed */
+    uint32_t send_latency[MBED_STATS_SOCKET_LATENCY_BUCKETS]; /**< Histogram of send call durations */
+    uint32_t recv_latency[MBED_STATS_SOCKET_LATENCY_BUCKETS]; /**< Histogram of receive call durations */
+    us_timestamp_t recv_blocked_time;/**< Time receive calls spent waiting for data, in microseconds */
 } mbed_stats_socket_t;
 
 /**  SocketStats class
@@ -143,18 +153,60 @@ public:
      */
     void stats_update_recv_bytes(const Socket *const reference_id, size_t recv_bytes);
 
+    /** Get the time to measure the duration of a socket call from.
+     *  API used by socket (TCP or UDP) layers only, not to be used by application.
+     *
+     *  @return Current time in microseconds, 0 if statistics are disabled.
+     *
+     */
+    static us_timestamp_t stats_get_time();
+
+    /** Record a send call: add its duration to the send histogram and the bytes it sent.
+     *  API used by socket (TCP or UDP) layers only, not to be used by application.
+     *
+     *  @param reference_id   ID to identify socket in data array.
+     *  @param start  Time the call started, from `stats_get_time`.
+     *  @param sent_bytes  Bytes sent by the call, ignored if not positive.
+     *
+     */
+    void stats_update_send(const Socket *const reference_id, us_timestamp_t start, nsapi_size_or_error_t sent_bytes);
+
+    /** Record a receive call: add its duration to the receive histogram, the time
+     *  it spent waiting for data and the bytes it received.
+     *  API used by socket (TCP or UDP) layers only, not to be used by application.
+     *
+     *  @param reference_id   ID to identify socket in data array.
+     *  @param start  Time the call started, from `stats_get_time`.
+     *  @param blocked_time  Time the call spent waiting for data, in microseconds.
+     *  @param recv_bytes  Bytes received by the call, ignored if not positive.
+     *
+     */
+    void stats_update_recv(const Socket *const reference_id, us_timestamp_t start,
+                           us_timestamp_t blocked_time, nsapi_size_or_error_t recv_bytes);
+
 #if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
 private:
     static mbed_stats_socket_t _stats[MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT];
     static SingletonPtr<PlatformMutex> _mutex;
     static uint32_t _size;
 
+    /** Position of the entry of the socket owning this object, to avoid scanning the array. */
+    int _position;
+
     /** Internal function to scan the array and get the position of the element in the list.
      *
      *  @param reference_id   ID to identify the socket in the data array.
      *
      */
     int get_entry_position(const Socket *const reference_id);
+
+    /** Internal function to add a call duration to a histogram.
+     *
+     *  @param histogram  Histogram to update.
+     *  @param duration  Duration of the call, in microseconds.
+     *
+     */
+    static void update_latency(uint32_t *histogram, us_timestamp_t duration);
 #endif
 #endif
 };
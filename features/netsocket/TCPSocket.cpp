@@ -15,9 +15,120 @@
  */
 
 #include "TCPSocket.h"
+#include "NetStackMemoryManager.h"
 #include "Timer.h"
 #include "mbed_assert.h"
 
+// Socket calls made through InternetSocket::blocking_call. Send calls carry on
+// from the bytes already written.
+
+struct TCPSocket::SendCall {
+    SendCall(const void *data, nsapi_size_t size) :
+        data(static_cast<const uint8_t *>(data)), size(size), written(0)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_send(socket, data + written, size - written);
+    }
+
+    const uint8_t *data;
+    nsapi_size_t size;
+    nsapi_size_t written;
+};
+
+struct TCPSocket::RecvCall {
+    RecvCall(void *data, nsapi_size_t size) :
+        data(data), size(size)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_recv(socket, data, size);
+    }
+
+    void *data;
+    nsapi_size_t size;
+};
+
+struct TCPSocket::SendBufCall {
+    SendBufCall(net_stack_mem_buf_t *buf, nsapi_size_t offset) :
+        buf(buf), offset(offset), written(0)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_send_buf(socket, NULL, buf, offset + written);
+    }
+
+    net_stack_mem_buf_t *buf;
+    nsapi_size_t offset;
+    nsapi_size_t written;
+};
+
+struct TCPSocket::RecvBufCall {
+    RecvBufCall(net_stack_mem_buf_t **buf) :
+        buf(buf)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_recv_buf(socket, NULL, buf);
+    }
+
+    net_stack_mem_buf_t **buf;
+};
+
+struct TCPSocket::SendmsgCall {
+    SendmsgCall(const nsapi_iovec_t *iov, unsigned iovcnt) :
+        iov(iov), iovcnt(iovcnt), written(0)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        // Skip the buffers already written
+        unsigned index = 0;
+        nsapi_size_t offset = written;
+        while (index < iovcnt && offset >= iov[index].iov_len) {
+            offset -= iov[index].iov_len;
+            index++;
+        }
+        if (index >= iovcnt) {
+            return 0;
+        }
+
+        if (offset) {
+            // Finish the partly written buffer on its own
+            return stack->socket_send(socket, static_cast<const uint8_t *>(iov[index].iov_base) + offset,
+                                      iov[index].iov_len - offset);
+        }
+        return stack->socket_sendmsg(socket, NULL, iov + index, iovcnt - index);
+    }
+
+    const nsapi_iovec_t *iov;
+    unsigned iovcnt;
+    nsapi_size_t written;
+};
+
+struct TCPSocket::RecvmsgCall {
+    RecvmsgCall(const nsapi_iovec_t *iov, unsigned iovcnt) :
+        iov(iov), iovcnt(iovcnt)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_recvmsg(socket, NULL, iov, iovcnt);
+    }
+
+    const nsapi_iovec_t *iov;
+    unsigned iovcnt;
+};
 TCPSocket::TCPSocket()
 {
     _socket_stats.stats_update_proto(this, NSAPI_TCP);
@@ -128,10 +239,90 @@ nsapi_error_t TCPSocket::connect(const char *host, uint16_t port)
 
 nsapi_size_or_error_t TCPSocket::send(const void *data, nsapi_size_t size)
 {
+    SendCall call(data, size);
+    return send_all(mbed::callback(&call, &SendCall::call), size, &call.written);
+}
+
+nsapi_size_or_error_t TCPSocket::sendto(const SocketAddress &address, const void *data, nsapi_size_t size)
+{
+    (void)address;
+    return send(data, size);
+}
+
+nsapi_size_or_error_t TCPSocket::recv(void *data, nsapi_size_t size)
+{
+    RecvCall call(data, size);
+    return recv_call(mbed::callback(&call, &RecvCall::call));
+}
+
+nsapi_size_or_error_t TCPSocket::recvfrom(SocketAddress *address, void *data, nsapi_size_t size)
+{
+    if (address) {
+        *address = _remote_peer;
+    }
+    return recv(data, size);
+}
+
+nsapi_size_or_error_t TCPSocket::sendmsg(const SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    (void)address;
+    nsapi_size_t size = 0;
+    for (unsigned i = 0; i < iovcnt; i++) {
+        size += iov[i].iov_len;
+    }
+
+    // As for send, write the whole thing if blocking
+    SendmsgCall call(iov, iovcnt);
+    return send_all(mbed::callback(&call, &SendmsgCall::call), size, &call.written);
+}
+
+nsapi_size_or_error_t TCPSocket::recvmsg(SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    if (address) {
+        *address = _remote_peer;
+    }
+
+    RecvmsgCall call(iov, iovcnt);
+    return recv_call(mbed::callback(&call, &RecvmsgCall::call));
+}
+
+nsapi_size_or_error_t TCPSocket::send_buf(net_stack_mem_buf_t *buf, nsapi_size_t offset)
+{
+    _lock.lock();
+    nsapi_size_or_error_t ret;
+
+    // Once everything is written the stack owns the buffer, so its
+    // length must not be read again
+    NetStackMemoryManager *memory_manager = _socket ? _stack->get_memory_manager() : NULL;
+    nsapi_size_t size = memory_manager ? memory_manager->get_total_len(buf) : 0;
+
+    if (!_socket) {
+        ret = NSAPI_ERROR_NO_SOCKET;
+    } else if (!memory_manager) {
+        ret = NSAPI_ERROR_UNSUPPORTED;
+    } else if (offset >= size) {
+        ret = NSAPI_ERROR_PARAMETER;
+    } else {
+        SendBufCall call(buf, offset);
+        ret = send_all(mbed::callback(&call, &SendBufCall::call), size - offset, &call.written);
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+nsapi_size_or_error_t TCPSocket::recv_buf(net_stack_mem_buf_t **buf)
+{
+    *buf = NULL;
+    RecvBufCall call(buf);
+    return recv_call(mbed::callback(&call, &RecvBufCall::call));
+}
+
+nsapi_size_or_error_t TCPSocket::send_all(socket_call_t send, nsapi_size_t size, nsapi_size_t *written)
+{
+    us_timestamp_t start = _socket_stats.stats_get_time();
     _lock.lock();
-    const uint8_t *data_ptr = static_cast<const uint8_t *>(data);
     nsapi_size_or_error_t ret;
-    nsapi_size_t written = 0;
 
     // If this assert is hit then there are two threads
     // performing a send at the same time which is undefined
@@ -142,66 +333,34 @@ nsapi_size_or_error_t TCPSocket::send(const void *data, nsapi_size_t size)
     // Unlike recv, we should write the whole thing if blocking. POSIX only
     // allows partial as a side-effect of signal handling; it normally tries to
     // write everything if blocking. Without signals we can always write all.
-    while (true) {
-        if (!_socket) {
-            ret = NSAPI_ERROR_NO_SOCKET;
-            break;
-        }
-
-        core_util_atomic_flag_clear(&_pending);
-        ret = _stack->socket_send(_socket, data_ptr + written, size - written);
-        if (ret >= 0) {
-            written += ret;
-            if (written >= size) {
-                break;
-            }
+    do {
+        ret = blocking_call(send, WRITE_FLAG, NULL);
+        if (ret > 0) {
+            *written += ret;
         }
-        if (_timeout == 0) {
-            break;
-        } else if (ret == NSAPI_ERROR_WOULD_BLOCK) {
-            uint32_t flag;
-
-            // Release lock before blocking so other threads
-            // accessing this object aren't blocked
-            _lock.unlock();
-            flag = _event_flag.wait_any(WRITE_FLAG, _timeout);
-            _lock.lock();
-
-            if (flag & osFlagsError) {
-                // Timeout break
-                break;
-            }
-        } else if (ret < 0) {
-            break;
-        }
-    }
+    } while (ret >= 0 && *written < size && _timeout != 0);
 
     _writers--;
     if (!_socket) {
         _event_flag.set(FINISHED_FLAG);
     }
 
+    _socket_stats.stats_update_send(this, start, *written);
     _lock.unlock();
     if (ret <= 0 && ret != NSAPI_ERROR_WOULD_BLOCK) {
         return ret;
-    } else if (written == 0) {
+    } else if (*written == 0) {
         return NSAPI_ERROR_WOULD_BLOCK;
     } else {
-        _socket_stats.stats_update_sent_bytes(this, written);
-        return written;
+        return *written;
     }
 }
 
-nsapi_size_or_error_t TCPSocket::sendto(const SocketAddress &address, const void *data, nsapi_size_t size)
-{
-    (void)address;
-    return send(data, size);
-}
-
-nsapi_size_or_error_t TCPSocket::recv(void *data, nsapi_size_t size)
+nsapi_size_or_error_t TCPSocket::recv_call(socket_call_t call)
 {
+    us_timestamp_t start = _socket_stats.stats_get_time();
+    us_timestamp_t blocked_time = 0;
     _lock.lock();
-    nsapi_size_or_error_t ret;
 
     // If this assert is hit then there are two threads
     // performing a recv at the same time which is undefined
@@ -209,51 +368,18 @@ nsapi_size_or_error_t TCPSocket::recv(void *data, nsapi_size_t size)
     MBED_ASSERT(_readers == 0);
     _readers++;
 
-    while (true) {
-        if (!_socket) {
-            ret = NSAPI_ERROR_NO_SOCKET;
-            break;
-        }
-
-        core_util_atomic_flag_clear(&_pending);
-        ret = _stack->socket_recv(_socket, data, size);
-        if ((_timeout == 0) || (ret != NSAPI_ERROR_WOULD_BLOCK)) {
-            _socket_stats.stats_update_recv_bytes(this, ret);
-            break;
-        } else {
-            uint32_t flag;
-
-            // Release lock before blocking so other threads
-            // accessing this object aren't blocked
-            _lock.unlock();
-            flag = _event_flag.wait_any(READ_FLAG, _timeout);
-            _lock.lock();
-
-            if (flag & osFlagsError) {
-                // Timeout break
-                ret = NSAPI_ERROR_WOULD_BLOCK;
-                break;
-            }
-        }
-    }
+    nsapi_size_or_error_t ret = blocking_call(call, READ_FLAG, &blocked_time);
 
     _readers--;
     if (!_socket) {
         _event_flag.set(FINISHED_FLAG);
     }
 
+    _socket_stats.stats_update_recv(this, start, blocked_time, ret);
     _lock.unlock();
     return ret;
 }
 
-nsapi_size_or_error_t TCPSocket::recvfrom(SocketAddress *address, void *data, nsapi_size_t size)
-{
-    if (address) {
-        *address = _remote_peer;
-    }
-    return recv(data, size);
-}
-
 nsapi_error_t TCPSocket::listen(int backlog)
 {
     _lock.lock();
@@ -125,6 +125,82 @@ public:
      */
     virtual nsapi_size_or_error_t recv(void *data, nsapi_size_t size);
 
+    /** Send data gathered from a list of buffers over a TCP socket
+     *
+     *  The socket must be connected to a remote host, so address is ignored.
+     *  Returns the number of bytes sent from the buffers.
+     *
+     *  By default, sendmsg blocks until all data is sent. If socket is set to
+     *  non-blocking or times out, a partial amount can be written.
+     *  NSAPI_ERROR_WOULD_BLOCK is returned if no data was written.
+     *
+     *  @param address  Remote address, ignored
+     *  @param iov      Buffers of data to send to the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual nsapi_size_or_error_t sendmsg(const SocketAddress *address,
+                                          const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive data over a TCP socket, scattered into a list of buffers
+     *
+     *  The socket must be connected to a remote host. Stores the remote
+     *  address in address if address is not NULL. Returns the number of
+     *  bytes received into the buffers.
+     *
+     *  By default, recvmsg blocks until some data is received. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK can be returned to
+     *  indicate no data.
+     *
+     *  @param address  Destination for the remote address or NULL
+     *  @param iov      Destination buffers for data received from the host
+     *  @param iovcnt   Number of buffers
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure. If no data is available to be received
+     *                  and the peer has performed an orderly shutdown,
+     *                  recvmsg() returns 0.
+     */
+    virtual nsapi_size_or_error_t recvmsg(SocketAddress *address,
+                                          const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Send data from a memory buffer chain over a TCP socket without copying
+     *
+     *  Sends the contents of a buffer chain allocated with the memory manager
+     *  of the socket (see InternetSocket::get_memory_manager), starting at
+     *  offset. Returns the number of bytes sent.
+     *
+     *  By default, send_buf blocks until all data is sent, and the socket then
+     *  owns and frees the buffer. If socket is set to non-blocking or times out,
+     *  a partial amount can be written, and the buffer still belongs to the
+     *  caller, who can send the rest by calling send_buf again with the new offset.
+     *  NSAPI_ERROR_WOULD_BLOCK is returned if no data was written.
+     *
+     *  @param buf      Memory buffer chain to send
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    nsapi_size_or_error_t send_buf(net_stack_mem_buf_t *buf, nsapi_size_t offset = 0);
+
+    /** Receive data over a TCP socket without copying
+     *
+     *  Hands over the next block of data received from the host as a buffer
+     *  chain, which the caller must free with the memory manager of the
+     *  socket (see InternetSocket::get_memory_manager).
+     *
+     *  By default, recv_buf blocks until some data is received. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK can be returned to
+     *  indicate no data.
+     *
+     *  @param buf      Destination for the received buffer chain
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure. If no data is available to be received
+     *                  and the peer has performed an orderly shutdown,
+     *                  recv_buf() returns 0 and no buffer.
+     */
+    nsapi_size_or_error_t recv_buf(net_stack_mem_buf_t **buf);
+
     /** Send data on a socket.
      *
      * TCP socket is connection oriented protocol, so address is ignored.
@@ -196,6 +272,26 @@ private:
      *  To be used within accept() function. Close() will clean this up.
      */
     TCPSocket(TCPSocket *parent, nsapi_socket_t socket, SocketAddress address);
+
+    // Socket calls made through blocking_call
+    struct SendCall;
+    struct RecvCall;
+    struct SendBufCall;
+    struct RecvBufCall;
+    struct SendmsgCall;
+    struct RecvmsgCall;
+
+    /** Send with blocking_call until everything is written, or the call fails or would block
+     *
+     *  @param send     Call sending what is left after the bytes already written
+     *  @param size     Number of bytes to write
+     *  @param written  Number of bytes written, updated after each call
+     *  @return         Number of bytes written, or a negative error code
+     */
+    nsapi_size_or_error_t send_all(socket_call_t send, nsapi_size_t size, nsapi_size_t *written);
+
+    /** Receive with blocking_call, and record the call in the statistics */
+    nsapi_size_or_error_t recv_call(socket_call_t call);
 };
 
 
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2019 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TLSSessionCache.h"
+#include "features/storage/kvstore/include/KVStore.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include <string.h>
+
+#define TRACE_GROUP "TLSC"
+#include "mbed-trace/mbed_trace.h"
+
+#if defined(MBEDTLS_SSL_CLI_C)
+
+using mbed::KVStore;
+
+#define SESSION_FORMAT_VERSION  1
+#define SESSION_HEADER_SIZE     111
+#define SESSION_ID_LEN_OFFSET   17
+#define SESSION_MASTER_OFFSET   50
+// Larger tickets are not cached, the session ID can still be used
+#define SESSION_MAX_TICKET_SIZE 1024
+#define SESSION_KEY_PREFIX      "tls_"
+
+static uint8_t *write_u8(uint8_t *p, uint8_t value)
+{
+    *p++ = value;
+    return p;
+}
+
+static uint8_t *write_u16(uint8_t *p, uint16_t value)
+{
+    *p++ = value & 0xFF;
+    *p++ = value >> 8;
+    return p;
+}
+
+static uint8_t *write_u32(uint8_t *p, uint32_t value)
+{
+    p = write_u16(p, value & 0xFFFF);
+    return write_u16(p, value >> 16);
+}
+
+static uint8_t *write_u64(uint8_t *p, uint64_t value)
+{
+    p = write_u32(p, value & 0xFFFFFFFF);
+    return write_u32(p, value >> 32);
+}
+
+// Resuming a session skips certificate verification, so sessions are only
+// cached for, and offered to, connections that require verification
+static bool requires_verification(const mbedtls_ssl_context *ssl)
+{
+    return ssl->conf && ssl->conf->authmode == MBEDTLS_SSL_VERIFY_REQUIRED;
+}
+
+static uint16_t read_u16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t read_u32(const uint8_t *p)
+{
+    return read_u16(p) | ((uint32_t)read_u16(p + 2) << 16);
+}
+
+static uint64_t read_u64(const uint8_t *p)
+{
+    return read_u32(p) | ((uint64_t)read_u32(p + 4) << 32);
+}
+
+TLSSessionCache::TLSSessionCache(unsigned size) :
+    _kvstore(NULL),
+    _entries(new entry_t[size]),
+    _size(size),
+    _seq(0)
+{
+    memset(_entries, 0, size * sizeof(entry_t));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+TLSSessionCache::~TLSSessionCache()
+{
+    for (unsigned i = 0; i < _size; i++) {
+        drop(&_entries[i]);
+    }
+    delete[] _entries;
+}
+
+TLSSessionCache *TLSSessionCache::get_default_instance()
+{
+#if MBED_CONF_NSAPI_TLS_SESSION_CACHE_SIZE > 0
+    static TLSSessionCache cache(MBED_CONF_NSAPI_TLS_SESSION_CACHE_SIZE);
+    return &cache;
+#else
+    return NULL;
+#endif
+}
+
+void TLSSessionCache::set_kvstore(KVStore *kvstore)
+{
+    _mutex.lock();
+    _kvstore = kvstore;
+    _mutex.unlock();
+}
+
+bool TLSSessionCache::load_session(const char *hostname, mbedtls_ssl_context *ssl)
+{
+    if (!hostname || !_size || !requires_verification(ssl)) {
+        return false;
+    }
+
+    _mutex.lock();
+
+    entry_t *entry = find(hostname);
+    char key[KVStore::MAX_KEY_SIZE];
+    if (!entry && _kvstore && make_key(key, hostname)) {
+        KVStore::info_t info;
+        if (_kvstore->get_info(key, &info) == 0 && info.size >= SESSION_HEADER_SIZE
+                && info.size <= SESSION_HEADER_SIZE + SESSION_MAX_TICKET_SIZE) {
+            uint8_t *data = new uint8_t[info.size];
+            size_t actual_size;
+            if (_kvstore->get(key, data, info.size, &actual_size) == 0 && actual_size == info.size) {
+                entry = insert(hostname, data, info.size);
+            }
+            mbedtls_platform_zeroize(data, info.size);
+            delete[] data;
+        }
+    }
+
+    bool loaded = false;
+    if (entry) {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        int ret = deserialize(entry->data, entry->size, &session);
+        if (ret == 0) {
+            ret = mbedtls_ssl_set_session(ssl, &session);
+        }
+        mbedtls_ssl_session_free(&session);
+
+        if (ret == 0) {
+            entry->seq = ++_seq;
+            loaded = true;
+            tr_debug("Offering cached session for %s", hostname);
+        } else {
+            tr_warn("Cached session for %s not usable (%d)", hostname, ret);
+            drop(entry);
+        }
+    }
+
+    _mutex.unlock();
+
+    return loaded;
+}
+
+bool TLSSessionCache::save_session(const char *hostname, const mbedtls_ssl_context *ssl)
+{
+    if (!hostname || !_size || !ssl->session) {
+        return false;
+    }
+
+    if (!requires_verification(ssl) || ssl->session->verify_result != 0) {
+        _mutex.lock();
+        _stats.full_handshakes++;
+        _mutex.unlock();
+        tr_info("Full handshake with %s, session not cached without verification", hostname);
+        return false;
+    }
+
+    // Serialize straight from the context, mbedtls_ssl_get_session() would
+    // also make a copy of the peer certificate, which isn't cached
+    uint8_t *data = new uint8_t[SESSION_HEADER_SIZE + SESSION_MAX_TICKET_SIZE];
+    uint16_t size = serialize(ssl->session, data, SESSION_HEADER_SIZE + SESSION_MAX_TICKET_SIZE);
+
+    _mutex.lock();
+
+    entry_t *entry = find(hostname);
+    // The master secret is only kept if the session was resumed
+    bool resumed = entry && memcmp(entry->data + SESSION_MASTER_OFFSET, data + SESSION_MASTER_OFFSET, 48) == 0;
+    if (resumed) {
+        _stats.resumed_handshakes++;
+    } else {
+        _stats.full_handshakes++;
+    }
+
+    bool changed = !entry || entry->size != size || memcmp(entry->data, data, size) != 0;
+    if (changed) {
+        if (entry) {
+            drop(entry);
+        }
+        entry = insert(hostname, data, size);
+
+        char key[KVStore::MAX_KEY_SIZE];
+        if (_kvstore && make_key(key, hostname)) {
+            int ret = _kvstore->set(key, data, size, KVStore::REQUIRE_CONFIDENTIALITY_FLAG);
+            if (ret) {
+                tr_warn("Failed to store session for %s (%d)", hostname, ret);
+            }
+        }
+    } else {
+        entry->seq = ++_seq;
+    }
+
+    _mutex.unlock();
+
+    mbedtls_platform_zeroize(data, size);
+    delete[] data;
+
+    tr_info("%s handshake with %s", resumed ? "Resumed" : "Full", hostname);
+    return resumed;
+}
+
+void TLSSessionCache::remove(const char *hostname)
+{
+    if (!hostname || !_size) {
+        return;
+    }
+
+    _mutex.lock();
+
+    entry_t *entry = find(hostname);
+    if (entry) {
+        drop(entry);
+    }
+
+    char key[KVStore::MAX_KEY_SIZE];
+    if (_kvstore && make_key(key, hostname)) {
+        _kvstore->remove(key);
+    }
+
+    _mutex.unlock();
+}
+
+void TLSSessionCache::clear()
+{
+    _mutex.lock();
+
+    for (unsigned i = 0; i < _size; i++) {
+        drop(&_entries[i]);
+    }
+
+    if (_kvstore) {
+        KVStore::iterator_t it;
+        char key[KVStore::MAX_KEY_SIZE];
+        // Removing keys may invalidate the iterator, so restart it after each one
+        while (_kvstore->iterator_open(&it, SESSION_KEY_PREFIX) == 0) {
+            int ret = _kvstore->iterator_next(it, key, sizeof(key));
+            _kvstore->iterator_close(it);
+            if (ret || _kvstore->remove(key)) {
+                break;
+            }
+        }
+    }
+
+    _mutex.unlock();
+}
+
+void TLSSessionCache::get_stats(stats_t *stats)
+{
+    _mutex.lock();
+    *stats = _stats;
+    _mutex.unlock();
+}
+
+TLSSessionCache::entry_t *TLSSessionCache::find(const char *hostname)
+{
+    for (unsigned i = 0; i < _size; i++) {
+        if (_entries[i].hostname && strcmp(_entries[i].hostname, hostname) == 0) {
+            return &_entries[i];
+        }
+    }
+    return NULL;
+}
+
+TLSSessionCache::entry_t *TLSSessionCache::insert(const char *hostname, const uint8_t *data, uint16_t size)
+{
+    // Take a free entry, or the least recently used one
+    entry_t *entry = &_entries[0];
+    for (unsigned i = 0; i < _size && entry->hostname; i++) {
+        if (!_entries[i].hostname || (int32_t)(_entries[i].seq - entry->seq) < 0) {
+            entry = &_entries[i];
+        }
+    }
+    drop(entry);
+
+    size_t len = strlen(hostname) + 1;
+    entry->hostname = new char[len];
+    memcpy(entry->hostname, hostname, len);
+    entry->data = new uint8_t[size];
+    memcpy(entry->data, data, size);
+    entry->size = size;
+    entry->seq = ++_seq;
+    return entry;
+}
+
+void TLSSessionCache::drop(entry_t *entry)
+{
+    if (entry->data) {
+        // Don't leave the master secret around in the heap
+        mbedtls_platform_zeroize(entry->data, entry->size);
+    }
+    delete[] entry->hostname;
+    delete[] entry->data;
+    memset(entry, 0, sizeof(entry_t));
+}
+
+bool TLSSessionCache::make_key(char *key, const char *hostname)
+{
+    size_t len = strlen(hostname);
+    if (sizeof(SESSION_KEY_PREFIX) + len > KVStore::MAX_KEY_SIZE) {
+        return false;
+    }
+    memcpy(key, SESSION_KEY_PREFIX, sizeof(SESSION_KEY_PREFIX) - 1);
+    memcpy(key + sizeof(SESSION_KEY_PREFIX) - 1, hostname, len + 1);
+    return true;
+}
+
+uint16_t TLSSessionCache::serialize(const mbedtls_ssl_session *session, uint8_t *data, uint16_t size)
+{
+    uint8_t *p = data;
+    p = write_u8(p, SESSION_FORMAT_VERSION);
+#if defined(MBEDTLS_HAVE_TIME)
+    p = write_u64(p, session->start);
+#else
+    p = write_u64(p, 0);
+#endif
+    p = write_u32(p, session->ciphersuite);
+    p = write_u32(p, session->compression);
+    p = write_u8(p, session->id_len);
+    memcpy(p, session->id, 32);
+    p += 32;
+    memcpy(p, session->master, 48);
+    p += 48;
+    p = write_u32(p, session->verify_result);
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    p = write_u8(p, session->mfl_code);
+#else
+    p = write_u8(p, 0);
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+    p = write_u8(p, session->trunc_hmac);
+#else
+    p = write_u8(p, 0);
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+    p = write_u8(p, session->encrypt_then_mac);
+#else
+    p = write_u8(p, 0);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (session->ticket && session->ticket_len <= (size_t)(size - SESSION_HEADER_SIZE)) {
+        p = write_u32(p, session->ticket_lifetime);
+        p = write_u16(p, session->ticket_len);
+        memcpy(p, session->ticket, session->ticket_len);
+        p += session->ticket_len;
+    } else
+#endif
+    {
+        p = write_u32(p, 0);
+        p = write_u16(p, 0);
+    }
+
+    return p - data;
+}
+
+int TLSSessionCache::deserialize(const uint8_t *data, uint16_t size, mbedtls_ssl_session *session)
+{
+    if (size < SESSION_HEADER_SIZE || data[0] != SESSION_FORMAT_VERSION || data[SESSION_ID_LEN_OFFSET] > 32) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    const uint8_t *p = data + 1;
+#if defined(MBEDTLS_HAVE_TIME)
+    session->start = (mbedtls_time_t)read_u64(p);
+#endif
+    p += 8;
+    session->ciphersuite = read_u32(p);
+    p += 4;
+    session->compression = read_u32(p);
+    p += 4;
+    session->id_len = *p++;
+    memcpy(session->id, p, 32);
+    p += 32;
+    memcpy(session->master, p, 48);
+    p += 48;
+    session->verify_result = read_u32(p);
+    p += 4;
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    session->mfl_code = *p;
+#endif
+    p++;
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+    session->trunc_hmac = *p;
+#endif
+    p++;
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+    session->encrypt_then_mac = *p;
+#endif
+    p++;
+    uint32_t ticket_lifetime = read_u32(p);
+    p += 4;
+    uint16_t ticket_len = read_u16(p);
+    p += 2;
+
+    if (size != SESSION_HEADER_SIZE + ticket_len) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (ticket_len) {
+        session->ticket = (unsigned char *)mbedtls_calloc(1, ticket_len);
+        if (!session->ticket) {
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+        memcpy(session->ticket, p, ticket_len);
+        session->ticket_len = ticket_len;
+        session->ticket_lifetime = ticket_lifetime;
+    }
+#else
+    (void)ticket_lifetime;
+#endif
+
+    return 0;
+}
+
+#endif // MBEDTLS_SSL_CLI_C
@@ -0,0 +1,163 @@
+/** @file TLSSessionCache.h TLSSessionCache */
+/*
+ * Copyright (c) 2019 ARM Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @addtogroup netsocket
+* @{
+*/
+
+#ifndef _MBED_TLS_SESSION_CACHE_H_
+#define _MBED_TLS_SESSION_CACHE_H_
+
+#include "platform/PlatformMutex.h"
+#include "platform/NonCopyable.h"
+#include "mbedtls/ssl.h"
+
+// Session resumption is only done by the Mbed TLS SSL/TLS client
+#if defined(MBEDTLS_SSL_CLI_C) || defined(DOXYGEN_ONLY)
+
+#ifndef MBED_CONF_NSAPI_TLS_SESSION_CACHE_SIZE
+#define MBED_CONF_NSAPI_TLS_SESSION_CACHE_SIZE 0
+#endif
+
+namespace mbed {
+class KVStore;
+}
+
+/**
+ * Client-side cache of TLS sessions, used to resume sessions instead of
+ * doing a full handshake when reconnecting to a host.
+ *
+ * Sessions are kept per hostname, and resumed either with the session ID or,
+ * if the server issued one, with an RFC 5077 session ticket. When the cache
+ * is full, the least recently used session is dropped.
+ *
+ * Resuming a session skips certificate verification, so only sessions of
+ * connections that require verification (MBEDTLS_SSL_VERIFY_REQUIRED) and
+ * passed it are cached, and sessions are only offered to such connections.
+ * Sessions are not tied to the CA chain that verified them: sockets sharing
+ * a cache must trust the same CAs.
+ *
+ * Optionally, sessions can also be written to a KVStore, so that they
+ * survive a reset. They are stored with the confidentiality flag, since
+ * they contain the master secret. Peer certificates are not stored; they
+ * were verified during the full handshake.
+ */
+class TLSSessionCache : private mbed::NonCopyable<TLSSessionCache> {
+public:
+    /** Handshake statistics */
+    typedef struct {
+        uint32_t full_handshakes;       /**< Handshakes that did not resume a session */
+        uint32_t resumed_handshakes;    /**< Handshakes that resumed a cached session */
+    } stats_t;
+
+    /** Create a session cache.
+     *
+     * @param size      Number of hostnames to keep sessions for.
+     */
+    TLSSessionCache(unsigned size);
+
+    /** Destroy a session cache.
+     *
+     *  Clears all sessions from memory. Sessions in the KVStore are kept.
+     */
+    ~TLSSessionCache();
+
+    /** Get the session cache used by TLS sockets by default.
+     *
+     *  Its size is set by the nsapi.tls-session-cache-size configuration option,
+     *  which is 0 by default.
+     *
+     *  @return         Default session cache, NULL if the size is 0.
+     */
+    static TLSSessionCache *get_default_instance();
+
+    /** Write sessions to a KVStore.
+     *
+     *  Sessions for hostnames that are not in memory are read from the KVStore.
+     *
+     *  @param kvstore  Initialized KVStore, or NULL to keep sessions in memory only.
+     */
+    void set_kvstore(mbed::KVStore *kvstore);
+
+    /** Offer the cached session for a hostname to the server.
+     *
+     *  Must be called after mbedtls_ssl_setup() and before the handshake.
+     *  No session is offered if the configuration does not require
+     *  certificate verification.
+     *
+     *  @param hostname Hostname of the remote host.
+     *  @param ssl      SSL context of the connection.
+     *  @return         True if a session was set, false otherwise.
+     */
+    bool load_session(const char *hostname, mbedtls_ssl_context *ssl);
+
+    /** Cache the session of a completed handshake.
+     *
+     *  The session is only cached if the configuration requires certificate
+     *  verification and the peer certificate passed it. Also updates the
+     *  statistics.
+     *
+     *  @param hostname Hostname of the remote host.
+     *  @param ssl      SSL context of the connection, with the handshake completed.
+     *  @return         True if the handshake resumed the cached session, false
+     *                  if it was a full handshake.
+     */
+    bool save_session(const char *hostname, const mbedtls_ssl_context *ssl);
+
+    /** Drop the session for a hostname, for example after a failed handshake.
+     *
+     *  @param hostname Hostname of the remote host.
+     */
+    void remove(const char *hostname);
+
+    /** Drop all sessions from memory and from the KVStore. */
+    void clear();
+
+    /** Get handshake statistics.
+     *
+     *  @param stats    Returned statistics.
+     */
+    void get_stats(stats_t *stats);
+
+#if !defined(DOXYGEN_ONLY)
+private:
+    struct entry_t {
+        char *hostname;
+        uint8_t *data;
+        uint16_t size;
+        uint32_t seq;
+    };
+
+    entry_t *find(const char *hostname);
+    entry_t *insert(const char *hostname, const uint8_t *data, uint16_t size);
+    void drop(entry_t *entry);
+    static bool make_key(char *key, const char *hostname);
+    static uint16_t serialize(const mbedtls_ssl_session *session, uint8_t *data, uint16_t size);
+    static int deserialize(const uint8_t *data, uint16_t size, mbedtls_ssl_session *session);
+
+    PlatformMutex _mutex;
+    mbed::KVStore *_kvstore;
+    entry_t *_entries;
+    unsigned _size;
+    uint32_t _seq;
+    stats_t _stats;
+#endif //#if !defined(DOXYGEN_ONLY)
+};
+
+#endif /* MBEDTLS_SSL_CLI_C */
+#endif // _MBED_TLS_SESSION_CACHE_H_
+/** @} */
@@ -38,13 +38,15 @@ TLSSocketWrapper::TLSSocketWrapper(Socket *transport, const char *hostname, cont
     _clicert(NULL),
 #endif
     _ssl_conf(NULL),
+    _session_cache(TLSSessionCache::get_default_instance()),
     _connect_transport(control == TRANSPORT_CONNECT || control == TRANSPORT_CONNECT_AND_CLOSE),
     _close_transport(control == TRANSPORT_CLOSE || control == TRANSPORT_CONNECT_AND_CLOSE),
     _tls_initialized(false),
     _handshake_completed(false),
     _cacert_allocated(false),
     _clicert_allocated(false),
-    _ssl_conf_allocated(false)
+    _ssl_conf_allocated(false),
+    _session_resumed(false)
 {
 #if defined(MBEDTLS_PLATFORM_C)
     int ret = mbedtls_platform_setup(NULL);
@@ -175,6 +177,8 @@ nsapi_error_t TLSSocketWrapper::start_handshake(bool first_call)
         return continue_handshake();
     }
 
+    _session_resumed = false;
+
 #ifdef MBEDTLS_X509_CRT_PARSE_C
     tr_info("Starting TLS handshake with %s", _ssl.hostname);
 #else
@@ -205,6 +209,12 @@ nsapi_error_t TLSSocketWrapper::start_handshake(bool first_call)
         return NSAPI_ERROR_AUTH_FAILURE;
     }
 
+#ifdef MBEDTLS_X509_CRT_PARSE_C
+    if (_session_cache) {
+        _session_cache->load_session(_ssl.hostname, &_ssl);
+    }
+#endif
+
     _transport->set_blocking(false);
     _transport->sigio(mbed::callback(this, &TLSSocketWrapper::event));
     mbedtls_ssl_set_bio(&_ssl, this, ssl_send, ssl_recv, NULL);
@@ -253,6 +263,12 @@ nsapi_error_t TLSSocketWrapper::continue_handshake()
         if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
             return NSAPI_ERROR_ALREADY;
         } else {
+#ifdef MBEDTLS_X509_CRT_PARSE_C
+            // Don't offer the session again, in case the server rejected it
+            if (_session_cache) {
+                _session_cache->remove(_ssl.hostname);
+            }
+#endif
             return NSAPI_ERROR_AUTH_FAILURE;
         }
     }
@@ -282,6 +298,11 @@ nsapi_error_t TLSSocketWrapper::continue_handshake()
         tr_info("Certificate verification passed");
     }
     delete[] buf;
+
+    // Only cache sessions of verified peers, resumption skips verification
+    if (_session_cache && flags == 0 && get_ssl_config()->authmode == MBEDTLS_SSL_VERIFY_REQUIRED) {
+        _session_resumed = _session_cache->save_session(_ssl.hostname, &_ssl);
+    }
 #endif
 
     _handshake_completed = true;
@@ -564,10 +585,47 @@ mbedtls_ssl_config *TLSSocketWrapper::get_ssl_config()
          * MBEDTLS_SSL_VERIFY_NONE in the call to mbedtls_ssl_conf_authmode()
          */
         mbedtls_ssl_conf_authmode(get_ssl_config(), MBEDTLS_SSL_VERIFY_REQUIRED);
+
+#if MBED_CONF_NSAPI_TLS_MAX_FRAG_LEN
+        set_max_frag_len(MBED_CONF_NSAPI_TLS_MAX_FRAG_LEN);
+#endif
     }
     return _ssl_conf;
 }
 
+nsapi_error_t TLSSocketWrapper::set_max_frag_len(size_t len)
+{
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    unsigned char mfl_code;
+    switch (len) {
+        case 0:
+            mfl_code = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+            break;
+        case 512:
+            mfl_code = MBEDTLS_SSL_MAX_FRAG_LEN_512;
+            break;
+        case 1024:
+            mfl_code = MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+            break;
+        case 2048:
+            mfl_code = MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+            break;
+        case 4096:
+            mfl_code = MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+            break;
+        default:
+            return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (mbedtls_ssl_conf_max_frag_len(get_ssl_config(), mfl_code) != 0) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    return NSAPI_ERROR_OK;
+#else
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif
+}
+
 void TLSSocketWrapper::set_ssl_config(mbedtls_ssl_config *conf)
 {
     if (_ssl_conf && _ssl_conf_allocated) {
@@ -583,6 +641,16 @@ mbedtls_ssl_context *TLSSocketWrapper::get_ssl_context()
     return &_ssl;
 }
 
+void TLSSocketWrapper::set_session_cache(TLSSessionCache *cache)
+{
+    _session_cache = cache;
+}
+
+bool TLSSocketWrapper::is_session_resumed() const
+{
+    return _session_resumed;
+}
+
 nsapi_error_t TLSSocketWrapper::close()
 {
     if (!_transport) {
@@ -601,6 +669,13 @@ nsapi_error_t TLSSocketWrapper::close()
         _handshake_completed = false;
     }
 
+    // Release the record buffers now rather than when the socket is destroyed
+    if (_tls_initialized) {
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_init(&_ssl);
+        _tls_initialized = false;
+    }
+
     if (_close_transport) {
         int ret2 = _transport->close();
         if (!ret) {
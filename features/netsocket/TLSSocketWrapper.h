@@ -23,6 +23,7 @@
 #define _MBED_HTTPS_TLS_SOCKET_WRAPPER_H_
 
 #include "netsocket/Socket.h"
+#include "netsocket/TLSSessionCache.h"
 #include "rtos/EventFlags.h"
 #include "platform/Callback.h"
 #include "mbedtls/platform.h"
@@ -202,6 +203,42 @@ public:
      */
     mbedtls_ssl_context *get_ssl_context();
 
+    /** Request smaller TLS records from the server.
+     *
+     * Uses the max_fragment_length extension (RFC 6066). If the server
+     * accepts it, Mbed TLS record buffers can be configured smaller with
+     * MBEDTLS_SSL_IN_CONTENT_LEN and MBEDTLS_SSL_OUT_CONTENT_LEN. The default
+     * is set by the nsapi.tls-max-frag-len configuration option.
+     *
+     * @note Each socket owns its record buffers from connect() to close(),
+     *       they are not shared between sockets or released while idle.
+     *
+     * @note Must be called before calling connect()
+     *
+     * @param len   Maximum record length: 512, 1024, 2048 or 4096 bytes,
+     *              or 0 to not request a maximum length.
+     * @return      0 on success, NSAPI_ERROR_PARAMETER for an unsupported length,
+     *              NSAPI_ERROR_UNSUPPORTED if Mbed TLS is built without
+     *              MBEDTLS_SSL_MAX_FRAGMENT_LENGTH.
+     */
+    nsapi_error_t set_max_frag_len(size_t len);
+
+    /** Set the cache used to resume TLS sessions.
+     *
+     * By default, TLSSessionCache::get_default_instance() is used.
+     *
+     * @note Must be called before calling connect()
+     *
+     * @param cache Session cache, or NULL to always do a full handshake.
+     */
+    void set_session_cache(TLSSessionCache *cache);
+
+    /** Check whether the handshake resumed a cached session.
+     *
+     * @return True if the session was resumed, false after a full handshake.
+     */
+    bool is_session_resumed() const;
+
 protected:
 #ifndef DOXYGEN_ONLY
     /** Initiates TLS Handshake.
@@ -279,6 +316,7 @@ private:
     mbedtls_x509_crt *_clicert;
 #endif
     mbedtls_ssl_config *_ssl_conf;
+    TLSSessionCache *_session_cache;
 
     bool _connect_transport: 1;
     bool _close_transport: 1;
@@ -287,6 +325,7 @@ private:
     bool _cacert_allocated: 1;
     bool _clicert_allocated: 1;
     bool _ssl_conf_allocated: 1;
+    bool _session_resumed: 1;
 
 };
 
@@ -15,9 +15,185 @@
  */
 
 #include "UDPSocket.h"
+#include "NetStackMemoryManager.h"
 #include "Timer.h"
 #include "mbed_assert.h"
+#include <string.h>
 
+// Socket calls made through InternetSocket::blocking_call
+
+struct UDPSocket::SendtoCall {
+    SendtoCall(const SocketAddress &address, const void *data, nsapi_size_t size) :
+        address(address), data(data), size(size)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_sendto(socket, address, data, size);
+    }
+
+    const SocketAddress &address;
+    const void *data;
+    nsapi_size_t size;
+};
+
+// Datagrams that are not from the connected peer are dropped
+struct UDPSocket::RecvfromCall {
+    RecvfromCall(const SocketAddress &peer, SocketAddress *address, void *buffer, nsapi_size_t size) :
+        peer(peer), address(address), buffer(buffer), size(size)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        nsapi_size_or_error_t recv;
+        do {
+            recv = stack->socket_recvfrom(socket, address, buffer, size);
+        } while (recv >= 0 && peer && peer != *address);
+        return recv;
+    }
+
+    const SocketAddress &peer;
+    SocketAddress *address;
+    void *buffer;
+    nsapi_size_t size;
+};
+
+struct UDPSocket::SendtoBufCall {
+    SendtoBufCall(const SocketAddress &address, net_stack_mem_buf_t *buf) :
+        address(address), buf(buf)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_send_buf(socket, &address, buf, 0);
+    }
+
+    const SocketAddress &address;
+    net_stack_mem_buf_t *buf;
+};
+
+// Datagrams that are not from the connected peer are freed
+struct UDPSocket::RecvfromBufCall {
+    RecvfromBufCall(const SocketAddress &peer, SocketAddress *address, net_stack_mem_buf_t **buf) :
+        peer(peer), address(address), buf(buf)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        nsapi_size_or_error_t recv;
+        while (true) {
+            recv = stack->socket_recv_buf(socket, address, buf);
+            if (recv < 0 || !peer || peer == *address) {
+                return recv;
+            }
+            if (*buf) {
+                stack->get_memory_manager()->free(*buf);
+                *buf = NULL;
+            }
+        }
+    }
+
+    const SocketAddress &peer;
+    SocketAddress *address;
+    net_stack_mem_buf_t **buf;
+};
+
+struct UDPSocket::SendmsgCall {
+    SendmsgCall(const SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt) :
+        address(address), iov(iov), iovcnt(iovcnt)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        return stack->socket_sendmsg(socket, address, iov, iovcnt);
+    }
+
+    const SocketAddress *address;
+    const nsapi_iovec_t *iov;
+    unsigned iovcnt;
+};
+
+// Datagrams that are not from the connected peer are dropped
+struct UDPSocket::RecvmsgCall {
+    RecvmsgCall(const SocketAddress &peer, SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt) :
+        peer(peer), address(address), iov(iov), iovcnt(iovcnt)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        nsapi_size_or_error_t recv;
+        do {
+            recv = stack->socket_recvmsg(socket, address, iov, iovcnt);
+        } while (recv >= 0 && peer && peer != *address);
+        return recv;
+    }
+
+    const SocketAddress &peer;
+    SocketAddress *address;
+    const nsapi_iovec_t *iov;
+    unsigned iovcnt;
+};
+
+// Datagrams that are not from the connected peer are dropped, and the accepted
+// ones are moved to the front of the array
+struct UDPSocket::RecvmmsgCall {
+    RecvmmsgCall(const SocketAddress &peer, nsapi_msg_t *msgs, unsigned count) :
+        peer(peer), msgs(msgs), count(count), bytes(0)
+    {
+    }
+
+    nsapi_size_or_error_t call(NetworkStack *stack, nsapi_socket_t socket)
+    {
+        while (true) {
+            nsapi_size_or_error_t recv = stack->socket_recvmmsg(socket, msgs, count);
+            if (recv > 0 && peer) {
+                recv = filter(recv);
+                if (!recv) {
+                    continue;
+                }
+            }
+
+            bytes = 0;
+            for (int i = 0; i < recv; i++) {
+                bytes += msgs[i].msg_len;
+            }
+            return recv;
+        }
+    }
+
+    unsigned filter(unsigned recv)
+    {
+        unsigned accepted = 0;
+        for (unsigned i = 0; i < recv; i++) {
+            if (peer != SocketAddress(msgs[i].msg_addr, msgs[i].msg_port)) {
+                continue;
+            }
+            if (accepted != i) {
+                nsapi_size_t len = msgs[i].msg_len;
+                if (len > msgs[accepted].msg_size) {
+                    len = msgs[accepted].msg_size;
+                }
+                memmove(msgs[accepted].msg_buf, msgs[i].msg_buf, len);
+                msgs[accepted].msg_len = len;
+                msgs[accepted].msg_addr = msgs[i].msg_addr;
+                msgs[accepted].msg_port = msgs[i].msg_port;
+            }
+            accepted++;
+        }
+        return accepted;
+    }
+
+    const SocketAddress &peer;
+    nsapi_msg_t *msgs;
+    unsigned count;
+    nsapi_size_t bytes;
+};
 UDPSocket::UDPSocket()
 {
     _socket_stats.stats_update_proto(this, NSAPI_UDP);
@@ -63,125 +239,132 @@ nsapi_size_or_error_t UDPSocket::sendto(const char *host, uint16_t port, const v
 
 nsapi_size_or_error_t UDPSocket::sendto(const SocketAddress &address, const void *data, nsapi_size_t size)
 {
-    _lock.lock();
-    nsapi_size_or_error_t ret;
+    SendtoCall call(address, data, size);
+    return send_call(address, mbed::callback(&call, &SendtoCall::call));
+}
 
-    _writers++;
-    if (_socket) {
-        _socket_stats.stats_update_socket_state(this, SOCK_OPEN);
-        _socket_stats.stats_update_peer(this, address);
+nsapi_size_or_error_t UDPSocket::send(const void *data, nsapi_size_t size)
+{
+    if (!_remote_peer) {
+        return NSAPI_ERROR_NO_ADDRESS;
     }
-    while (true) {
-        if (!_socket) {
-            ret = NSAPI_ERROR_NO_SOCKET;
-            break;
-        }
+    return sendto(_remote_peer, data, size);
+}
 
-        core_util_atomic_flag_clear(&_pending);
-        nsapi_size_or_error_t sent = _stack->socket_sendto(_socket, address, data, size);
-        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
-            _socket_stats.stats_update_sent_bytes(this, sent);
-            ret = sent;
-            break;
-        } else {
-            uint32_t flag;
-
-            // Release lock before blocking so other threads
-            // accessing this object aren't blocked
-            _lock.unlock();
-            flag = _event_flag.wait_any(WRITE_FLAG, _timeout);
-            _lock.lock();
-
-            if (flag & osFlagsError) {
-                // Timeout break
-                ret = NSAPI_ERROR_WOULD_BLOCK;
-                break;
-            }
+nsapi_size_or_error_t UDPSocket::recvfrom(SocketAddress *address, void *buffer, nsapi_size_t size)
+{
+    SocketAddress ignored;
+    RecvfromCall call(_remote_peer, address ? address : &ignored, buffer, size);
+    return recv_call(mbed::callback(&call, &RecvfromCall::call));
+}
+
+nsapi_size_or_error_t UDPSocket::recv(void *buffer, nsapi_size_t size)
+{
+    return recvfrom(NULL, buffer, size);
+}
+
+nsapi_size_or_error_t UDPSocket::sendmsg(const SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    if (!address) {
+        if (!_remote_peer) {
+            return NSAPI_ERROR_NO_ADDRESS;
         }
+        address = &_remote_peer;
     }
 
-    _writers--;
-    if (!_socket || !_writers) {
-        _event_flag.set(FINISHED_FLAG);
-    }
-    _lock.unlock();
-    return ret;
+    SendmsgCall call(address, iov, iovcnt);
+    return send_call(*address, mbed::callback(&call, &SendmsgCall::call));
 }
 
-nsapi_size_or_error_t UDPSocket::send(const void *data, nsapi_size_t size)
+nsapi_size_or_error_t UDPSocket::recvmsg(SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    SocketAddress ignored;
+    RecvmsgCall call(_remote_peer, address ? address : &ignored, iov, iovcnt);
+    return recv_call(mbed::callback(&call, &RecvmsgCall::call));
+}
+
+nsapi_size_or_error_t UDPSocket::recvmmsg(nsapi_msg_t *msgs, unsigned count)
+{
+    RecvmmsgCall call(_remote_peer, msgs, count);
+    return recv_call(mbed::callback(&call, &RecvmmsgCall::call), &call.bytes);
+}
+
+nsapi_size_or_error_t UDPSocket::sendto_buf(const SocketAddress &address, net_stack_mem_buf_t *buf)
+{
+    SendtoBufCall call(address, buf);
+    return send_call(address, mbed::callback(&call, &SendtoBufCall::call));
+}
+
+nsapi_size_or_error_t UDPSocket::send_buf(net_stack_mem_buf_t *buf)
 {
     if (!_remote_peer) {
         return NSAPI_ERROR_NO_ADDRESS;
     }
-    return sendto(_remote_peer, data, size);
+    return sendto_buf(_remote_peer, buf);
 }
 
-nsapi_size_or_error_t UDPSocket::recvfrom(SocketAddress *address, void *buffer, nsapi_size_t size)
+nsapi_size_or_error_t UDPSocket::recvfrom_buf(SocketAddress *address, net_stack_mem_buf_t **buf)
 {
-    _lock.lock();
-    nsapi_size_or_error_t ret;
     SocketAddress ignored;
+    *buf = NULL;
+    RecvfromBufCall call(_remote_peer, address ? address : &ignored, buf);
+    return recv_call(mbed::callback(&call, &RecvfromBufCall::call));
+}
 
-    if (!address) {
-        address = &ignored;
-    }
+nsapi_size_or_error_t UDPSocket::recv_buf(net_stack_mem_buf_t **buf)
+{
+    return recvfrom_buf(NULL, buf);
+}
 
-    _readers++;
+nsapi_size_or_error_t UDPSocket::send_call(const SocketAddress &address, socket_call_t call)
+{
+    us_timestamp_t start = _socket_stats.stats_get_time();
+    _lock.lock();
 
+    _writers++;
     if (_socket) {
         _socket_stats.stats_update_socket_state(this, SOCK_OPEN);
+        _socket_stats.stats_update_peer(this, address);
     }
-    while (true) {
-        if (!_socket) {
-            ret = NSAPI_ERROR_NO_SOCKET;
-            break;
-        }
 
-        core_util_atomic_flag_clear(&_pending);
-        nsapi_size_or_error_t recv = _stack->socket_recvfrom(_socket, address, buffer, size);
+    nsapi_size_or_error_t ret = blocking_call(call, WRITE_FLAG, NULL);
 
-        // Filter incomming packets using connected peer address
-        if (recv >= 0 && _remote_peer && _remote_peer != *address) {
-            continue;
-        }
+    _writers--;
+    if (!_socket || !_writers) {
+        _event_flag.set(FINISHED_FLAG);
+    }
+    _socket_stats.stats_update_send(this, start, ret);
+    _lock.unlock();
+    return ret;
+}
 
+nsapi_size_or_error_t UDPSocket::recv_call(socket_call_t call, const nsapi_size_t *recv_bytes)
+{
+    us_timestamp_t start = _socket_stats.stats_get_time();
+    us_timestamp_t blocked_time = 0;
+    _lock.lock();
+
+    _readers++;
+    if (_socket) {
+        _socket_stats.stats_update_socket_state(this, SOCK_OPEN);
         _socket_stats.stats_update_peer(this, _remote_peer);
-        // Non-blocking sockets always return. Blocking only returns when success or errors other than WOULD_BLOCK
-        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
-            ret = recv;
-            _socket_stats.stats_update_recv_bytes(this, recv);
-            break;
-        } else {
-            uint32_t flag;
-
-            // Release lock before blocking so other threads
-            // accessing this object aren't blocked
-            _lock.unlock();
-            flag = _event_flag.wait_any(READ_FLAG, _timeout);
-            _lock.lock();
-
-            if (flag & osFlagsError) {
-                // Timeout break
-                ret = NSAPI_ERROR_WOULD_BLOCK;
-                break;
-            }
-        }
     }
 
+    nsapi_size_or_error_t ret = blocking_call(call, READ_FLAG, &blocked_time);
+
     _readers--;
     if (!_socket || !_readers) {
         _event_flag.set(FINISHED_FLAG);
     }
-
+    if (!recv_bytes) {
+        _socket_stats.stats_update_recv(this, start, blocked_time, ret);
+    } else if (ret >= 0) {
+        _socket_stats.stats_update_recv(this, start, blocked_time, *recv_bytes);
+    }
     _lock.unlock();
     return ret;
 }
 
-nsapi_size_or_error_t UDPSocket::recv(void *buffer, nsapi_size_t size)
-{
-    return recvfrom(NULL, buffer, size);
-}
-
 Socket *UDPSocket::accept(nsapi_error_t *error)
 {
     if (error) {
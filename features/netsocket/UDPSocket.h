@@ -156,6 +156,130 @@ public:
      */
     virtual nsapi_size_or_error_t recv(void *data, nsapi_size_t size);
 
+    /** Send a datagram gathered from a list of buffers.
+     *
+     *  Sends the buffers as one datagram to address, or to the connected
+     *  remote address if address is NULL.
+     *
+     *  By default, sendmsg blocks until data is sent. If socket is set to
+     *  nonblocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  The SocketAddress of the remote host or NULL.
+     *  @param iov      Buffers of data to send to the host.
+     *  @param iovcnt   Number of buffers.
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure.
+     */
+    virtual nsapi_size_or_error_t sendmsg(const SocketAddress *address,
+                                          const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a datagram scattered into a list of buffers and store the source address in address if it's not NULL.
+     *
+     *  By default, recvmsg blocks until a datagram is received. If socket is set to
+     *  nonblocking or times out with no datagram, NSAPI_ERROR_WOULD_BLOCK
+     *  is returned.
+     *
+     *  @note If the datagram is larger than the buffers, the excess data is silently discarded.
+     *
+     *  @note If socket is connected, only packets coming from connected peer address
+     *  are accepted.
+     *
+     *  @param address  Destination for the source address or NULL.
+     *  @param iov      Destination buffers for the datagram received from the host.
+     *  @param iovcnt   Number of buffers.
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure.
+     */
+    virtual nsapi_size_or_error_t recvmsg(SocketAddress *address,
+                                          const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a batch of datagrams into an array of buffers.
+     *
+     *  Fills msgs in order with the datagrams queued on the socket, up to
+     *  count datagrams, so that a burst of datagrams is received with one call.
+     *  For each datagram, msg_len is set to the number of bytes received into
+     *  msg_buf, and msg_addr and msg_port to its source address.
+     *
+     *  By default, recvmmsg blocks until at least one datagram is received. If
+     *  socket is set to nonblocking or times out with no datagram,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned.
+     *
+     *  @note If a datagram is larger than its buffer, the excess data is silently discarded.
+     *
+     *  @note If socket is connected, only packets coming from connected peer address
+     *  are accepted.
+     *
+     *  @note With the NSAPI_COALESCE_RECV_EVENTS socket option set, on stacks
+     *  that support it, the sigio callback is called once for a burst of
+     *  datagrams, and is called again only for datagrams arriving after the
+     *  next receive call. Receiving until fewer than count datagrams are
+     *  returned drains the socket.
+     *
+     *  @param msgs     Array of datagram buffers.
+     *  @param count    Number of entries in msgs.
+     *  @return         Number of received datagrams on success, negative error
+     *                  code on failure.
+     */
+    nsapi_size_or_error_t recvmmsg(nsapi_msg_t *msgs, unsigned count);
+
+    /** Send a datagram from a memory buffer chain to the specified address without copying.
+     *
+     *  The buffer chain must be allocated with the memory manager of the socket
+     *  (see InternetSocket::get_memory_manager), and is sent as a single datagram.
+     *  If it is sent, the socket owns and frees the buffer. On failure, the buffer
+     *  still belongs to the caller.
+     *
+     *  By default, sendto_buf blocks until data is sent. If socket is set to
+     *  nonblocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  The SocketAddress of the remote host.
+     *  @param buf      Memory buffer chain to send.
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure.
+     */
+    nsapi_size_or_error_t sendto_buf(const SocketAddress &address, net_stack_mem_buf_t *buf);
+
+    /** Send a datagram from a memory buffer chain to connected remote address without copying.
+     *
+     *  This is equivalent to calling sendto_buf with the connected address.
+     *
+     *  @param buf      Memory buffer chain to send.
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure.
+     */
+    nsapi_size_or_error_t send_buf(net_stack_mem_buf_t *buf);
+
+    /** Receive a datagram without copying and store the source address in address if it's not NULL.
+     *
+     *  Hands over the whole datagram as a buffer chain, which the caller must free
+     *  with the memory manager of the socket (see InternetSocket::get_memory_manager).
+     *
+     *  By default, recvfrom_buf blocks until a datagram is received. If socket is set to
+     *  nonblocking or times out with no datagram, NSAPI_ERROR_WOULD_BLOCK
+     *  is returned.
+     *
+     *  @note If socket is connected, only packets coming from connected peer address
+     *  are accepted.
+     *
+     *  @param address  Destination for the source address or NULL.
+     *  @param buf      Destination for the received buffer chain.
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure.
+     */
+    nsapi_size_or_error_t recvfrom_buf(SocketAddress *address, net_stack_mem_buf_t **buf);
+
+    /** Receive a datagram without copying.
+     *
+     *  This is equivalent to calling recvfrom_buf(NULL, buf).
+     *
+     *  @param buf      Destination for the received buffer chain.
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure.
+     */
+    nsapi_size_or_error_t recv_buf(net_stack_mem_buf_t **buf);
+
     /** Not implemented for UDP.
      *
      *  @param error      Not used.
@@ -175,6 +299,28 @@ public:
 protected:
     virtual nsapi_protocol_t get_proto();
 
+private:
+    // Socket calls made through blocking_call
+    struct SendtoCall;
+    struct RecvfromCall;
+    struct SendtoBufCall;
+    struct RecvfromBufCall;
+    struct SendmsgCall;
+    struct RecvmsgCall;
+    struct RecvmmsgCall;
+
+    /** Send with blocking_call, and record the call in the statistics */
+    nsapi_size_or_error_t send_call(const SocketAddress &address, socket_call_t call);
+
+    /** Receive with blocking_call, and record the call in the statistics
+     *
+     *  @param call         Call receiving data
+     *  @param recv_bytes   Bytes received, for calls that return something else on
+     *                      success. If not NULL, failed calls are not recorded.
+     *  @return             Result of the call
+     */
+    nsapi_size_or_error_t recv_call(socket_call_t call, const nsapi_size_t *recv_bytes = NULL);
+
 #endif //!defined(DOXYGEN_ONLY)
 };
 
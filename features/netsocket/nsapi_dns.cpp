@@ -33,8 +33,11 @@
 #define CLASS_IN 1
 
 #define RR_A 1
+#define RR_SOA 6
 #define RR_AAAA 28
 
+#define RCODE_NXDOMAIN 3
+
 // DNS options
 #define DNS_BUFFER_SIZE 512
 #define DNS_SERVERS_SIZE 5
@@ -43,12 +46,28 @@
 #define DNS_QUERY_QUEUE_SIZE 5
 #define DNS_HOST_NAME_MAX_LEN 255
 #define DNS_TIMER_TIMEOUT 100
+#define DNS_CACHE_NONE -1
+
+// Returned by dns_scan_response when the server failed to answer, another server may succeed
+#define DNS_RESPONSE_SERVER_FAILURE -2
+
+#ifndef MBED_CONF_NSAPI_DNS_PARALLEL_SERVERS
+#define MBED_CONF_NSAPI_DNS_PARALLEL_SERVERS 1
+#endif
+
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_NEGATIVE_MAX_TTL
+#define MBED_CONF_NSAPI_DNS_CACHE_NEGATIVE_MAX_TTL 0
+#endif
 
 struct DNS_CACHE {
-    nsapi_addr_t address;
-    char *host;
+    nsapi_addr_t address;  /*!< address, NSAPI_UNSPEC if the host has no address of the version */
+    nsapi_version_t version; /*!< version of the address, or of the failed query */
+    char *host;            /*!< host name, NULL if the entry is free */
     uint64_t expires;      /*!< time to live in milliseconds */
-    uint64_t accessed;     /*!< last accessed */
+    uint32_t hash;         /*!< hash of the host name */
+    int16_t next;          /*!< next entry in the same hash bucket */
+    int16_t lru_prev;      /*!< more recently used entry */
+    int16_t lru_next;      /*!< less recently used entry */
 };
 
 struct SOCKET_CB_DATA {
@@ -80,6 +99,9 @@ struct DNS_QUERY {
     uint32_t socket_timeout;
     uint16_t dns_message_id;
     uint8_t dns_server;
+    uint8_t dns_server_next;
+    uint8_t servers_queried;
+    uint8_t server_failures;
     uint8_t retries;
     uint8_t total_attempts;
     uint8_t send_success;
@@ -88,6 +110,7 @@ struct DNS_QUERY {
 };
 
 static void nsapi_dns_cache_add(const char *host, nsapi_addr_t *address, uint32_t ttl);
+static void nsapi_dns_cache_add_negative(const char *host, nsapi_version_t version, uint32_t ttl);
 static nsapi_size_or_error_t nsapi_dns_cache_find(const char *host, nsapi_version_t version, nsapi_addr_t *address);
 
 static nsapi_error_t nsapi_dns_get_server_addr(NetworkStack *stack, uint8_t *index, uint8_t *total_attempts, uint8_t *send_success, SocketAddress *dns_addr, const char *interface_name);
@@ -115,7 +138,12 @@ static nsapi_addr_t dns_servers[DNS_SERVERS_SIZE] = {
 // *INDENT-ON*
 
 #if (MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0)
-static DNS_CACHE *dns_cache[MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+// Entries are chained in hash buckets, and in a list from most to least recently used
+static DNS_CACHE dns_cache[MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+static int16_t dns_cache_buckets[MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+static int16_t dns_cache_lru_head = DNS_CACHE_NONE;
+static int16_t dns_cache_lru_tail = DNS_CACHE_NONE;
+static bool dns_cache_initialized = false;
 // Protects cache shared between blocking and asynchronous calls
 static SingletonPtr<PlatformMutex> dns_cache_mutex;
 #endif
@@ -214,6 +242,26 @@ static int dns_append_question(uint8_t *ptr, uint16_t id, const char *host, nsap
     return *p - s_ptr;
 }
 
+static void dns_skip_name(const uint8_t **p)
+{
+    while (true) {
+        uint8_t len = dns_scan_byte(p);
+        if (len == 0) {
+            break;
+        } else if (len & 0xc0) { // this is link
+            dns_scan_byte(p);
+            break;
+        }
+
+        *p += len;
+    }
+}
+
+/* Returns the number of addresses found, 0 if the host has no addresses,
+ * -1 if the response does not match the query, or DNS_RESPONSE_SERVER_FAILURE.
+ * TTL is the time the result can be cached, for a host with no addresses it is
+ * taken from the SOA record (RFC 2308), and is 0 if there is none.
+ */
 static int dns_scan_response(const uint8_t *ptr, uint16_t exp_id, uint32_t *ttl, nsapi_addr_t *addr, unsigned addr_count)
 {
     const uint8_t **p = &ptr;
@@ -227,7 +275,7 @@ static int dns_scan_response(const uint8_t *ptr, uint16_t exp_id, uint32_t *ttl,
 
     uint16_t qdcount = dns_scan_word(p); // qdcount
     uint16_t ancount = dns_scan_word(p); // ancount
-    dns_scan_word(p);                    // nscount
+    uint16_t nscount = dns_scan_word(p); // nscount
     dns_scan_word(p);                    // arcount
 
     // verify header is response to query
@@ -235,51 +283,33 @@ static int dns_scan_response(const uint8_t *ptr, uint16_t exp_id, uint32_t *ttl,
         return -1;
     }
 
-    if (rcode != 0) {
-        return 0;
+    if (rcode != 0 && rcode != RCODE_NXDOMAIN) {
+        return DNS_RESPONSE_SERVER_FAILURE;
     }
 
     // skip questions
     for (int i = 0; i < qdcount; i++) {
-        while (true) {
-            uint8_t len = dns_scan_byte(p);
-            if (len == 0) {
-                break;
-            }
-
-            *p += len;
-        }
-
+        dns_skip_name(p);
         dns_scan_word(p); // qtype
         dns_scan_word(p); // qclass
     }
 
     // scan each response
     unsigned count = 0;
+    int i = 0;
 
-    for (int i = 0; i < ancount && count < addr_count; i++) {
-        while (true) {
-            uint8_t len = dns_scan_byte(p);
-            if (len == 0) {
-                break;
-            } else if (len & 0xc0) { // this is link
-                dns_scan_byte(p);
-                break;
-            }
+    *ttl = INT32_MAX;
 
-            *p += len;
-        }
+    for (; i < ancount && count < addr_count; i++) {
+        dns_skip_name(p);
 
         uint16_t rtype    = dns_scan_word(p);    // rtype
         uint16_t rclass   = dns_scan_word(p);    // rclass
         uint32_t ttl_val  = dns_scan_word32(p);  // ttl
         uint16_t rdlength = dns_scan_word(p);    // rdlength
 
-        if (i == 0) {
-            // Is interested only on first address that is stored to cache
-            if (ttl_val > INT32_MAX) {
-                ttl_val = INT32_MAX;
-            }
+        // First address is stored to cache, valid as long as it and the aliases before it
+        if (count == 0 && ttl_val < *ttl) {
             *ttl = ttl_val;
         }
 
@@ -307,63 +337,207 @@ static int dns_scan_response(const uint8_t *ptr, uint16_t exp_id, uint32_t *ttl,
         }
     }
 
+    if (count == 0) {
+        // Negative response can be cached for the time given in the SOA record
+        *ttl = 0;
+
+        for (; i < ancount; i++) {
+            dns_skip_name(p);
+            dns_scan_word(p);   // rtype
+            dns_scan_word(p);   // rclass
+            dns_scan_word32(p); // ttl
+            *p += dns_scan_word(p);
+        }
+
+        for (i = 0; i < nscount; i++) {
+            dns_skip_name(p);
+
+            uint16_t rtype    = dns_scan_word(p);    // rtype
+            dns_scan_word(p);                        // rclass
+            uint32_t ttl_val  = dns_scan_word32(p);  // ttl
+            uint16_t rdlength = dns_scan_word(p);    // rdlength
+
+            if (rtype == RR_SOA && rdlength >= 4) {
+                // Minimum TTL is the last field of the record
+                const uint8_t *minimum = *p + rdlength - 4;
+                uint32_t minimum_ttl = dns_scan_word32(&minimum);
+                *ttl = minimum_ttl < ttl_val ? minimum_ttl : ttl_val;
+                if (*ttl > INT32_MAX) {
+                    *ttl = INT32_MAX;
+                }
+                break;
+            }
+
+            *p += rdlength;
+        }
+    }
+
     return count;
 }
 
-static void nsapi_dns_cache_add(const char *host, nsapi_addr_t *address, uint32_t ttl)
-{
 #if (MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0)
-    // RFC 1034: if TTL is zero, entry is not added to cache
-    if (ttl == 0) {
-        return;
+static uint32_t nsapi_dns_cache_hash(const char *host)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*host) {
+        hash = (hash ^ (uint8_t) * host++) * 16777619u;
     }
+    return hash;
+}
 
-    // Checks if already cached
-    if (nsapi_dns_cache_find(host, address->version, NULL) == NSAPI_ERROR_OK) {
+static void nsapi_dns_cache_init(void)
+{
+    if (dns_cache_initialized) {
         return;
     }
 
+    for (int i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        dns_cache_buckets[i] = DNS_CACHE_NONE;
+        dns_cache[i].host = NULL;
+    }
+    dns_cache_initialized = true;
+}
+
+static void nsapi_dns_cache_lru_unlink(int16_t index)
+{
+    DNS_CACHE *entry = &dns_cache[index];
+
+    if (entry->lru_prev != DNS_CACHE_NONE) {
+        dns_cache[entry->lru_prev].lru_next = entry->lru_next;
+    } else {
+        dns_cache_lru_head = entry->lru_next;
+    }
+
+    if (entry->lru_next != DNS_CACHE_NONE) {
+        dns_cache[entry->lru_next].lru_prev = entry->lru_prev;
+    } else {
+        dns_cache_lru_tail = entry->lru_prev;
+    }
+}
+
+static void nsapi_dns_cache_lru_push(int16_t index)
+{
+    DNS_CACHE *entry = &dns_cache[index];
+
+    entry->lru_prev = DNS_CACHE_NONE;
+    entry->lru_next = dns_cache_lru_head;
+    if (dns_cache_lru_head != DNS_CACHE_NONE) {
+        dns_cache[dns_cache_lru_head].lru_prev = index;
+    } else {
+        dns_cache_lru_tail = index;
+    }
+    dns_cache_lru_head = index;
+}
+
+static void nsapi_dns_cache_remove(int16_t index)
+{
+    DNS_CACHE *entry = &dns_cache[index];
+    int16_t *link = &dns_cache_buckets[entry->hash % MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+
+    while (*link != index) {
+        link = &dns_cache[*link].next;
+    }
+    *link = entry->next;
+
+    nsapi_dns_cache_lru_unlink(index);
+
+    delete[] entry->host;
+    entry->host = NULL;
+}
+
+/* Negative entries have an unspecified address, and the version of the query
+ * that found no addresses.
+ */
+static void nsapi_dns_cache_insert(const char *host, const nsapi_addr_t *address, nsapi_version_t version, uint32_t ttl)
+{
     dns_cache_mutex->lock();
 
-    int index = -1;
-    uint64_t accessed = UINT64_MAX;
+    nsapi_dns_cache_init();
+
+    uint32_t hash = nsapi_dns_cache_hash(host);
+    uint64_t ms_count = rtos::Kernel::get_ms_count();
+    int16_t index = dns_cache_buckets[hash % MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+
+    // Replaces the entry of the same host and version, positive or negative
+    while (index != DNS_CACHE_NONE) {
+        DNS_CACHE *entry = &dns_cache[index];
+        int16_t next = entry->next;
+        if (entry->hash == hash && entry->version == version && strcmp(entry->host, host) == 0) {
+            nsapi_dns_cache_remove(index);
+        } else if (ms_count > entry->expires) {
+            nsapi_dns_cache_remove(index);
+        }
+        index = next;
+    }
 
-    // Finds free or last accessed entry
+    // Finds free entry, otherwise reuses the least recently used
     for (int i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
-        if (!dns_cache[i]) {
+        if (!dns_cache[i].host) {
             index = i;
             break;
-        } else if (dns_cache[i]->accessed <= accessed) {
-            accessed = dns_cache[i]->accessed;
-            index = i;
         }
     }
 
-    if (index < 0) {
-        dns_cache_mutex->unlock();
+    if (index == DNS_CACHE_NONE) {
+        index = dns_cache_lru_tail;
+        nsapi_dns_cache_remove(index);
+    }
+
+    DNS_CACHE *entry = &dns_cache[index];
+    entry->host = new (std::nothrow) char[strlen(host) + 1];
+    if (entry->host) {
+        strcpy(entry->host, host);
+        if (address) {
+            entry->address = *address;
+        } else {
+            memset(&entry->address, 0, sizeof(entry->address));
+            entry->address.version = NSAPI_UNSPEC;
+        }
+        entry->version = version;
+        entry->expires = ms_count + (uint64_t) ttl * 1000;
+        entry->hash = hash;
+        entry->next = dns_cache_buckets[hash % MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+        dns_cache_buckets[hash % MBED_CONF_NSAPI_DNS_CACHE_SIZE] = index;
+        nsapi_dns_cache_lru_push(index);
+    }
+
+    dns_cache_mutex->unlock();
+}
+#endif
+
+static void nsapi_dns_cache_add(const char *host, nsapi_addr_t *address, uint32_t ttl)
+{
+#if (MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0)
+    // RFC 1034: if TTL is zero, entry is not added to cache
+    if (ttl == 0) {
         return;
     }
 
-    // Allocates in case entry is free, otherwise reuses
-    if (!dns_cache[index]) {
-        dns_cache[index] = new (std::nothrow) DNS_CACHE;
-    } else {
-        delete dns_cache[index]->host;
+    nsapi_dns_cache_insert(host, address, address->version, ttl);
+#endif
+}
+
+static void nsapi_dns_cache_add_negative(const char *host, nsapi_version_t version, uint32_t ttl)
+{
+#if (MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0)
+    // RFC 2308: negative answers are cached for a limited time only
+    if (ttl > MBED_CONF_NSAPI_DNS_CACHE_NEGATIVE_MAX_TTL) {
+        ttl = MBED_CONF_NSAPI_DNS_CACHE_NEGATIVE_MAX_TTL;
     }
 
-    if (dns_cache[index]) {
-        dns_cache[index]->address = *address;
-        dns_cache[index]->host = new (std::nothrow) char[strlen(host) + 1];
-        strcpy(dns_cache[index]->host, host);
-        uint64_t ms_count = rtos::Kernel::get_ms_count();
-        dns_cache[index]->expires = ms_count + (uint64_t) ttl * 1000;
-        dns_cache[index]->accessed = ms_count;
+    if (ttl == 0) {
+        return;
     }
 
-    dns_cache_mutex->unlock();
+    // Queries for unspecified version are sent as IPv4 queries
+    nsapi_dns_cache_insert(host, NULL, version == NSAPI_IPv6 ? NSAPI_IPv6 : NSAPI_IPv4, ttl);
 #endif
 }
 
+/* Returns NSAPI_ERROR_OK if an address was found, NSAPI_ERROR_DNS_FAILURE if the
+ * host is known to have no addresses, and NSAPI_ERROR_NO_ADDRESS if not cached.
+ */
 static nsapi_error_t nsapi_dns_cache_find(const char *host, nsapi_version_t version, nsapi_addr_t *address)
 {
     nsapi_error_t ret_val = NSAPI_ERROR_NO_ADDRESS;
@@ -371,23 +545,37 @@ static nsapi_error_t nsapi_dns_cache_find(const char *host, nsapi_version_t vers
 #if (MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0)
     dns_cache_mutex->lock();
 
-    for (int i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
-        if (dns_cache[i]) {
-            uint64_t ms_count = rtos::Kernel::get_ms_count();
-            // Checks all entries for expired entries
-            if (ms_count > dns_cache[i]->expires) {
-                delete dns_cache[i]->host;
-                delete dns_cache[i];
-                dns_cache[i] = NULL;
-            } else if ((version == NSAPI_UNSPEC || version == dns_cache[i]->address.version) &&
-                       strcmp(dns_cache[i]->host, host) == 0) {
+    nsapi_dns_cache_init();
+
+    uint32_t hash = nsapi_dns_cache_hash(host);
+    uint64_t ms_count = rtos::Kernel::get_ms_count();
+    nsapi_version_t negative_version = version == NSAPI_IPv6 ? NSAPI_IPv6 : NSAPI_IPv4;
+    int16_t index = dns_cache_buckets[hash % MBED_CONF_NSAPI_DNS_CACHE_SIZE];
+
+    while (index != DNS_CACHE_NONE) {
+        DNS_CACHE *entry = &dns_cache[index];
+        int16_t next = entry->next;
+
+        if (ms_count > entry->expires) {
+            // Removes expired entries on the way
+            nsapi_dns_cache_remove(index);
+        } else if (entry->hash == hash && strcmp(entry->host, host) == 0) {
+            if (entry->address.version == NSAPI_UNSPEC) {
+                if (entry->version == negative_version && ret_val == NSAPI_ERROR_NO_ADDRESS) {
+                    ret_val = NSAPI_ERROR_DNS_FAILURE;
+                }
+            } else if (version == NSAPI_UNSPEC || version == entry->version) {
                 if (address) {
-                    *address = dns_cache[i]->address;
+                    *address = entry->address;
                 }
-                dns_cache[i]->accessed = ms_count;
+                nsapi_dns_cache_lru_unlink(index);
+                nsapi_dns_cache_lru_push(index);
                 ret_val = NSAPI_ERROR_OK;
+                break;
             }
         }
+
+        index = next;
     }
 
     dns_cache_mutex->unlock();
@@ -396,6 +584,23 @@ static nsapi_error_t nsapi_dns_cache_find(const char *host, nsapi_version_t vers
     return ret_val;
 }
 
+extern "C" void nsapi_dns_reset(void)
+{
+#if (MBED_CONF_NSAPI_DNS_CACHE_SIZE > 0)
+    dns_cache_mutex->lock();
+
+    nsapi_dns_cache_init();
+
+    for (int i = 0; i < MBED_CONF_NSAPI_DNS_CACHE_SIZE; i++) {
+        if (dns_cache[i].host) {
+            nsapi_dns_cache_remove(i);
+        }
+    }
+
+    dns_cache_mutex->unlock();
+#endif
+}
+
 static nsapi_error_t nsapi_dns_get_server_addr(NetworkStack *stack, uint8_t *index, uint8_t *total_attempts, uint8_t *send_success, SocketAddress *dns_addr, const char *interface_name)
 {
     bool dns_addr_set = false;
@@ -443,8 +648,11 @@ static nsapi_size_or_error_t nsapi_dns_query_multiple(NetworkStack *stack, const
     }
 
     // check cache
-    if (nsapi_dns_cache_find(host, version, addr) == NSAPI_ERROR_OK) {
+    nsapi_error_t cached = nsapi_dns_cache_find(host, version, addr);
+    if (cached == NSAPI_ERROR_OK) {
         return 1;
+    } else if (cached == NSAPI_ERROR_DNS_FAILURE) {
+        return cached;
     }
 
     // create a udp socket
@@ -472,61 +680,84 @@ static nsapi_size_or_error_t nsapi_dns_query_multiple(NetworkStack *stack, const
     uint8_t total_attempts = MBED_CONF_NSAPI_DNS_TOTAL_ATTEMPTS;
     uint8_t send_success = 0;
 
-    // check against each dns server
+    // check against groups of dns servers, queried in parallel
     while (true) {
-        SocketAddress dns_addr;
-        err = nsapi_dns_get_server_addr(stack, &index, &total_attempts, &send_success, &dns_addr, interface_name);
-        if (err != NSAPI_ERROR_OK) {
-            break;
-        }
+        uint8_t group_index = index;
+        uint8_t sent = 0;
 
         // send the question
         int len = dns_append_question(packet, 1, host, version);
 
-        err = socket.sendto(dns_addr, packet, len);
-        // send may fail for various reasons, including wrong address type - move on
-        if (err < 0) {
-            // goes to next dns server
-            retries = MBED_CONF_NSAPI_DNS_RETRIES;
+        while (sent < MBED_CONF_NSAPI_DNS_PARALLEL_SERVERS) {
+            SocketAddress dns_addr;
+            err = nsapi_dns_get_server_addr(stack, &index, &total_attempts, &send_success, &dns_addr, interface_name);
+            if (err != NSAPI_ERROR_OK) {
+                break;
+            }
+
+            if (sent == 0) {
+                group_index = index;
+            }
+
+            err = socket.sendto(dns_addr, packet, len);
             index++;
-            continue;
-        }
+            // send may fail for various reasons, including wrong address type - move on
+            if (err < 0) {
+                continue;
+            }
 
-        send_success++;
+            send_success++;
+            sent++;
 
-        if (total_attempts) {
-            total_attempts--;
+            if (total_attempts) {
+                total_attempts--;
+            }
         }
 
-        // recv the response
-        err = socket.recvfrom(NULL, packet, DNS_BUFFER_SIZE);
-        if (err == NSAPI_ERROR_WOULD_BLOCK) {
-            if (retries) {
-                // retries
-                retries--;
-            } else {
-                // goes to next dns server
-                retries = MBED_CONF_NSAPI_DNS_RETRIES;
-                index++;
-            }
-            continue;
-        } else if (err < 0) {
-            result = err;
+        if (sent == 0) {
             break;
         }
 
-        const uint8_t *response = packet;
+        // recv the responses, until one of the servers gives a final answer
+        uint8_t server_failures = 0;
         uint32_t ttl;
-        int resp = dns_scan_response(response, 1, &ttl, addr, addr_count);
+        int resp = -1;
+        while (true) {
+            err = socket.recvfrom(NULL, packet, DNS_BUFFER_SIZE);
+            if (err < 0) {
+                break;
+            }
+
+            const uint8_t *response = packet;
+            resp = dns_scan_response(response, 1, &ttl, addr, addr_count);
+            if (resp >= 0) {
+                break;
+            } else if (resp == DNS_RESPONSE_SERVER_FAILURE && ++server_failures == sent) {
+                break;
+            }
+        }
+
         if (resp > 0) {
             nsapi_dns_cache_add(host, addr, ttl);
             result = resp;
-        } else if (resp < 0) {
-            continue;
+            break;
+        } else if (resp == 0) {
+            /* The DNS response is final, no need to check other servers */
+            nsapi_dns_cache_add_negative(host, version, ttl);
+            break;
         }
 
-        /* The DNS response is final, no need to check other servers */
-        break;
+        if (err == NSAPI_ERROR_WOULD_BLOCK && retries) {
+            // retries the same servers
+            retries--;
+            index = group_index;
+        } else if (err < 0 && err != NSAPI_ERROR_WOULD_BLOCK) {
+            result = err;
+            break;
+        } else {
+            // goes to next dns servers
+            retries = MBED_CONF_NSAPI_DNS_RETRIES;
+        }
     }
 
     // clean up packet
@@ -625,12 +856,12 @@ nsapi_value_or_error_t nsapi_dns_query_multiple_async(NetworkStack *stack, const
                                                       NetworkStack::hostbyname_cb_t callback, nsapi_size_t addr_count,
                                                       call_in_callback_cb_t call_in_cb, const char *interface_name, nsapi_version_t version)
 {
-    dns_mutex->lock();
-
     if (!stack) {
         return NSAPI_ERROR_PARAMETER;
     }
 
+    dns_mutex->lock();
+
     // check for valid host name
     int host_len = host ? strlen(host) : 0;
     if (host_len > DNS_HOST_NAME_MAX_LEN || host_len == 0) {
@@ -639,11 +870,17 @@ nsapi_value_or_error_t nsapi_dns_query_multiple_async(NetworkStack *stack, const
     }
 
     nsapi_addr address;
-    if (nsapi_dns_cache_find(host, version, &address) == NSAPI_ERROR_OK) {
+    nsapi_error_t cached = nsapi_dns_cache_find(host, version, &address);
+    if (cached == NSAPI_ERROR_OK) {
         SocketAddress addr(address);
         dns_mutex->unlock();
         callback(NSAPI_ERROR_OK, &addr);
         return NSAPI_ERROR_OK;
+    } else if (cached == NSAPI_ERROR_DNS_FAILURE) {
+        // Cached as not found, delivered like any other failure
+        dns_mutex->unlock();
+        callback(NSAPI_ERROR_DNS_FAILURE, NULL);
+        return NSAPI_ERROR_OK;
     }
 
     int index = -1;
@@ -684,6 +921,9 @@ nsapi_value_or_error_t nsapi_dns_query_multiple_async(NetworkStack *stack, const
     query->socket_cb_data = NULL;
     query->addrs = NULL;
     query->dns_server = 0;
+    query->dns_server_next = 0;
+    query->servers_queried = 0;
+    query->server_failures = 0;
     query->retries = MBED_CONF_NSAPI_DNS_RETRIES + 1;
     query->total_attempts =  MBED_CONF_NSAPI_DNS_TOTAL_ATTEMPTS;
     query->send_success = 0;
@@ -717,7 +957,7 @@ nsapi_value_or_error_t nsapi_dns_query_multiple_async(NetworkStack *stack, const
 
     if (!dns_timer_running) {
         if (nsapi_dns_call_in(query->call_in_cb, DNS_TIMER_TIMEOUT, mbed::callback(nsapi_dns_query_async_timeout)) != NSAPI_ERROR_OK) {
-            delete query->host;
+            delete[] query->host;
             delete query;
             dns_mutex->unlock();
             return NSAPI_ERROR_NO_MEMORY;
@@ -735,29 +975,14 @@ nsapi_value_or_error_t nsapi_dns_query_multiple_async(NetworkStack *stack, const
 
 static void nsapi_dns_query_async_initiate_next(void)
 {
-    int id = INT32_MAX;
-    DNS_QUERY *query = NULL;
-
-    // Trigger next query to start, find one that has been on queue longest
+    // Trigger queries to start, they run concurrently and are matched to responses by message id
     for (int i = 0; i < DNS_QUERY_QUEUE_SIZE; i++) {
-        if (dns_query_queue[i]) {
-            if (dns_query_queue[i]->state == DNS_CREATED) {
-                if (dns_query_queue[i]->unique_id <= id) {
-                    query = dns_query_queue[i];
-                    id = dns_query_queue[i]->unique_id;
-                }
-                // If some query is already ongoing do not trigger
-            } else if (dns_query_queue[i]->state == DNS_INITIATED) {
-                query = NULL;
-                break;
-            }
+        DNS_QUERY *query = dns_query_queue[i];
+        if (query && query->state == DNS_CREATED) {
+            query->state = DNS_INITIATED;
+            nsapi_dns_call_in(query->call_in_cb, 0, mbed::callback(nsapi_dns_query_async_create, reinterpret_cast<void *>(query->unique_id)));
         }
     }
-
-    if (query) {
-        query->state = DNS_INITIATED;
-        nsapi_dns_call_in(query->call_in_cb, 0, mbed::callback(nsapi_dns_query_async_create, reinterpret_cast<void *>(query->unique_id)));
-    }
 }
 
 static void nsapi_dns_query_async_timeout(void)
@@ -844,7 +1069,7 @@ static void nsapi_dns_query_async_create(void *ptr)
 {
     dns_mutex->lock();
 
-    int unique_id = reinterpret_cast<int>(ptr);
+    int unique_id = static_cast<int>(reinterpret_cast<intptr_t>(ptr));
 
     DNS_QUERY *query = NULL;
 
@@ -946,7 +1171,7 @@ static nsapi_error_t nsapi_dns_query_async_delete(int unique_id)
         delete[] query->addrs;
     }
 
-    delete query->host;
+    delete[] query->host;
     delete query;
     dns_query_queue[index] = NULL;
 
@@ -970,7 +1195,7 @@ static void nsapi_dns_query_async_send(void *ptr)
 {
     dns_mutex->lock();
 
-    int unique_id = reinterpret_cast<int>(ptr);
+    int unique_id = static_cast<int>(reinterpret_cast<intptr_t>(ptr));
 
     DNS_QUERY *query = NULL;
 
@@ -990,7 +1215,7 @@ static void nsapi_dns_query_async_send(void *ptr)
     if (query->retries) {
         query->retries--;
     } else {
-        query->dns_server++;
+        query->dns_server = query->dns_server_next;
         query->retries = MBED_CONF_NSAPI_DNS_RETRIES;
     }
 
@@ -1009,38 +1234,54 @@ static void nsapi_dns_query_async_send(void *ptr)
     // send the question
     int len = dns_append_question(packet, query->dns_message_id, query->host, query->version);
 
-    while (true) {
+    // Sends to a group of servers at once, first answer is used
+    uint8_t index = query->dns_server;
+    query->servers_queried = 0;
+    query->server_failures = 0;
+
+    while (query->servers_queried < MBED_CONF_NSAPI_DNS_PARALLEL_SERVERS) {
         SocketAddress dns_addr;
-        nsapi_size_or_error_t err = nsapi_dns_get_server_addr(query->stack, &(query->dns_server), &(query->total_attempts), &(query->send_success), &dns_addr, query->interface_name);
+        nsapi_size_or_error_t err = nsapi_dns_get_server_addr(query->stack, &index, &(query->total_attempts), &(query->send_success), &dns_addr, query->interface_name);
         if (err != NSAPI_ERROR_OK) {
-            nsapi_dns_query_async_resp(query, NSAPI_ERROR_TIMEOUT, NULL);
-            free(packet);
-            return;
+            break;
+        }
+
+        if (query->servers_queried == 0) {
+            query->dns_server = index;
         }
 
         err = query->socket->sendto(dns_addr, packet, len);
 
         if (err < 0) {
             if (err == NSAPI_ERROR_WOULD_BLOCK) {
+                if (query->servers_queried) {
+                    break;
+                }
                 nsapi_dns_call_in(query->call_in_cb, DNS_TIMER_TIMEOUT, mbed::callback(nsapi_dns_query_async_send, ptr));
                 free(packet);
                 dns_mutex->unlock();
                 return; // Timeout handler will retry the connection if possible
-            } else {
-                query->dns_server++;
             }
         } else {
-            break;
+            query->servers_queried++;
+            query->send_success++;
+
+            if (query->total_attempts) {
+                query->total_attempts--;
+            }
         }
+
+        index++;
     }
 
-    query->send_success++;
+    free(packet);
 
-    if (query->total_attempts) {
-        query->total_attempts--;
+    if (query->servers_queried == 0) {
+        nsapi_dns_query_async_resp(query, NSAPI_ERROR_TIMEOUT, NULL);
+        return;
     }
 
-    free(packet);
+    query->dns_server_next = index;
 
     query->socket_timeout = MBED_CONF_NSAPI_DNS_RESPONSE_WAIT_TIME;
 
@@ -1097,7 +1338,8 @@ static void nsapi_dns_query_async_socket_callback_handle(NetworkStack *stack)
                 }
             }
 
-            if (!query || query->state != DNS_INITIATED) {
+            // Ignores answers from the other servers once one has answered
+            if (!query || query->state != DNS_INITIATED || query->addrs) {
                 continue;
             }
 
@@ -1114,6 +1356,13 @@ static void nsapi_dns_query_async_socket_callback_handle(NetworkStack *stack)
             if (resp < 0) {
                 delete[] query->addrs;
                 query->addrs = 0;
+
+                // Moves on to the next servers when all have failed
+                if (resp == DNS_RESPONSE_SERVER_FAILURE && ++query->server_failures == query->servers_queried) {
+                    query->retries = 0;
+                    query->socket_timeout = 0;
+                    nsapi_dns_call_in(query->call_in_cb, 0, mbed::callback(nsapi_dns_query_async_send, reinterpret_cast<void *>(query->unique_id)));
+                }
             } else {
                 query->count = resp;
                 query->status = NSAPI_ERROR_DNS_FAILURE; // Used in case failure, otherwise ok
@@ -1132,7 +1381,7 @@ static void nsapi_dns_query_async_response(void *ptr)
 {
     dns_mutex->lock();
 
-    int unique_id = reinterpret_cast<int>(ptr);
+    int unique_id = static_cast<int>(reinterpret_cast<intptr_t>(ptr));
 
     DNS_QUERY *query = NULL;
 
@@ -1161,6 +1410,9 @@ static void nsapi_dns_query_async_response(void *ptr)
             if (query->addr_count > 0) {
                 status = query->count;
             }
+        } else if (status == NSAPI_ERROR_DNS_FAILURE) {
+            // Server answered that the host has no addresses
+            nsapi_dns_cache_add_negative(query->host, query->version, query->ttl);
         }
 
         nsapi_dns_query_async_resp(query, status, addresses);
@@ -61,6 +61,10 @@ nsapi_size_or_error_t nsapi_dns_query_multiple(nsapi_stack_t *stack, const char
  */
 nsapi_error_t nsapi_dns_add_server(nsapi_addr_t addr, const char *interface_name);
 
+/** Clear the DNS cache, including hostnames cached as not found
+ */
+void nsapi_dns_reset(void);
+
 
 #else
 
@@ -255,6 +259,10 @@ static inline nsapi_error_t nsapi_dns_add_server(const char *address, const char
     return nsapi_dns_add_server(SocketAddress(address), interface_name);
 }
 
+/** Clear the DNS cache, including hostnames cached as not found
+ */
+extern "C" void nsapi_dns_reset(void);
+
 
 #endif
 
@@ -264,6 +264,7 @@ typedef enum nsapi_socket_option {
     NSAPI_ADD_MEMBERSHIP,    /*!< Add membership to multicast address */
     NSAPI_DROP_MEMBERSHIP,   /*!< Drop membership to multicast address */
     NSAPI_BIND_TO_DEVICE,        /*!< Bind socket network interface name*/
+    NSAPI_COALESCE_RECV_EVENTS,  /*!< Call sigio once for a burst of received datagrams, until the next receive */
 } nsapi_socket_option_t;
 
 /** Supported IP protocol versions of IP stack
@@ -322,6 +323,53 @@ typedef struct nsapi_ip_mreq {
     nsapi_addr_t imr_interface; /* local IP address of interface */
 } nsapi_ip_mreq_t;
 
+/** nsapi_iovec structure
+ *
+ *  Describes one buffer of a scatter/gather list
+ */
+typedef struct nsapi_iovec {
+    void *iov_base;         /* start of the buffer */
+    nsapi_size_t iov_len;   /* size of the buffer in bytes */
+} nsapi_iovec_t;
+
+/** nsapi_msg structure
+ *
+ *  Describes one datagram of a batch receive
+ */
+typedef struct nsapi_msg {
+    void *msg_buf;          /* buffer for the datagram */
+    nsapi_size_t msg_size;  /* size of the buffer in bytes */
+    nsapi_size_t msg_len;   /* number of bytes received into the buffer */
+    nsapi_addr_t msg_addr;  /* source address of the datagram */
+    uint16_t msg_port;      /* source port of the datagram */
+} nsapi_msg_t;
+
+/** nsapi_stack_stats structure
+ *
+ *  Protocol counters of a network stack
+ */
+typedef struct nsapi_stack_stats {
+    uint32_t tcp_sent;          /* TCP segments sent */
+    uint32_t tcp_received;      /* TCP segments received */
+    uint32_t tcp_retransmits;   /* TCP segments retransmitted */
+    uint32_t tcp_dropped;       /* TCP segments dropped */
+    uint32_t udp_sent;          /* UDP datagrams sent */
+    uint32_t udp_received;      /* UDP datagrams received */
+    uint32_t udp_dropped;       /* UDP datagrams dropped */
+} nsapi_stack_stats_t;
+
+/** nsapi_pool_stats structure
+ *
+ *  Usage of one of the memory pools of a network stack
+ */
+typedef struct nsapi_pool_stats {
+    const char *name;           /* name of the pool */
+    uint32_t size;              /* elements in the pool, or bytes for a heap */
+    uint32_t used;              /* elements currently in use */
+    uint32_t max_used;          /* high-water mark of elements in use */
+    uint32_t errors;            /* failed allocations */
+} nsapi_pool_stats_t;
+
 /** nsapi_stack_api structure
  *
  *  Common api structure for network stack operations. A network stack
@@ -19,6 +19,7 @@
 
 #include "BufferedBlockDevice.h"
 #include "HeapBlockDevice.h"
+#include "ProfilingBlockDevice.h"
 #include <stdlib.h>
 
 using namespace utest::v1;
@@ -175,6 +176,125 @@ void functionality_test()
     }
 }
 
+void cache_test()
+{
+    const bd_size_t read_size = 4;
+    const bd_size_t prog_size = 64;
+    const bd_size_t read_line_size = 128;
+
+    uint8_t *read_buf, *write_buf, *shadow;
+    read_buf = new (std::nothrow) uint8_t[heap_erase_size];
+    TEST_SKIP_UNLESS_MESSAGE(read_buf, "Not enough memory for test");
+    write_buf = new (std::nothrow) uint8_t[heap_erase_size];
+    TEST_SKIP_UNLESS_MESSAGE(write_buf, "Not enough memory for test");
+    shadow = new (std::nothrow) uint8_t[heap_erase_size];
+    TEST_SKIP_UNLESS_MESSAGE(shadow, "Not enough memory for test");
+
+    HeapBlockDevice heap_bd(num_blocks * heap_erase_size, read_size, prog_size, heap_erase_size);
+    ProfilingBlockDevice prof_bd(&heap_bd);
+    BufferedBlockDevice bd(&prof_bd, 4, 2, read_line_size);
+    BufferedBlockDevice::cache_stats_t stats;
+
+    int err = bd.init();
+    TEST_ASSERT_EQUAL(0, err);
+
+    for (bd_size_t i = 0; i < heap_erase_size; i++) {
+        write_buf[i] = i & 0xFF;
+    }
+    err = heap_bd.program(write_buf, 0, heap_erase_size);
+    TEST_SKIP_UNLESS_MESSAGE(!err, "Not enough memory for test");
+    err = heap_bd.program(write_buf, heap_erase_size, heap_erase_size);
+    TEST_SKIP_UNLESS_MESSAGE(!err, "Not enough memory for test");
+
+    // Small reads within a single line should read it from the underlying BD once
+    prof_bd.reset();
+    err = bd.read(read_buf, 10, 16);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf + 10, read_buf, 16);
+    err = bd.read(read_buf, 20, 4);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf + 20, read_buf, 4);
+    err = bd.read(read_buf, 100, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf + 100, read_buf, 8);
+    TEST_ASSERT_EQUAL(read_line_size, prof_bd.get_read_count());
+    bd.get_cache_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.read_misses);
+    TEST_ASSERT_EQUAL(2, stats.read_hits);
+
+    // Third line evicts the least recently used one (first line)
+    err = bd.read(read_buf, 130, 4);
+    TEST_ASSERT_EQUAL(0, err);
+    err = bd.read(read_buf, 300, 4);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf + 300, read_buf, 4);
+    err = bd.read(read_buf, 140, 4);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf + 140, read_buf, 4);
+    TEST_ASSERT_EQUAL(3 * read_line_size, prof_bd.get_read_count());
+    err = bd.read(read_buf, 0, 4);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(4 * read_line_size, prof_bd.get_read_count());
+
+    // Aligned whole line reads bypass the cache
+    err = bd.read(read_buf, 2 * read_line_size, 2 * read_line_size);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf + 2 * read_line_size, read_buf, 2 * read_line_size);
+    TEST_ASSERT_EQUAL(6 * read_line_size, prof_bd.get_read_count());
+
+    // Interleaved partial programs to several units should be combined until sync
+    memcpy(shadow, write_buf, heap_erase_size);
+    memset(write_buf, 0x5A, 8);
+    memcpy(shadow + 0, write_buf, 8);
+    memcpy(shadow + 64, write_buf, 8);
+    memcpy(shadow + 128, write_buf, 8);
+    memcpy(shadow + 8, write_buf, 8);
+    memcpy(shadow + 72, write_buf, 8);
+    prof_bd.reset();
+    err = bd.program(write_buf, heap_erase_size + 0, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    err = bd.program(write_buf, heap_erase_size + 64, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    err = bd.program(write_buf, heap_erase_size + 128, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    err = bd.program(write_buf, heap_erase_size + 8, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    err = bd.program(write_buf, heap_erase_size + 72, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(0, prof_bd.get_program_count());
+    bd.get_cache_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.write_misses);
+    TEST_ASSERT_EQUAL(2, stats.write_hits);
+    TEST_ASSERT_EQUAL(0, stats.write_flushes);
+
+    err = bd.read(read_buf, heap_erase_size, heap_erase_size);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(shadow, read_buf, heap_erase_size);
+
+    err = bd.sync();
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL(3 * prog_size, prof_bd.get_program_count());
+    bd.get_cache_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.write_flushes);
+
+    // Both the underlying BD and the read cache should be up to date
+    err = heap_bd.read(read_buf, heap_erase_size, heap_erase_size);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(shadow, read_buf, heap_erase_size);
+    err = bd.read(read_buf, heap_erase_size + 4, 8);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(shadow + 4, read_buf, 8);
+    err = bd.read(read_buf, heap_erase_size + 130, 4);
+    TEST_ASSERT_EQUAL(0, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(shadow + 130, read_buf, 4);
+
+    bd.deinit();
+
+    delete[] read_buf;
+    delete[] write_buf;
+    delete[] shadow;
+}
+
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases)
 {
@@ -184,6 +304,7 @@ utest::v1::status_t test_setup(const size_t number_of_cases)
 
 Case cases[] = {
     Case("BufferedBlockDevice functionality test", functionality_test),
+    Case("BufferedBlockDevice cache test", cache_test),
 };
 
 Specification specification(test_setup, cases);
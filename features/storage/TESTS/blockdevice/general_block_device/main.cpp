@@ -675,6 +675,71 @@ void test_unaligned_erase_blocks()
     TEST_ASSERT_EQUAL(0, err);
 }
 
+class AsyncResult {
+public:
+    AsyncResult() : _err(0) {}
+
+    void complete(int err)
+    {
+        _err = err;
+        _done.release();
+    }
+
+    int wait()
+    {
+        _done.wait();
+        return _err;
+    }
+
+private:
+    rtos::Semaphore _done;
+    int _err;
+};
+
+void test_async_erase_program_read()
+{
+    utest_printf("\nTest Async Erase/Program/Read Starts..\n");
+
+    TEST_SKIP_UNLESS_MESSAGE(block_device != NULL, "no block device found.");
+
+    utest_printf("async_queue_depth=%lu\n", block_device->get_async_queue_depth());
+
+    bd_addr_t addr = sectors_addr[rand() % num_of_sectors];
+    bd_size_t erase_size = block_device->get_erase_size(addr);
+    bd_size_t program_size = block_device->get_program_size();
+    bd_size_t buf_size = program_size;
+    while (buf_size < 256 && buf_size + program_size <= erase_size) {
+        buf_size += program_size;
+    }
+
+    uint8_t *write_buf = new (std::nothrow) uint8_t[buf_size];
+    TEST_SKIP_UNLESS_MESSAGE(write_buf, "Not enough memory for test.\n");
+    uint8_t *read_buf = new (std::nothrow) uint8_t[buf_size];
+    TEST_SKIP_UNLESS_MESSAGE(read_buf, "Not enough memory for test.\n");
+
+    for (bd_size_t i = 0; i < buf_size; i++) {
+        write_buf[i] = 0xff & rand();
+    }
+    memset(read_buf, 0, buf_size);
+
+    // Operations complete in the order they were started, so the read returns the programmed data
+    AsyncResult erase_result, program_result, read_result;
+    int err = block_device->erase_async(addr, erase_size, callback(&erase_result, &AsyncResult::complete));
+    TEST_ASSERT_EQUAL(0, err);
+    err = block_device->program_async(write_buf, addr, buf_size, callback(&program_result, &AsyncResult::complete));
+    TEST_ASSERT_EQUAL(0, err);
+    err = block_device->read_async(read_buf, addr, buf_size, callback(&read_result, &AsyncResult::complete));
+    TEST_ASSERT_EQUAL(0, err);
+
+    TEST_ASSERT_EQUAL(0, erase_result.wait());
+    TEST_ASSERT_EQUAL(0, program_result.wait());
+    TEST_ASSERT_EQUAL(0, read_result.wait());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_buf, read_buf, buf_size);
+
+    delete[] write_buf;
+    delete[] read_buf;
+}
+
 void test_deinit_bd()
 {
     utest_printf("\nTest deinit block device.\n");
@@ -732,6 +797,7 @@ template_case_t template_cases[] = {
     {"Testing BlockDevice erase functionality", test_erase_functionality, greentea_failure_handler},
     {"Testing program read small data sizes", test_program_read_small_data_sizes, greentea_failure_handler},
     {"Testing unaligned erase blocks", test_unaligned_erase_blocks, greentea_failure_handler},
+    {"Testing async erase, program and read", test_async_erase_program_read, greentea_failure_handler},
     {"Testing Deinit block device", test_deinit_bd, greentea_failure_handler},
 };
 
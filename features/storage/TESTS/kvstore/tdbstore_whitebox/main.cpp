@@ -614,6 +614,284 @@ static void error_inject_test()
 }
 
 
+static void lookup_scaling_test()
+{
+
+#if !defined(TARGET_K64F)
+    TEST_SKIP_MESSAGE("Kvstore API tests run only on K64F devices");
+#endif
+
+    const size_t key_counts[] = {16, 64, 256};
+    char key[16];
+    uint8_t set_buf[8], get_buf[8];
+    size_t data_size = sizeof(set_buf);
+    size_t num_blocks = 32;
+    size_t block_size = 4096;
+    size_t actual_data_size;
+    int result;
+    mbed::Timer timer;
+
+    uint8_t *dummy = new (std::nothrow) uint8_t[heap_alloc_threshold_size];
+    TEST_SKIP_UNLESS_MESSAGE(dummy, "Not enough heap to run test");
+
+    HeapBlockDevice heap_bd(num_blocks * block_size, 1, 1, block_size);
+    FlashSimBlockDevice sim_bd(&heap_bd);
+
+    // We need to skip the test if we don't have enough memory for the heap block device.
+    // However, this device allocates the erase units on the fly, so "erase" it via the flash
+    // simulator. A failure here means we haven't got enough memory.
+    sim_bd.init();
+    result = sim_bd.erase(0, sim_bd.size());
+    TEST_SKIP_UNLESS_MESSAGE(!result, "Not enough heap to run test");
+    sim_bd.deinit();
+
+    delete[] dummy;
+
+    TDBStore *tdbs = new TDBStore(&sim_bd);
+
+    result = tdbs->init();
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    timer.start();
+    for (size_t count_ind = 0; count_ind < sizeof(key_counts) / sizeof(key_counts[0]); count_ind++) {
+        size_t num_keys = key_counts[count_ind];
+        int total_set_time = 0, total_get_time = 0, total_miss_time = 0;
+
+        result = tdbs->reset();
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+        for (size_t key_ind = 0; key_ind < num_keys; key_ind++) {
+            sprintf(key, "key_%u", (unsigned) key_ind);
+            memset(set_buf, key_ind, data_size);
+            timer.reset();
+            result = tdbs->set(key, set_buf, data_size, 0);
+            total_set_time += timer.read_us();
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+        }
+
+        for (size_t key_ind = 0; key_ind < num_keys; key_ind++) {
+            sprintf(key, "key_%u", (unsigned) key_ind);
+            memset(set_buf, key_ind, data_size);
+            timer.reset();
+            result = tdbs->get(key, get_buf, data_size, &actual_data_size);
+            total_get_time += timer.read_us();
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+            TEST_ASSERT_EQUAL(data_size, actual_data_size);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(set_buf, get_buf, data_size);
+        }
+
+        for (size_t key_ind = 0; key_ind < num_keys; key_ind++) {
+            sprintf(key, "nokey_%u", (unsigned) key_ind);
+            timer.reset();
+            result = tdbs->get(key, get_buf, data_size, &actual_data_size);
+            total_miss_time += timer.read_us();
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_ERROR_ITEM_NOT_FOUND, result);
+        }
+
+        printf("%u keys: set average - %d us, get average - %d us, missing get average - %d us\n",
+               (unsigned) num_keys, total_set_time / (int) num_keys,
+               total_get_time / (int) num_keys, total_miss_time / (int) num_keys);
+    }
+
+    result = tdbs->deinit();
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    delete tdbs;
+}
+
+
+static void incremental_gc_test()
+{
+
+#if !defined(TARGET_K64F)
+    TEST_SKIP_MESSAGE("Kvstore API tests run only on K64F devices");
+#endif
+
+    char key[16];
+    uint8_t set_buf[64], get_buf[64];
+    size_t num_keys = 16;
+    size_t set_iters = 40;
+    size_t num_blocks = 8;
+    size_t block_size = 4096;
+    size_t actual_data_size;
+    int result;
+    TDBStore::gc_stats_t stats;
+
+    uint8_t *dummy = new (std::nothrow) uint8_t[heap_alloc_threshold_size];
+    TEST_SKIP_UNLESS_MESSAGE(dummy, "Not enough heap to run test");
+
+    HeapBlockDevice heap_bd(num_blocks * block_size, 1, 1, block_size);
+    FlashSimBlockDevice sim_bd(&heap_bd);
+
+    // We need to skip the test if we don't have enough memory for the heap block device.
+    // However, this device allocates the erase units on the fly, so "erase" it via the flash
+    // simulator. A failure here means we haven't got enough memory.
+    sim_bd.init();
+    result = sim_bd.erase(0, sim_bd.size());
+    TEST_SKIP_UNLESS_MESSAGE(!result, "Not enough heap to run test");
+    sim_bd.deinit();
+
+    delete[] dummy;
+
+    for (int incremental = 0; incremental < 2; incremental++) {
+        TDBStore *tdbs = new TDBStore(&sim_bd);
+
+        result = tdbs->init();
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+        result = tdbs->reset();
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+        if (incremental) {
+            result = tdbs->set_incremental_gc(4, 2 * block_size);
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+        }
+
+        for (size_t i = 0; i < set_iters; i++) {
+            for (size_t key_ind = 0; key_ind < num_keys; key_ind++) {
+                sprintf(key, "key_%u", (unsigned) key_ind);
+                memset(set_buf, key_ind + i, sizeof(set_buf));
+                result = tdbs->set(key, set_buf, sizeof(set_buf), 0);
+                TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+            }
+            // Odd keys get removed and rewritten every other iteration
+            for (size_t key_ind = 1; (i % 2) && (key_ind < num_keys); key_ind += 2) {
+                sprintf(key, "key_%u", (unsigned) key_ind);
+                result = tdbs->remove(key);
+                TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+            }
+            result = tdbs->gc_step();
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+        }
+
+        // Check contents both before and after a reboot (which may occur mid GC)
+        for (int reboot = 0; reboot < 2; reboot++) {
+            for (size_t key_ind = 0; key_ind < num_keys; key_ind++) {
+                sprintf(key, "key_%u", (unsigned) key_ind);
+                memset(set_buf, key_ind + set_iters - 1, sizeof(set_buf));
+                result = tdbs->get(key, get_buf, sizeof(get_buf), &actual_data_size);
+                if (key_ind % 2) {
+                    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_ERROR_ITEM_NOT_FOUND, result);
+                } else {
+                    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+                    TEST_ASSERT_EQUAL(sizeof(set_buf), actual_data_size);
+                    TEST_ASSERT_EQUAL_UINT8_ARRAY(set_buf, get_buf, sizeof(set_buf));
+                }
+            }
+
+            result = tdbs->deinit();
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+            result = tdbs->init();
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+        }
+
+        result = tdbs->get_gc_stats(&stats);
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+        printf("%s GC: full %u, incremental %u (%u steps), max pause %u us\n",
+               incremental ? "Incremental" : "Full", (unsigned) stats.full_gc_count,
+               (unsigned) stats.incremental_gc_count, (unsigned) stats.gc_step_count,
+               (unsigned) stats.max_pause_us);
+        if (incremental) {
+            TEST_ASSERT(stats.incremental_gc_count > 0);
+        }
+
+        result = tdbs->deinit();
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+        delete tdbs;
+    }
+}
+
+
+static void batch_test()
+{
+
+#if !defined(TARGET_K64F)
+    TEST_SKIP_MESSAGE("Kvstore API tests run only on K64F devices");
+#endif
+
+    char keys[4][16];
+    uint8_t set_buf[4][32], get_buf[32];
+    KVStore::batch_op_t ops[4];
+    size_t num_blocks = 8;
+    size_t block_size = 4096;
+    size_t actual_data_size;
+    int result;
+
+    uint8_t *dummy = new (std::nothrow) uint8_t[heap_alloc_threshold_size];
+    TEST_SKIP_UNLESS_MESSAGE(dummy, "Not enough heap to run test");
+
+    HeapBlockDevice heap_bd(num_blocks * block_size, 1, 1, block_size);
+    FlashSimBlockDevice sim_bd(&heap_bd);
+
+    sim_bd.init();
+    result = sim_bd.erase(0, sim_bd.size());
+    TEST_SKIP_UNLESS_MESSAGE(!result, "Not enough heap to run test");
+    sim_bd.deinit();
+
+    delete[] dummy;
+
+    TDBStore *tdbs = new TDBStore(&sim_bd);
+
+    result = tdbs->init();
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    result = tdbs->reset();
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    for (size_t i = 0; i < 4; i++) {
+        sprintf(keys[i], "key_%u", (unsigned) i);
+        memset(set_buf[i], 'a' + i, sizeof(set_buf[i]));
+        ops[i].key = keys[i];
+        ops[i].buffer = set_buf[i];
+        ops[i].size = sizeof(set_buf[i]);
+        ops[i].create_flags = 0;
+        ops[i].remove = false;
+    }
+
+    result = tdbs->set(keys[3], "old", 3, 0);
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    // Set three keys and remove a fourth one in a single batch
+    ops[3].remove = true;
+    result = tdbs->batch(ops, 4);
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    // Removing a missing key fails the whole batch
+    ops[0].buffer = set_buf[1];
+    result = tdbs->batch(ops, 4);
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_ERROR_ITEM_NOT_FOUND, result);
+
+    // As does setting a key twice, with the first set being write once
+    ops[3].remove = false;
+    ops[1].create_flags = KVStore::WRITE_ONCE_FLAG;
+    ops[3].key = keys[1];
+    result = tdbs->batch(ops, 4);
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_ERROR_WRITE_PROTECTED, result);
+
+    // Check contents both before and after a reboot
+    for (int reboot = 0; reboot < 2; reboot++) {
+        for (size_t i = 0; i < 3; i++) {
+            result = tdbs->get(keys[i], get_buf, sizeof(get_buf), &actual_data_size);
+            TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+            TEST_ASSERT_EQUAL(sizeof(set_buf[i]), actual_data_size);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(set_buf[i], get_buf, sizeof(set_buf[i]));
+        }
+        result = tdbs->get(keys[3], get_buf, sizeof(get_buf), &actual_data_size);
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_ERROR_ITEM_NOT_FOUND, result);
+
+        result = tdbs->deinit();
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+        result = tdbs->init();
+        TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+    }
+
+    result = tdbs->deinit();
+    TEST_ASSERT_EQUAL_ERROR_CODE(MBED_SUCCESS, result);
+
+    delete tdbs;
+}
+
 utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason)
 {
     greentea_case_failure_abort_handler(source, reason);
@@ -624,6 +902,9 @@ Case cases[] = {
     Case("TDBStore: White box test",     white_box_test,    greentea_failure_handler),
     Case("TDBStore: Multiple set test",  multi_set_test,    greentea_failure_handler),
     Case("TDBStore: Error inject test",  error_inject_test, greentea_failure_handler),
+    Case("TDBStore: Lookup scaling test", lookup_scaling_test, greentea_failure_handler),
+    Case("TDBStore: Incremental GC test", incremental_gc_test, greentea_failure_handler),
+    Case("TDBStore: Batch test",         batch_test,        greentea_failure_handler),
 };
 
 utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
@@ -21,6 +21,7 @@
 #define MBED_BLOCK_DEVICE_H
 
 #include <stdint.h>
+#include "platform/Callback.h"
 
 namespace mbed {
 
@@ -122,6 +123,82 @@ public:
         return 0;
     }
 
+    /** Read blocks from a block device asynchronously
+     *
+     *  Starts the read and returns, so that the transfer can overlap with other work. The
+     *  callback is called with the result once the read completes, possibly from another
+     *  thread. It may start one more operation, but must not wait for others to complete.
+     *
+     *  The default implementation reads synchronously and calls the callback before returning.
+     *
+     *  @param buffer   Buffer to write blocks to, must stay valid until the callback is called
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes, must be a multiple of the read block size
+     *  @param callback Called with 0 on success or a negative error code on failure
+     *  @return         0 if the read was started or a negative error code on failure,
+     *                  in which case the callback is not called
+     */
+    virtual int read_async(void *buffer, bd_addr_t addr, bd_size_t size, mbed::Callback<void(int)> callback)
+    {
+        int err = read(buffer, addr, size);
+        if (callback) {
+            callback(err);
+        }
+        return 0;
+    }
+
+    /** Program blocks to a block device asynchronously
+     *
+     *  Same as read_async, for a program.
+     *
+     *  @param buffer   Buffer of data to write to blocks, must stay valid until the callback is called
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes, must be a multiple of the program block size
+     *  @param callback Called with 0 on success or a negative error code on failure
+     *  @return         0 if the program was started or a negative error code on failure,
+     *                  in which case the callback is not called
+     */
+    virtual int program_async(const void *buffer, bd_addr_t addr, bd_size_t size,
+                              mbed::Callback<void(int)> callback)
+    {
+        int err = program(buffer, addr, size);
+        if (callback) {
+            callback(err);
+        }
+        return 0;
+    }
+
+    /** Erase blocks on a block device asynchronously
+     *
+     *  Same as read_async, for an erase.
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes, must be a multiple of the erase block size
+     *  @param callback Called with 0 on success or a negative error code on failure
+     *  @return         0 if the erase was started or a negative error code on failure,
+     *                  in which case the callback is not called
+     */
+    virtual int erase_async(bd_addr_t addr, bd_size_t size, mbed::Callback<void(int)> callback)
+    {
+        int err = erase(addr, size);
+        if (callback) {
+            callback(err);
+        }
+        return 0;
+    }
+
+    /** Get the number of asynchronous operations that can be pending at once
+     *
+     *  Asynchronous operations complete in the order they were started. Starting one
+     *  more blocks until a pending one completes.
+     *
+     *  @return         Queue depth, or 0 if asynchronous operations complete synchronously
+     */
+    virtual uint32_t get_async_queue_depth() const
+    {
+        return 0;
+    }
+
     /** Mark blocks as no longer in use
      *
      *  This function provides a hint to the underlying block device that a region of blocks
@@ -0,0 +1,223 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BlockDeviceAsyncQueue.h"
+
+#if MBED_CONF_RTOS_PRESENT
+#include "platform/PlatformMutex.h"
+#include "platform/SingletonPtr.h"
+#include "rtos/Thread.h"
+#endif
+
+namespace mbed {
+
+#if MBED_CONF_RTOS_PRESENT
+// Semaphore counts are limited to 16 bits
+static const uint32_t max_depth = 0xFFFF;
+
+// State shared by all queues, protected by the mutex
+static SingletonPtr<PlatformMutex> async_mutex;
+static SingletonPtr<rtos::Semaphore> async_work;
+static SingletonPtr<rtos::Thread> async_thread;
+static bool async_thread_started = false;
+
+// Queues with queued operations, in the order the worker serves them
+static BlockDeviceAsyncQueue *async_head = 0;
+static BlockDeviceAsyncQueue *async_tail = 0;
+
+BlockDeviceAsyncQueue::BlockDeviceAsyncQueue(BlockDevice *bd, uint32_t depth)
+    : _bd(bd), _depth(depth > max_depth ? max_depth : depth), _requests(0), _head(0), _tail(0),
+      _queued(0), _pending(0), _stopped(false), _next(0),
+      _slots(_depth, _depth ? _depth : 1), _done(0, 1)
+{
+}
+#else
+BlockDeviceAsyncQueue::BlockDeviceAsyncQueue(BlockDevice *bd, uint32_t depth)
+    : _bd(bd), _depth(0)
+{
+}
+#endif
+
+BlockDeviceAsyncQueue::~BlockDeviceAsyncQueue()
+{
+    stop();
+#if MBED_CONF_RTOS_PRESENT
+    delete[] _requests;
+#endif
+}
+
+void BlockDeviceAsyncQueue::stop()
+{
+#if MBED_CONF_RTOS_PRESENT
+    async_mutex->lock();
+    _stopped = true;
+    bool pending = _pending > 0;
+    async_mutex->unlock();
+
+    if (pending) {
+        _done.wait();
+    }
+#endif
+}
+
+int BlockDeviceAsyncQueue::read(void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return enqueue(ASYNC_OP_READ, buffer, addr, size, callback);
+}
+
+int BlockDeviceAsyncQueue::program(const void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return enqueue(ASYNC_OP_PROGRAM, const_cast<void *>(buffer), addr, size, callback);
+}
+
+int BlockDeviceAsyncQueue::erase(bd_addr_t addr, bd_size_t size, Callback<void(int)> callback)
+{
+    return enqueue(ASYNC_OP_ERASE, 0, addr, size, callback);
+}
+
+uint32_t BlockDeviceAsyncQueue::get_depth() const
+{
+    return _depth;
+}
+
+int BlockDeviceAsyncQueue::execute(async_op_e op, void *buffer, bd_addr_t addr, bd_size_t size)
+{
+    switch (op) {
+        case ASYNC_OP_READ:
+            return _bd->read(buffer, addr, size);
+        case ASYNC_OP_PROGRAM:
+            return _bd->program(buffer, addr, size);
+        case ASYNC_OP_ERASE:
+            return _bd->erase(addr, size);
+        default:
+            return BD_ERROR_OK;
+    }
+}
+
+int BlockDeviceAsyncQueue::enqueue(async_op_e op, void *buffer, bd_addr_t addr, bd_size_t size,
+                                   Callback<void(int)> callback)
+{
+    if (!_depth) {
+        int err = execute(op, buffer, addr, size);
+        if (callback) {
+            callback(err);
+        }
+        return BD_ERROR_OK;
+    }
+
+#if MBED_CONF_RTOS_PRESENT
+    async_mutex->lock();
+    if (_stopped) {
+        async_mutex->unlock();
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    if (!async_thread_started) {
+        if (async_thread->start(mbed::callback(&BlockDeviceAsyncQueue::worker)) != osOK) {
+            async_mutex->unlock();
+            return BD_ERROR_DEVICE_ERROR;
+        }
+        async_thread_started = true;
+    }
+
+    if (!_requests) {
+        _requests = new request_t[_depth];
+    }
+    async_mutex->unlock();
+
+    _slots.wait();
+
+    async_mutex->lock();
+    if (_stopped) {
+        async_mutex->unlock();
+        _slots.release();
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    request_t &req = _requests[_head];
+    req.op = op;
+    req.buffer = buffer;
+    req.addr = addr;
+    req.size = size;
+    req.callback = callback;
+    _head = (_head + 1) % _depth;
+    _pending += 1;
+
+    // Queue up for the worker if not queued up already
+    if (_queued++ == 0) {
+        _next = 0;
+        if (async_tail) {
+            async_tail->_next = this;
+        } else {
+            async_head = this;
+        }
+        async_tail = this;
+    }
+    async_mutex->unlock();
+
+    async_work->release();
+#endif
+    return BD_ERROR_OK;
+}
+
+#if MBED_CONF_RTOS_PRESENT
+void BlockDeviceAsyncQueue::worker()
+{
+    while (1) {
+        async_work->wait();
+
+        // Take the next operation of the first queue, and send the queue to
+        // the back of the line if it has more operations queued
+        async_mutex->lock();
+        BlockDeviceAsyncQueue *queue = async_head;
+        async_head = queue->_next;
+        if (!async_head) {
+            async_tail = 0;
+        }
+
+        request_t req = queue->_requests[queue->_tail];
+        queue->_tail = (queue->_tail + 1) % queue->_depth;
+        if (--queue->_queued) {
+            queue->_next = 0;
+            if (async_tail) {
+                async_tail->_next = queue;
+            } else {
+                async_head = queue;
+            }
+            async_tail = queue;
+        }
+        async_mutex->unlock();
+
+        int err = queue->execute(req.op, req.buffer, req.addr, req.size);
+
+        // Free the slot first, so that the callback can queue the next operation without blocking
+        queue->_slots.release();
+        if (req.callback) {
+            req.callback(err);
+        }
+
+        // Once stopped and done, the queue may be destroyed as soon as it is released
+        async_mutex->lock();
+        bool done = --queue->_pending == 0 && queue->_stopped;
+        async_mutex->unlock();
+        if (done) {
+            queue->_done.release();
+        }
+    }
+}
+#endif
+
+} // namespace mbed
@@ -0,0 +1,159 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** \addtogroup storage */
+/** @{*/
+
+#ifndef MBED_BLOCK_DEVICE_ASYNC_QUEUE_H
+#define MBED_BLOCK_DEVICE_ASYNC_QUEUE_H
+
+#include "BlockDevice.h"
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+#if MBED_CONF_RTOS_PRESENT
+#include "rtos/Semaphore.h"
+#endif
+
+namespace mbed {
+
+/** Queue of block device operations, offloaded to a worker thread
+ *
+ *  Lets drivers with blocking transfers implement the asynchronous BlockDevice API.
+ *  This is a thread offload shim, not asynchronous I/O: a single worker thread, shared
+ *  by every queue, calls the drivers' synchronous read, program and erase, so the
+ *  caller can keep working while the transfer is in progress. The transfer itself still
+ *  blocks the worker thread, and operations on other devices wait their turn.
+ *
+ *  Operations on one queue are executed in order, the worker serves the queues with
+ *  pending operations in turn. The worker thread is only started when the first
+ *  operation is queued.
+ *
+ *  With a depth of 0, or without an RTOS, operations complete synchronously.
+ */
+class BlockDeviceAsyncQueue : private NonCopyable<BlockDeviceAsyncQueue> {
+public:
+    /** Create a queue of operations on a block device
+     *
+     *  @param bd       Block device to execute the operations on
+     *  @param depth    Maximum number of operations pending at once
+     */
+    BlockDeviceAsyncQueue(BlockDevice *bd, uint32_t depth);
+
+    /** Complete all pending operations
+     */
+    ~BlockDeviceAsyncQueue();
+
+    /** Complete all pending operations and stop accepting new ones
+     *
+     *  Blocks until the pending operations, including their callbacks, are
+     *  complete. Operations queued afterwards fail with BD_ERROR_DEVICE_ERROR.
+     *  Drivers call this first thing in their destructor, so that no operation
+     *  runs on a partially destroyed device.
+     */
+    void stop();
+
+    /** Queue a read
+     *
+     *  Blocks if the queue is full, until an operation completes.
+     *
+     *  @param buffer   Buffer to read blocks into
+     *  @param addr     Address of block to begin reading from
+     *  @param size     Size to read in bytes
+     *  @param callback Called with the result of the read
+     *  @return         0 if the read was queued or a negative error code on failure
+     */
+    int read(void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback);
+
+    /** Queue a program
+     *
+     *  Blocks if the queue is full, until an operation completes.
+     *
+     *  @param buffer   Buffer of data to write to blocks
+     *  @param addr     Address of block to begin writing to
+     *  @param size     Size to write in bytes
+     *  @param callback Called with the result of the program
+     *  @return         0 if the program was queued or a negative error code on failure
+     */
+    int program(const void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback);
+
+    /** Queue an erase
+     *
+     *  Blocks if the queue is full, until an operation completes.
+     *
+     *  @param addr     Address of block to begin erasing
+     *  @param size     Size to erase in bytes
+     *  @param callback Called with the result of the erase
+     *  @return         0 if the erase was queued or a negative error code on failure
+     */
+    int erase(bd_addr_t addr, bd_size_t size, Callback<void(int)> callback);
+
+    /** Get the maximum number of operations pending at once
+     *
+     *  @return         Queue depth, 0 if operations complete synchronously
+     */
+    uint32_t get_depth() const;
+
+#if !(DOXYGEN_ONLY)
+private:
+    typedef enum {
+        ASYNC_OP_READ,
+        ASYNC_OP_PROGRAM,
+        ASYNC_OP_ERASE
+    } async_op_e;
+
+    typedef struct {
+        async_op_e op;
+        void *buffer;
+        bd_addr_t addr;
+        bd_size_t size;
+        Callback<void(int)> callback;
+    } request_t;
+
+    int enqueue(async_op_e op, void *buffer, bd_addr_t addr, bd_size_t size, Callback<void(int)> callback);
+    int execute(async_op_e op, void *buffer, bd_addr_t addr, bd_size_t size);
+
+    BlockDevice *_bd;
+    uint32_t _depth;
+
+#if MBED_CONF_RTOS_PRESENT
+    static void worker();
+
+    // Protected by the shared mutex
+    request_t *_requests;
+    uint32_t _head;
+    uint32_t _tail;
+    uint32_t _queued;
+    uint32_t _pending;
+    bool _stopped;
+    BlockDeviceAsyncQueue *_next;
+
+    rtos::Semaphore _slots;
+    rtos::Semaphore _done;
+#endif
+#endif //#if !(DOXYGEN_ONLY)
+};
+
+} // namespace mbed
+
+// Added "using" for backwards compatibility
+#ifndef MBED_NO_GLOBAL_USING_DIRECTIVE
+using mbed::BlockDeviceAsyncQueue;
+#endif
+
+#endif
+
+/** @}*/
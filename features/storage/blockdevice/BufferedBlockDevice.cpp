@@ -27,10 +27,14 @@ static inline uint32_t align_down(bd_size_t val, bd_size_t size)
     return val / size * size;
 }
 
-BufferedBlockDevice::BufferedBlockDevice(BlockDevice *bd)
-    : _bd(bd), _bd_program_size(0), _bd_read_size(0), _write_cache_addr(0), _write_cache_valid(false),
-      _write_cache(0), _read_buf(0), _init_ref_count(0), _is_initialized(false)
+BufferedBlockDevice::BufferedBlockDevice(BlockDevice *bd, uint32_t write_lines, uint32_t read_lines,
+                                         bd_size_t read_line_size)
+    : _bd(bd), _bd_program_size(0), _bd_read_size(0), _bd_size(0), _num_write_lines(write_lines ? write_lines : 1),
+      _num_read_lines(read_lines), _read_line_size(read_line_size), _write_line_addr(0), _write_line_seq(0),
+      _write_cache(0), _read_line_addr(0), _read_line_seq(0), _read_cache(0), _read_buf(0), _seq(0),
+      _init_ref_count(0), _is_initialized(false)
 {
+    memset(&_stats, 0, sizeof(_stats));
 }
 
 BufferedBlockDevice::~BufferedBlockDevice()
@@ -55,15 +59,36 @@ int BufferedBlockDevice::init()
     _bd_program_size = _bd->get_program_size();
     _bd_size = _bd->size();
 
+    if (!_read_line_size) {
+        _read_line_size = _bd_program_size;
+    }
+    MBED_ASSERT(!(_read_line_size % _bd_read_size));
+
     if (!_write_cache) {
-        _write_cache = new uint8_t[_bd_program_size];
+        _write_cache = new uint8_t[_num_write_lines * _bd_program_size];
+        _write_line_addr = new bd_addr_t[_num_write_lines];
+        _write_line_seq = new uint32_t[_num_write_lines];
     }
 
     if (!_read_buf) {
         _read_buf = new uint8_t[_bd_read_size];
     }
 
-    invalidate_write_cache();
+    if (_num_read_lines && !_read_cache) {
+        _read_cache = new uint8_t[_num_read_lines * _read_line_size];
+        _read_line_addr = new bd_addr_t[_num_read_lines];
+        _read_line_seq = new uint32_t[_num_read_lines];
+    }
+
+    // Invalid lines hold an address beyond the end of the device
+    for (uint32_t i = 0; i < _num_write_lines; i++) {
+        _write_line_addr[i] = _bd_size;
+    }
+    for (uint32_t i = 0; i < _num_read_lines; i++) {
+        _read_line_addr[i] = _bd_size;
+    }
+    _seq = 0;
+    memset(&_stats, 0, sizeof(_stats));
 
     _is_initialized = true;
     return BD_ERROR_OK;
@@ -83,6 +108,16 @@ int BufferedBlockDevice::deinit()
 
     delete[] _write_cache;
     _write_cache = 0;
+    delete[] _write_line_addr;
+    _write_line_addr = 0;
+    delete[] _write_line_seq;
+    _write_line_seq = 0;
+    delete[] _read_cache;
+    _read_cache = 0;
+    delete[] _read_line_addr;
+    _read_line_addr = 0;
+    delete[] _read_line_seq;
+    _read_line_seq = 0;
     delete[] _read_buf;
     _read_buf = 0;
     _is_initialized = false;
@@ -96,20 +131,162 @@ int BufferedBlockDevice::flush()
         return BD_ERROR_DEVICE_ERROR;
     }
 
-    if (_write_cache_valid) {
-        int ret = _bd->program(_write_cache, _write_cache_addr, _bd_program_size);
+    // Flushing the newest line flushes all the others before it
+    uint32_t newest = _num_write_lines;
+    for (uint32_t i = 0; i < _num_write_lines; i++) {
+        if ((_write_line_addr[i] != _bd_size) &&
+                ((newest == _num_write_lines) || ((int32_t)(_write_line_seq[i] - _write_line_seq[newest]) > 0))) {
+            newest = i;
+        }
+    }
+
+    if (newest == _num_write_lines) {
+        return 0;
+    }
+    return flush_line(newest);
+}
+
+int BufferedBlockDevice::flush_line(uint32_t line)
+{
+    uint32_t seq = _write_line_seq[line];
+
+    while (1) {
+        // Find the oldest line, up to the given one
+        uint32_t oldest = _num_write_lines;
+        for (uint32_t i = 0; i < _num_write_lines; i++) {
+            if ((_write_line_addr[i] == _bd_size) || ((int32_t)(_write_line_seq[i] - seq) > 0)) {
+                continue;
+            }
+            if ((oldest == _num_write_lines) || ((int32_t)(_write_line_seq[i] - _write_line_seq[oldest]) < 0)) {
+                oldest = i;
+            }
+        }
+
+        if (oldest == _num_write_lines) {
+            return 0;
+        }
+
+        int ret = program_bd(_write_cache + oldest * _bd_program_size, _write_line_addr[oldest], _bd_program_size);
         if (ret) {
             return ret;
         }
-        invalidate_write_cache();
+        _write_line_addr[oldest] = _bd_size;
+        _stats.write_flushes++;
+    }
+}
+
+void BufferedBlockDevice::invalidate_range(bd_addr_t addr, bd_size_t size, bool drop_write_lines)
+{
+    for (uint32_t i = 0; drop_write_lines && (i < _num_write_lines); i++) {
+        if ((_write_line_addr[i] + _bd_program_size > addr) && (_write_line_addr[i] < addr + size)) {
+            _write_line_addr[i] = _bd_size;
+        }
+    }
+
+    for (uint32_t i = 0; i < _num_read_lines; i++) {
+        if ((_read_line_addr[i] + _read_line_size > addr) && (_read_line_addr[i] < addr + size)) {
+            _read_line_addr[i] = _bd_size;
+        }
+    }
+}
+
+int BufferedBlockDevice::program_bd(const void *buffer, bd_addr_t addr, bd_size_t size)
+{
+    int ret = _bd->program(buffer, addr, size);
+    if (ret) {
+        return ret;
+    }
+
+    // Keep read cache lines in sync with the underlying BD
+    for (uint32_t i = 0; i < _num_read_lines; i++) {
+        bd_addr_t line_addr = _read_line_addr[i];
+        if ((line_addr == _bd_size) || (line_addr + _read_line_size <= addr) || (line_addr >= addr + size)) {
+            continue;
+        }
+        bd_addr_t start = std::max(addr, line_addr);
+        bd_addr_t end = std::min(addr + size, line_addr + _read_line_size);
+        memcpy(_read_cache + i * _read_line_size + (start - line_addr),
+               static_cast<const uint8_t *>(buffer) + (start - addr), end - start);
     }
     return 0;
 }
 
-void BufferedBlockDevice::invalidate_write_cache()
+int BufferedBlockDevice::read_bd(uint8_t *buf, bd_addr_t addr, bd_size_t size)
 {
-    _write_cache_addr = _bd_size;
-    _write_cache_valid = false;
+    int ret;
+
+    while (size) {
+        bd_size_t chunk;
+
+        if (!_num_read_lines) {
+            // No read cache, make sure we are aligned with the BD read size.
+            // If not, use read buffer as a helper.
+            bd_size_t offs_in_read_buf = addr % _bd_read_size;
+            if (offs_in_read_buf || (size < _bd_read_size)) {
+                chunk = std::min(size, _bd_read_size - offs_in_read_buf);
+                ret = _bd->read(_read_buf, addr - offs_in_read_buf, _bd_read_size);
+                memcpy(buf, _read_buf + offs_in_read_buf, chunk);
+            } else {
+                chunk = align_down(size, _bd_read_size);
+                ret = _bd->read(buf, addr, chunk);
+            }
+            if (ret) {
+                return ret;
+            }
+        } else {
+            bd_addr_t line_addr = addr - addr % _read_line_size;
+            bd_size_t offs_in_line = addr - line_addr;
+            if (!offs_in_line && (size >= _read_line_size)) {
+                // Whole lines are read directly, so they don't evict the cached ones
+                chunk = size - size % _read_line_size;
+                ret = _bd->read(buf, addr, chunk);
+                if (ret) {
+                    return ret;
+                }
+            } else {
+                chunk = std::min(size, _read_line_size - offs_in_line);
+                uint32_t line = _num_read_lines;
+                for (uint32_t i = 0; i < _num_read_lines; i++) {
+                    if (_read_line_addr[i] == line_addr) {
+                        line = i;
+                        break;
+                    }
+                }
+
+                if (line != _num_read_lines) {
+                    _stats.read_hits++;
+                } else {
+                    // Miss - replace the least recently used line
+                    line = 0;
+                    for (uint32_t i = 0; i < _num_read_lines; i++) {
+                        if (_read_line_addr[i] == _bd_size) {
+                            line = i;
+                            break;
+                        }
+                        if ((int32_t)(_read_line_seq[i] - _read_line_seq[line]) < 0) {
+                            line = i;
+                        }
+                    }
+                    _read_line_addr[line] = _bd_size;
+                    ret = _bd->read(_read_cache + line * _read_line_size, line_addr,
+                                    std::min(_read_line_size, _bd_size - line_addr));
+                    if (ret) {
+                        return ret;
+                    }
+                    _read_line_addr[line] = line_addr;
+                    _stats.read_misses++;
+                }
+                _read_line_seq[line] = ++_seq;
+                memcpy(buf, _read_cache + line * _read_line_size + offs_in_line, chunk);
+            }
+        }
+
+        buf += chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return 0;
 }
 
 int BufferedBlockDevice::sync()
@@ -133,42 +310,32 @@ int BufferedBlockDevice::read(void *b, bd_addr_t addr, bd_size_t size)
     }
 
     MBED_ASSERT(_write_cache && _read_buf);
-    // Common case - no need to involve write cache or read buffer
-    if (_bd->is_valid_read(addr, size) &&
-            ((addr + size <= _write_cache_addr) || (addr > _write_cache_addr + _bd_program_size))) {
-        return _bd->read(b, addr, size);
-    }
 
     uint8_t *buf = static_cast<uint8_t *>(b);
 
-    // Read logic: Split read to chunks, according to whether we cross the write cache
+    // Read logic: Split read to chunks, according to whether we cross write lines
     while (size) {
-        bd_size_t chunk;
+        bd_size_t chunk = size;
         bool read_from_bd = true;
-        if (addr < _write_cache_addr) {
-            chunk = std::min(size, _write_cache_addr - addr);
-        } else if ((addr >= _write_cache_addr) && (addr < _write_cache_addr + _bd_program_size)) {
-            // One case we need to take our data from cache
-            chunk = std::min(size, _bd_program_size - addr % _bd_program_size);
-            memcpy(buf, _write_cache + addr % _bd_program_size, chunk);
-            read_from_bd = false;
-        } else {
-            chunk = size;
+        for (uint32_t i = 0; i < _num_write_lines; i++) {
+            bd_addr_t line_addr = _write_line_addr[i];
+            if (line_addr == _bd_size) {
+                continue;
+            }
+            if ((addr >= line_addr) && (addr < line_addr + _bd_program_size)) {
+                // Take our data from the write line
+                chunk = std::min(size, line_addr + _bd_program_size - addr);
+                memcpy(buf, _write_cache + i * _bd_program_size + (addr - line_addr), chunk);
+                read_from_bd = false;
+                break;
+            }
+            if (line_addr > addr) {
+                chunk = std::min(chunk, line_addr - addr);
+            }
         }
 
-        // Now, in case we read from the BD, make sure we are aligned with its read size.
-        // If not, use read buffer as a helper.
         if (read_from_bd) {
-            bd_size_t offs_in_read_buf = addr % _bd_read_size;
-            int ret;
-            if (offs_in_read_buf || (chunk < _bd_read_size)) {
-                chunk = std::min(chunk, _bd_read_size - offs_in_read_buf);
-                ret = _bd->read(_read_buf, addr - offs_in_read_buf, _bd_read_size);
-                memcpy(buf, _read_buf + offs_in_read_buf, chunk);
-            } else {
-                chunk = align_down(chunk, _bd_read_size);
-                ret = _bd->read(buf, addr, chunk);
-            }
+            int ret = read_bd(buf, addr, chunk);
             if (ret) {
                 return ret;
             }
@@ -192,52 +359,29 @@ int BufferedBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
 
     int ret;
 
-    bd_addr_t aligned_addr = align_down(addr, _bd_program_size);
-
     const uint8_t *buf = static_cast <const uint8_t *>(b);
 
-    // Need to flush if moved to another program unit
-    if (aligned_addr != _write_cache_addr) {
-        ret = flush();
-        if (ret) {
-            return ret;
-        }
-        _write_cache_addr = aligned_addr;
-    }
-
-    // Write logic: Keep data in cache as long as we don't reach the end of the program unit.
+    // Write logic: Keep data in write lines as long as we don't reach the end of the program unit.
     // Otherwise, program to the underlying BD.
     while (size) {
-        _write_cache_addr = align_down(addr, _bd_program_size);
-        bd_addr_t offs_in_buf = addr - _write_cache_addr;
+        bd_addr_t line_addr = align_down(addr, _bd_program_size);
+        bd_addr_t offs_in_buf = addr - line_addr;
         bd_size_t chunk;
-        if (offs_in_buf) {
-            chunk = std::min(_bd_program_size - offs_in_buf, size);
-        } else if (size >= _bd_program_size) {
-            chunk = align_down(size, _bd_program_size);
-        } else {
-            chunk = size;
-        }
 
-        const uint8_t *prog_buf;
-        if (chunk < _bd_program_size) {
-            // If cache not valid, and program doesn't cover an entire unit, it means we need to
-            // read it from the underlying BD
-            if (!_write_cache_valid) {
-                ret = _bd->read(_write_cache, _write_cache_addr, _bd_program_size);
-                if (ret) {
-                    return ret;
+        if (!offs_in_buf && (size >= _bd_program_size)) {
+            // Entire program units go directly to the underlying BD, after all buffered data.
+            // Write lines they overwrite are simply dropped.
+            chunk = align_down(size, _bd_program_size);
+            for (uint32_t i = 0; i < _num_write_lines; i++) {
+                if ((_write_line_addr[i] >= addr) && (_write_line_addr[i] < addr + chunk)) {
+                    _write_line_addr[i] = _bd_size;
                 }
             }
-            memcpy(_write_cache + offs_in_buf, buf, chunk);
-            prog_buf = _write_cache;
-        } else {
-            prog_buf = buf;
-        }
-
-        // Only program if we reached the end of a program unit
-        if (!((offs_in_buf + chunk) % _bd_program_size)) {
-            ret = _bd->program(prog_buf, _write_cache_addr, std::max(chunk, _bd_program_size));
+            ret = flush();
+            if (ret) {
+                return ret;
+            }
+            ret = program_bd(buf, addr, chunk);
             if (ret) {
                 return ret;
             }
@@ -245,9 +389,61 @@ int BufferedBlockDevice::program(const void *b, bd_addr_t addr, bd_size_t size)
             if (ret) {
                 return ret;
             }
-            invalidate_write_cache();
         } else {
-            _write_cache_valid = true;
+            chunk = std::min(_bd_program_size - offs_in_buf, size);
+
+            uint32_t line = _num_write_lines;
+            for (uint32_t i = 0; i < _num_write_lines; i++) {
+                if (_write_line_addr[i] == line_addr) {
+                    line = i;
+                    break;
+                }
+            }
+
+            if (line != _num_write_lines) {
+                _stats.write_hits++;
+            } else {
+                // Take a free line, or flush the oldest one
+                line = 0;
+                for (uint32_t i = 0; i < _num_write_lines; i++) {
+                    if (_write_line_addr[i] == _bd_size) {
+                        line = i;
+                        break;
+                    }
+                    if ((int32_t)(_write_line_seq[i] - _write_line_seq[line]) < 0) {
+                        line = i;
+                    }
+                }
+                if (_write_line_addr[line] != _bd_size) {
+                    ret = flush_line(line);
+                    if (ret) {
+                        return ret;
+                    }
+                }
+
+                // Program doesn't cover an entire unit, so we need to read it from the underlying BD
+                ret = read_bd(_write_cache + line * _bd_program_size, line_addr, _bd_program_size);
+                if (ret) {
+                    return ret;
+                }
+                _write_line_addr[line] = line_addr;
+                _write_line_seq[line] = ++_seq;
+                _stats.write_misses++;
+            }
+
+            memcpy(_write_cache + line * _bd_program_size + offs_in_buf, buf, chunk);
+
+            // Only program if we reached the end of a program unit
+            if (!((offs_in_buf + chunk) % _bd_program_size)) {
+                ret = flush_line(line);
+                if (ret) {
+                    return ret;
+                }
+                ret = _bd->sync();
+                if (ret) {
+                    return ret;
+                }
+            }
         }
 
         buf += chunk;
@@ -265,9 +461,7 @@ int BufferedBlockDevice::erase(bd_addr_t addr, bd_size_t size)
         return BD_ERROR_DEVICE_ERROR;
     }
 
-    if ((_write_cache_addr >= addr) && (_write_cache_addr <= addr + size)) {
-        invalidate_write_cache();
-    }
+    invalidate_range(addr, size, true);
     return _bd->erase(addr, size);
 }
 
@@ -278,9 +472,7 @@ int BufferedBlockDevice::trim(bd_addr_t addr, bd_size_t size)
         return BD_ERROR_DEVICE_ERROR;
     }
 
-    if ((_write_cache_addr >= addr) && (_write_cache_addr <= addr + size)) {
-        invalidate_write_cache();
-    }
+    invalidate_range(addr, size, true);
     return _bd->trim(addr, size);
 }
 
@@ -339,4 +531,9 @@ const char *BufferedBlockDevice::get_type() const
     return NULL;
 }
 
+void BufferedBlockDevice::get_cache_stats(cache_stats_t *stats) const
+{
+    *stats = _stats;
+}
+
 } // namespace mbed
@@ -32,14 +32,34 @@ namespace mbed {
 
 /** Block device for allowing minimal read and program sizes (of 1) for the underlying BD,
  *  using a buffer on the heap.
+ *
+ *  Programs are collected in write lines (of the underlying program size), which are programmed
+ *  to the underlying BD once complete, when a line is needed for another address, or on sync.
+ *  Lines are always programmed in the order they were first written to.
+ *  Optionally, reads are served from an LRU read cache.
  */
 class BufferedBlockDevice : public BlockDevice {
 public:
+    /** Cache statistics
+     */
+    typedef struct {
+        uint32_t read_hits;         /**< Reads served from the read cache */
+        uint32_t read_misses;       /**< Read cache lines read from the underlying BD */
+        uint32_t write_hits;        /**< Programs to an already buffered write line */
+        uint32_t write_misses;      /**< Write lines allocated */
+        uint32_t write_flushes;     /**< Write lines programmed to the underlying BD */
+    } cache_stats_t;
+
     /** Lifetime of a memory-buffered block device wrapping an underlying block device
      *
-     *  @param bd        Block device to back the BufferedBlockDevice
+     *  @param bd               Block device to back the BufferedBlockDevice
+     *  @param write_lines      Number of write lines buffered at once
+     *  @param read_lines       Number of read cache lines (0 for no read cache)
+     *  @param read_line_size   Size of a read cache line, must be a multiple of the underlying
+     *                          read size (0 for the underlying program size)
      */
-    BufferedBlockDevice(BlockDevice *bd);
+    BufferedBlockDevice(BlockDevice *bd, uint32_t write_lines = 1, uint32_t read_lines = 0,
+                        bd_size_t read_line_size = 0);
 
     /** Lifetime of the memory-buffered block device
      */
@@ -159,30 +179,72 @@ public:
      */
     virtual const char *get_type() const;
 
+    /** Get cache statistics (cleared on init)
+     *
+     *  @param stats    Returned statistics
+     */
+    void get_cache_stats(cache_stats_t *stats) const;
+
 protected:
     BlockDevice *_bd;
     bd_size_t _bd_program_size;
     bd_size_t _bd_read_size;
     bd_size_t _bd_size;
-    bd_size_t _write_cache_addr;
-    bool _write_cache_valid;
+    uint32_t _num_write_lines;
+    uint32_t _num_read_lines;
+    bd_size_t _read_line_size;
+    bd_addr_t *_write_line_addr;
+    uint32_t *_write_line_seq;
     uint8_t *_write_cache;
+    bd_addr_t *_read_line_addr;
+    uint32_t *_read_line_seq;
+    uint8_t *_read_cache;
     uint8_t *_read_buf;
+    uint32_t _seq;
+    cache_stats_t _stats;
     uint32_t _init_ref_count;
     bool _is_initialized;
 
 #if !(DOXYGEN_ONLY)
-    /** Flush data in cache
+    /** Flush all write lines
      *
      *  @return         0 on success or a negative error code on failure
      */
     int flush();
 
-    /** Invalidate write cache
+    /** Flush a write line, after all write lines written to before it
+     *
+     *  @param line     Write line index
+     *  @return         0 on success or a negative error code on failure
+     */
+    int flush_line(uint32_t line);
+
+    /** Drop write lines and read cache lines in a given range
      *
-     *  @return         none
+     *  @param addr     Start address
+     *  @param size     Size
+     *  @param drop_write_lines
+     *                  Whether write lines should be dropped too
+     */
+    void invalidate_range(bd_addr_t addr, bd_size_t size, bool drop_write_lines);
+
+    /** Program data to the underlying BD, keeping the read cache up to date
+     *
+     *  @param buffer   Data
+     *  @param addr     Address, aligned to the program size
+     *  @param size     Size, a multiple of the program size
+     *  @return         0 on success or a negative error code on failure
+     */
+    int program_bd(const void *buffer, bd_addr_t addr, bd_size_t size);
+
+    /** Read from the underlying BD, through the read cache if there is one
+     *
+     *  @param buffer   Buffer to read into
+     *  @param addr     Address
+     *  @param size     Size, must not cross a write line
+     *  @return         0 on success or a negative error code on failure
      */
-    void invalidate_write_cache();
+    int read_bd(uint8_t *buffer, bd_addr_t addr, bd_size_t size);
 #endif //#if !(DOXYGEN_ONLY)
 };
 } // namespace mbed
@@ -319,6 +319,91 @@ exit_point:
     return status;
 }
 
+int FileSystemStore::batch(const batch_op_t *ops, size_t num_ops)
+{
+    int status = MBED_SUCCESS;
+    File kv_file;
+    key_metadata_t key_metadata;
+    bool exists, write_once;
+    size_t i, j;
+
+    if ((ops == NULL) && (num_ops > 0)) {
+        return MBED_ERROR_INVALID_ARGUMENT;
+    }
+
+    _mutex.lock();
+
+    if (false == _is_initialized) {
+        status = MBED_ERROR_NOT_READY;
+        goto exit_point;
+    }
+
+    /* Check all operations, against the latest earlier operation on the same key or the key file */
+    for (i = 0; i < num_ops; i++) {
+        if (!is_valid_key(ops[i].key)) {
+            status = MBED_ERROR_INVALID_ARGUMENT;
+            goto exit_point;
+        }
+
+        if (!ops[i].remove &&
+                (((ops[i].buffer == NULL) && (ops[i].size > 0)) || (ops[i].create_flags & ~supported_flags))) {
+            status = MBED_ERROR_INVALID_ARGUMENT;
+            goto exit_point;
+        }
+
+        for (j = i; j > 0; j--) {
+            if (!strcmp(ops[j - 1].key, ops[i].key)) {
+                break;
+            }
+        }
+
+        if (j > 0) {
+            exists = !ops[j - 1].remove;
+            write_once = exists && (ops[j - 1].create_flags & KVStore::WRITE_ONCE_FLAG);
+        } else {
+            status = _verify_key_file(ops[i].key, &key_metadata, &kv_file);
+            if (status == MBED_ERROR_ITEM_NOT_FOUND) {
+                exists = false;
+                write_once = false;
+            } else {
+                kv_file.close();
+                exists = true;
+                write_once = (status == MBED_SUCCESS) && (key_metadata.user_flags & KVStore::WRITE_ONCE_FLAG);
+            }
+        }
+
+        if (write_once) {
+            tr_error("File: %s, Exists but write protected", ops[i].key);
+            status = MBED_ERROR_WRITE_PROTECTED;
+            goto exit_point;
+        }
+
+        if (ops[i].remove && !exists) {
+            status = MBED_ERROR_ITEM_NOT_FOUND;
+            goto exit_point;
+        }
+    }
+
+    /* _mutex is recursive, so no other operation can interleave with the batch */
+    for (i = 0; i < num_ops; i++) {
+        if (ops[i].remove) {
+            status = remove(ops[i].key);
+        } else {
+            status = set(ops[i].key, ops[i].buffer, ops[i].size, ops[i].create_flags);
+        }
+        if (status != MBED_SUCCESS) {
+            tr_error("FSST Batch operation %d Failed: %d", (int)i, status);
+            goto exit_point;
+        }
+    }
+
+    status = MBED_SUCCESS;
+
+exit_point:
+    _mutex.unlock();
+    return status;
+}
+
 // Incremental set API
 int FileSystemStore::set_start(set_handle_t *handle, const char *key, size_t final_data_size, uint32_t create_flags)
 {
@@ -136,6 +136,25 @@ public:
      */
     virtual int remove(const char *key);
 
+    /**
+     * @brief Set and remove multiple FileSystemStore items, in the given order.
+     *        This is best effort: all operations are checked before any of them is applied,
+     *        so a batch that fails the checks leaves the store untouched. As each item is a
+     *        separate file, a file system error or a power failure while applying the batch
+     *        can leave only some of the operations applied.
+     *
+     * @param[in]  ops                  Operations.
+     * @param[in]  num_ops              Number of operations.
+     *
+     * @returns MBED_SUCCESS                        Success.
+     *          MBED_ERROR_NOT_READY                Not initialized.
+     *          MBED_ERROR_FAILED_OPERATION         Underlying file system failed operation.
+     *          MBED_ERROR_INVALID_ARGUMENT         Invalid argument given in function arguments.
+     *          MBED_ERROR_ITEM_NOT_FOUND           Removed item not found.
+     *          MBED_ERROR_WRITE_PROTECTED          Already stored with "write once" flag.
+     */
+    virtual int batch(const batch_op_t *ops, size_t num_ops);
+
     /**
      * @brief Start an incremental FileSystemStore set sequence. This operation is blocking other operations.
      *        Any get/set/remove/iterator operation will be blocked until set_finalize is called.
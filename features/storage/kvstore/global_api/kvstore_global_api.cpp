@@ -111,6 +111,54 @@ int kv_remove(const char *full_name_key)
     return kv_instance->remove(full_name_key + key_index);
 }
 
+int kv_batch(const kv_batch_op_t *ops, size_t num_ops)
+{
+    if ((ops == NULL) && (num_ops > 0)) {
+        return MBED_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (num_ops == 0) {
+        return MBED_SUCCESS;
+    }
+
+    int ret = kv_init_storage_config();
+    if (MBED_SUCCESS != ret) {
+        return ret;
+    }
+
+    KVStore::batch_op_t *inner_ops = new KVStore::batch_op_t[num_ops];
+    KVMap &kv_map = KVMap::get_instance();
+    KVStore *kv_instance = NULL;
+    for (size_t i = 0; i < num_ops; i++) {
+        KVStore *op_kv_instance = NULL;
+        uint32_t flags_mask = 0;
+        size_t key_index = 0;
+        ret = kv_map.lookup(ops[i].full_name_key, &op_kv_instance, &key_index, &flags_mask);
+        if (ret != MBED_SUCCESS) {
+            goto exit;
+        }
+
+        // A batch can't span multiple KVStore instances
+        if (kv_instance && (op_kv_instance != kv_instance)) {
+            ret = MBED_ERROR_INVALID_ARGUMENT;
+            goto exit;
+        }
+        kv_instance = op_kv_instance;
+
+        inner_ops[i].key = ops[i].full_name_key + key_index;
+        inner_ops[i].buffer = ops[i].buffer;
+        inner_ops[i].size = ops[i].size;
+        inner_ops[i].create_flags = ops[i].create_flags & flags_mask;
+        inner_ops[i].remove = ops[i].remove;
+    }
+
+    ret = kv_instance->batch(inner_ops, num_ops);
+
+exit:
+    delete[] inner_ops;
+    return ret;
+}
+
 int kv_iterator_open(kv_iterator_t *it, const char *full_prefix)
 {
     if (it == NULL) {
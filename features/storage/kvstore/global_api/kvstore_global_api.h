@@ -18,6 +18,7 @@
 
 #include "stddef.h"
 #include "stdint.h"
+#include "stdbool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +50,32 @@ typedef struct info {
     uint32_t flags;
 } kv_info_t;
 
+/**
+ * A single operation of a batch
+ */
+typedef struct kv_batch_op {
+    /**
+     * /Partition_path/Key
+     */
+    const char *full_name_key;
+    /**
+     * Value data buffer (ignored on removal)
+     */
+    const void *buffer;
+    /**
+     * Value data size (ignored on removal)
+     */
+    size_t size;
+    /**
+     * Flag mask (ignored on removal)
+     */
+    uint32_t create_flags;
+    /**
+     * Remove the key rather than set it
+     */
+    bool remove;
+} kv_batch_op_t;
+
 /**
  * @brief Set one KVStore item, given key and value.
  *
@@ -92,6 +119,18 @@ int kv_get_info(const char *full_name_key, kv_info_t *info);
  */
 int kv_remove(const char *full_name_key);
 
+/**
+ * @brief Set and remove multiple KVStore items at once, in the given order.
+ *        All keys must belong to the same partition. The batch is atomic if the KVStore
+ *        of the partition is a TDBStore, and best effort otherwise.
+ *
+ * @param[in]  ops                  Operations.
+ * @param[in]  num_ops              Number of operations.
+ *
+ * @returns MBED_SUCCESS on success or an error code from underlying KVStore instances
+ */
+int kv_batch(const kv_batch_op_t *ops, size_t num_ops);
+
 /**
  * @brief Start an iteration over KVStore keys to find all the entries
  *        that fit the full_prefix. There are no issues with any other operations while
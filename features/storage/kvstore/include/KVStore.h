@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include "platform/mbed_error.h"
 
 namespace mbed {
 
@@ -59,6 +60,32 @@ public:
         uint32_t flags;
     } info_t;
 
+    /**
+     * Holds a single operation of a batch
+     */
+    typedef struct batch_op {
+        /**
+         * The key
+         */
+        const char *key;
+        /**
+         * Value data buffer (ignored on removal)
+         */
+        const void *buffer;
+        /**
+         * Value data size (ignored on removal)
+         */
+        size_t size;
+        /**
+         * Flag mask (ignored on removal)
+         */
+        uint32_t create_flags;
+        /**
+         * Remove the key rather than set it
+         */
+        bool remove;
+    } batch_op_t;
+
     virtual ~KVStore() {};
 
     /**
@@ -127,6 +154,37 @@ public:
      */
     virtual int remove(const char *key) = 0;
 
+    /**
+     * @brief Set and remove multiple KVStore items at once, in the given order.
+     *        The default implementation applies the operations one by one with set and remove,
+     *        and stops at the first failure, leaving the earlier operations applied.
+     *        Implementations may do better; see each of them for how atomic its batch is.
+     *
+     * @param[in]  ops                  Operations.
+     * @param[in]  num_ops              Number of operations.
+     *
+     * @returns MBED_SUCCESS on success or an error code on failure
+     */
+    virtual int batch(const batch_op_t *ops, size_t num_ops)
+    {
+        if (!ops && num_ops) {
+            return MBED_ERROR_INVALID_ARGUMENT;
+        }
+
+        for (size_t i = 0; i < num_ops; i++) {
+            int ret;
+            if (ops[i].remove) {
+                ret = remove(ops[i].key);
+            } else {
+                ret = set(ops[i].key, ops[i].buffer, ops[i].size, ops[i].create_flags);
+            }
+            if (ret != MBED_SUCCESS) {
+                return ret;
+            }
+        }
+        return MBED_SUCCESS;
+    }
+
 
     /**
      * @brief Start an incremental KVStore set sequence.
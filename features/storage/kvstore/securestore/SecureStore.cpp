@@ -515,6 +515,232 @@ end:
     return ret;
 }
 
+int SecureStore::batch(const batch_op_t *ops, size_t num_ops)
+{
+    int os_ret, ret = MBED_SUCCESS;
+    record_metadata_t *metadata;
+    info_t info;
+    batch_op_t *underlying_ops = 0, *rbp_ops = 0;
+    uint8_t **bufs = 0;
+    uint8_t *cmacs = 0;
+    uint32_t *prev_flags = 0;
+    uint8_t ctr_buf[enc_block_size];
+    mbedtls_aes_context enc_ctx;
+    mbedtls_cipher_context_t auth_ctx;
+    size_t aes_offs, i, j, num_rbp_ops = 0;
+    bool exists;
+
+    if (!_is_initialized) {
+        return MBED_ERROR_NOT_READY;
+    }
+
+    if (!ops && num_ops) {
+        return MBED_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < num_ops; i++) {
+        if (!is_valid_key(ops[i].key)) {
+            return MBED_ERROR_INVALID_ARGUMENT;
+        }
+        if (!ops[i].remove && !ops[i].buffer && ops[i].size) {
+            return MBED_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    if (!num_ops) {
+        return MBED_SUCCESS;
+    }
+
+    _mutex.lock();
+
+    underlying_ops = new batch_op_t[num_ops];
+    rbp_ops = new batch_op_t[num_ops];
+    bufs = new uint8_t *[num_ops];
+    memset(bufs, 0, num_ops * sizeof(uint8_t *));
+    cmacs = new uint8_t[num_ops * cmac_size];
+    prev_flags = new uint32_t[num_ops];
+
+    for (i = 0; i < num_ops; i++) {
+        // Check operation against the latest earlier operation on the same key, if any,
+        // or against the stored key
+        for (j = i; j > 0; j--) {
+            if (!strcmp(ops[j - 1].key, ops[i].key)) {
+                break;
+            }
+        }
+
+        if (j) {
+            exists = !ops[j - 1].remove;
+            prev_flags[i] = exists ? ops[j - 1].create_flags : 0;
+        } else {
+            record_metadata_t stored_metadata;
+            ret = _underlying_kv->get(ops[i].key, &stored_metadata, sizeof(record_metadata_t));
+            if (ret == MBED_SUCCESS) {
+                exists = true;
+                prev_flags[i] = stored_metadata.create_flags;
+            } else if (ret == MBED_ERROR_ITEM_NOT_FOUND) {
+                exists = false;
+                prev_flags[i] = 0;
+                // Write once keys removed from underlying KV are still protected by the RBP KV
+                if (_rbp_kv) {
+                    ret = _rbp_kv->get_info(ops[i].key, &info);
+                    if (ret == MBED_SUCCESS) {
+                        prev_flags[i] = info.flags & WRITE_ONCE_FLAG;
+                    } else if (ret != MBED_ERROR_ITEM_NOT_FOUND) {
+                        goto end;
+                    }
+                }
+            } else {
+                ret = MBED_ERROR_READ_FAILED;
+                goto end;
+            }
+        }
+
+        if (prev_flags[i] & WRITE_ONCE_FLAG) {
+            ret = MBED_ERROR_WRITE_PROTECTED;
+            goto end;
+        }
+
+        underlying_ops[i] = ops[i];
+
+        if (ops[i].remove) {
+            if (!exists) {
+                ret = MBED_ERROR_ITEM_NOT_FOUND;
+                goto end;
+            }
+            continue;
+        }
+
+        // Must not remove RP flag
+        if (exists && (prev_flags[i] & REQUIRE_REPLAY_PROTECTION_FLAG) &&
+                !(ops[i].create_flags & REQUIRE_REPLAY_PROTECTION_FLAG)) {
+            ret = MBED_ERROR_INVALID_ARGUMENT;
+            goto end;
+        }
+
+        // Build the complete record (metadata, possibly encrypted data and CMAC)
+        bufs[i] = new uint8_t[sizeof(record_metadata_t) + ops[i].size + cmac_size];
+        metadata = reinterpret_cast<record_metadata_t *>(bufs[i]);
+        metadata->create_flags = ops[i].create_flags;
+        metadata->data_size = ops[i].size;
+        metadata->metadata_size = sizeof(record_metadata_t);
+        metadata->revision = securestore_revision;
+        if (ops[i].size) {
+            memcpy(bufs[i] + sizeof(record_metadata_t), ops[i].buffer, ops[i].size);
+        }
+
+        if (ops[i].create_flags & REQUIRE_CONFIDENTIALITY_FLAG) {
+            os_ret = mbedtls_entropy_func(_entropy, metadata->iv, iv_size);
+            if (os_ret) {
+                ret = MBED_ERROR_FAILED_OPERATION;
+                goto end;
+            }
+            os_ret = encrypt_decrypt_start(enc_ctx, metadata->iv, ops[i].key, ctr_buf, _scratch_buf,
+                                           scratch_buf_size);
+            if (os_ret) {
+                ret = MBED_ERROR_FAILED_OPERATION;
+                goto end;
+            }
+            aes_offs = 0;
+            os_ret = encrypt_decrypt_data(enc_ctx, bufs[i] + sizeof(record_metadata_t),
+                                          bufs[i] + sizeof(record_metadata_t), ops[i].size, ctr_buf, aes_offs);
+            mbedtls_aes_free(&enc_ctx);
+            if (os_ret) {
+                ret = MBED_ERROR_FAILED_OPERATION;
+                goto end;
+            }
+        } else {
+            memset(metadata->iv, 0, iv_size);
+        }
+
+        // Although name is not part of the data, we calculate CMAC on it as well
+        mbedtls_cipher_init(&auth_ctx);
+        os_ret = cmac_calc_start(auth_ctx, ops[i].key, _scratch_buf, scratch_buf_size);
+        if (!os_ret) {
+            os_ret = cmac_calc_data(auth_ctx, ops[i].key, strlen(ops[i].key));
+        }
+        if (!os_ret) {
+            os_ret = cmac_calc_data(auth_ctx, bufs[i], sizeof(record_metadata_t) + ops[i].size);
+        }
+        if (!os_ret) {
+            os_ret = cmac_calc_finish(auth_ctx, cmacs + i * cmac_size);
+        }
+        mbedtls_cipher_free(&auth_ctx);
+        if (os_ret) {
+            ret = MBED_ERROR_FAILED_OPERATION;
+            goto end;
+        }
+        memcpy(bufs[i] + sizeof(record_metadata_t) + ops[i].size, cmacs + i * cmac_size, cmac_size);
+
+        // Should strip security flags from underlying storage
+        underlying_ops[i].buffer = bufs[i];
+        underlying_ops[i].size = sizeof(record_metadata_t) + ops[i].size + cmac_size;
+        underlying_ops[i].create_flags = ops[i].create_flags & ~security_flags;
+    }
+
+    ret = _underlying_kv->batch(underlying_ops, num_ops);
+    if (ret || !_rbp_kv) {
+        goto end;
+    }
+
+    // Now update the RBP KV with the CMACs of rollback protected and write once keys,
+    // and remove the rollback protected keys that were removed
+    for (i = 0; i < num_ops; i++) {
+        if (!ops[i].remove) {
+            if (!(ops[i].create_flags & (REQUIRE_REPLAY_PROTECTION_FLAG | WRITE_ONCE_FLAG))) {
+                continue;
+            }
+            rbp_ops[num_rbp_ops].key = ops[i].key;
+            rbp_ops[num_rbp_ops].buffer = cmacs + i * cmac_size;
+            rbp_ops[num_rbp_ops].size = cmac_size;
+            rbp_ops[num_rbp_ops].create_flags = ops[i].create_flags & WRITE_ONCE_FLAG;
+            rbp_ops[num_rbp_ops].remove = false;
+            num_rbp_ops++;
+            continue;
+        }
+
+        if (!(prev_flags[i] & REQUIRE_REPLAY_PROTECTION_FLAG)) {
+            continue;
+        }
+        for (j = num_rbp_ops; j > 0; j--) {
+            if (!strcmp(rbp_ops[j - 1].key, ops[i].key)) {
+                break;
+            }
+        }
+        if (j) {
+            exists = !rbp_ops[j - 1].remove;
+        } else {
+            ret = _rbp_kv->get_info(ops[i].key, &info);
+            if ((ret != MBED_SUCCESS) && (ret != MBED_ERROR_ITEM_NOT_FOUND)) {
+                goto end;
+            }
+            exists = (ret == MBED_SUCCESS);
+        }
+        if (exists) {
+            rbp_ops[num_rbp_ops].key = ops[i].key;
+            rbp_ops[num_rbp_ops].buffer = 0;
+            rbp_ops[num_rbp_ops].size = 0;
+            rbp_ops[num_rbp_ops].create_flags = 0;
+            rbp_ops[num_rbp_ops].remove = true;
+            num_rbp_ops++;
+        }
+    }
+
+    ret = _rbp_kv->batch(rbp_ops, num_rbp_ops);
+
+end:
+    for (i = 0; i < num_ops; i++) {
+        delete[] bufs[i];
+    }
+    delete[] bufs;
+    delete[] cmacs;
+    delete[] prev_flags;
+    delete[] rbp_ops;
+    delete[] underlying_ops;
+    _mutex.unlock();
+    return ret;
+}
+
 int SecureStore::do_get(const char *key, void *buffer, size_t buffer_size, size_t *actual_size,
                         size_t offset, info_t *info)
 {
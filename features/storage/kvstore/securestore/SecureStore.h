@@ -173,6 +173,28 @@ public:
      */
     virtual int remove(const char *key);
 
+    /**
+     * @brief Set and remove multiple KVStore items at once, in the given order.
+     *        This is best effort: all records are passed to the underlying KVStore in a single
+     *        batch, so they are as atomic as its batch is, but rollback protection data is
+     *        updated in a second batch once the first one succeeds. If the second batch fails,
+     *        or power fails in between, replay protected items of the batch fail authentication
+     *        until they are set again.
+     *
+     * @param[in]  ops                  Operations.
+     * @param[in]  num_ops              Number of operations.
+     *
+     * @returns MBED_SUCCESS                        Success.
+     *          MBED_ERROR_NOT_READY                Not initialized.
+     *          MBED_ERROR_READ_FAILED              Unable to read from media.
+     *          MBED_ERROR_INVALID_ARGUMENT         Invalid argument given in function arguments.
+     *          MBED_ERROR_ITEM_NOT_FOUND           Removed item not found.
+     *          MBED_ERROR_WRITE_PROTECTED          Already stored with "write once" flag.
+     *          MBED_ERROR_FAILED_OPERATION         Internal error.
+     *          or any other error from underlying KVStore instances.
+     */
+    virtual int batch(const batch_op_t *ops, size_t num_ops);
+
 
     /**
      * @brief Start an incremental KVStore set sequence. This operation is blocking other operations.
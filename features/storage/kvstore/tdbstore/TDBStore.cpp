@@ -24,6 +24,10 @@
 #include "mbed_error.h"
 #include "mbed_wait_api.h"
 #include "MbedCRC.h"
+#if DEVICE_USTICKER
+#include "hal/ticker_api.h"
+#include "hal/us_ticker_api.h"
+#endif
 //Bypass the check of NVStore co existance if compiled for TARGET_TFM
 #if !(BYPASS_NVSTORE_CHECK)
 #include "SystemStorage.h"
@@ -34,6 +38,7 @@ using namespace mbed;
 // --------------------------------------------------------- Definitions ----------------------------------------------------------
 
 static const uint32_t delete_flag = (1UL << 31);
+static const uint32_t batch_flag = (1UL << 30);
 static const uint32_t internal_flags = delete_flag;
 static const uint32_t supported_flags = KVStore::WRITE_ONCE_FLAG;
 
@@ -50,12 +55,18 @@ typedef struct {
     uint32_t crc;
 } record_header_t;
 
+// RAM table is kept sorted by hash (descending). Key size is cached here, so that hash
+// collisions can mostly be resolved without reading the record from flash. gc_offset holds
+// the record's location in the standby area while an incremental GC is in progress.
 typedef struct {
-    uint32_t  hash;
-    bd_size_t bd_offset;
+    uint32_t hash;
+    uint32_t bd_offset;
+    uint32_t gc_offset;
+    uint16_t key_size;
 } ram_table_entry_t;
 
 static const char *master_rec_key = "TDBS";
+static const char *batch_rec_key = "TDBB";
 static const uint32_t tdbstore_magic = 0x54686683; // "TDBS" in ASCII
 static const uint32_t tdbstore_revision = 1;
 
@@ -106,6 +117,31 @@ typedef struct {
 
 // -------------------------------------------------- Functions Implementation ----------------------------------------------------
 
+static inline uint64_t gc_time_us()
+{
+#if DEVICE_USTICKER
+    return ticker_read_us(get_us_ticker_data());
+#else
+    return 0;
+#endif
+}
+
+// Index of the first RAM table entry whose hash is not above the given one
+static uint32_t find_hash_ind(const ram_table_entry_t *ram_table, uint32_t num_keys, uint32_t hash)
+{
+    uint32_t low = 0, high = num_keys, mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (ram_table[mid].hash > hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
 static inline uint32_t align_up(uint32_t val, uint32_t size)
 {
     return (((val - 1) / size) + 1) * size;
@@ -125,8 +161,11 @@ static uint32_t calc_crc(uint32_t init_crc, uint32_t data_size, const void *data
 TDBStore::TDBStore(BlockDevice *bd) : _ram_table(0), _max_keys(0),
     _num_keys(0), _bd(bd), _buff_bd(0),  _free_space_offset(0), _master_record_offset(0),
     _master_record_size(0), _is_initialized(false), _active_area(0), _active_area_version(0), _size(0),
-    _prog_size(0), _work_buf(0), _key_buf(0), _variant_bd_erase_unit_size(false), _inc_set_handle(0)
+    _prog_size(0), _work_buf(0), _key_buf(0), _variant_bd_erase_unit_size(false), _inc_set_handle(0),
+    _gc_records_per_step(0), _gc_free_space_threshold(0), _gc_in_progress(false), _gc_from_offset(0),
+    _gc_to_offset(0), _gc_start_offset(0)
 {
+    memset(&_gc_stats, 0, sizeof(_gc_stats));
 }
 
 TDBStore::~TDBStore()
@@ -240,7 +279,7 @@ int TDBStore::read_record(uint8_t area, uint32_t offset, char *key,
         return MBED_ERROR_INVALID_DATA_DETECTED;
     }
 
-    if (offset + total_size >= _size) {
+    if (offset + total_size > _size) {
         return MBED_ERROR_INVALID_DATA_DETECTED;
     }
 
@@ -356,19 +395,21 @@ int TDBStore::find_record(uint8_t area, const char *key, uint32_t &offset,
     int ret = MBED_ERROR_ITEM_NOT_FOUND;
     uint32_t actual_data_size;
     uint32_t flags, dummy_hash, next_offset;
+    size_t key_size = strlen(key);
 
+    hash = calc_crc(initial_crc, key_size, key);
 
-    hash = calc_crc(initial_crc, strlen(key), key);
-
-    for (ram_table_ind = 0; ram_table_ind < _num_keys; ram_table_ind++) {
+    // Scan all entries sharing our hash. If none match, ram_table_ind ends up
+    // right after them, which is where a new key should be inserted.
+    for (ram_table_ind = find_hash_ind(ram_table, _num_keys, hash); ram_table_ind < _num_keys; ram_table_ind++) {
         entry = &ram_table[ram_table_ind];
         offset = entry->bd_offset;
-        if (hash < entry->hash)  {
-            continue;
-        }
-        if (hash > entry->hash)  {
+        if (hash != entry->hash)  {
             return MBED_ERROR_ITEM_NOT_FOUND;
         }
+        if (key_size != entry->key_size) {
+            continue;
+        }
         ret = read_record(_active_area, offset, const_cast<char *>(key), 0, 0, actual_data_size, 0,
                           false, false, true, false, dummy_hash, flags, next_offset);
         // not found return code here means that hash doesn't belong to name. Continue searching.
@@ -425,8 +466,15 @@ int TDBStore::set_start(set_handle_t *handle, const char *key, size_t final_data
             }
         }
 
-        // If we have no room for the record, perform garbage collection
         uint32_t rec_size = record_size(key, final_data_size);
+
+        // With incremental GC, migrate a bounded number of records now (or all remaining ones if
+        // we have already run out of room). Failures aren't fatal here, full GC below is the fallback.
+        if (_gc_records_per_step) {
+            incremental_gc_step((_free_space_offset + rec_size > _size) ? (uint32_t) -1 : _gc_records_per_step);
+        }
+
+        // If we have no room for the record, perform garbage collection
         if (_free_space_offset + rec_size > _size) {
             ret = garbage_collection();
             if (ret) {
@@ -562,8 +610,6 @@ int TDBStore::set_finalize(set_handle_t handle)
 {
     int os_ret, ret = MBED_SUCCESS;
     inc_set_handle_t *ih;
-    ram_table_entry_t *ram_table = (ram_table_entry_t *) _ram_table;
-    ram_table_entry_t *entry;
     bool need_gc = false;
     uint32_t actual_data_size, hash, flags, next_offset;
 
@@ -615,27 +661,8 @@ int TDBStore::set_finalize(set_handle_t handle)
         goto end;
     }
 
-    // Update RAM table
-    if (ih->header.flags & delete_flag) {
-        _num_keys--;
-        if (ih->ram_table_ind < _num_keys) {
-            memmove(&ram_table[ih->ram_table_ind], &ram_table[ih->ram_table_ind + 1],
-                    sizeof(ram_table_entry_t) * (_num_keys - ih->ram_table_ind));
-        }
-        update_all_iterators(false, ih->ram_table_ind);
-    } else {
-        if (ih->new_key) {
-            if (ih->ram_table_ind < _num_keys) {
-                memmove(&ram_table[ih->ram_table_ind + 1], &ram_table[ih->ram_table_ind],
-                        sizeof(ram_table_entry_t) * (_num_keys - ih->ram_table_ind));
-            }
-            _num_keys++;
-            update_all_iterators(true, ih->ram_table_ind);
-        }
-        entry = &ram_table[ih->ram_table_ind];
-        entry->hash = ih->hash;
-        entry->bd_offset = ih->bd_base_offset;
-    }
+    update_ram_table(ih->header.flags & delete_flag, ih->new_key, ih->ram_table_ind, ih->hash,
+                     ih->header.key_size, ih->bd_base_offset);
 
     _free_space_offset = align_up(ih->bd_curr_offset, _prog_size);
 
@@ -655,6 +682,242 @@ end:
     return ret;
 }
 
+void TDBStore::update_ram_table(bool deleted, bool new_key, uint32_t ram_table_ind, uint32_t hash,
+                                uint16_t key_size, uint32_t bd_offset)
+{
+    ram_table_entry_t *ram_table = (ram_table_entry_t *) _ram_table;
+    ram_table_entry_t *entry;
+
+    if (deleted) {
+        _num_keys--;
+        if (ram_table_ind < _num_keys) {
+            memmove(&ram_table[ram_table_ind], &ram_table[ram_table_ind + 1],
+                    sizeof(ram_table_entry_t) * (_num_keys - ram_table_ind));
+        }
+        update_all_iterators(false, ram_table_ind);
+        return;
+    }
+
+    if (new_key) {
+        if (ram_table_ind < _num_keys) {
+            memmove(&ram_table[ram_table_ind + 1], &ram_table[ram_table_ind],
+                    sizeof(ram_table_entry_t) * (_num_keys - ram_table_ind));
+        }
+        _num_keys++;
+        update_all_iterators(true, ram_table_ind);
+    }
+    entry = &ram_table[ram_table_ind];
+    entry->hash = hash;
+    entry->key_size = key_size;
+    entry->bd_offset = bd_offset;
+}
+
+int TDBStore::write_record(uint32_t offset, const char *key, const void *data, uint32_t data_size,
+                           uint32_t flags, uint32_t &next_offset)
+{
+    record_header_t header;
+    uint32_t rec_size = record_size(key, data_size);
+    uint32_t key_offset = offset + align_up(sizeof(record_header_t), _prog_size);
+    int ret;
+
+    header.magic = tdbstore_magic;
+    header.header_size = sizeof(record_header_t);
+    header.revision = tdbstore_revision;
+    header.flags = flags;
+    header.key_size = strlen(key);
+    header.reserved = 0;
+    header.data_size = data_size;
+    header.crc = calc_crc(initial_crc, sizeof(record_header_t) - sizeof(header.crc), &header);
+    header.crc = calc_crc(header.crc, header.key_size, key);
+    header.crc = calc_crc(header.crc, data_size, data);
+
+    ret = check_erase_before_write(_active_area, offset, rec_size);
+    if (ret) {
+        return ret;
+    }
+
+    // As in the incremental set, header goes last
+    ret = write_area(_active_area, key_offset, header.key_size, key);
+    if (ret) {
+        return ret;
+    }
+
+    if (data_size) {
+        ret = write_area(_active_area, key_offset + header.key_size, data_size, data);
+        if (ret) {
+            return ret;
+        }
+    }
+
+    ret = write_area(_active_area, offset, sizeof(record_header_t), &header);
+    if (ret) {
+        return ret;
+    }
+
+    next_offset = offset + rec_size;
+    return MBED_SUCCESS;
+}
+
+int TDBStore::batch(const batch_op_t *ops, size_t num_ops)
+{
+    int os_ret, ret = MBED_SUCCESS;
+    record_header_t header;
+    uint32_t batch_offset, batch_size, offset, next_offset, rec_offset, ram_table_ind, hash, flags;
+    uint32_t actual_data_size;
+    uint32_t num_records = num_ops;
+    bool exists, write_once, need_gc = false;
+    size_t i, j;
+
+    if (!_is_initialized) {
+        return MBED_ERROR_NOT_READY;
+    }
+
+    if (!ops && num_ops) {
+        return MBED_ERROR_INVALID_ARGUMENT;
+    }
+
+    batch_size = record_size(batch_rec_key, sizeof(num_records));
+    for (i = 0; i < num_ops; i++) {
+        if (!is_valid_key(ops[i].key)) {
+            return MBED_ERROR_INVALID_ARGUMENT;
+        }
+        if (ops[i].remove) {
+            batch_size += record_size(ops[i].key, 0);
+            continue;
+        }
+        if ((!ops[i].buffer && ops[i].size) || (ops[i].create_flags & ~supported_flags)) {
+            return MBED_ERROR_INVALID_ARGUMENT;
+        }
+        batch_size += record_size(ops[i].key, ops[i].size);
+    }
+
+    if (!num_ops) {
+        return MBED_SUCCESS;
+    }
+
+    _mutex.lock();
+
+    // Check all operations against the stored keys, or against earlier operations in this batch
+    for (i = 0; i < num_ops; i++) {
+        for (j = i; j > 0; j--) {
+            if (!strcmp(ops[j - 1].key, ops[i].key)) {
+                break;
+            }
+        }
+
+        if (j) {
+            exists = !ops[j - 1].remove;
+            write_once = exists && (ops[j - 1].create_flags & WRITE_ONCE_FLAG);
+        } else {
+            ret = find_record(_active_area, ops[i].key, rec_offset, ram_table_ind, hash);
+            if (ret == MBED_SUCCESS) {
+                ret = read_area(_active_area, rec_offset, sizeof(header), &header);
+                if (ret) {
+                    goto end;
+                }
+                exists = true;
+                write_once = header.flags & WRITE_ONCE_FLAG;
+            } else if (ret == MBED_ERROR_ITEM_NOT_FOUND) {
+                exists = false;
+                write_once = false;
+            } else {
+                goto end;
+            }
+        }
+
+        if (write_once) {
+            ret = MBED_ERROR_WRITE_PROTECTED;
+            goto end;
+        }
+        if (ops[i].remove && !exists) {
+            ret = MBED_ERROR_ITEM_NOT_FOUND;
+            goto end;
+        }
+    }
+
+    if (_gc_records_per_step) {
+        incremental_gc_step((_free_space_offset + batch_size > _size) ? (uint32_t) -1 : _gc_records_per_step);
+    }
+
+    if (_free_space_offset + batch_size > _size) {
+        ret = garbage_collection();
+        if (ret) {
+            goto end;
+        }
+    }
+
+    if (_free_space_offset + batch_size > _size) {
+        ret = MBED_ERROR_MEDIA_FULL;
+        goto end;
+    }
+
+    // Write a batch record holding the number of records that follow, then the records themselves.
+    // Until all of them are valid, build_ram_table ignores the whole batch.
+    need_gc = true;
+    batch_offset = _free_space_offset;
+    ret = write_record(batch_offset, batch_rec_key, &num_records, sizeof(num_records), batch_flag,
+                       offset);
+    if (ret) {
+        goto end;
+    }
+
+    for (i = 0; i < num_ops; i++) {
+        if (ops[i].remove) {
+            ret = write_record(offset, ops[i].key, 0, 0, delete_flag, offset);
+        } else {
+            ret = write_record(offset, ops[i].key, ops[i].buffer, ops[i].size, ops[i].create_flags, offset);
+        }
+        if (ret) {
+            goto end;
+        }
+    }
+
+    // Single flush for the whole batch
+    os_ret = _buff_bd->sync();
+    if (os_ret) {
+        ret = MBED_ERROR_WRITE_FAILED;
+        goto end;
+    }
+
+    // Writes may fail without returning a failure (as in set_finalize), so reread all records
+    offset = batch_offset;
+    for (i = 0; i <= num_ops; i++) {
+        ret = read_record(_active_area, offset, 0, 0, (uint32_t) -1, actual_data_size, 0,
+                          false, false, false, false, hash, flags, next_offset);
+        if (ret) {
+            goto end;
+        }
+        offset = next_offset;
+    }
+    need_gc = false;
+    _free_space_offset = offset;
+
+    // Batch is committed, now update RAM table
+    offset = batch_offset + record_size(batch_rec_key, sizeof(num_records));
+    for (i = 0; i < num_ops; i++) {
+        ret = find_record(_active_area, ops[i].key, rec_offset, ram_table_ind, hash);
+        if ((ret != MBED_SUCCESS) && (ret != MBED_ERROR_ITEM_NOT_FOUND)) {
+            goto end;
+        }
+        exists = (ret == MBED_SUCCESS);
+        if (!exists && !ops[i].remove && (_num_keys >= _max_keys)) {
+            increment_max_keys();
+        }
+        if (exists || !ops[i].remove) {
+            update_ram_table(ops[i].remove, !exists, ram_table_ind, hash, strlen(ops[i].key), offset);
+        }
+        offset += record_size(ops[i].key, ops[i].remove ? 0 : ops[i].size);
+    }
+    ret = MBED_SUCCESS;
+
+end:
+    if (need_gc) {
+        garbage_collection();
+    }
+    _mutex.unlock();
+    return ret;
+}
+
 int TDBStore::set(const char *key, const void *buffer, size_t size, uint32_t create_flags)
 {
     int ret;
@@ -819,10 +1082,24 @@ int TDBStore::copy_record(uint8_t from_area, uint32_t from_offset, uint32_t to_o
 }
 
 int TDBStore::garbage_collection()
+{
+    uint64_t start_time = gc_time_us();
+    int ret;
+
+    // Full GC always starts from scratch, dropping any incremental progress
+    _gc_in_progress = false;
+
+    ret = do_garbage_collection();
+
+    _gc_stats.full_gc_count++;
+    update_gc_pause(start_time);
+    return ret;
+}
+
+int TDBStore::do_garbage_collection()
 {
     ram_table_entry_t *ram_table = (ram_table_entry_t *) _ram_table;
     uint32_t to_offset, to_next_offset;
-    uint32_t chunk_size, reserved_size;
     int ret;
     size_t ind;
 
@@ -831,26 +1108,9 @@ int TDBStore::garbage_collection()
         return ret;
     }
 
-    ret = do_reserved_data_get(0, RESERVED_AREA_SIZE);
-
-    if (!ret) {
-        // Copy reserved data
-        to_offset = 0;
-        reserved_size = _master_record_offset;
-
-        while (reserved_size) {
-            chunk_size = std::min(work_buf_size, reserved_size);
-            ret = read_area(_active_area, to_offset, chunk_size, _work_buf);
-            if (ret) {
-                return ret;
-            }
-            ret = write_area(1 - _active_area, to_offset, chunk_size, _work_buf);
-            if (ret) {
-                return ret;
-            }
-            to_offset += chunk_size;
-            reserved_size -= chunk_size;
-        }
+    ret = copy_reserved_data();
+    if (ret) {
+        return ret;
     }
 
     to_offset = _master_record_offset + _master_record_size;
@@ -892,6 +1152,149 @@ int TDBStore::garbage_collection()
     return MBED_SUCCESS;
 }
 
+int TDBStore::copy_reserved_data()
+{
+    uint32_t offset = 0, chunk_size, reserved_size = _master_record_offset;
+    int ret;
+
+    // Nothing to copy if reserved data is missing or corrupt
+    if (do_reserved_data_get(0, RESERVED_AREA_SIZE)) {
+        return MBED_SUCCESS;
+    }
+
+    while (reserved_size) {
+        chunk_size = std::min(work_buf_size, reserved_size);
+        ret = read_area(_active_area, offset, chunk_size, _work_buf);
+        if (ret) {
+            return ret;
+        }
+        ret = write_area(1 - _active_area, offset, chunk_size, _work_buf);
+        if (ret) {
+            return ret;
+        }
+        offset += chunk_size;
+        reserved_size -= chunk_size;
+    }
+
+    return MBED_SUCCESS;
+}
+
+int TDBStore::incremental_gc_step(uint32_t max_records)
+{
+    ram_table_entry_t *ram_table = (ram_table_entry_t *) _ram_table;
+    uint32_t offset, next_offset, to_next_offset, hash, flags, actual_data_size, ind;
+    uint64_t start_time;
+    bool live;
+    int ret = MBED_SUCCESS;
+
+    if (!_gc_in_progress) {
+        if (_free_space_offset + _gc_free_space_threshold < _size) {
+            return MBED_SUCCESS;
+        }
+
+        start_time = gc_time_us();
+        ret = check_erase_before_write(1 - _active_area, 0, _master_record_offset + _master_record_size);
+        if (ret) {
+            goto end;
+        }
+
+        _gc_in_progress = true;
+        _gc_from_offset = _master_record_offset;
+        _gc_to_offset = _master_record_offset + _master_record_size;
+        _gc_start_offset = _free_space_offset;
+    } else {
+        start_time = gc_time_us();
+    }
+
+    // Scan the active area in log order, so that later versions of a key also land later
+    // in the standby area (which is what build_ram_table expects after a reset).
+    while (max_records && (_gc_from_offset < _free_space_offset)) {
+        offset = _gc_from_offset;
+        ret = read_record(_active_area, offset, _key_buf, 0, 0, actual_data_size, 0,
+                          true, false, false, true, hash, flags, next_offset);
+        if (ret) {
+            goto end;
+        }
+
+        if (flags & delete_flag) {
+            // Deletions only matter if they happened after we started, as an earlier version
+            // of the key may have been migrated already.
+            live = (offset >= _gc_start_offset);
+            ind = _num_keys;
+        } else {
+            // Set records are live as long as the RAM table points at them
+            for (ind = find_hash_ind(ram_table, _num_keys, hash);
+                    (ind < _num_keys) && (ram_table[ind].hash == hash); ind++) {
+                if (ram_table[ind].bd_offset == offset) {
+                    break;
+                }
+            }
+            live = (ind < _num_keys) && (ram_table[ind].hash == hash);
+        }
+
+        if (live) {
+            if (_gc_to_offset + (next_offset - offset) > _size) {
+                ret = MBED_ERROR_MEDIA_FULL;
+                goto end;
+            }
+            ret = copy_record(_active_area, offset, _gc_to_offset, to_next_offset);
+            if (ret) {
+                goto end;
+            }
+            if (ind < _num_keys) {
+                ram_table[ind].gc_offset = _gc_to_offset;
+            }
+            _gc_to_offset = to_next_offset;
+        }
+
+        _gc_from_offset = next_offset;
+        max_records--;
+    }
+
+    _gc_stats.gc_step_count++;
+
+    if (_gc_from_offset < _free_space_offset) {
+        goto end;
+    }
+
+    // All live records are in the standby area now, switch to it
+    ret = copy_reserved_data();
+    if (ret) {
+        goto end;
+    }
+
+    for (ind = 0; ind < _num_keys; ind++) {
+        ram_table[ind].bd_offset = ram_table[ind].gc_offset;
+    }
+
+    _gc_in_progress = false;
+    _free_space_offset = _gc_to_offset;
+    _active_area = 1 - _active_area;
+    _active_area_version++;
+    ret = write_master_record(_active_area, _active_area_version, offset);
+    if (ret) {
+        goto end;
+    }
+
+    ret = reset_area(1 - _active_area);
+    _gc_stats.incremental_gc_count++;
+
+end:
+    if (ret) {
+        // Drop our progress, the standby area is only adopted once its master record is written
+        _gc_in_progress = false;
+    }
+    update_gc_pause(start_time);
+    return ret;
+}
+
+void TDBStore::update_gc_pause(uint64_t start_time)
+{
+    uint32_t pause = gc_time_us() - start_time;
+
+    _gc_stats.max_pause_us = std::max(_gc_stats.max_pause_us, pause);
+}
+
 
 int TDBStore::build_ram_table()
 {
@@ -902,6 +1305,7 @@ int TDBStore::build_ram_table()
     uint32_t flags;
     uint32_t actual_data_size;
     uint32_t ram_table_ind;
+    uint32_t batch_offset = 0, batch_start = 0, batch_end = 0, batch_remaining = 0;
 
     _num_keys = 0;
     offset = _master_record_offset;
@@ -914,6 +1318,37 @@ int TDBStore::build_ram_table()
             goto end;
         }
 
+        // Records of a batch only take effect once all of them are found valid. Until then, just
+        // count them, and then go back and apply them (at which point offset is below batch_end).
+        if (offset >= batch_end) {
+            if (flags & batch_flag) {
+                if (batch_remaining) {
+                    // Previous batch was interrupted
+                    ret = MBED_ERROR_INVALID_DATA_DETECTED;
+                    goto end;
+                }
+                ret = read_area(_active_area, offset + align_up(sizeof(record_header_t), _prog_size) + strlen(_key_buf),
+                                sizeof(batch_remaining), &batch_remaining);
+                if (ret) {
+                    goto end;
+                }
+                batch_offset = offset;
+                batch_start = next_offset;
+                offset = next_offset;
+                continue;
+            }
+
+            if (batch_remaining) {
+                offset = next_offset;
+                if (--batch_remaining) {
+                    continue;
+                }
+                batch_end = offset;
+                offset = batch_start;
+                continue;
+            }
+        }
+
         ret = find_record(_active_area, _key_buf, dummy, ram_table_ind, hash);
 
         if ((ret != MBED_SUCCESS) && (ret != MBED_ERROR_ITEM_NOT_FOUND)) {
@@ -949,10 +1384,16 @@ int TDBStore::build_ram_table()
 
         // update record parameters
         ram_table[ram_table_ind].hash = hash;
+        ram_table[ram_table_ind].key_size = strlen(_key_buf);
         ram_table[ram_table_ind].bd_offset = save_offset;
     }
 
 end:
+    if (batch_remaining) {
+        // Treat an interrupted batch like a corrupt record (forcing a GC, which drops it)
+        ret = MBED_ERROR_INVALID_DATA_DETECTED;
+        next_offset = batch_offset;
+    }
     _free_space_offset = next_offset;
     return ret;
 }
@@ -961,11 +1402,11 @@ int TDBStore::increment_max_keys(void **ram_table)
 {
     // Reallocate ram table with new size
     ram_table_entry_t *old_ram_table = (ram_table_entry_t *) _ram_table;
-    ram_table_entry_t *new_ram_table = new ram_table_entry_t[_max_keys + 1];
+    ram_table_entry_t *new_ram_table = new ram_table_entry_t[_max_keys + initial_max_keys];
 
     // Copy old content to new table
     memcpy(new_ram_table, old_ram_table, sizeof(ram_table_entry_t) * _max_keys);
-    _max_keys++;
+    _max_keys += initial_max_keys;
 
     _ram_table = new_ram_table;
     delete[] old_ram_table;
@@ -1006,6 +1447,7 @@ int TDBStore::init()
 #endif
 
     _max_keys = initial_max_keys;
+    _gc_in_progress = false;
 
     ram_table = new ram_table_entry_t[_max_keys];
     _ram_table = ram_table;
@@ -1173,6 +1615,9 @@ int TDBStore::reset()
 
     _mutex.lock();
 
+    // Any incremental GC progress is meaningless once both areas are reset
+    _gc_in_progress = false;
+
     // Reset both areas
     for (area = 0; area < _num_areas; area++) {
         ret = reset_area(area);
@@ -1442,6 +1887,45 @@ int TDBStore::reserved_data_get(void *reserved_data, size_t reserved_data_buf_si
     return ret;
 }
 
+int TDBStore::set_incremental_gc(uint32_t records_per_step, uint32_t free_space_threshold)
+{
+    _mutex.lock();
+    _gc_records_per_step = records_per_step;
+    _gc_free_space_threshold = free_space_threshold;
+    _mutex.unlock();
+    return MBED_SUCCESS;
+}
+
+int TDBStore::gc_step()
+{
+    int ret = MBED_SUCCESS;
+
+    if (!_is_initialized) {
+        return MBED_ERROR_NOT_READY;
+    }
+
+    _mutex.lock();
+
+    if (_gc_records_per_step) {
+        ret = incremental_gc_step(_gc_records_per_step);
+    }
+
+    _mutex.unlock();
+    return ret;
+}
+
+int TDBStore::get_gc_stats(gc_stats_t *stats)
+{
+    if (!stats) {
+        return MBED_ERROR_INVALID_ARGUMENT;
+    }
+
+    _mutex.lock();
+    *stats = _gc_stats;
+    _mutex.unlock();
+    return MBED_SUCCESS;
+}
+
 
 void TDBStore::offset_in_erase_unit(uint8_t area, uint32_t offset,
                                     uint32_t &offset_from_start, uint32_t &dist_to_end)
@@ -36,6 +36,14 @@ public:
 
     static const uint32_t RESERVED_AREA_SIZE = 64;
 
+    /** Garbage collection statistics */
+    typedef struct {
+        uint32_t full_gc_count;             ///< Number of full (blocking) garbage collections
+        uint32_t incremental_gc_count;      ///< Number of completed incremental garbage collections
+        uint32_t gc_step_count;             ///< Number of incremental garbage collection steps
+        uint32_t max_pause_us;              ///< Longest time spent in a single GC or GC step (us)
+    } gc_stats_t;
+
     /**
      * @brief Class constructor
      *
@@ -154,6 +162,25 @@ public:
      */
     virtual int remove(const char *key);
 
+    /**
+     * @brief Set and remove multiple TDBStore items atomically, in the given order.
+     *        All records are written and flushed together, and only take effect
+     *        (also after a power failure) once all of them have been written.
+     *
+     * @param[in]  ops                  Operations.
+     * @param[in]  num_ops              Number of operations.
+     *
+     * @returns MBED_SUCCESS                        Success.
+     *          MBED_ERROR_NOT_READY                Not initialized.
+     *          MBED_ERROR_READ_FAILED              Unable to read from media.
+     *          MBED_ERROR_WRITE_FAILED             Unable to write to media.
+     *          MBED_ERROR_INVALID_ARGUMENT         Invalid argument given in function arguments.
+     *          MBED_ERROR_ITEM_NOT_FOUND           Removed item not found.
+     *          MBED_ERROR_MEDIA_FULL               Not enough room on media.
+     *          MBED_ERROR_WRITE_PROTECTED          Already stored with "write once" flag.
+     */
+    virtual int batch(const batch_op_t *ops, size_t num_ops);
+
 
     /**
      * @brief Start an incremental TDBStore set sequence. This operation is blocking other operations.
@@ -280,6 +307,44 @@ public:
     virtual int reserved_data_get(void *reserved_data, size_t reserved_data_buf_size,
                                   size_t *actual_data_size = 0);
 
+    /**
+     * @brief Configure incremental garbage collection.
+     *        Once free space in the active area drops below the given threshold, live records
+     *        start migrating to the standby area, a bounded number of them on each set/remove
+     *        or gc_step call. Areas are only switched once all records have been migrated,
+     *        so a power failure during the process leaves the active area intact. If the active
+     *        area fills up before that, the remaining records are migrated at once.
+     *
+     * @param[in]  records_per_step     Maximal number of records scanned per step
+     *                                  (0 disables incremental GC, which is the default).
+     * @param[in]  free_space_threshold Free space in active area (bytes) below which incremental GC starts.
+     *
+     * @returns MBED_SUCCESS                        Success.
+     */
+    int set_incremental_gc(uint32_t records_per_step, uint32_t free_space_threshold);
+
+    /**
+     * @brief Perform a single incremental garbage collection step, if one is due.
+     *        Can be called periodically (e.g. from an event queue) to keep set latency low.
+     *
+     * @returns MBED_SUCCESS                        Success.
+     *          MBED_ERROR_NOT_READY                Not initialized.
+     *          MBED_ERROR_READ_FAILED              Unable to read from media.
+     *          MBED_ERROR_WRITE_FAILED             Unable to write to media.
+     *          MBED_ERROR_MEDIA_FULL               Not enough room on standby area.
+     */
+    int gc_step();
+
+    /**
+     * @brief Get garbage collection statistics.
+     *
+     * @param[out] stats                Statistics.
+     *
+     * @returns MBED_SUCCESS                        Success.
+     *          MBED_ERROR_INVALID_ARGUMENT         Invalid argument given in function arguments.
+     */
+    int get_gc_stats(gc_stats_t *stats);
+
 #if !defined(DOXYGEN_ONLY)
 private:
 
@@ -312,6 +377,13 @@ private:
     bool _variant_bd_erase_unit_size;
     void *_inc_set_handle;
     void *_iterator_table[_max_open_iterators];
+    uint32_t _gc_records_per_step;
+    uint32_t _gc_free_space_threshold;
+    bool _gc_in_progress;
+    uint32_t _gc_from_offset;
+    uint32_t _gc_to_offset;
+    uint32_t _gc_start_offset;
+    gc_stats_t _gc_stats;
 
     /**
      * @brief Read a block from an area.
@@ -418,6 +490,37 @@ private:
      */
     int garbage_collection();
 
+    /**
+     * @brief Actual logics of garbage collection.
+     *
+     * @returns 0 for success, nonzero for failure.
+     */
+    int do_garbage_collection();
+
+    /**
+     * @brief Copy reserved data (if valid) from active area to the standby one.
+     *
+     * @returns 0 for success, nonzero for failure.
+     */
+    int copy_reserved_data();
+
+    /**
+     * @brief Incremental garbage collection step. Starts incremental GC if free space
+     *        dropped below threshold, and switches areas once all records are migrated.
+     *
+     * @param[in]  max_records          Maximal number of records to scan.
+     *
+     * @returns 0 for success, nonzero for failure.
+     */
+    int incremental_gc_step(uint32_t max_records);
+
+    /**
+     * @brief Update maximal GC pause statistics.
+     *
+     * @param[in]  start_time           Time GC started (us).
+     */
+    void update_gc_pause(uint64_t start_time);
+
     /**
      * @brief Return record size given key and data size.
      *
@@ -469,6 +572,34 @@ private:
      */
     int do_set(const char *key, const void *data_buf, uint32_t data_buf_size, uint32_t flags);
 
+    /**
+     * @brief Write a complete record to active area (without flushing it).
+     *
+     * @param[in]  offset               Offset of record in area.
+     * @param[in]  key                  Key.
+     * @param[in]  data                 Data buffer.
+     * @param[in]  data_size            Data size.
+     * @param[in]  flags                Record flags.
+     * @param[out] next_offset          Offset of next record.
+     *
+     * @returns 0 for success, nonzero for failure.
+     */
+    int write_record(uint32_t offset, const char *key, const void *data, uint32_t data_size,
+                     uint32_t flags, uint32_t &next_offset);
+
+    /**
+     * @brief Update RAM table after a record has been written.
+     *
+     * @param[in]  deleted              Record deletes the key.
+     * @param[in]  new_key              Key doesn't exist in RAM table yet.
+     * @param[in]  ram_table_ind        RAM table index.
+     * @param[in]  hash                 Key hash.
+     * @param[in]  key_size             Key size.
+     * @param[in]  bd_offset            Offset of record in area.
+     */
+    void update_ram_table(bool deleted, bool new_key, uint32_t ram_table_ind, uint32_t hash,
+                          uint16_t key_size, uint32_t bd_offset);
+
     /**
      * @brief Build RAM table and update _free_space_offset (scanning all the records in the area).
      *
@@ -206,6 +206,198 @@ private:
     bool _full;
 };
 
+/** Templated circular buffer for a single producer and a single consumer
+ *
+ *  Unlike CircularBuffer, the producer and the consumer do not enter a
+ *  critical section: each of them owns one index, and reads the index of
+ *  the other to find how many elements it can push or pop. As the producer
+ *  cannot move the tail, push does not overwrite the buffer when it's full.
+ *
+ *  Bulk push and pop copy contiguous spans of the buffer, at most two per call.
+ *
+ *  @note Synchronization level: Interrupt safe, if push is only called from
+ *  one context (such as an interrupt handler) and pop from one other
+ *  context (such as a thread holding a mutex). Each of empty, full and size
+ *  may be called from either context. reset may only be called when
+ *  neither push nor pop can be running.
+ */
+template<typename T, uint32_t BufferSize>
+class SPSCCircularBuffer {
+public:
+    SPSCCircularBuffer() : _head(0), _tail(0)
+    {
+        MBED_STATIC_ASSERT(
+            BufferSize > 0 && BufferSize < 0x80000000,
+            "Invalid BufferSize"
+        );
+    }
+
+    ~SPSCCircularBuffer()
+    {
+    }
+
+    /** Push the transaction to the buffer, unless it's full
+     *
+     * @param data Data to be pushed to the buffer
+     * @return True if the data was pushed, false if the buffer is full
+     */
+    bool push(const T &data)
+    {
+        uint32_t head = _head;
+        if (count(head, core_util_atomic_load_u32(&_tail)) == BufferSize) {
+            return false;
+        }
+        _pool[index(head)] = data;
+        core_util_atomic_store_u32(&_head, advance(head, 1));
+        return true;
+    }
+
+    /** Push an array of transactions to the buffer, as many as it has room for
+     *
+     * @param data Data to be pushed to the buffer
+     * @param len Number of elements in data
+     * @return Number of elements pushed
+     */
+    uint32_t push(const T *data, uint32_t len)
+    {
+        uint32_t head = _head;
+        uint32_t space = BufferSize - count(head, core_util_atomic_load_u32(&_tail));
+        if (len > space) {
+            len = space;
+        }
+        uint32_t start = index(head);
+        uint32_t span = BufferSize - start;
+        if (span > len) {
+            span = len;
+        }
+        copy(&_pool[start], data, span);
+        copy(&_pool[0], data + span, len - span);
+        core_util_atomic_store_u32(&_head, advance(head, len));
+        return len;
+    }
+
+    /** Pop the transaction from the buffer
+     *
+     * @param data Data to be popped from the buffer
+     * @return True if the buffer is not empty and data contains a transaction, false otherwise
+     */
+    bool pop(T &data)
+    {
+        uint32_t tail = _tail;
+        if (count(core_util_atomic_load_u32(&_head), tail) == 0) {
+            return false;
+        }
+        data = _pool[index(tail)];
+        core_util_atomic_store_u32(&_tail, advance(tail, 1));
+        return true;
+    }
+
+    /** Pop transactions from the buffer into an array, as many as are stored
+     *
+     * @param data Array for the data popped from the buffer
+     * @param len Number of elements in data
+     * @return Number of elements popped
+     */
+    uint32_t pop(T *data, uint32_t len)
+    {
+        uint32_t tail = _tail;
+        uint32_t elements = count(core_util_atomic_load_u32(&_head), tail);
+        if (len > elements) {
+            len = elements;
+        }
+        uint32_t start = index(tail);
+        uint32_t span = BufferSize - start;
+        if (span > len) {
+            span = len;
+        }
+        copy(data, &_pool[start], span);
+        copy(data + span, &_pool[0], len - span);
+        core_util_atomic_store_u32(&_tail, advance(tail, len));
+        return len;
+    }
+
+    /** Check if the buffer is empty
+     *
+     * @return True if the buffer is empty, false if not
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /** Check if the buffer is full
+     *
+     * @return True if the buffer is full, false if not
+     */
+    bool full() const
+    {
+        return size() == BufferSize;
+    }
+
+    /** Reset the buffer
+     *
+     */
+    void reset()
+    {
+        core_util_atomic_store_u32(&_head, 0);
+        core_util_atomic_store_u32(&_tail, 0);
+    }
+
+    /** Get the number of elements currently stored in the circular_buffer */
+    uint32_t size() const
+    {
+        return count(core_util_atomic_load_u32(&_head), core_util_atomic_load_u32(&_tail));
+    }
+
+    /** Peek into circular buffer without popping
+     *
+     * @param data Data to be peeked from the buffer
+     * @return True if the buffer is not empty and data contains a transaction, false otherwise
+     */
+    bool peek(T &data) const
+    {
+        uint32_t tail = _tail;
+        if (count(core_util_atomic_load_u32(&_head), tail) == 0) {
+            return false;
+        }
+        data = _pool[index(tail)];
+        return true;
+    }
+
+private:
+    /* Indexes run over twice the buffer size, so that a full buffer can be
+     * told from an empty one without a flag written by both sides.
+     */
+    static const uint32_t Wrap = 2 * BufferSize;
+
+    static uint32_t count(uint32_t head, uint32_t tail)
+    {
+        return head >= tail ? head - tail : Wrap - tail + head;
+    }
+
+    static uint32_t index(uint32_t position)
+    {
+        return position < BufferSize ? position : position - BufferSize;
+    }
+
+    static uint32_t advance(uint32_t position, uint32_t len)
+    {
+        position += len;
+        return position >= Wrap ? position - Wrap : position;
+    }
+
+    static void copy(T *dst, const T *src, uint32_t len)
+    {
+        for (uint32_t i = 0; i < len; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    T _pool[BufferSize];
+    volatile uint32_t _head;
+    volatile uint32_t _tail;
+};
+
 /**@}*/
 
 /**@}*/
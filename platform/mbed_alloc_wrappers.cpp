@@ -17,6 +17,8 @@
 
 #include "platform/mbed_mem_trace.h"
 #include "platform/mbed_stats.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
 #include "platform/mbed_toolchain.h"
 #include "platform/SingletonPtr.h"
 #include "platform/PlatformMutex.h"
@@ -35,7 +37,12 @@
 
 Both tracers can be activated and deactivated in any combination. If both tracers
 are active, the second one (MBED_MEM_TRACING_ENABLED) will trace the first one's
-(MBED_HEAP_STATS_ENABLED) memory calls.*/
+(MBED_HEAP_STATS_ENABLED) memory calls.
+
+Below both tracers, small allocations can be served from pools of fixed-size
+blocks instead of the heap, to keep short-lived objects from fragmenting it.
+Pools are enabled by setting the number of blocks of any of the
+platform.heap-pool-<size>-blocks configuration options.*/
 
 /******************************************************************************/
 /* Implementation of the runtime max heap usage checker                       */
@@ -44,6 +51,10 @@ are active, the second one (MBED_MEM_TRACING_ENABLED) will trace the first one's
 typedef struct {
     uint32_t size;
     uint32_t signature;
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+    uint32_t site;
+    uint32_t padding;       // Keep the allocated memory 8-byte aligned
+#endif
 } alloc_info_t;
 
 #ifdef MBED_HEAP_STATS_ENABLED
@@ -59,6 +70,199 @@ typedef struct  {
 #define MALLOC_HEADER_SIZE          (sizeof(mbed_heap_overhead_t))
 #define MALLOC_HEADER_PTR(p)        (mbed_heap_overhead_t *)((char *)(p) - MALLOC_HEADER_SIZE)
 #define MALLOC_HEAP_TOTAL_SIZE(p)   (((p)->size) & (~0x1))
+
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+#define MBED_HEAP_STATS_SITES       MBED_CONF_PLATFORM_HEAP_STATS_SITES
+
+/* Call sites are hashed by address into the table with linear probing. Once
+ * the table is full, other call sites are accounted in the extra last entry.
+ * Entries are never removed, so each allocation can store its site index. */
+static mbed_stats_heap_site_t heap_sites[MBED_HEAP_STATS_SITES + 1];
+
+static uint32_t heap_site_alloc(void *caller, uint32_t size)
+{
+    // Thumb bit dropped, Fibonacci hashing
+    uint32_t index = (((uint32_t)(uintptr_t)caller >> 1) * 2654435761UL) % MBED_HEAP_STATS_SITES;
+    uint32_t probes;
+    for (probes = 0; probes < MBED_HEAP_STATS_SITES; probes++) {
+        if (heap_sites[index].caller == caller) {
+            break;
+        }
+        if (heap_sites[index].caller == NULL) {
+            heap_sites[index].caller = caller;
+            break;
+        }
+        if (++index == MBED_HEAP_STATS_SITES) {
+            index = 0;
+        }
+    }
+    if (probes == MBED_HEAP_STATS_SITES) {
+        index = MBED_HEAP_STATS_SITES;
+    }
+
+    mbed_stats_heap_site_t *site = &heap_sites[index];
+    site->current_size += size;
+    site->alloc_cnt += 1;
+    site->total_cnt += 1;
+    if (site->current_size > site->max_size) {
+        site->max_size = site->current_size;
+    }
+    return index;
+}
+
+static void heap_site_free(uint32_t index, uint32_t size)
+{
+    heap_sites[index].current_size -= size;
+    heap_sites[index].alloc_cnt -= 1;
+}
+#endif // MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+#endif
+
+/******************************************************************************/
+/* Fixed-size block pools                                                     */
+/******************************************************************************/
+
+#ifndef MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS
+#define MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS      0
+#endif
+#ifndef MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS
+#define MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS      0
+#endif
+#ifndef MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS
+#define MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS      0
+#endif
+#ifndef MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS
+#define MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS     0
+#endif
+
+#define HEAP_POOL_16_OFFSET     0
+#define HEAP_POOL_32_OFFSET     (HEAP_POOL_16_OFFSET + 16 * MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS)
+#define HEAP_POOL_64_OFFSET     (HEAP_POOL_32_OFFSET + 32 * MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS)
+#define HEAP_POOL_128_OFFSET    (HEAP_POOL_64_OFFSET + 64 * MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS)
+#define HEAP_POOL_SIZE          (HEAP_POOL_128_OFFSET + 128 * MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS)
+
+#if HEAP_POOL_SIZE > 0
+#define MBED_HEAP_POOL_ENABLED
+
+typedef struct heap_pool_block {
+    struct heap_pool_block *next;
+} heap_pool_block_t;
+
+typedef struct {
+    uint8_t *start;                 // First block of the pool
+    uint8_t *end;                   // End of the last block of the pool
+    uint8_t *unused;                // Blocks from here to the end have never been allocated
+    heap_pool_block_t *free_list;   // Blocks allocated and freed since
+} heap_pool_t;
+
+// Blocks of all the pools, from the smallest to the largest
+static uint64_t heap_pool_memory[HEAP_POOL_SIZE / sizeof(uint64_t)];
+
+#define HEAP_POOL_INIT(offset, blocks, size) {                              \
+        (uint8_t *)heap_pool_memory + (offset),                             \
+        (uint8_t *)heap_pool_memory + (offset) + (blocks) * (size),         \
+        (uint8_t *)heap_pool_memory + (offset),                             \
+        NULL                                                                \
+    }
+
+static heap_pool_t heap_pools[MBED_HEAP_POOL_CLASSES] = {
+    HEAP_POOL_INIT(HEAP_POOL_16_OFFSET, MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS, 16),
+    HEAP_POOL_INIT(HEAP_POOL_32_OFFSET, MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS, 32),
+    HEAP_POOL_INIT(HEAP_POOL_64_OFFSET, MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS, 64),
+    HEAP_POOL_INIT(HEAP_POOL_128_OFFSET, MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS, 128)
+};
+
+static mbed_stats_heap_pool_t heap_pool_stats[MBED_HEAP_POOL_CLASSES] = {
+    {16, MBED_CONF_PLATFORM_HEAP_POOL_16_BLOCKS, 0, 0, 0},
+    {32, MBED_CONF_PLATFORM_HEAP_POOL_32_BLOCKS, 0, 0, 0},
+    {64, MBED_CONF_PLATFORM_HEAP_POOL_64_BLOCKS, 0, 0, 0},
+    {128, MBED_CONF_PLATFORM_HEAP_POOL_128_BLOCKS, 0, 0, 0}
+};
+
+/* Allocate a block from the smallest pool the size fits in. Returns NULL if
+ * there is no such pool, or if it is full and the heap must be used instead. */
+static void *heap_pool_alloc(size_t size)
+{
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        mbed_stats_heap_pool_t *stats = &heap_pool_stats[i];
+        if (size > stats->block_size || stats->block_cnt == 0) {
+            continue;
+        }
+
+        heap_pool_t *pool = &heap_pools[i];
+        void *block = NULL;
+        core_util_critical_section_enter();
+        if (pool->free_list != NULL) {
+            block = pool->free_list;
+            pool->free_list = pool->free_list->next;
+        } else if (pool->unused < pool->end) {
+            block = pool->unused;
+            pool->unused += stats->block_size;
+        }
+        if (block != NULL) {
+            stats->alloc_cnt += 1;
+            if (stats->alloc_cnt > stats->max_cnt) {
+                stats->max_cnt = stats->alloc_cnt;
+            }
+        } else {
+            stats->fallback_cnt += 1;
+        }
+        core_util_critical_section_exit();
+        return block;
+    }
+    return NULL;
+}
+
+/* Get the size of the pool block ptr points to, or 0 if it was allocated from the heap */
+static size_t heap_pool_block_size(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    if (p < (const uint8_t *)heap_pool_memory || p >= (const uint8_t *)heap_pool_memory + HEAP_POOL_SIZE) {
+        return 0;
+    }
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        if (p < heap_pools[i].end) {
+            return heap_pool_stats[i].block_size;
+        }
+    }
+    return 0;
+}
+
+/* Give back the pool block ptr points to. Returns false if it was allocated from the heap. */
+static bool heap_pool_free(void *ptr)
+{
+    uint8_t *p = (uint8_t *)ptr;
+    if (p < (uint8_t *)heap_pool_memory || p >= (uint8_t *)heap_pool_memory + HEAP_POOL_SIZE) {
+        return false;
+    }
+    for (int i = 0; i < MBED_HEAP_POOL_CLASSES; i++) {
+        heap_pool_t *pool = &heap_pools[i];
+        if (p < pool->end) {
+            heap_pool_block_t *block = (heap_pool_block_t *)p;
+            core_util_critical_section_enter();
+            block->next = pool->free_list;
+            pool->free_list = block;
+            heap_pool_stats[i].alloc_cnt -= 1;
+            core_util_critical_section_exit();
+            break;
+        }
+    }
+    return true;
+}
+#endif // HEAP_POOL_SIZE > 0
+
+#ifdef MBED_HEAP_STATS_ENABLED
+/* Get the number of bytes the heap or a pool gave for the allocation */
+static size_t heap_alloc_total_size(void *ptr)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    size_t block_size = heap_pool_block_size(ptr);
+    if (block_size != 0) {
+        return block_size;
+    }
+#endif
+    return MALLOC_HEAP_TOTAL_SIZE(MALLOC_HEADER_PTR(ptr));
+}
 #endif
 
 void mbed_stats_heap_get(mbed_stats_heap_t *stats)
@@ -73,6 +277,49 @@ void mbed_stats_heap_get(mbed_stats_heap_t *stats)
 #else
     memset(stats, 0, sizeof(mbed_stats_heap_t));
 #endif
+#ifdef MBED_HEAP_POOL_ENABLED
+    core_util_critical_section_enter();
+    memcpy(stats->pool, heap_pool_stats, sizeof(stats->pool));
+    core_util_critical_section_exit();
+#endif
+}
+
+size_t mbed_stats_heap_site_get_each(mbed_stats_heap_site_t *stats, size_t count)
+{
+    MBED_ASSERT(stats != NULL);
+    memset(stats, 0, count * sizeof(mbed_stats_heap_site_t));
+    size_t i = 0;
+
+#if defined(MBED_HEAP_STATS_ENABLED) && MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+    malloc_stats_mutex->lock();
+    for (size_t index = 0; index <= MBED_HEAP_STATS_SITES && i < count; index++) {
+        if (heap_sites[index].total_cnt != 0) {
+            stats[i++] = heap_sites[index];
+        }
+    }
+    malloc_stats_mutex->unlock();
+#endif
+
+    return i;
+}
+
+void mbed_mem_trace_dump_heap_sites(void)
+{
+#if defined(MBED_HEAP_STATS_ENABLED) && MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+    // Copy one entry at a time, so that nothing is allocated from the heap
+    // being reported on, and allocations are not blocked while printing
+    for (size_t index = 0; index <= MBED_HEAP_STATS_SITES; index++) {
+        malloc_stats_mutex->lock();
+        mbed_stats_heap_site_t site = heap_sites[index];
+        malloc_stats_mutex->unlock();
+
+        if (site.total_cnt != 0) {
+            printf(MBED_MEM_DEFAULT_TRACER_PREFIX "s:%p;%u;%u;%u;%u\n", site.caller,
+                   (unsigned)site.current_size, (unsigned)site.max_size,
+                   (unsigned)site.alloc_cnt, (unsigned)site.total_cnt);
+        }
+    }
+#endif
 }
 
 /******************************************************************************/
@@ -91,6 +338,67 @@ extern "C" {
     void free_wrapper(struct _reent *r, void *ptr, void *caller);
 }
 
+static void *heap_malloc(struct _reent *r, size_t size)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    void *ptr = heap_pool_alloc(size);
+    if (ptr != NULL) {
+        return ptr;
+    }
+#endif
+    return __real__malloc_r(r, size);
+}
+
+static void heap_free(struct _reent *r, void *ptr)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    if (heap_pool_free(ptr)) {
+        return;
+    }
+#endif
+    __real__free_r(r, ptr);
+}
+
+#ifndef MBED_HEAP_STATS_ENABLED
+static void *heap_realloc(struct _reent *r, void *ptr, size_t size)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    if (ptr == NULL) {
+        return heap_malloc(r, size);
+    }
+    size_t block_size = heap_pool_block_size(ptr);
+    if (block_size != 0) {
+        void *new_ptr = NULL;
+        if (size != 0) {
+            new_ptr = heap_malloc(r, size);
+            if (new_ptr == NULL) {
+                return NULL;
+            }
+            memcpy(new_ptr, ptr, (block_size < size) ? block_size : size);
+        }
+        heap_pool_free(ptr);
+        return new_ptr;
+    }
+#endif
+    return __real__realloc_r(r, ptr, size);
+}
+
+static void *heap_calloc(struct _reent *r, size_t nmemb, size_t size)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    // Both bounded by the largest block size, so that the product can't overflow
+    if (nmemb <= 128 && size <= 128) {
+        void *ptr = heap_pool_alloc(nmemb * size);
+        if (ptr != NULL) {
+            memset(ptr, 0, nmemb * size);
+            return ptr;
+        }
+    }
+#endif
+    return __real__calloc_r(r, nmemb, size);
+}
+#endif // #ifndef MBED_HEAP_STATS_ENABLED
+
 
 extern "C" void *__wrap__malloc_r(struct _reent *r, size_t size)
 {
@@ -105,7 +413,7 @@ extern "C" void *malloc_wrapper(struct _reent *r, size_t size, void *caller)
 #endif
 #ifdef MBED_HEAP_STATS_ENABLED
     malloc_stats_mutex->lock();
-    alloc_info_t *alloc_info = (alloc_info_t *)__real__malloc_r(r, size + sizeof(alloc_info_t));
+    alloc_info_t *alloc_info = (alloc_info_t *)heap_malloc(r, size + sizeof(alloc_info_t));
     if (alloc_info != NULL) {
         alloc_info->size = size;
         alloc_info->signature = MBED_HEAP_STATS_SIGNATURE;
@@ -116,13 +424,16 @@ extern "C" void *malloc_wrapper(struct _reent *r, size_t size, void *caller)
         if (heap_stats.current_size > heap_stats.max_size) {
             heap_stats.max_size = heap_stats.current_size;
         }
-        heap_stats.overhead_size += MALLOC_HEAP_TOTAL_SIZE(MALLOC_HEADER_PTR(alloc_info)) - size;
+        heap_stats.overhead_size += heap_alloc_total_size(alloc_info) - size;
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+        alloc_info->site = heap_site_alloc(caller, size);
+#endif
     } else {
         heap_stats.alloc_fail_cnt += 1;
     }
     malloc_stats_mutex->unlock();
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = __real__malloc_r(r, size);
+    ptr = heap_malloc(r, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_malloc(ptr, size, caller);
@@ -154,7 +465,7 @@ extern "C" void *__wrap__realloc_r(struct _reent *r, void *ptr, size_t size)
 
     // Allocate space
     if (size != 0) {
-        new_ptr = malloc(size);
+        new_ptr = malloc_wrapper(r, size, MBED_CALLER_ADDR());
     }
 
     // If the new buffer has been allocated copy the data to it
@@ -162,10 +473,10 @@ extern "C" void *__wrap__realloc_r(struct _reent *r, void *ptr, size_t size)
     if (new_ptr != NULL) {
         uint32_t copy_size = (old_size < size) ? old_size : size;
         memcpy(new_ptr, (void *)ptr, copy_size);
-        free(ptr);
+        free_wrapper(r, ptr, MBED_CALLER_ADDR());
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    new_ptr = __real__realloc_r(r, ptr, size);
+    new_ptr = heap_realloc(r, ptr, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_realloc(new_ptr, ptr, size, MBED_CALLER_ADDR());
@@ -191,20 +502,23 @@ extern "C" void free_wrapper(struct _reent *r, void *ptr, void *caller)
         alloc_info = ((alloc_info_t *)ptr) - 1;
         if (MBED_HEAP_STATS_SIGNATURE == alloc_info->signature) {
             size_t user_size = alloc_info->size;
-            size_t alloc_size = MALLOC_HEAP_TOTAL_SIZE(MALLOC_HEADER_PTR(alloc_info));
+            size_t alloc_size = heap_alloc_total_size(alloc_info);
             alloc_info->signature = 0x0;
             heap_stats.current_size -= user_size;
             heap_stats.alloc_cnt -= 1;
             heap_stats.overhead_size -= (alloc_size - user_size);
-            __real__free_r(r, (void *)alloc_info);
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+            heap_site_free(alloc_info->site, user_size);
+#endif
+            heap_free(r, (void *)alloc_info);
         } else {
-            __real__free_r(r, ptr);
+            heap_free(r, ptr);
         }
     }
 
     malloc_stats_mutex->unlock();
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    __real__free_r(r, ptr);
+    heap_free(r, ptr);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_free(ptr, caller);
@@ -221,12 +535,12 @@ extern "C" void *__wrap__calloc_r(struct _reent *r, size_t nmemb, size_t size)
 #ifdef MBED_HEAP_STATS_ENABLED
     // Note - no lock needed since malloc is thread safe
 
-    ptr = malloc(nmemb * size);
+    ptr = malloc_wrapper(r, nmemb * size, MBED_CALLER_ADDR());
     if (ptr != NULL) {
         memset(ptr, 0, nmemb * size);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = __real__calloc_r(r, nmemb, size);
+    ptr = heap_calloc(r, nmemb, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_calloc(ptr, nmemb, size, MBED_CALLER_ADDR());
@@ -267,8 +581,8 @@ extern "C" void *__wrap__memalign_r(struct _reent *r, size_t alignment, size_t b
 #define SUB_FREE        $Sub$$__iar_dlfree
 #endif
 
-/* Enable hooking of memory function only if tracing is also enabled */
-#if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED)
+/* Enable hooking of memory function only if tracing or pools are also enabled */
+#if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED) || defined(MBED_HEAP_POOL_ENABLED)
 
 extern "C" {
     void *SUPER_MALLOC(size_t size);
@@ -279,6 +593,67 @@ extern "C" {
     void free_wrapper(void *ptr, void *caller);
 }
 
+static void *heap_malloc(size_t size)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    void *ptr = heap_pool_alloc(size);
+    if (ptr != NULL) {
+        return ptr;
+    }
+#endif
+    return SUPER_MALLOC(size);
+}
+
+static void heap_free(void *ptr)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    if (heap_pool_free(ptr)) {
+        return;
+    }
+#endif
+    SUPER_FREE(ptr);
+}
+
+#ifndef MBED_HEAP_STATS_ENABLED
+static void *heap_realloc(void *ptr, size_t size)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    if (ptr == NULL) {
+        return heap_malloc(size);
+    }
+    size_t block_size = heap_pool_block_size(ptr);
+    if (block_size != 0) {
+        void *new_ptr = NULL;
+        if (size != 0) {
+            new_ptr = heap_malloc(size);
+            if (new_ptr == NULL) {
+                return NULL;
+            }
+            memcpy(new_ptr, ptr, (block_size < size) ? block_size : size);
+        }
+        heap_pool_free(ptr);
+        return new_ptr;
+    }
+#endif
+    return SUPER_REALLOC(ptr, size);
+}
+
+static void *heap_calloc(size_t nmemb, size_t size)
+{
+#ifdef MBED_HEAP_POOL_ENABLED
+    // Both bounded by the largest block size, so that the product can't overflow
+    if (nmemb <= 128 && size <= 128) {
+        void *ptr = heap_pool_alloc(nmemb * size);
+        if (ptr != NULL) {
+            memset(ptr, 0, nmemb * size);
+            return ptr;
+        }
+    }
+#endif
+    return SUPER_CALLOC(nmemb, size);
+}
+#endif // #ifndef MBED_HEAP_STATS_ENABLED
+
 extern "C" void *SUB_MALLOC(size_t size)
 {
     return malloc_wrapper(size, MBED_CALLER_ADDR());
@@ -292,7 +667,7 @@ extern "C" void *malloc_wrapper(size_t size, void *caller)
 #endif
 #ifdef MBED_HEAP_STATS_ENABLED
     malloc_stats_mutex->lock();
-    alloc_info_t *alloc_info = (alloc_info_t *)SUPER_MALLOC(size + sizeof(alloc_info_t));
+    alloc_info_t *alloc_info = (alloc_info_t *)heap_malloc(size + sizeof(alloc_info_t));
     if (alloc_info != NULL) {
         alloc_info->size = size;
         alloc_info->signature = MBED_HEAP_STATS_SIGNATURE;
@@ -303,13 +678,16 @@ extern "C" void *malloc_wrapper(size_t size, void *caller)
         if (heap_stats.current_size > heap_stats.max_size) {
             heap_stats.max_size = heap_stats.current_size;
         }
-        heap_stats.overhead_size += MALLOC_HEAP_TOTAL_SIZE(MALLOC_HEADER_PTR(alloc_info)) - size;
+        heap_stats.overhead_size += heap_alloc_total_size(alloc_info) - size;
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+        alloc_info->site = heap_site_alloc(caller, size);
+#endif
     } else {
         heap_stats.alloc_fail_cnt += 1;
     }
     malloc_stats_mutex->unlock();
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = SUPER_MALLOC(size);
+    ptr = heap_malloc(size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_malloc(ptr, size, caller);
@@ -337,7 +715,7 @@ extern "C" void *SUB_REALLOC(void *ptr, size_t size)
 
     // Allocate space
     if (size != 0) {
-        new_ptr = malloc(size);
+        new_ptr = malloc_wrapper(size, MBED_CALLER_ADDR());
     }
 
     // If the new buffer has been allocated copy the data to it
@@ -345,10 +723,10 @@ extern "C" void *SUB_REALLOC(void *ptr, size_t size)
     if ((new_ptr != NULL) && (ptr != NULL)) {
         uint32_t copy_size = (old_size < size) ? old_size : size;
         memcpy(new_ptr, (void *)ptr, copy_size);
-        free(ptr);
+        free_wrapper(ptr, MBED_CALLER_ADDR());
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    new_ptr = SUPER_REALLOC(ptr, size);
+    new_ptr = heap_realloc(ptr, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_realloc(new_ptr, ptr, size, MBED_CALLER_ADDR());
@@ -365,12 +743,12 @@ extern "C" void *SUB_CALLOC(size_t nmemb, size_t size)
 #endif
 #ifdef MBED_HEAP_STATS_ENABLED
     // Note - no lock needed since malloc is thread safe
-    ptr = malloc(nmemb * size);
+    ptr = malloc_wrapper(nmemb * size, MBED_CALLER_ADDR());
     if (ptr != NULL) {
         memset(ptr, 0, nmemb * size);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = SUPER_CALLOC(nmemb, size);
+    ptr = heap_calloc(nmemb, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_calloc(ptr, nmemb, size, MBED_CALLER_ADDR());
@@ -396,20 +774,23 @@ extern "C" void free_wrapper(void *ptr, void *caller)
         alloc_info = ((alloc_info_t *)ptr) - 1;
         if (MBED_HEAP_STATS_SIGNATURE == alloc_info->signature) {
             size_t user_size = alloc_info->size;
-            size_t alloc_size = MALLOC_HEAP_TOTAL_SIZE(MALLOC_HEADER_PTR(alloc_info));
+            size_t alloc_size = heap_alloc_total_size(alloc_info);
             alloc_info->signature = 0x0;
             heap_stats.current_size -= user_size;
             heap_stats.alloc_cnt -= 1;
             heap_stats.overhead_size -= (alloc_size - user_size);
-            SUPER_FREE((void *)alloc_info);
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0
+            heap_site_free(alloc_info->site, user_size);
+#endif
+            heap_free((void *)alloc_info);
         } else {
-            SUPER_FREE(ptr);
+            heap_free(ptr);
         }
     }
 
     malloc_stats_mutex->unlock();
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    SUPER_FREE(ptr);
+    heap_free(ptr);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mbed_mem_trace_free(ptr, caller);
@@ -417,7 +798,7 @@ extern "C" void free_wrapper(void *ptr, void *caller)
 #endif // #ifdef MBED_MEM_TRACING_ENABLED
 }
 
-#endif // #if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED)
+#endif // #if defined(MBED_MEM_TRACING_ENABLED) || defined(MBED_HEAP_STATS_ENABLED) || defined(MBED_HEAP_POOL_ENABLED)
 
 /******************************************************************************/
 /* Allocation wrappers for other toolchains are not supported yet             */
@@ -433,4 +814,8 @@ extern "C" void free_wrapper(void *ptr, void *caller)
 #error Heap statistics are not supported with the current toolchain.
 #endif
 
+#ifdef MBED_HEAP_POOL_ENABLED
+#error Heap pools are not supported with the current toolchain.
+#endif
+
 #endif // #if defined(TOOLCHAIN_GCC)
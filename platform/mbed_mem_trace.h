@@ -163,6 +163,16 @@ void mbed_mem_trace_free(void *ptr, void *caller);
  */
 void mbed_mem_trace_default_callback(uint8_t op, void *res, void *caller, ...);
 
+/**
+ * Print the heap statistics of each allocation call site (see 'mbed_stats_heap_site_get_each'),
+ * in the format of the default callback. For each call site, it outputs a line
+ * "#s:<0xcaller>;<current_size>;<max_size>;<alloc_cnt>;<total_cnt>", where 'caller' is 0x0
+ * for the call sites that did not fit in the table.
+ * The call sites can be symbolized on the host with tools/mem_trace_sites.py.
+ * Nothing is printed unless the platform.heap-stats-sites configuration option is set.
+ */
+void mbed_mem_trace_dump_heap_sites(void);
+
 /** @}*/
 
 #ifdef __cplusplus
@@ -51,9 +51,27 @@ extern "C" {
 
 #endif // MBED_ALL_STATS_ENABLED
 
+#if MBED_CONF_PLATFORM_HEAP_STATS_SITES > 0 && !defined(MBED_HEAP_STATS_ENABLED)
+#define MBED_HEAP_STATS_ENABLED     1
+#endif
+
 /** Maximum memory regions reported by mbed-os memory statistics */
 #define MBED_MAX_MEM_REGIONS     4
 
+/** Number of fixed-size block pools reported in the heap statistics */
+#define MBED_HEAP_POOL_CLASSES   4
+
+/**
+ * struct mbed_stats_heap_pool_t definition
+ */
+typedef struct {
+    uint32_t block_size;        /**< Size of the blocks of the pool, allocations up to this size are served by the pool */
+    uint32_t block_cnt;         /**< Number of blocks of the pool, set with the platform.heap-pool-<block_size>-blocks configuration option */
+    uint32_t alloc_cnt;         /**< Current number of blocks allocated */
+    uint32_t max_cnt;           /**< Maximum number of blocks allocated at one time */
+    uint32_t fallback_cnt;      /**< Number of allocations of this size class served by the heap because the pool was full */
+} mbed_stats_heap_pool_t;
+
 /**
  * struct mbed_stats_heap_t definition
  */
@@ -65,6 +83,7 @@ typedef struct {
     uint32_t alloc_cnt;         /**< Current number of allocations that have not been freed since reset */
     uint32_t alloc_fail_cnt;    /**< Number of failed allocations since reset */
     uint32_t overhead_size;     /**< Number of bytes used to store heap statistics. This overhead takes up space on the heap, reducing the available heap space */
+    mbed_stats_heap_pool_t pool[MBED_HEAP_POOL_CLASSES];    /**< Statistics of the fixed-size block pools, from the smallest blocks to the largest */
 } mbed_stats_heap_t;
 
 /**
@@ -74,6 +93,30 @@ typedef struct {
  */
 void mbed_stats_heap_get(mbed_stats_heap_t *stats);
 
+/**
+ * struct mbed_stats_heap_site_t definition
+ */
+typedef struct {
+    void *caller;               /**< Address of the call to the allocation function, or NULL for all the call sites that did not fit in the table */
+    uint32_t current_size;      /**< Bytes currently allocated from the call site */
+    uint32_t max_size;          /**< Maximum bytes allocated from the call site at one time since the system started */
+    uint32_t alloc_cnt;         /**< Current number of allocations from the call site that have not been freed */
+    uint32_t total_cnt;         /**< Number of allocations from the call site since the system started */
+} mbed_stats_heap_site_t;
+
+/**
+ *  Fill the passed array of structures with the heap statistics for each call site that allocated memory.
+ *  Statistics are kept for up to MBED_CONF_PLATFORM_HEAP_STATS_SITES call sites, set with the
+ *  platform.heap-stats-sites configuration option.
+ *
+ *  @param stats    A pointer to an array of mbed_stats_heap_site_t structures to fill
+ *  @param count    The number of mbed_stats_heap_site_t structures in the provided array
+ *  @return         The number of mbed_stats_heap_site_t structures that have been filled.
+ *                  If the number of call sites is less than or equal to count, it will equal the number of call sites.
+ *                  If the number of call sites is greater than count, it will equal count.
+ */
+size_t mbed_stats_heap_site_get_each(mbed_stats_heap_site_t *stats, size_t count);
+
 /**
  * struct mbed_stats_stack_t definition
  */
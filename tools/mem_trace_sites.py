@@ -0,0 +1,171 @@
+#!/usr/bin/env python
+"""
+mbed SDK
+Copyright (c) 2019 ARM Limited
+SPDX-License-Identifier: Apache-2.0
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Symbolize the heap usage of each allocation call site from a device log.
+
+The log may contain the output of mbed_mem_trace_dump_heap_sites() ("#s:"
+lines, the last dump of each call site is kept) or of the default memory
+trace callback ("#m:", "#c:", "#r:" and "#f:" lines, which are aggregated
+per call site here). Call sites are resolved to functions and source lines
+with addr2line.
+
+Example:
+    mem_trace_sites.py -e BUILD/K64F/GCC_ARM/app.elf serial.log
+"""
+
+from __future__ import print_function
+
+import argparse
+import re
+import subprocess
+import sys
+
+SITE_RE = re.compile(r"#s:(0x[0-9a-fA-F]+|\(nil\)|0);(\d+);(\d+);(\d+);(\d+)")
+TRACE_RE = re.compile(r"#([mcrf]):(0x[0-9a-fA-F]+|\(nil\)|0);(0x[0-9a-fA-F]+|\(nil\)|0)-([^\s]*)")
+
+
+def to_int(value):
+    """Parse an address or a size as printed by the device"""
+    if value in ("(nil)", ""):
+        return 0
+    return int(value, 0)
+
+
+class Site(object):
+    """Heap usage of a call site"""
+
+    def __init__(self, caller):
+        self.caller = caller
+        self.current_size = 0
+        self.max_size = 0
+        self.alloc_cnt = 0
+        self.total_cnt = 0
+
+    def alloc(self, size):
+        self.current_size += size
+        self.max_size = max(self.max_size, self.current_size)
+        self.alloc_cnt += 1
+        self.total_cnt += 1
+
+    def free(self, size):
+        self.current_size -= size
+        self.alloc_cnt -= 1
+
+
+def parse(lines):
+    """Collect the call sites from the log lines"""
+    dumped = {}
+    traced = {}
+    live = {}
+
+    def alloc(res, caller, size):
+        if res:
+            site = traced.setdefault(caller, Site(caller))
+            site.alloc(size)
+            live[res] = (site, size)
+
+    def free(ptr):
+        if ptr in live:
+            site, size = live.pop(ptr)
+            site.free(size)
+
+    for line in lines:
+        match = SITE_RE.search(line)
+        if match:
+            site = Site(to_int(match.group(1)))
+            (site.current_size, site.max_size,
+             site.alloc_cnt, site.total_cnt) = [int(x) for x in match.groups()[1:]]
+            dumped[site.caller] = site
+            continue
+
+        match = TRACE_RE.search(line)
+        if not match:
+            continue
+        op, res, caller, args = match.groups()
+        res, caller, args = to_int(res), to_int(caller), args.split(";")
+        try:
+            if op == "m":
+                alloc(res, caller, to_int(args[0]))
+            elif op == "c":
+                alloc(res, caller, to_int(args[0]) * to_int(args[1]))
+            elif op == "r":
+                if res or to_int(args[1]) == 0:
+                    free(to_int(args[0]))
+                alloc(res, caller, to_int(args[1]))
+            else:
+                free(to_int(args[0]))
+        except (IndexError, ValueError):
+            continue
+
+    return dumped if dumped else traced
+
+
+def symbolize(addr2line, elf, sites):
+    """Map each call site address to 'function file:line'"""
+    names = {}
+    callers = [site.caller for site in sites if site.caller]
+    if not elf or not callers:
+        return names
+    # Return addresses point after the call, and have the Thumb bit set
+    cmd = [addr2line, "-f", "-C", "-e", elf] + ["0x%x" % (caller - 1) for caller in callers]
+    try:
+        output = subprocess.check_output(cmd).decode("utf-8", "replace").splitlines()
+    except (OSError, subprocess.CalledProcessError) as error:
+        print("Cannot run %s: %s" % (addr2line, error), file=sys.stderr)
+        return names
+    for i, caller in enumerate(callers):
+        if 2 * i + 1 < len(output):
+            names[caller] = "%s %s" % (output[2 * i], output[2 * i + 1])
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1],
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"), default=sys.stdin,
+                        help="device output, standard input by default")
+    parser.add_argument("-e", "--elf", help="application ELF file used to resolve the call sites")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line",
+                        help="addr2line command (default: %(default)s)")
+    parser.add_argument("-s", "--sort", default="current",
+                        choices=["current", "max", "count", "total"],
+                        help="column to sort by, largest first (default: %(default)s)")
+    args = parser.parse_args()
+
+    sites = list(parse(args.log).values())
+    key = {
+        "current": lambda site: site.current_size,
+        "max": lambda site: site.max_size,
+        "count": lambda site: site.alloc_cnt,
+        "total": lambda site: site.total_cnt,
+    }[args.sort]
+    sites.sort(key=key, reverse=True)
+    names = symbolize(args.addr2line, args.elf, sites)
+
+    print("%10s %10s %10s %8s %8s  %s" % ("caller", "current", "max", "count", "total", "location"))
+    for site in sites:
+        if site.caller:
+            caller, location = "0x%08x" % site.caller, names.get(site.caller, "")
+        else:
+            caller, location = "-", "(call sites not in the table)"
+        print("%10s %10d %10d %8d %8d  %s" % (caller, site.current_size, site.max_size,
+                                             site.alloc_cnt, site.total_cnt, location))
+
+
+if __name__ == "__main__":
+    main()